@@ -51,7 +51,8 @@ namespace neogames
 				neogfx::face_list faceList;
 
 				// Card background shape...
-				auto cardBackgroundVertices = neogfx::rounded_rect_vertices(neogfx::rect{ neogfx::point{}, neogfx::size{1.0, kBridgeCardSize.cy / kBridgeCardSize.cx } }.with_centred_origin(), 0.1, true, 20);
+				std::vector<neogfx::xyz> cardBackgroundVertices;
+				neogfx::rounded_rect_vertices(cardBackgroundVertices, neogfx::rect{ neogfx::point{}, neogfx::size{1.0, kBridgeCardSize.cy / kBridgeCardSize.cx } }.with_centred_origin(), 0.1, true, 20);
 				vlp->reserve(cardBackgroundVertices.end() - cardBackgroundVertices.begin() + 28 * 3);
 				neogfx::add_faces(vlp, faceList, cardBackgroundVertices);
 				iCardBackgroundFaces = faceList.faces().size();
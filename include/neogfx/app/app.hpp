@@ -21,6 +21,7 @@
 
 #include <neogfx/neogfx.hpp>
 #include <map>
+#include <array>
 #include <boost/optional.hpp>
 #include <boost/pool/pool_alloc.hpp>
 #include <neolib/async_thread.hpp>
@@ -38,6 +39,7 @@
 #include <neogfx/app/action.hpp>
 #include <neogfx/app/i_mnemonic.hpp>
 #include <neogfx/app/i_help.hpp>
+#include <neogfx/app/timer_wheel.hpp>
 
 namespace neogfx
 {
@@ -97,6 +99,7 @@ namespace neogfx
 		~app();
 	public:
 		static app& instance();
+		static bool has_instance(); ///< false when running headless (e.g. tests and benchmarks)
 		const neogfx::program_options& program_options() const override;
 		const std::string& name() const override;
 		int exec(bool aQuitWhenLastWindowClosed = true) override;
@@ -109,6 +112,7 @@ namespace neogfx
 		i_keyboard& keyboard() const override;
 		i_clipboard& clipboard() const override;
 		i_audio& audio() const override;
+		neogfx::timer_wheel& timer_wheel();
 	public:
 		dimension default_dpi_scale_factor() const override;
 	public:
@@ -119,6 +123,8 @@ namespace neogfx
 		i_style& current_style() override;
 		i_style& change_style(const std::string& aStyleName) override;
 		i_style& register_style(const i_style& aStyle) override;
+		uint32_t style_epoch(style_aspect aAspect = style_aspect::Style) const override;
+		void current_style_updated(style_aspect aAspect);
 	public:
 		const std::string& translate(const std::string& aTranslatableString, const std::string& aContext = std::string{}) const override;
 	public:
@@ -164,6 +170,7 @@ namespace neogfx
 		std::string iName;
 		bool iQuitWhenLastWindowClosed;
 		bool iInExec;
+		neogfx::timer_wheel iTimerWheel;
 		std::unique_ptr<i_basic_services> iBasicServices;
 		std::unique_ptr<i_keyboard> iKeyboard;
 		std::unique_ptr<i_clipboard> iClipboard;
@@ -190,11 +197,14 @@ namespace neogfx
 		i_action& iActionPaste;
 		i_action& iActionDelete;
 		i_action& iActionSelectAll;
-		neolib::callback_timer iStandardActionManager;
+		wheel_timer iStandardActionManager;
 		mnemonic_list iMnemonics;
 		event_processing_context iAppContext;
 		event_processing_context iAppMessageQueueContext;
 		std::vector<std::pair<key_code_e, key_modifiers_e>> iKeySequence;
 		mutable std::unique_ptr<i_help> iHelp;
+		uint32_t iStyleGeneration;
+		std::array<uint32_t, 3> iStyleEpochs; // geometry, font, colour
+		wheel_timer iStyleRelayout;
 	};
 }
\ No newline at end of file
@@ -20,9 +20,86 @@
 #pragma once
 
 #include <neogfx/neogfx.hpp>
+#include <map>
 
 namespace neogfx
 {
+	typedef uint64_t translation_key;
+
+	// 64-bit FNV-1a over the context, a zero separator and then the source string; the resource compiler (nrc) 
+	// computes the same keys when it compiles translation catalogues.
+	inline translation_key translation_context_hash(const char* aContext, std::size_t aContextLength)
+	{
+		translation_key hash = 14695981039346656037ull;
+		for (std::size_t i = 0; i < aContextLength; ++i)
+			hash = (hash ^ static_cast<uint8_t>(aContext[i])) * 1099511628211ull;
+		return hash * 1099511628211ull;
+	}
+
+	inline translation_key translation_context_hash(const std::string& aContext)
+	{
+		return translation_context_hash(aContext.c_str(), aContext.size());
+	}
+
+	inline translation_key translation_key_of(translation_key aContextHash, const char* aSource, std::size_t aSourceLength)
+	{
+		translation_key hash = aContextHash;
+		for (std::size_t i = 0; i < aSourceLength; ++i)
+			hash = (hash ^ static_cast<uint8_t>(aSource[i])) * 1099511628211ull;
+		return hash;
+	}
+
+	inline translation_key translation_key_of(translation_key aContextHash, const std::string& aSource)
+	{
+		return translation_key_of(aContextHash, aSource.c_str(), aSource.size());
+	}
+
+	struct translation_entry
+	{
+		translation_key key;
+		const char* context;
+		const char* source;
+		const char* translation;
+	};
+
+	// A precompiled table of translations for one language, sorted by key.
+	class translation_catalogue
+	{
+	public:
+		struct entries_not_sorted : std::logic_error { entries_not_sorted() : std::logic_error("neogfx::translation_catalogue::entries_not_sorted") {} };
+	public:
+		translation_catalogue(const std::string& aLanguage, const translation_entry* aEntries, std::size_t aEntryCount);
+	public:
+		const std::string& language() const;
+		std::size_t size() const;
+		const std::string* find(translation_key aKey, const std::string& aContext, const char* aSource, std::size_t aSourceLength) const;
+	private:
+		std::string iLanguage;
+		const translation_entry* iEntries;
+		std::size_t iEntryCount;
+		std::vector<std::string> iTranslations; // built once so that lookups can return stable references
+	};
+
+	class translation_manager
+	{
+	private:
+		typedef std::vector<std::unique_ptr<translation_catalogue>> catalogue_list;
+	public:
+		translation_manager();
+		static translation_manager& instance();
+	public:
+		void add_catalogue(const std::string& aLanguage, const translation_entry* aEntries, std::size_t aEntryCount);
+		const std::string& language() const;
+		void set_language(const std::string& aLanguage);
+	public:
+		const std::string& translate(const std::string& aTranslatableString, const std::string& aContext, translation_key aContextHash) const; ///< returns aTranslatableString itself if there is no translation
+		const std::string* find(const char* aTranslatableString, std::size_t aStringLength, const std::string& aContext, translation_key aContextHash) const;
+	private:
+		std::map<std::string, catalogue_list> iCatalogues;
+		std::string iLanguage;
+		const catalogue_list* iActiveCatalogues;
+	};
+
 	class translation_context
 	{
 	public:
@@ -30,11 +107,12 @@ namespace neogfx
 		~translation_context();
 	public:
 		static const std::string& context();
+		static translation_key context_hash();
 	private:
-		static std::vector<std::string>& context_stack();
+		static std::vector<std::pair<std::string, translation_key>>& context_stack();
 	};
 
-	std::string operator "" _t(const char* aTranslatableString, std::size_t aStringLength);
+	const std::string& operator "" _t(const char* aTranslatableString, std::size_t aStringLength);
 
 	const std::string& translate(const std::string& aTranslatableString);
 
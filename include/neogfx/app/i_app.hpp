@@ -90,6 +90,7 @@ namespace neogfx
 		virtual i_style& current_style() = 0;
 		virtual i_style& change_style(const std::string& aStyleName) = 0;
 		virtual i_style& register_style(const i_style& aStyle) = 0;
+		virtual uint32_t style_epoch(style_aspect aAspect = style_aspect::Style) const = 0; // generation at which any of the given aspects of the current style last changed
 	public:
 		virtual const std::string& translate(const std::string& aTranslatableString, const std::string& aContext = std::string{}) const = 0;
 	public:
@@ -30,6 +30,7 @@ namespace neogfx
 		virtual void add_resource(const std::string& aUri, const void* aResourceData, std::size_t aResourceSize) = 0;
 		virtual void add_module_resource(const std::string& aUri, const void* aResourceData, std::size_t aResourceSize) = 0;
 		virtual i_resource::pointer load_resource(const std::string& aUri) = 0;
+		virtual std::shared_ptr<const i_resource::data_type> load_archived_resource(const std::string& aArchiveUri, const std::string& aEntryPath) = 0;
 	public:
 		virtual void cleanup() = 0;
 		virtual void clean() = 0;
@@ -45,11 +45,14 @@ namespace neogfx
 		virtual void* data();
 		virtual std::size_t size() const;
 		virtual hash_digest_type hash() const;
+	private:
+		const data_type& contents() const;
 	private:
 		i_resource_manager& iManager;
 		std::string iUri;
 		boost::optional<std::string> iError;
 		std::size_t iSize;
 		std::vector<uint8_t> iData;
+		std::shared_ptr<const data_type> iPayload; // archive entries share the archive's decompressed payload until written to
 	};
 }
\ No newline at end of file
@@ -0,0 +1,71 @@
+// resource_archive.hpp
+/*
+  neogfx C++ GUI Library
+  Copyright (c) 2018 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <neogfx/neogfx.hpp>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <neolib/zip.hpp>
+#include "i_resource.hpp"
+
+namespace neogfx
+{
+	// A zip resource archive whose central directory is indexed once on opening; entries are only decompressed when 
+	// requested and recently used payloads are kept up to a total size bound.
+	class resource_archive
+	{
+	public:
+		typedef i_resource::data_type data_type;
+		typedef std::shared_ptr<const data_type> payload_pointer;
+	public:
+		static constexpr std::size_t DefaultPayloadCacheCapacity = 16u * 1024u * 1024u;
+	private:
+		typedef std::pair<std::string, payload_pointer> payload_entry;
+		typedef std::list<payload_entry> payload_list;
+	public:
+		resource_archive(const std::string& aPath, std::size_t aPayloadCacheCapacity = DefaultPayloadCacheCapacity);
+		resource_archive(i_resource::pointer aArchive, std::size_t aPayloadCacheCapacity = DefaultPayloadCacheCapacity);
+	private:
+		resource_archive(const resource_archive&) = delete;
+		resource_archive& operator=(const resource_archive&) = delete;
+	public:
+		std::size_t entry_count() const;
+		bool contains(const std::string& aEntryPath) const;
+		payload_pointer extract(const std::string& aEntryPath);
+		std::size_t payload_cache_size() const;
+	private:
+		void index();
+		void evict();
+	private:
+		mutable std::mutex iMutex;
+		boost::interprocess::file_mapping iFile;
+		boost::interprocess::mapped_region iMappedFile;
+		i_resource::pointer iArchiveResource; // if not a file; kept alive as the archive is read in place
+		neolib::zip iZip;
+		std::unordered_map<std::string, std::size_t> iIndex;
+		std::size_t iPayloadCacheCapacity;
+		std::size_t iPayloadCacheSize;
+		payload_list iPayloads; // most recently used first
+		std::unordered_map<std::string, payload_list::iterator> iPayloadIndex;
+	};
+}
@@ -20,8 +20,10 @@
 #pragma once
 
 #include <neogfx/neogfx.hpp>
+#include <mutex>
 #include <neolib/variant.hpp>
 #include "i_resource_manager.hpp"
+#include "resource_archive.hpp"
 
 namespace neogfx
 {
@@ -34,11 +36,17 @@ namespace neogfx
 		virtual void add_resource(const std::string& aUri, const void* aResourceData, std::size_t aResourceSize);
 		virtual void add_module_resource(const std::string& aUri, const void* aResourceData, std::size_t aResourceSize);
 		virtual i_resource::pointer load_resource(const std::string& aUri);
+		virtual std::shared_ptr<const i_resource::data_type> load_archived_resource(const std::string& aArchiveUri, const std::string& aEntryPath);
+	public:
+		std::shared_ptr<resource_archive> archive(const std::string& aArchiveUri);
 	public:
 		virtual void cleanup();
 		virtual void clean();
 	private:
+		i_resource::pointer find_resource(const std::string& aUri) const;
+	private:
+		std::recursive_mutex iMutex; // resources are also loaded by image decoder worker threads
 		std::map<std::string, neolib::variant<i_resource::pointer, i_resource::weak_pointer>> iResources;
-		std::map<std::string, neolib::variant<i_resource::pointer, i_resource::weak_pointer>> iResourceArchives;
+		std::map<std::string, std::shared_ptr<resource_archive>> iResourceArchives; // opened once and indexed
 	};
 }
\ No newline at end of file
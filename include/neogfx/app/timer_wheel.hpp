@@ -0,0 +1,106 @@
+// timer_wheel.hpp
+/*
+  neogfx C++ GUI Library
+  Copyright (c) 2018 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <neogfx/neogfx.hpp>
+#include <array>
+#include <functional>
+#include <boost/optional.hpp>
+
+namespace neogfx
+{
+	class wheel_timer;
+
+	// Hierarchical timer wheel: four levels of 64 one millisecond slots; timers further out than the top level
+	// can reach are parked in it and re-placed when cascaded. The clock is injectable so that scheduling can be
+	// driven by a virtual clock.
+	class timer_wheel
+	{
+		friend class wheel_timer;
+	public:
+		typedef uint64_t time_point; // milliseconds
+		typedef std::function<time_point()> clock;
+	private:
+		static constexpr uint32_t Levels = 4u;
+		static constexpr uint32_t SlotBits = 6u;
+		static constexpr uint32_t Slots = 1u << SlotBits;
+		static constexpr time_point SlotMask = Slots - 1u;
+		typedef std::array<wheel_timer*, Slots> level;
+	public:
+		timer_wheel();
+		timer_wheel(const clock& aClock);
+		~timer_wheel();
+	private:
+		timer_wheel(const timer_wheel&) = delete;
+		timer_wheel& operator=(const timer_wheel&) = delete;
+	public:
+		static time_point steady_clock();
+	public:
+		time_point now() const;
+		bool empty() const;
+		std::size_t count() const;
+		boost::optional<time_point> next_deadline() const;
+		bool advance();
+		bool advance(time_point aNow);
+	private:
+		void insert(wheel_timer& aTimer, time_point aEarliest);
+		void remove(wheel_timer& aTimer);
+		void cascade(time_point aTick);
+		bool expire(time_point aTick);
+	private:
+		clock iClock;
+		time_point iCurrentTick;
+		std::array<level, Levels> iLevels;
+		std::array<uint64_t, Levels> iOccupied;
+		std::size_t iCount;
+	};
+
+	// A timer scheduled on a timer_wheel; the handle is the wheel's list node so scheduling and cancelling never allocate.
+	class wheel_timer
+	{
+		friend class timer_wheel;
+	public:
+		typedef std::function<void(wheel_timer&)> callback;
+	public:
+		wheel_timer(neogfx::timer_wheel& aWheel, const callback& aCallback, uint32_t aDuration_ms, bool aInitialWait = true);
+		~wheel_timer();
+	private:
+		wheel_timer(const wheel_timer&) = delete;
+		wheel_timer& operator=(const wheel_timer&) = delete;
+	public:
+		neogfx::timer_wheel& timer_wheel() const;
+		uint32_t duration() const;
+		void set_duration(uint32_t aDuration_ms, bool aEffectiveImmediately = false);
+		timer_wheel::time_point deadline() const;
+		bool waiting() const;
+		void again();
+		void again_if();
+		void cancel();
+	private:
+		neogfx::timer_wheel& iWheel;
+		callback iCallback;
+		uint32_t iDuration;
+		timer_wheel::time_point iDeadline;
+		wheel_timer** iLink;
+		wheel_timer* iNext;
+		uint32_t iLevel;
+		uint32_t iSlot;
+	};
+}
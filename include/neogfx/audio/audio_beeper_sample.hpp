@@ -19,6 +19,7 @@
 #pragma once
 
 #include <neogfx/neogfx.hpp>
+#include <mutex>
 #include <neolib/variant.hpp>
 #include <neogfx/audio/audio_spec.hpp>
 #include <neogfx/audio/i_audio_beeper_sample.hpp>
@@ -34,6 +35,17 @@ namespace neogfx
 		struct item_repeat_start { uint32_t repeatCount; };
 		struct item_repeat_end {};
 		typedef neolib::variant<item_beep, item_envelope, item_silence, item_repeat_start, item_repeat_end> value_type;
+		struct segment
+		{
+			frame_index start;
+			frame_index frames;
+			double frequency; // zero for silence
+			bool hasEnvelope;
+			audio_envelope envelope;
+		};
+	public:
+		static constexpr float Amplitude = 0.25f;
+		static constexpr double SustainLevel = 0.6; // envelope sustain values are durations so the level is fixed
 	public:
 		audio_beeper_sample(const audio_spec& aSpec);
 	public:
@@ -49,8 +61,15 @@ namespace neogfx
 		void repeat_start(uint32_t aRepeatCount) override;
 		void repeat_end() override;
 		void clear() override;
+	private:
+		void update_segments() const;
+		void render(const segment& aSegment, frame_index aOffset, float* aBuffer, frame_index aFrameCount) const;
 	private:
 		audio_spec iSpec;
+		mutable std::recursive_mutex iMutex;
 		std::vector<value_type> iItems;
+		mutable bool iSegmentsValid;
+		mutable std::vector<segment> iSegments; // items with repeat blocks expanded
+		mutable frame_index iTotalFrames;
 	};
 }
\ No newline at end of file
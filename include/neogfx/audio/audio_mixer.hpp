@@ -0,0 +1,84 @@
+// audio_mixer.hpp
+/*
+  neogfx C++ GUI Library
+  Copyright (c) 2018 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <neogfx/neogfx.hpp>
+#include <mutex>
+#include <neogfx/audio/audio_spec.hpp>
+#include <neogfx/audio/i_audio_track.hpp>
+
+namespace neogfx
+{
+	// Renders tracks into interleaved output in the device format. Working buffers are sized by set_spec() and
+	// add_track() so that mix() and render() do not allocate; callers serialize access through mutex().
+	class audio_mixer
+	{
+	public:
+		typedef i_audio_sample::frame_index frame_index;
+	private:
+		struct repeat
+		{
+			i_audio_track::item_index start;
+			uint32_t remaining;
+		};
+		struct cursor
+		{
+			i_audio_track* track;
+			i_audio_track::item_index item;
+			double position; // in source frames for samples, output frames for silence
+			std::vector<repeat> repeats;
+		};
+		typedef std::vector<cursor> cursor_list;
+	public:
+		static constexpr frame_index ChunkFrames = 1024;
+		static constexpr frame_index SourceChunkFrames = ChunkFrames * 2 + 2; // enough source frames to produce a chunk from a source at up to twice the output rate
+		static constexpr uint32_t MaxSourceChannels = 8;
+		static constexpr std::size_t ReservedRepeatDepth = 16;
+	public:
+		audio_mixer(const audio_spec& aSpec);
+	public:
+		std::recursive_mutex& mutex() const;
+		const audio_spec& spec() const;
+		void set_spec(const audio_spec& aSpec);
+		float gain() const;
+		void set_gain(float aGain);
+	public:
+		void add_track(i_audio_track& aTrack);
+		void remove_track(i_audio_track& aTrack);
+	public:
+		void mix(float* aOutput, frame_index aFrameCount);
+		void render(void* aOutput, frame_index aFrameCount);
+	private:
+		void mix(cursor& aCursor, float* aOutput, frame_index aFrameCount);
+		frame_index mix_sample(cursor& aCursor, const i_audio_sample& aSample, float* aOutput, frame_index aFrameCount);
+		void convert(const float* aSource, void* aOutput, std::size_t aCount) const;
+	private:
+		mutable std::recursive_mutex iMutex;
+		audio_spec iSpec;
+		float iGain;
+		cursor_list iCursors;
+		std::vector<float> iMixBuffer;
+		std::vector<float> iSourceBuffer;
+		std::vector<float> iFromBuffer;
+		std::vector<float> iToBuffer;
+		std::vector<float> iWeightBuffer;
+		std::vector<float> iResampleBuffer;
+	};
+}
@@ -19,14 +19,22 @@
 #pragma once
 
 #include <neogfx/neogfx.hpp>
+#include <atomic>
 #include <neogfx/audio/i_audio_playback_device.hpp>
+#include <neogfx/audio/audio_mixer.hpp>
+#include <neogfx/audio/audio_ring_buffer.hpp>
 
 namespace neogfx
 {
 	class audio_playback_device : public i_audio_playback_device
 	{
+	private:
+		class feeder_thread;
+	public:
+		static constexpr uint32_t BufferPeriods = 4; // device buffers' worth of mixed audio kept ahead of the device
 	public:
 		audio_playback_device();
+		~audio_playback_device();
 	public:
 		i_audio_sample& load_sample(const std::string& aUri) override;
 		i_audio_sample& create_sample(double aDuration) override;
@@ -36,9 +44,27 @@ namespace neogfx
 		void destroy_track(i_audio_track& aTrack) override;
 	public:
 		i_audio_beeper& beeper() override;
+	public:
+		audio_mixer& mixer();
+		bool streaming() const;
+		uint64_t underruns() const;
+	protected:
+		void start_streaming();
+		void stop_streaming();
+		std::size_t buffered() const;
+		void pull(void* aBuffer, std::size_t aSize);
+	private:
+		void feed();
 	private:
 		std::vector<std::shared_ptr<i_audio_sample>> iSamples;
 		std::vector<std::shared_ptr<i_audio_track>> iTracks;
 		std::unique_ptr<i_audio_beeper> iBeeper;
+		std::unique_ptr<audio_mixer> iMixer;
+		std::unique_ptr<audio_ring_buffer<uint8_t>> iRing;
+		std::atomic<audio_ring_buffer<uint8_t>*> iDeviceRing; ///< the ring as seen from the device thread; null once streaming stops
+		mutable std::atomic<uint32_t> iDeviceReaders; ///< device thread calls to pull() and buffered() in progress
+		std::vector<uint8_t> iFeedBuffer;
+		std::atomic<uint64_t> iUnderruns;
+		std::unique_ptr<feeder_thread> iFeederThread;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,96 @@
+// audio_ring_buffer.hpp
+/*
+  neogfx C++ GUI Library
+  Copyright (c) 2018 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <neogfx/neogfx.hpp>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+namespace neogfx
+{
+	// Lock-free ring for exactly one producer thread and one consumer thread; read() and write() never block or allocate.
+	template <typename T>
+	class audio_ring_buffer
+	{
+	public:
+		typedef T value_type;
+	public:
+		audio_ring_buffer(std::size_t aCapacity) :
+			iBuffer(round_up(aCapacity)), iMask{ iBuffer.size() - 1 }, iWritePosition{ 0 }, iReadPosition{ 0 }
+		{
+		}
+	private:
+		audio_ring_buffer(const audio_ring_buffer&) = delete;
+		audio_ring_buffer& operator=(const audio_ring_buffer&) = delete;
+	public:
+		std::size_t capacity() const
+		{
+			return iBuffer.size();
+		}
+		std::size_t available() const
+		{
+			return iWritePosition.load(std::memory_order_acquire) - iReadPosition.load(std::memory_order_acquire);
+		}
+		std::size_t space() const
+		{
+			return capacity() - available();
+		}
+	public:
+		std::size_t write(const value_type* aData, std::size_t aCount)
+		{
+			const std::size_t writePosition = iWritePosition.load(std::memory_order_relaxed);
+			const std::size_t readPosition = iReadPosition.load(std::memory_order_acquire);
+			const std::size_t count = std::min(aCount, capacity() - (writePosition - readPosition));
+			const std::size_t offset = writePosition & iMask;
+			const std::size_t first = std::min(count, capacity() - offset);
+			std::memcpy(&iBuffer[offset], aData, first * sizeof(value_type));
+			std::memcpy(&iBuffer[0], aData + first, (count - first) * sizeof(value_type));
+			iWritePosition.store(writePosition + count, std::memory_order_release);
+			return count;
+		}
+		std::size_t read(value_type* aData, std::size_t aCount)
+		{
+			const std::size_t readPosition = iReadPosition.load(std::memory_order_relaxed);
+			const std::size_t writePosition = iWritePosition.load(std::memory_order_acquire);
+			const std::size_t count = std::min(aCount, writePosition - readPosition);
+			const std::size_t offset = readPosition & iMask;
+			const std::size_t first = std::min(count, capacity() - offset);
+			std::memcpy(aData, &iBuffer[offset], first * sizeof(value_type));
+			std::memcpy(aData + first, &iBuffer[0], (count - first) * sizeof(value_type));
+			iReadPosition.store(readPosition + count, std::memory_order_release);
+			return count;
+		}
+	private:
+		static std::size_t round_up(std::size_t aCapacity)
+		{
+			std::size_t result = 1;
+			while (result < aCapacity)
+				result <<= 1;
+			return result;
+		}
+	private:
+		std::vector<value_type> iBuffer;
+		std::size_t iMask;
+		std::atomic<std::size_t> iWritePosition; // positions run freely; their difference is the number of readable elements
+		std::atomic<std::size_t> iReadPosition;
+	};
+}
@@ -47,6 +47,32 @@ namespace neogfx
 
 	struct unknown_audio_format : std::logic_error { unknown_audio_format() : std::logic_error("neogfx::unknown_audio_format") {} };
 
+	inline uint32_t audio_sample_size(audio_format aFormat)
+	{
+		switch (aFormat)
+		{
+		case audio_format::S8:
+		case audio_format::U8:
+			return 1;
+		case audio_format::S16LSB:
+		case audio_format::S16MSB:
+		case audio_format::S16SYS:
+		case audio_format::U16LSB:
+		case audio_format::U16MSB:
+		case audio_format::U16SYS:
+			return 2;
+		case audio_format::S32LSB:
+		case audio_format::S32MSB:
+		case audio_format::S32SYS:
+		case audio_format::F32LSB:
+		case audio_format::F32MSB:
+		case audio_format::F32SYS:
+			return 4;
+		default:
+			throw unknown_audio_format();
+		}
+	}
+
 	class audio_spec
 	{
 	public:
@@ -69,6 +95,7 @@ namespace neogfx
 		uint16_t samples() const { return iSamples; }
 		uint32_t size() const { return iSize; }
 		uint8_t silence() const { return iSilence; }
+		uint32_t frame_size() const { return audio_sample_size(iFormat) * iChannels; }
 	private:
 		int32_t iFrequency;
 		audio_format iFormat;
@@ -19,15 +19,19 @@
 #pragma once
 
 #include <neogfx/neogfx.hpp>
+#include <mutex>
 #include <neogfx/audio/audio_spec.hpp>
 #include <neogfx/audio/i_audio_track.hpp>
 
 namespace neogfx
 {
+	// Items may be added while the track is playing: the track shares the mutex of the mixer that plays it so that
+	// adding an item cannot reallocate the item list while the mixer is walking it. Readers (the mixer) hold that
+	// mutex already.
 	class audio_track : public i_audio_track
 	{
 	public:
-		audio_track(const audio_spec& aSpec);
+		audio_track(const audio_spec& aSpec, std::recursive_mutex& aMutex);
 	public:
 		const audio_spec& spec() const override;
 	public:
@@ -41,6 +45,7 @@ namespace neogfx
 		const value_type& item(item_index aItemIndex) const override;
 		value_type& item(item_index aItemIndex) override;
 	private:
+		std::recursive_mutex& iMutex;
 		audio_spec iSpec;
 		std::vector<value_type> iItems;
 	};
@@ -0,0 +1,67 @@
+// null_audio_playback_device.hpp
+/*
+  neogfx C++ GUI Library
+  Copyright (c) 2018 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <neogfx/neogfx.hpp>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <boost/optional.hpp>
+#include <neogfx/audio/audio_playback_device.hpp>
+
+namespace neogfx
+{
+	// A playback device with no hardware behind it: mixed output is consumed by a thread of its own and optionally 
+	// written to a file as raw PCM. In real-time mode periods are consumed at the rate a sound card would consume them
+	// (exercising underrun behaviour); otherwise they are consumed as fast as the mixer can produce them.
+	class null_audio_playback_device : public audio_playback_device
+	{
+	private:
+		class consumer_thread;
+	public:
+		struct failed_to_open_output_file : std::runtime_error { failed_to_open_output_file(const std::string& aPath) : std::runtime_error("neogfx::null_audio_playback_device::failed_to_open_output_file: " + aPath) {} };
+	public:
+		null_audio_playback_device(const std::string& aName = "null", const boost::optional<std::string>& aOutputFile = boost::none, bool aRealTime = true);
+		~null_audio_playback_device();
+	public:
+		const std::string& name() const override;
+	public:
+		bool is_open() const override;
+		void open(const audio_spec& aAudioSpec = audio_spec{}, audio_spec_requirements aRequirements = audio_spec_requirements::RequireNone) override;
+		void close() override;
+	public:
+		const audio_spec& spec() const override;
+	public:
+		bool real_time() const;
+		uint64_t frames_consumed() const;
+	private:
+		void consume();
+	private:
+		std::string iName;
+		boost::optional<std::string> iOutputFile;
+		bool iRealTime;
+		optional_audio_spec iSpec;
+		std::ofstream iOutput;
+		std::vector<uint8_t> iBuffer;
+		std::atomic<uint64_t> iFramesConsumed;
+		std::chrono::steady_clock::time_point iNextPeriod;
+		std::unique_ptr<consumer_thread> iConsumerThread;
+	};
+}
@@ -0,0 +1,48 @@
+// colour_conversion.hpp
+/*
+  neogfx C++ GUI Library
+  Copyright (c) 2018 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <neogfx/neogfx.hpp>
+#include <neogfx/core/colour.hpp>
+
+namespace neogfx
+{
+	// Bulk colour space conversion. RGBA output is always interleaved 8-bit (as uploaded to textures); HSV/HSL input
+	// may be interleaved (arrays of hsv_colour/hsl_colour) or planar (separate component arrays with hue in degrees
+	// and other components in [0, 1]). Planar kernels use SSE2 when available.
+	// Planar hues wrap modulo 360 so 360 gives the same colour as 0 (red), as hsv_colour/hsl_colour do; negative
+	// planar hues are treated as 0.
+
+	void hsv_to_rgba(const float* aHue, const float* aSaturation, const float* aValue, std::size_t aCount, uint8_t* aRgba, uint8_t aAlpha = 0xFF);
+	void hsv_to_rgba(const hsv_colour* aSource, std::size_t aCount, uint8_t* aRgba);
+	void hsl_to_rgba(const float* aHue, const float* aSaturation, const float* aLightness, std::size_t aCount, uint8_t* aRgba, uint8_t aAlpha = 0xFF);
+	void hsl_to_rgba(const hsl_colour* aSource, std::size_t aCount, uint8_t* aRgba);
+
+	void rgba_to_hsv(const uint8_t* aRgba, std::size_t aCount, float* aHue, float* aSaturation, float* aValue);
+	void rgba_to_hsv(const uint8_t* aRgba, std::size_t aCount, hsv_colour* aResult);
+	void rgba_to_hsl(const uint8_t* aRgba, std::size_t aCount, float* aHue, float* aSaturation, float* aLightness);
+	void rgba_to_hsl(const uint8_t* aRgba, std::size_t aCount, hsl_colour* aResult);
+
+	// sRGB <-> linear RGB; alpha is passed through unchanged (scaled to/from [0, 1]).
+	void srgb_to_linear(const uint8_t* aRgba, std::size_t aCount, float* aLinearRgba);
+	void srgb_to_linear(const uint8_t* aRgba, std::size_t aCount, float* aRed, float* aGreen, float* aBlue, float* aAlpha);
+	void linear_to_srgb(const float* aLinearRgba, std::size_t aCount, uint8_t* aRgba);
+	void linear_to_srgb(const float* aRed, const float* aGreen, const float* aBlue, const float* aAlpha, std::size_t aCount, uint8_t* aRgba);
+}
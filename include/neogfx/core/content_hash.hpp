@@ -0,0 +1,45 @@
+// content_hash.hpp
+/*
+  neogfx C++ GUI Library
+  Copyright (c) 2018 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <neogfx/neogfx.hpp>
+#include <array>
+
+namespace neogfx
+{
+	// Streaming 64-bit content hash producing the same digests as XXH64. It is fast but not cryptographic so it must only 
+	// be used for deduplication and cache keys.
+	class content_hasher
+	{
+	public:
+		content_hasher(uint64_t aSeed = 0u);
+	public:
+		void update(const void* aData, std::size_t aSize);
+		uint64_t digest() const;
+	private:
+		std::array<uint64_t, 4> iAccumulators;
+		std::array<uint8_t, 32> iBuffer;
+		std::size_t iBuffered;
+		uint64_t iTotalSize;
+		uint64_t iSeed;
+	};
+
+	uint64_t content_hash(const void* aData, std::size_t aSize, uint64_t aSeed = 0u);
+}
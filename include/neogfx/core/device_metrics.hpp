@@ -30,6 +30,15 @@ namespace neogfx
 		return static_cast<dimension>(static_cast<int32_t>(aPpi / 150.0) + 1);
 	}
 
+	// The pixel density to report in place of aPpi so that the default DPI scale factor becomes aDpiScaleFactor (rounded 
+	// down to a whole step); aPpi is scaled by the ratio of the steps and then clamped into the requested step's band.
+	inline dimension ppi_for_dpi_scale_factor(dimension aPpi, dimension aDpiScaleFactor)
+	{
+		const dimension step = std::max<dimension>(std::floor(aDpiScaleFactor), 1.0);
+		const dimension scaled = aPpi * step / default_dpi_scale_factor(aPpi);
+		return std::min(std::max(scaled, (step - 1.0) * 150.0), step * 150.0 - 1.0);
+	}
+
 	class i_device_resolution
 	{
 	public:
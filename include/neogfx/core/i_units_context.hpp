@@ -20,6 +20,7 @@
 #pragma once
 
 #include <neogfx/neogfx.hpp>
+#include <array>
 #include <neogfx/core/geometrical.hpp>
 #include <neogfx/core/device_metrics.hpp>
 
@@ -39,6 +40,32 @@ namespace neogfx
 		Percentage
 	};
 
+	// Per-unit horizontal and vertical factors from a unit to device units (and back) for a given resolution and em size;
+	// percentages depend on the extents being converted against so their factors are the identity.
+	class units_scale
+	{
+	public:
+		units_scale();
+		units_scale(dimension aHorizontalDpi, dimension aVerticalDpi, dimension aEmSize);
+	public:
+		bool valid() const
+		{
+			return iValid;
+		}
+		const vector2& to_device_units(units aUnits) const
+		{
+			return iToDeviceUnits[static_cast<std::size_t>(aUnits)];
+		}
+		const vector2& from_device_units(units aUnits) const
+		{
+			return iFromDeviceUnits[static_cast<std::size_t>(aUnits)];
+		}
+	private:
+		bool iValid; // false if built without device metrics
+		std::array<vector2, static_cast<std::size_t>(units::Percentage) + 1> iToDeviceUnits;
+		std::array<vector2, static_cast<std::size_t>(units::Percentage) + 1> iFromDeviceUnits;
+	};
+
 	class i_units_context
 	{
 	public:
@@ -51,6 +78,7 @@ namespace neogfx
 		virtual const i_device_metrics& device_metrics() const = 0;
 		virtual neogfx::units units() const = 0;
 		virtual neogfx::units set_units(neogfx::units aUnits) const = 0;
+		virtual const units_scale& device_units_scale() const = 0;
 		// helpers
 	public:
 		dimension dpi_scale(dimension aValue) const
@@ -28,6 +28,7 @@
 #include <boost/optional.hpp>
 #include <boost/math/constants/constants.hpp>
 #include "swizzle.hpp"
+#include "simd.hpp"
 
 namespace neogfx
 { 
@@ -50,7 +51,7 @@ namespace neogfx
 	template <typename T, uint32_t Size, typename Type = column_vector, bool IsScalar=std::is_scalar<T>::value>
 	class basic_vector;
 
-	/* todo: specializations that use SIMD intrinsics. */
+	// arithmetic is delegated to detail::vector_kernel which has SIMD specializations for common float/double sizes
 	template <typename T, uint32_t _Size, typename Type>
 	class basic_vector<T, _Size, Type, true>
 	{
@@ -99,16 +100,16 @@ namespace neogfx
 	public:
 		bool operator==(const basic_vector& right) const { return v == right.v; }
 		bool operator!=(const basic_vector& right) const { return v != right.v; }
-		basic_vector& operator+=(input_reference_type value) { for (uint32_t index = 0; index < Size; ++index) v[index] += value; return *this; }
-		basic_vector& operator-=(input_reference_type value) { for (uint32_t index = 0; index < Size; ++index) v[index] -= value; return *this; }
-		basic_vector& operator*=(input_reference_type value) { for (uint32_t index = 0; index < Size; ++index) v[index] *= value; return *this; }
-		basic_vector& operator/=(input_reference_type value) { for (uint32_t index = 0; index < Size; ++index) v[index] /= value; return *this; }
-		basic_vector& operator+=(const basic_vector& right) { for (uint32_t index = 0; index < Size; ++index) v[index] += right.v[index]; return *this; }
-		basic_vector& operator-=(const basic_vector& right) { for (uint32_t index = 0; index < Size; ++index) v[index] -= right.v[index]; return *this; }
-		basic_vector& operator*=(const basic_vector& right) { for (uint32_t index = 0; index < Size; ++index) v[index] *= right.v[index]; return *this; }
-		basic_vector& operator/=(const basic_vector& right) { for (uint32_t index = 0; index < Size; ++index) v[index] /= right.v[index]; return *this; }
+		basic_vector& operator+=(input_reference_type value) { detail::vector_kernel<value_type, Size>::add(&v[0], value); return *this; }
+		basic_vector& operator-=(input_reference_type value) { detail::vector_kernel<value_type, Size>::subtract(&v[0], value); return *this; }
+		basic_vector& operator*=(input_reference_type value) { detail::vector_kernel<value_type, Size>::multiply(&v[0], value); return *this; }
+		basic_vector& operator/=(input_reference_type value) { detail::vector_kernel<value_type, Size>::divide(&v[0], value); return *this; }
+		basic_vector& operator+=(const basic_vector& right) { detail::vector_kernel<value_type, Size>::add(&v[0], &right.v[0]); return *this; }
+		basic_vector& operator-=(const basic_vector& right) { detail::vector_kernel<value_type, Size>::subtract(&v[0], &right.v[0]); return *this; }
+		basic_vector& operator*=(const basic_vector& right) { detail::vector_kernel<value_type, Size>::multiply(&v[0], &right.v[0]); return *this; }
+		basic_vector& operator/=(const basic_vector& right) { detail::vector_kernel<value_type, Size>::divide(&v[0], &right.v[0]); return *this; }
 		basic_vector operator-() const { basic_vector result; for (uint32_t index = 0; index < Size; ++index) result.v[index] = -v[index]; return result; }
-		scalar magnitude() const { scalar ss = 0; for (uint32_t index = 0; index < Size; ++index) ss += (v[index] * v[index]); return std::sqrt(ss); }
+		scalar magnitude() const { return std::sqrt(detail::vector_kernel<value_type, Size>::sum_of_squares(&v[0])); }
 		basic_vector normalized() const { basic_vector result; scalar m = magnitude(); for (uint32_t index = 0; index < Size; ++index) result.v[index] = v[index] / m; return result; }
 		basic_vector min(const basic_vector& right) const { basic_vector result; for (uint32_t index = 0; index < Size; ++index) result[index] = std::min(v[index], right.v[index]); return result; }
 		basic_vector max(const basic_vector& right) const { basic_vector result; for (uint32_t index = 0; index < Size; ++index) result[index] = std::max(v[index], right.v[index]); return result; }
@@ -511,7 +512,6 @@ namespace neogfx
 		return left[0] * right[0] + left[1] * right[1] + left[2] * right[2];
 	}
 
-	/* todo: specializations that use SIMD intrinsics. */
 	template <typename T, uint32_t Rows, uint32_t Columns>
 	class basic_matrix
 	{
@@ -543,6 +543,7 @@ namespace neogfx
 		const column_type& operator[](uint32_t aColumn) const { return m[aColumn]; }
 		column_type& operator[](uint32_t aColumn) { return m[aColumn]; }
 		const value_type* data() const { return &m[0].v[0]; }
+		value_type* data() { return &m[0].v[0]; }
 	public:
 		basic_matrix& operator+=(input_reference_type value) { for (uint32_t column = 0; column < Columns; ++column) m[column] += value; return *this; }
 		basic_matrix& operator-=(input_reference_type value) { for (uint32_t column = 0; column < Columns; ++column) m[column] -= value; return *this; }
@@ -552,12 +553,7 @@ namespace neogfx
 		basic_matrix& operator-=(const basic_matrix& right) { for (uint32_t column = 0; column < Columns; ++column) m[column] -= right.m[column]; return *this; }
 		basic_matrix& operator*=(const basic_matrix& right) 
 		{ 
-			basic_matrix result;
-			for (uint32_t column = 0; column < Columns; ++column)
-				for (uint32_t row = 0; row < Rows; ++row)
-					for (uint32_t index = 0; index < Columns; ++index)
-						result[column][row] += (m[index][row] * right[column][index]);
-			*this = result;
+			*this = *this * right;
 			return *this;
 		}
 		basic_matrix operator-() const
@@ -729,6 +725,14 @@ namespace neogfx
 		return result;
 	}
 
+	template <typename T>
+	inline basic_matrix<T, 4, 4> operator*(const basic_matrix<T, 4, 4>& left, const basic_matrix<T, 4, 4>& right)
+	{
+		basic_matrix<T, 4, 4> result;
+		detail::matrix44_kernel<T>::multiply(left.data(), right.data(), result.data());
+		return result;
+	}
+
 	template <typename T, uint32_t D, bool IsScalar>
 	inline basic_vector<T, D, column_vector, IsScalar> operator*(const basic_matrix<T, D, D>& left, const basic_vector<T, D, column_vector, IsScalar>& right)
 	{
@@ -739,6 +743,14 @@ namespace neogfx
 		return result;
 	}
 
+	template <typename T>
+	inline basic_vector<T, 4, column_vector, true> operator*(const basic_matrix<T, 4, 4>& left, const basic_vector<T, 4, column_vector, true>& right)
+	{
+		basic_vector<T, 4, column_vector, true> result;
+		detail::matrix44_kernel<T>::transform(left.data(), &right.v[0], &result.v[0]);
+		return result;
+	}
+
 	template <typename T, uint32_t D, bool IsScalar>
 	inline basic_vector<T, D, row_vector, IsScalar> operator*(const basic_vector<T, D, row_vector, IsScalar>& left, const basic_matrix<T, D, D>& right)
 	{
@@ -39,6 +39,11 @@ namespace neogfx
 			LineStrip,
 			ConvexPolygon,
 		};
+		enum fill_rule_e
+		{
+			NonZero,
+			EvenOdd
+		};
 		typedef PointType point_type;
 		typedef typename point_type::coordinate_type coordinate_type;
 		typedef typename point_type::coordinate_type coordinate_delta_type;
@@ -83,11 +88,11 @@ namespace neogfx
 		typedef std::vector<intersect> intersect_list;
 		// construction
 	public:
-		basic_path(shape_type_e aShape = ConvexPolygon, paths_size_type aPathCountHint = 0) : iShape(aShape)
+		basic_path(shape_type_e aShape = ConvexPolygon, paths_size_type aPathCountHint = 0) : iShape(aShape), iFillRule(NonZero)
 		{
 			iPaths.reserve(aPathCountHint);
 		}
-		basic_path(const rect_type& aRect, shape_type_e aShape = ConvexPolygon) : iShape(aShape)
+		basic_path(const rect_type& aRect, shape_type_e aShape = ConvexPolygon) : iShape(aShape), iFillRule(NonZero)
 		{
 			iPaths.reserve(5);
 			move_to(aRect.top_left());
@@ -106,6 +111,14 @@ namespace neogfx
 		{ 
 			iShape = aShape; 
 		}
+		fill_rule_e fill_rule() const
+		{
+			return iFillRule;
+		}
+		void set_fill_rule(fill_rule_e aFillRule)
+		{
+			iFillRule = aFillRule;
+		}
 		point_type position() const 
 		{ 
 			return iPosition; 
@@ -232,6 +245,7 @@ namespace neogfx
 		// attributes
 	private:
 		shape_type_e iShape;
+		fill_rule_e iFillRule;
 		point_type iPosition;
 		boost::optional<point_type> iPointFrom;
 		paths_type iPaths;
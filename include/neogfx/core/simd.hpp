@@ -0,0 +1,321 @@
+// simd.hpp
+/*
+  neogfx C++ GUI Library
+  Copyright (c) 2018 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <neogfx/neogfx.hpp>
+#include <cmath>
+#include <algorithm>
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define NEOGFX_SIMD_SSE2
+#if defined(__AVX__)
+#include <immintrin.h>
+#define NEOGFX_SIMD_AVX
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define NEOGFX_SIMD_NEON
+#endif
+
+namespace neogfx
+{
+	namespace detail
+	{
+		// Component-wise kernels used by basic_vector and basic_matrix. The generic versions are plain loops; the
+		// specializations below operate on the same (unaligned, tightly packed) storage so that the memory layout of
+		// vectors, which are handed directly to OpenGL as vertex data, is unaffected.
+		template <typename T, uint32_t Size>
+		struct vector_kernel
+		{
+			static void add(T* aLeft, const T* aRight) { for (uint32_t index = 0; index < Size; ++index) aLeft[index] += aRight[index]; }
+			static void subtract(T* aLeft, const T* aRight) { for (uint32_t index = 0; index < Size; ++index) aLeft[index] -= aRight[index]; }
+			static void multiply(T* aLeft, const T* aRight) { for (uint32_t index = 0; index < Size; ++index) aLeft[index] *= aRight[index]; }
+			static void divide(T* aLeft, const T* aRight) { for (uint32_t index = 0; index < Size; ++index) aLeft[index] /= aRight[index]; }
+			static void add(T* aLeft, T aRight) { for (uint32_t index = 0; index < Size; ++index) aLeft[index] += aRight; }
+			static void subtract(T* aLeft, T aRight) { for (uint32_t index = 0; index < Size; ++index) aLeft[index] -= aRight; }
+			static void multiply(T* aLeft, T aRight) { for (uint32_t index = 0; index < Size; ++index) aLeft[index] *= aRight; }
+			static void divide(T* aLeft, T aRight) { for (uint32_t index = 0; index < Size; ++index) aLeft[index] /= aRight; }
+			// accumulates in double (as basic_vector::magnitude always has) so integer vectors do not overflow
+			static double sum_of_squares(const T* aValue) { double result = 0.0; for (uint32_t index = 0; index < Size; ++index) result += static_cast<double>(aValue[index]) * static_cast<double>(aValue[index]); return result; }
+		};
+
+		// result = left * right for column-major 4x4 matrices; result may not alias either operand.
+		template <typename T>
+		struct matrix44_kernel
+		{
+			static void multiply(const T* aLeft, const T* aRight, T* aResult)
+			{
+				for (uint32_t column = 0; column < 4; ++column)
+					for (uint32_t row = 0; row < 4; ++row)
+					{
+						T sum{};
+						for (uint32_t index = 0; index < 4; ++index)
+							sum += aLeft[index * 4 + row] * aRight[column * 4 + index];
+						aResult[column * 4 + row] = sum;
+					}
+			}
+			static void transform(const T* aMatrix, const T* aVector, T* aResult)
+			{
+				for (uint32_t row = 0; row < 4; ++row)
+				{
+					T sum{};
+					for (uint32_t index = 0; index < 4; ++index)
+						sum += aMatrix[index * 4 + row] * aVector[index];
+					aResult[row] = sum;
+				}
+			}
+		};
+
+#if defined(NEOGFX_SIMD_SSE2)
+		template <>
+		struct vector_kernel<float, 4>
+		{
+			static void add(float* aLeft, const float* aRight) { _mm_storeu_ps(aLeft, _mm_add_ps(_mm_loadu_ps(aLeft), _mm_loadu_ps(aRight))); }
+			static void subtract(float* aLeft, const float* aRight) { _mm_storeu_ps(aLeft, _mm_sub_ps(_mm_loadu_ps(aLeft), _mm_loadu_ps(aRight))); }
+			static void multiply(float* aLeft, const float* aRight) { _mm_storeu_ps(aLeft, _mm_mul_ps(_mm_loadu_ps(aLeft), _mm_loadu_ps(aRight))); }
+			static void divide(float* aLeft, const float* aRight) { _mm_storeu_ps(aLeft, _mm_div_ps(_mm_loadu_ps(aLeft), _mm_loadu_ps(aRight))); }
+			static void add(float* aLeft, float aRight) { _mm_storeu_ps(aLeft, _mm_add_ps(_mm_loadu_ps(aLeft), _mm_set1_ps(aRight))); }
+			static void subtract(float* aLeft, float aRight) { _mm_storeu_ps(aLeft, _mm_sub_ps(_mm_loadu_ps(aLeft), _mm_set1_ps(aRight))); }
+			static void multiply(float* aLeft, float aRight) { _mm_storeu_ps(aLeft, _mm_mul_ps(_mm_loadu_ps(aLeft), _mm_set1_ps(aRight))); }
+			static void divide(float* aLeft, float aRight) { _mm_storeu_ps(aLeft, _mm_div_ps(_mm_loadu_ps(aLeft), _mm_set1_ps(aRight))); }
+			static double sum_of_squares(const float* aValue)
+			{
+				__m128 value = _mm_loadu_ps(aValue);
+				__m128d low = _mm_cvtps_pd(value);
+				__m128d high = _mm_cvtps_pd(_mm_movehl_ps(value, value));
+				__m128d sum = _mm_add_pd(_mm_mul_pd(low, low), _mm_mul_pd(high, high));
+				return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+			}
+		};
+
+		template <>
+		struct vector_kernel<double, 2>
+		{
+			static void add(double* aLeft, const double* aRight) { _mm_storeu_pd(aLeft, _mm_add_pd(_mm_loadu_pd(aLeft), _mm_loadu_pd(aRight))); }
+			static void subtract(double* aLeft, const double* aRight) { _mm_storeu_pd(aLeft, _mm_sub_pd(_mm_loadu_pd(aLeft), _mm_loadu_pd(aRight))); }
+			static void multiply(double* aLeft, const double* aRight) { _mm_storeu_pd(aLeft, _mm_mul_pd(_mm_loadu_pd(aLeft), _mm_loadu_pd(aRight))); }
+			static void divide(double* aLeft, const double* aRight) { _mm_storeu_pd(aLeft, _mm_div_pd(_mm_loadu_pd(aLeft), _mm_loadu_pd(aRight))); }
+			static void add(double* aLeft, double aRight) { _mm_storeu_pd(aLeft, _mm_add_pd(_mm_loadu_pd(aLeft), _mm_set1_pd(aRight))); }
+			static void subtract(double* aLeft, double aRight) { _mm_storeu_pd(aLeft, _mm_sub_pd(_mm_loadu_pd(aLeft), _mm_set1_pd(aRight))); }
+			static void multiply(double* aLeft, double aRight) { _mm_storeu_pd(aLeft, _mm_mul_pd(_mm_loadu_pd(aLeft), _mm_set1_pd(aRight))); }
+			static void divide(double* aLeft, double aRight) { _mm_storeu_pd(aLeft, _mm_div_pd(_mm_loadu_pd(aLeft), _mm_set1_pd(aRight))); }
+			static double sum_of_squares(const double* aValue)
+			{
+				__m128d value = _mm_loadu_pd(aValue);
+				__m128d product = _mm_mul_pd(value, value);
+				return _mm_cvtsd_f64(_mm_add_sd(product, _mm_unpackhi_pd(product, product)));
+			}
+		};
+
+		template <>
+		struct vector_kernel<double, 3>
+		{
+			static void add(double* aLeft, const double* aRight) { vector_kernel<double, 2>::add(aLeft, aRight); aLeft[2] += aRight[2]; }
+			static void subtract(double* aLeft, const double* aRight) { vector_kernel<double, 2>::subtract(aLeft, aRight); aLeft[2] -= aRight[2]; }
+			static void multiply(double* aLeft, const double* aRight) { vector_kernel<double, 2>::multiply(aLeft, aRight); aLeft[2] *= aRight[2]; }
+			static void divide(double* aLeft, const double* aRight) { vector_kernel<double, 2>::divide(aLeft, aRight); aLeft[2] /= aRight[2]; }
+			static void add(double* aLeft, double aRight) { vector_kernel<double, 2>::add(aLeft, aRight); aLeft[2] += aRight; }
+			static void subtract(double* aLeft, double aRight) { vector_kernel<double, 2>::subtract(aLeft, aRight); aLeft[2] -= aRight; }
+			static void multiply(double* aLeft, double aRight) { vector_kernel<double, 2>::multiply(aLeft, aRight); aLeft[2] *= aRight; }
+			static void divide(double* aLeft, double aRight) { vector_kernel<double, 2>::divide(aLeft, aRight); aLeft[2] /= aRight; }
+			static double sum_of_squares(const double* aValue) { return vector_kernel<double, 2>::sum_of_squares(aValue) + aValue[2] * aValue[2]; }
+		};
+
+#if defined(NEOGFX_SIMD_AVX)
+		template <>
+		struct vector_kernel<double, 4>
+		{
+			static void add(double* aLeft, const double* aRight) { _mm256_storeu_pd(aLeft, _mm256_add_pd(_mm256_loadu_pd(aLeft), _mm256_loadu_pd(aRight))); }
+			static void subtract(double* aLeft, const double* aRight) { _mm256_storeu_pd(aLeft, _mm256_sub_pd(_mm256_loadu_pd(aLeft), _mm256_loadu_pd(aRight))); }
+			static void multiply(double* aLeft, const double* aRight) { _mm256_storeu_pd(aLeft, _mm256_mul_pd(_mm256_loadu_pd(aLeft), _mm256_loadu_pd(aRight))); }
+			static void divide(double* aLeft, const double* aRight) { _mm256_storeu_pd(aLeft, _mm256_div_pd(_mm256_loadu_pd(aLeft), _mm256_loadu_pd(aRight))); }
+			static void add(double* aLeft, double aRight) { _mm256_storeu_pd(aLeft, _mm256_add_pd(_mm256_loadu_pd(aLeft), _mm256_set1_pd(aRight))); }
+			static void subtract(double* aLeft, double aRight) { _mm256_storeu_pd(aLeft, _mm256_sub_pd(_mm256_loadu_pd(aLeft), _mm256_set1_pd(aRight))); }
+			static void multiply(double* aLeft, double aRight) { _mm256_storeu_pd(aLeft, _mm256_mul_pd(_mm256_loadu_pd(aLeft), _mm256_set1_pd(aRight))); }
+			static void divide(double* aLeft, double aRight) { _mm256_storeu_pd(aLeft, _mm256_div_pd(_mm256_loadu_pd(aLeft), _mm256_set1_pd(aRight))); }
+			static double sum_of_squares(const double* aValue) { return vector_kernel<double, 2>::sum_of_squares(aValue) + vector_kernel<double, 2>::sum_of_squares(aValue + 2); }
+		};
+#else
+		template <>
+		struct vector_kernel<double, 4>
+		{
+			static void add(double* aLeft, const double* aRight) { vector_kernel<double, 2>::add(aLeft, aRight); vector_kernel<double, 2>::add(aLeft + 2, aRight + 2); }
+			static void subtract(double* aLeft, const double* aRight) { vector_kernel<double, 2>::subtract(aLeft, aRight); vector_kernel<double, 2>::subtract(aLeft + 2, aRight + 2); }
+			static void multiply(double* aLeft, const double* aRight) { vector_kernel<double, 2>::multiply(aLeft, aRight); vector_kernel<double, 2>::multiply(aLeft + 2, aRight + 2); }
+			static void divide(double* aLeft, const double* aRight) { vector_kernel<double, 2>::divide(aLeft, aRight); vector_kernel<double, 2>::divide(aLeft + 2, aRight + 2); }
+			static void add(double* aLeft, double aRight) { vector_kernel<double, 2>::add(aLeft, aRight); vector_kernel<double, 2>::add(aLeft + 2, aRight); }
+			static void subtract(double* aLeft, double aRight) { vector_kernel<double, 2>::subtract(aLeft, aRight); vector_kernel<double, 2>::subtract(aLeft + 2, aRight); }
+			static void multiply(double* aLeft, double aRight) { vector_kernel<double, 2>::multiply(aLeft, aRight); vector_kernel<double, 2>::multiply(aLeft + 2, aRight); }
+			static void divide(double* aLeft, double aRight) { vector_kernel<double, 2>::divide(aLeft, aRight); vector_kernel<double, 2>::divide(aLeft + 2, aRight); }
+			static double sum_of_squares(const double* aValue) { return vector_kernel<double, 2>::sum_of_squares(aValue) + vector_kernel<double, 2>::sum_of_squares(aValue + 2); }
+		};
+#endif
+
+		template <>
+		struct matrix44_kernel<float>
+		{
+			static void multiply(const float* aLeft, const float* aRight, float* aResult)
+			{
+				__m128 c0 = _mm_loadu_ps(aLeft);
+				__m128 c1 = _mm_loadu_ps(aLeft + 4);
+				__m128 c2 = _mm_loadu_ps(aLeft + 8);
+				__m128 c3 = _mm_loadu_ps(aLeft + 12);
+				for (uint32_t column = 0; column < 4; ++column)
+				{
+					const float* r = aRight + column * 4;
+					__m128 result = _mm_add_ps(
+						_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(r[0])), _mm_mul_ps(c1, _mm_set1_ps(r[1]))),
+						_mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(r[2])), _mm_mul_ps(c3, _mm_set1_ps(r[3]))));
+					_mm_storeu_ps(aResult + column * 4, result);
+				}
+			}
+			static void transform(const float* aMatrix, const float* aVector, float* aResult)
+			{
+				__m128 result = _mm_add_ps(
+					_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(aMatrix), _mm_set1_ps(aVector[0])), _mm_mul_ps(_mm_loadu_ps(aMatrix + 4), _mm_set1_ps(aVector[1]))),
+					_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(aMatrix + 8), _mm_set1_ps(aVector[2])), _mm_mul_ps(_mm_loadu_ps(aMatrix + 12), _mm_set1_ps(aVector[3]))));
+				_mm_storeu_ps(aResult, result);
+			}
+		};
+
+		template <>
+		struct matrix44_kernel<double>
+		{
+			static void multiply(const double* aLeft, const double* aRight, double* aResult)
+			{
+				for (uint32_t column = 0; column < 4; ++column)
+					transform(aLeft, aRight + column * 4, aResult + column * 4);
+			}
+			static void transform(const double* aMatrix, const double* aVector, double* aResult)
+			{
+#if defined(NEOGFX_SIMD_AVX)
+				__m256d result = _mm256_add_pd(
+					_mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(aMatrix), _mm256_set1_pd(aVector[0])), _mm256_mul_pd(_mm256_loadu_pd(aMatrix + 4), _mm256_set1_pd(aVector[1]))),
+					_mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(aMatrix + 8), _mm256_set1_pd(aVector[2])), _mm256_mul_pd(_mm256_loadu_pd(aMatrix + 12), _mm256_set1_pd(aVector[3]))));
+				_mm256_storeu_pd(aResult, result);
+#else
+				for (uint32_t half = 0; half < 4; half += 2)
+				{
+					__m128d result = _mm_add_pd(
+						_mm_add_pd(_mm_mul_pd(_mm_loadu_pd(aMatrix + half), _mm_set1_pd(aVector[0])), _mm_mul_pd(_mm_loadu_pd(aMatrix + 4 + half), _mm_set1_pd(aVector[1]))),
+						_mm_add_pd(_mm_mul_pd(_mm_loadu_pd(aMatrix + 8 + half), _mm_set1_pd(aVector[2])), _mm_mul_pd(_mm_loadu_pd(aMatrix + 12 + half), _mm_set1_pd(aVector[3]))));
+					_mm_storeu_pd(aResult + half, result);
+				}
+#endif
+			}
+		};
+#elif defined(NEOGFX_SIMD_NEON)
+		template <>
+		struct vector_kernel<float, 4>
+		{
+			static void add(float* aLeft, const float* aRight) { vst1q_f32(aLeft, vaddq_f32(vld1q_f32(aLeft), vld1q_f32(aRight))); }
+			static void subtract(float* aLeft, const float* aRight) { vst1q_f32(aLeft, vsubq_f32(vld1q_f32(aLeft), vld1q_f32(aRight))); }
+			static void multiply(float* aLeft, const float* aRight) { vst1q_f32(aLeft, vmulq_f32(vld1q_f32(aLeft), vld1q_f32(aRight))); }
+			static void divide(float* aLeft, const float* aRight) { for (uint32_t index = 0; index < 4; ++index) aLeft[index] /= aRight[index]; }
+			static void add(float* aLeft, float aRight) { vst1q_f32(aLeft, vaddq_f32(vld1q_f32(aLeft), vdupq_n_f32(aRight))); }
+			static void subtract(float* aLeft, float aRight) { vst1q_f32(aLeft, vsubq_f32(vld1q_f32(aLeft), vdupq_n_f32(aRight))); }
+			static void multiply(float* aLeft, float aRight) { vst1q_f32(aLeft, vmulq_f32(vld1q_f32(aLeft), vdupq_n_f32(aRight))); }
+			static void divide(float* aLeft, float aRight) { for (uint32_t index = 0; index < 4; ++index) aLeft[index] /= aRight; }
+			static double sum_of_squares(const float* aValue) { double result = 0.0; for (uint32_t index = 0; index < 4; ++index) result += static_cast<double>(aValue[index]) * aValue[index]; return result; }
+		};
+
+		template <>
+		struct matrix44_kernel<float>
+		{
+			static void multiply(const float* aLeft, const float* aRight, float* aResult)
+			{
+				for (uint32_t column = 0; column < 4; ++column)
+					transform(aLeft, aRight + column * 4, aResult + column * 4);
+			}
+			static void transform(const float* aMatrix, const float* aVector, float* aResult)
+			{
+				float32x4_t result = vmulq_n_f32(vld1q_f32(aMatrix), aVector[0]);
+				result = vmlaq_n_f32(result, vld1q_f32(aMatrix + 4), aVector[1]);
+				result = vmlaq_n_f32(result, vld1q_f32(aMatrix + 8), aVector[2]);
+				result = vmlaq_n_f32(result, vld1q_f32(aMatrix + 12), aVector[3]);
+				vst1q_f32(aResult, result);
+			}
+		};
+#endif
+
+		// Kernels over runs of floats (e.g. interleaved audio frames); unaligned, any length.
+		struct float_span_kernel
+		{
+			// aDestination[i] += aSource[i] * aScale
+			static void multiply_add(float* aDestination, const float* aSource, float aScale, std::size_t aCount)
+			{
+				std::size_t index = 0;
+#if defined(NEOGFX_SIMD_SSE2)
+				__m128 scale = _mm_set1_ps(aScale);
+				for (; index + 4 <= aCount; index += 4)
+					_mm_storeu_ps(aDestination + index, _mm_add_ps(_mm_loadu_ps(aDestination + index), _mm_mul_ps(_mm_loadu_ps(aSource + index), scale)));
+#elif defined(NEOGFX_SIMD_NEON)
+				for (; index + 4 <= aCount; index += 4)
+					vst1q_f32(aDestination + index, vmlaq_n_f32(vld1q_f32(aDestination + index), vld1q_f32(aSource + index), aScale));
+#endif
+				for (; index < aCount; ++index)
+					aDestination[index] += aSource[index] * aScale;
+			}
+			// aResult[i] = aFrom[i] + (aTo[i] - aFrom[i]) * aWeight[i]
+			static void lerp(float* aResult, const float* aFrom, const float* aTo, const float* aWeight, std::size_t aCount)
+			{
+				std::size_t index = 0;
+#if defined(NEOGFX_SIMD_SSE2)
+				for (; index + 4 <= aCount; index += 4)
+				{
+					__m128 from = _mm_loadu_ps(aFrom + index);
+					_mm_storeu_ps(aResult + index, _mm_add_ps(from, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(aTo + index), from), _mm_loadu_ps(aWeight + index))));
+				}
+#elif defined(NEOGFX_SIMD_NEON)
+				for (; index + 4 <= aCount; index += 4)
+				{
+					float32x4_t from = vld1q_f32(aFrom + index);
+					vst1q_f32(aResult + index, vmlaq_f32(from, vsubq_f32(vld1q_f32(aTo + index), from), vld1q_f32(aWeight + index)));
+				}
+#endif
+				for (; index < aCount; ++index)
+					aResult[index] = aFrom[index] + (aTo[index] - aFrom[index]) * aWeight[index];
+			}
+			// aResult[i] = int16(clamp(aSource[i], -1, 1) * 32767)
+			static void to_int16(int16_t* aResult, const float* aSource, std::size_t aCount)
+			{
+				std::size_t index = 0;
+#if defined(NEOGFX_SIMD_SSE2)
+				__m128 minimum = _mm_set1_ps(-1.0f);
+				__m128 maximum = _mm_set1_ps(1.0f);
+				__m128 scale = _mm_set1_ps(32767.0f);
+				for (; index + 8 <= aCount; index += 8)
+				{
+					__m128i low = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(aSource + index), minimum), maximum), scale));
+					__m128i high = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(aSource + index + 4), minimum), maximum), scale));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(aResult + index), _mm_packs_epi32(low, high));
+				}
+#elif defined(NEOGFX_SIMD_NEON)
+				float32x4_t minimum = vdupq_n_f32(-1.0f);
+				float32x4_t maximum = vdupq_n_f32(1.0f);
+				for (; index + 4 <= aCount; index += 4)
+					vst1_s16(aResult + index, vqmovn_s32(vcvtq_s32_f32(vmulq_n_f32(vminq_f32(vmaxq_f32(vld1q_f32(aSource + index), minimum), maximum), 32767.0f))));
+#endif
+				for (; index < aCount; ++index)
+					aResult[index] = static_cast<int16_t>(std::lround(std::min(std::max(aSource[index], -1.0f), 1.0f) * 32767.0f));
+			}
+		};
+	}
+}
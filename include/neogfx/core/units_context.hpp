@@ -36,11 +36,45 @@ namespace neogfx
 		const i_device_metrics& device_metrics() const override;
 		neogfx::units units() const override;
 		neogfx::units set_units(neogfx::units aUnits) const override;
+		const units_scale& device_units_scale() const override;
+	public:
+		static void device_metrics_changed();
+		void invalidate_device_units_scale() const;
 	private:
 		const i_units_context& iSource;
 		mutable neogfx::units iUnits;
+		mutable units_scale iScale;
+		mutable uint32_t iScaleGeneration;
 	};
 
+	// stateless conversions in explicitly given units; the context's current units are neither read nor changed
+	vector2 to_device_units(const i_units_context& aContext, units aUnits, const vector2& aValue);
+	dimension to_device_units(const i_units_context& aContext, units aUnits, dimension aValue);
+	delta to_device_units(const i_units_context& aContext, units aUnits, const delta& aValue);
+	size to_device_units(const i_units_context& aContext, units aUnits, const size& aValue);
+	point to_device_units(const i_units_context& aContext, units aUnits, const point& aValue);
+	rect to_device_units(const i_units_context& aContext, units aUnits, const rect& aValue);
+	margins to_device_units(const i_units_context& aContext, units aUnits, const margins& aValue);
+	vector2 to_device_units(const i_units_context& aContext, units aUnits, const size& aExtents, const vector2& aValue);
+	dimension to_device_units(const i_units_context& aContext, units aUnits, const size& aExtents, dimension aValue);
+	delta to_device_units(const i_units_context& aContext, units aUnits, const size& aExtents, const delta& aValue);
+	size to_device_units(const i_units_context& aContext, units aUnits, const size& aExtents, const size& aValue);
+	point to_device_units(const i_units_context& aContext, units aUnits, const size& aExtents, const point& aValue);
+	rect to_device_units(const i_units_context& aContext, units aUnits, const size& aExtents, const rect& aValue);
+	vector2 from_device_units(const i_units_context& aContext, units aUnits, const vector2& aValue);
+	dimension from_device_units(const i_units_context& aContext, units aUnits, dimension aValue);
+	delta from_device_units(const i_units_context& aContext, units aUnits, const delta& aValue);
+	size from_device_units(const i_units_context& aContext, units aUnits, const size& aValue);
+	point from_device_units(const i_units_context& aContext, units aUnits, const point& aValue);
+	rect from_device_units(const i_units_context& aContext, units aUnits, const rect& aValue);
+	margins from_device_units(const i_units_context& aContext, units aUnits, const margins& aValue);
+	vector2 from_device_units(const i_units_context& aContext, units aUnits, const size& aExtents, const vector2& aValue);
+	dimension from_device_units(const i_units_context& aContext, units aUnits, const size& aExtents, dimension aValue);
+	delta from_device_units(const i_units_context& aContext, units aUnits, const size& aExtents, const delta& aValue);
+	size from_device_units(const i_units_context& aContext, units aUnits, const size& aExtents, const size& aValue);
+	point from_device_units(const i_units_context& aContext, units aUnits, const size& aExtents, const point& aValue);
+	rect from_device_units(const i_units_context& aContext, units aUnits, const size& aExtents, const rect& aValue);
+
 	class units_converter
 	{
 	public:
@@ -166,11 +200,7 @@ namespace neogfx
 	{
 		if (aSourceUnitsContext.units() == aUnits)
 			return aValue;
-		units_converter uc(aSourceUnitsContext);
-		uc.set_units(aUnits);
-		T result = uc.to_device_units(aValue);
-		uc.set_units(uc.saved_units());
-		return uc.from_device_units(result);
+		return from_device_units(aSourceUnitsContext, aSourceUnitsContext.units(), to_device_units(aSourceUnitsContext, aUnits, aValue));
 	}
 
 	template<typename T>
@@ -178,9 +208,7 @@ namespace neogfx
 	{
 		if (aSourceUnitsContext.units() == aNewUnits)
 			return aValue;
-		T result = units_converter(aSourceUnitsContext).to_device_units(aValue);
-		scoped_units su(aSourceUnitsContext, aNewUnits);
-		return units_converter(aSourceUnitsContext).from_device_units(result);
+		return from_device_units(aSourceUnitsContext, aNewUnits, to_device_units(aSourceUnitsContext, aSourceUnitsContext.units(), aValue));
 	}
 
 	template<typename T>
@@ -195,13 +223,8 @@ namespace neogfx
 				return aValue;
 			}
 		}
-		T result = units_converter(aSourceUnitsContext).to_device_units(aValue);
-		{
-			scoped_units su1(aSourceUnitsContext, units::Millimeters);
-			result = units_converter(aSourceUnitsContext).from_device_units(aValue);
-			scoped_units su2(aDestinationUnitsContext, units::Millimeters);
-			result = units_converter(aDestinationUnitsContext).to_device_units(result);
-		}
-		return units_converter(aDestinationUnitsContext).from_device_units(result);
+		T result = from_device_units(aSourceUnitsContext, units::Millimeters, aValue);
+		result = to_device_units(aDestinationUnitsContext, units::Millimeters, result);
+		return from_device_units(aDestinationUnitsContext, aDestinationUnitsContext.units(), result);
 	}
 }
@@ -24,11 +24,12 @@
 #include <boost/pool/pool_alloc.hpp>
 #include <neogfx/core/numerical.hpp>
 #include <neogfx/game/i_collidable_object.hpp>
+#include <neogfx/game/i_broad_phase.hpp>
 
 namespace neogfx
 {
 	template <std::size_t BucketSize = 16, typename Allocator = boost::fast_pool_allocator<i_collidable_object>>
-	class aabb_quadtree
+	class aabb_quadtree : public i_broad_phase
 	{
 	public:
 		typedef Allocator allocator_type;
@@ -397,16 +398,33 @@ namespace neogfx
 			iRootNode.visit_aabbs(aVisitor);
 		}
 	public:
-		void insert(reference aItem)
+		object_iterator full_update(object_iterator aStart, object_iterator aEnd) override
+		{
+			return full_update<object_iterator>(aStart, aEnd);
+		}
+		object_iterator dynamic_update(object_iterator aStart, object_iterator aEnd) override
+		{
+			return dynamic_update<object_iterator>(aStart, aEnd);
+		}
+		object_iterator collisions(object_iterator aStart, object_iterator aEnd, const collision_action& aCollisionAction) const override
+		{
+			return collisions<object_iterator>(aStart, aEnd, aCollisionAction);
+		}
+		void pick(const vec2& aPoint, pick_result& aResult) const override
+		{
+			pick<pick_result>(aPoint, aResult);
+		}
+	public:
+		void insert(reference aItem) override
 		{
 			iRootNode.add_object(aItem);
 		}
-		void remove(reference aItem)
+		void remove(reference aItem) override
 		{
 			iRootNode.remove_object(aItem);
 		}
 	public:
-		uint32_t count() const
+		uint32_t count() const override
 		{
 			return iCount;
 		}
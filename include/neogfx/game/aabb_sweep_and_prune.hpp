@@ -0,0 +1,162 @@
+// aabb_sweep_and_prune.hpp
+/*
+  neogfx C++ GUI Library
+  Copyright (c) 2018 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <neogfx/neogfx.hpp>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <neogfx/core/numerical.hpp>
+#include <neogfx/game/i_collidable_object.hpp>
+#include <neogfx/game/i_broad_phase.hpp>
+
+namespace neogfx
+{
+	// Sort-and-sweep broad phase: objects are kept sorted by the minimum x of their AABBs and candidate pairs are those
+	// whose x intervals overlap. Objects rarely change relative order from one step to the next so dynamic updates
+	// re-sort with an insertion sort, which is close to linear for nearly sorted input.
+	template <typename Aabb = aabb_2d>
+	class aabb_sweep_and_prune : public i_broad_phase
+	{
+	public:
+		typedef Aabb aabb_type;
+		typedef i_collidable_object& reference;
+		typedef const i_collidable_object& const_reference;
+	private:
+		struct entry
+		{
+			i_collidable_object* object;
+			aabb_type aabb;
+		};
+		typedef std::vector<entry> entry_list;
+	public:
+		aabb_sweep_and_prune()
+		{
+		}
+	public:
+		template <typename IterObject>
+		IterObject full_update(IterObject aStart, IterObject aEnd)
+		{
+			iEntries.clear();
+			IterObject o;
+			for (o = aStart; o != aEnd && (**o).category() != object_category::Shape; ++o)
+			{
+				auto& object = (**o).as_collidable_object();
+				iEntries.push_back(entry{ &object, aabb_type{ object.aabb() } });
+				object.save_aabb();
+			}
+			std::sort(iEntries.begin(), iEntries.end(), [](const entry& left, const entry& right) { return left.aabb.min.x < right.aabb.min.x; });
+			return o;
+		}
+		template <typename IterObject>
+		IterObject dynamic_update(IterObject aStart, IterObject aEnd)
+		{
+			for (auto& e : iEntries)
+				e.aabb = aabb_type{ e.object->aabb() };
+			for (std::size_t i = 1; i < iEntries.size(); ++i)
+			{
+				if (iEntries[i - 1].aabb.min.x <= iEntries[i].aabb.min.x)
+					continue;
+				entry moving = iEntries[i];
+				std::size_t j = i;
+				for (; j > 0 && iEntries[j - 1].aabb.min.x > moving.aabb.min.x; --j)
+					iEntries[j] = iEntries[j - 1];
+				iEntries[j] = moving;
+			}
+			IterObject o;
+			for (o = aStart; o != aEnd && (**o).category() != object_category::Shape; ++o)
+				(**o).as_collidable_object().save_aabb();
+			return o;
+		}
+		template <typename IterObject, typename CollisionAction>
+		IterObject collisions(IterObject aStart, IterObject aEnd, CollisionAction aCollisionAction) const
+		{
+			for (auto e1 = iEntries.begin(); e1 != iEntries.end(); ++e1)
+			{
+				if (!e1->object->collidable())
+					continue;
+				for (auto e2 = std::next(e1); e2 != iEntries.end() && e2->aabb.min.x <= e1->aabb.max.x; ++e2)
+				{
+					if (!e2->object->collidable() || !aabb_intersects(e1->aabb, e2->aabb))
+						continue;
+					auto& first = std::less<i_collidable_object*>{}(e1->object, e2->object) ? *e1->object : *e2->object;
+					auto& second = &first == e1->object ? *e2->object : *e1->object;
+					if (first.has_collided(second))
+						aCollisionAction(first, second);
+				}
+			}
+			IterObject o = aStart;
+			while (o != aEnd && (**o).category() != object_category::Shape)
+				++o;
+			return o;
+		}
+		template <typename ResultContainer>
+		void pick(const vec2& aPoint, ResultContainer& aResult, std::function<bool(reference, const vec2& aPoint)> aColliderPredicate = [](reference, const vec2&) { return true; }) const
+		{
+			for (const auto& e : iEntries)
+			{
+				if (e.aabb.min.x > aPoint.x)
+					break;
+				if (aabb_contains(aabb_2d{ e.aabb }, aPoint) && aColliderPredicate(*e.object, aPoint))
+					aResult.insert(aResult.end(), e.object);
+			}
+		}
+		template <typename Visitor>
+		void visit_aabbs(const Visitor& aVisitor) const
+		{
+			for (const auto& e : iEntries)
+				aVisitor(e.aabb);
+		}
+	public:
+		object_iterator full_update(object_iterator aStart, object_iterator aEnd) override
+		{
+			return full_update<object_iterator>(aStart, aEnd);
+		}
+		object_iterator dynamic_update(object_iterator aStart, object_iterator aEnd) override
+		{
+			return dynamic_update<object_iterator>(aStart, aEnd);
+		}
+		object_iterator collisions(object_iterator aStart, object_iterator aEnd, const collision_action& aCollisionAction) const override
+		{
+			return collisions<object_iterator>(aStart, aEnd, aCollisionAction);
+		}
+		void pick(const vec2& aPoint, pick_result& aResult) const override
+		{
+			pick<pick_result>(aPoint, aResult);
+		}
+	public:
+		void insert(reference aItem) override
+		{
+			entry newEntry{ &aItem, aabb_type{ aItem.aabb() } };
+			iEntries.insert(std::upper_bound(iEntries.begin(), iEntries.end(), newEntry, [](const entry& left, const entry& right) { return left.aabb.min.x < right.aabb.min.x; }), newEntry);
+		}
+		void remove(reference aItem) override
+		{
+			iEntries.erase(std::remove_if(iEntries.begin(), iEntries.end(), [&aItem](const entry& e) { return e.object == &aItem; }), iEntries.end());
+		}
+	public:
+		uint32_t count() const override
+		{
+			return static_cast<uint32_t>(iEntries.size());
+		}
+	private:
+		entry_list iEntries;
+	};
+}
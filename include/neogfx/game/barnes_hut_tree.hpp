@@ -0,0 +1,207 @@
+// barnes_hut_tree.hpp
+/*
+  neogfx C++ GUI Library
+  Copyright (c) 2018 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <neogfx/neogfx.hpp>
+#include <vector>
+#include <array>
+#include <neogfx/core/numerical.hpp>
+
+namespace neogfx
+{
+	struct point_mass
+	{
+		const void* id;
+		vec3 position;
+		scalar mass;
+	};
+
+	// Barnes-Hut approximation of pairwise gravitation: bodies are binned into a quadtree (Dimensions == 2) or an
+	// octree (Dimensions == 3) whose nodes record their total mass and centre of mass so that a distant node can be
+	// treated as a single body. A node is approximated when its width divided by its distance is less than theta;
+	// a theta of zero gives the exact (O(n^2)) result.
+	template <uint32_t Dimensions>
+	class barnes_hut_tree
+	{
+		static_assert(Dimensions == 2 || Dimensions == 3, "neogfx::barnes_hut_tree: only quadtrees and octrees are supported");
+	public:
+		static constexpr uint32_t ChildCount = 1u << Dimensions;
+		static constexpr uint32_t MaxDepth = 32u;
+	private:
+		struct node
+		{
+			vec3 centre;
+			scalar halfExtent;
+			vec3 centreOfMass;
+			scalar mass;
+			uint32_t count;
+			uint32_t depth;
+			int32_t firstChild;
+			const void* body;
+		};
+		typedef std::vector<node> node_list;
+	public:
+		barnes_hut_tree(scalar aTheta = 0.5) : iTheta{ aTheta }
+		{
+		}
+	public:
+		scalar theta() const
+		{
+			return iTheta;
+		}
+		void set_theta(scalar aTheta)
+		{
+			iTheta = aTheta;
+		}
+		std::size_t node_count() const
+		{
+			return iNodes.size();
+		}
+	public:
+		void build(const std::vector<point_mass>& aBodies)
+		{
+			iNodes.clear();
+			if (aBodies.empty())
+				return;
+			vec3 min = aBodies[0].position;
+			vec3 max = min;
+			for (const auto& b : aBodies)
+			{
+				min = min.min(b.position);
+				max = max.max(b.position);
+			}
+			scalar extent = std::max(max.x - min.x, max.y - min.y);
+			if (Dimensions == 3)
+				extent = std::max(extent, max.z - min.z);
+			iNodes.push_back(make_node((min + max) / 2.0, extent / 2.0 + 1.0, 1));
+			for (const auto& b : aBodies)
+				insert(b);
+			for (auto& n : iNodes)
+				if (n.mass != 0.0)
+					n.centreOfMass /= n.mass;
+		}
+		vec3 force(const point_mass& aBody, scalar aG) const
+		{
+			vec3 result;
+			if (iNodes.empty())
+				return result;
+			std::array<int32_t, MaxDepth * (ChildCount - 1) + 1> stack;
+			std::size_t top = 0;
+			stack[top++] = 0;
+			while (top != 0)
+			{
+				const node& n = iNodes[stack[--top]];
+				if (n.mass == 0.0 || (n.count == 1 && n.body == aBody.id))
+					continue;
+				// a depth-limited leaf holding several (effectively coincident) bodies including this one exerts no usable force
+				if (n.firstChild == -1 && n.count > 1 && contains(n, aBody.position))
+					continue;
+				vec3 r = aBody.position - n.centreOfMass;
+				scalar distance = r.magnitude();
+				if (n.firstChild == -1 || (!contains(n, aBody.position) && n.halfExtent * 2.0 < iTheta * distance))
+				{
+					if (distance > 0.0)
+						result += -aG * n.mass * aBody.mass * r / (distance * distance * distance);
+				}
+				else
+				{
+					for (uint32_t child = 0; child < ChildCount; ++child)
+						stack[top++] = n.firstChild + static_cast<int32_t>(child);
+				}
+			}
+			return result;
+		}
+	private:
+		static node make_node(const vec3& aCentre, scalar aHalfExtent, uint32_t aDepth)
+		{
+			return node{ aCentre, aHalfExtent, vec3{}, 0.0, 0u, aDepth, -1, nullptr };
+		}
+		static uint32_t child_index(const node& aNode, const vec3& aPosition)
+		{
+			uint32_t result = 0;
+			if (aPosition.x >= aNode.centre.x)
+				result |= 1u;
+			if (aPosition.y >= aNode.centre.y)
+				result |= 2u;
+			if (Dimensions == 3 && aPosition.z >= aNode.centre.z)
+				result |= 4u;
+			return result;
+		}
+		static bool contains(const node& aNode, const vec3& aPosition)
+		{
+			return std::abs(aPosition.x - aNode.centre.x) <= aNode.halfExtent &&
+				std::abs(aPosition.y - aNode.centre.y) <= aNode.halfExtent &&
+				(Dimensions == 2 || std::abs(aPosition.z - aNode.centre.z) <= aNode.halfExtent);
+		}
+		void subdivide(int32_t aNode)
+		{
+			const node parent = iNodes[aNode];
+			const scalar quarter = parent.halfExtent / 2.0;
+			iNodes[aNode].firstChild = static_cast<int32_t>(iNodes.size());
+			for (uint32_t child = 0; child < ChildCount; ++child)
+			{
+				vec3 offset{ (child & 1u) ? quarter : -quarter, (child & 2u) ? quarter : -quarter, Dimensions == 3 ? ((child & 4u) ? quarter : -quarter) : 0.0 };
+				iNodes.push_back(make_node(parent.centre + offset, quarter, parent.depth + 1));
+			}
+		}
+		static void accumulate(node& aNode, const vec3& aPosition, scalar aMass)
+		{
+			aNode.centreOfMass += aPosition * aMass;
+			aNode.mass += aMass;
+			++aNode.count;
+		}
+		void insert(const point_mass& aBody)
+		{
+			int32_t index = 0;
+			for (;;)
+			{
+				if (iNodes[index].firstChild == -1)
+				{
+					if (iNodes[index].count == 0)
+					{
+						accumulate(iNodes[index], aBody.position, aBody.mass);
+						iNodes[index].body = aBody.id;
+						return;
+					}
+					if (iNodes[index].depth >= MaxDepth)
+					{
+						// coincident bodies: keep them together as a single point mass
+						accumulate(iNodes[index], aBody.position, aBody.mass);
+						iNodes[index].body = nullptr;
+						return;
+					}
+					// push the existing sole occupant down a level; its position is the (not yet normalised) centre of mass
+					const vec3 occupantPosition = iNodes[index].centreOfMass / iNodes[index].mass;
+					subdivide(index);
+					node& occupantNode = iNodes[iNodes[index].firstChild + child_index(iNodes[index], occupantPosition)];
+					accumulate(occupantNode, occupantPosition, iNodes[index].mass);
+					occupantNode.centreOfMass = iNodes[index].centreOfMass;
+					occupantNode.body = iNodes[index].body;
+					iNodes[index].body = nullptr;
+				}
+				accumulate(iNodes[index], aBody.position, aBody.mass);
+				index = iNodes[index].firstChild + static_cast<int32_t>(child_index(iNodes[index], aBody.position));
+			}
+		}
+	private:
+		scalar iTheta;
+		node_list iNodes;
+	};
+}
@@ -0,0 +1,54 @@
+// i_broad_phase.hpp
+/*
+  neogfx C++ GUI Library
+  Copyright (c) 2018 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <neogfx/neogfx.hpp>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <neogfx/core/numerical.hpp>
+#include <neogfx/game/i_collidable_object.hpp>
+
+namespace neogfx
+{
+	// The broad phase of collision detection: a spatial structure that finds candidate pairs of collidable objects
+	// for the narrow phase (i_collidable_object::has_collided). Objects are passed as the range of the owner's object
+	// list that precedes its shapes.
+	class i_broad_phase
+	{
+	public:
+		typedef std::vector<std::shared_ptr<i_game_object>> object_list;
+		typedef object_list::iterator object_iterator;
+		typedef std::function<void(i_collidable_object&, i_collidable_object&)> collision_action;
+		typedef std::vector<i_collidable_object*> pick_result;
+	public:
+		virtual ~i_broad_phase() {}
+	public:
+		virtual object_iterator full_update(object_iterator aStart, object_iterator aEnd) = 0;
+		virtual object_iterator dynamic_update(object_iterator aStart, object_iterator aEnd) = 0;
+		virtual object_iterator collisions(object_iterator aStart, object_iterator aEnd, const collision_action& aCollisionAction) const = 0;
+		virtual void pick(const vec2& aPoint, pick_result& aResult) const = 0;
+	public:
+		virtual void insert(i_collidable_object& aItem) = 0;
+		virtual void remove(i_collidable_object& aItem) = 0;
+	public:
+		virtual uint32_t count() const = 0;
+	};
+}
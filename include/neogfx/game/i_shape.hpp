@@ -27,6 +27,7 @@
 #include <neogfx/gfx/texture.hpp>
 #include <neogfx/game/i_game_object.hpp>
 #include <neogfx/game/i_mesh.hpp>
+#include <neogfx/game/mesh.hpp>
 
 namespace neogfx
 {
@@ -47,6 +48,7 @@ namespace neogfx
 
 	class i_widget;
 	class i_shape;
+	struct shape_snapshot;
 
 	class i_shape_container
 	{
@@ -122,6 +124,8 @@ namespace neogfx
 	public:
 		virtual bool update(time_interval aNow) = 0;
 		virtual void paint(graphics_context& aGraphicsContext) const = 0;
+		virtual void take_snapshot(shape_snapshot& aSnapshot) const = 0;
+		virtual void paint(graphics_context& aGraphicsContext, const shape_snapshot& aSnapshot) const = 0;
 		// helpers
 	public:
 		void set_origin(const vec2& aOrigin)
@@ -149,4 +153,17 @@ namespace neogfx
 			set_extents(vec3{ aExtents.cx, aExtents.cy, 0.0 });
 		}
 	};
+
+	// Immutable copy of the state needed to render a shape, taken after each simulation step so that painting does not
+	// have to synchronise with the physics thread.
+	struct shape_snapshot
+	{
+		std::shared_ptr<const i_shape> shape;
+		vec3 position;
+		vec3 previousPosition; ///< position before the last step (for interpolated rendering)
+		vec3 renderOffset; ///< set by the painter to draw the shape between steps
+		optional_rect boundingBox;
+		neogfx::mesh mesh;
+		optional_colour_or_gradient colour;
+	};
 }
\ No newline at end of file
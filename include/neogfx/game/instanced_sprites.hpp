@@ -0,0 +1,94 @@
+// instanced_sprites.hpp
+/*
+  neogfx C++ GUI Library
+  Copyright (c) 2018 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <neogfx/neogfx.hpp>
+#include <vector>
+#include <neogfx/core/numerical.hpp>
+#include <neogfx/gfx/texture.hpp>
+#include <neogfx/game/i_physical_object.hpp>
+#include <neogfx/game/mesh.hpp>
+
+namespace neogfx
+{
+	// Lightweight sprites held as parallel arrays (structure of arrays) rather than as individual objects so that the
+	// physics step can iterate them linearly; all instances are rendered as a single mesh, batched by texture.
+	// Instances take part in uniform gravity but not in collision detection or n-body gravitation.
+	class instanced_sprites
+	{
+	public:
+		struct bad_instance : std::logic_error { bad_instance() : std::logic_error("neogfx::instanced_sprites::bad_instance") {} };
+	public:
+		typedef uint32_t instance_id;
+		typedef i_physical_object::time_interval time_interval;
+		typedef i_physical_object::optional_time_interval optional_time_interval;
+	private:
+		static const uint32_t NoSlot = static_cast<uint32_t>(-1);
+	public:
+		instanced_sprites();
+	public:
+		std::size_t count() const;
+		void reserve(std::size_t aCapacity);
+		instance_id create(const i_texture& aTexture, const optional_rect& aTextureRect = optional_rect{});
+		instance_id create(const i_texture& aTexture, const optional_rect& aTextureRect, const vec2& aExtents);
+		bool alive(instance_id aInstance) const;
+		void kill(instance_id aInstance);
+		void clear();
+	public:
+		const vec3& position(instance_id aInstance) const;
+		void set_position(instance_id aInstance, const vec3& aPosition);
+		const vec3& velocity(instance_id aInstance) const;
+		void set_velocity(instance_id aInstance, const vec3& aVelocity);
+		const vec3& acceleration(instance_id aInstance) const;
+		void set_acceleration(instance_id aInstance, const vec3& aAcceleration);
+		scalar angle_radians(instance_id aInstance) const;
+		void set_angle_radians(instance_id aInstance, scalar aAngle);
+		scalar spin_radians(instance_id aInstance) const;
+		void set_spin_radians(instance_id aInstance, scalar aSpin);
+		scalar mass(instance_id aInstance) const;
+		void set_mass(instance_id aInstance, scalar aMass);
+		const vec2& extents(instance_id aInstance) const;
+		void set_extents(instance_id aInstance, const vec2& aExtents);
+	public:
+		const std::vector<vec3>& positions() const;
+		const std::vector<vec3>& velocities() const;
+		const std::vector<scalar>& angles() const;
+	public:
+		bool update(time_interval aNow, const optional_vec3& aUniformGravity = optional_vec3{});
+		void take_snapshot(mesh& aMesh) const;
+	private:
+		uint32_t slot(instance_id aInstance) const;
+		texture_index texture_source_index(const i_texture& aTexture, const optional_rect& aTextureRect);
+	private:
+		std::vector<vec3> iPositions;
+		std::vector<vec3> iVelocities;
+		std::vector<vec3> iAccelerations;
+		std::vector<scalar> iAngles;
+		std::vector<scalar> iSpins;
+		std::vector<scalar> iMasses;
+		std::vector<vec2> iExtents;
+		std::vector<texture_index> iTextureSources;
+		std::vector<instance_id> iInstances;
+		std::vector<uint32_t> iSlots;
+		std::vector<instance_id> iFreeInstances;
+		texture_list iTextures;
+		optional_time_interval iTimeOfLastUpdate;
+	};
+}
@@ -166,11 +166,14 @@ namespace neogfx
 	public:
 		bool update(time_interval aNow) override;
 		void paint(graphics_context& aGraphicsContext) const override;
+		void take_snapshot(shape_snapshot& aSnapshot) const override;
+		void paint(graphics_context& aGraphicsContext, const shape_snapshot& aSnapshot) const override;
 		// udates
 	public:
 		virtual void clear_vertices_cache();
 		// implementation
 	private:
+		void paint(graphics_context& aGraphicsContext, const shape_snapshot& aSnapshot, const i_mesh& aMesh) const;
 		void init_frames(const i_texture& aTexture, const optional_rect& aTextureRect, const optional_animation_info& aAnimationInfo);
 		void init_frames(texture_list_pointer aTextures, const optional_animation_info& aAnimationInfo);
 		// attributes
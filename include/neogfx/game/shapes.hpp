@@ -77,8 +77,25 @@ namespace neogfx
 		return aResult.insert(aResult.end(), temp.begin(), temp.end());
 	}
 
+	struct shape_cache_stats
+	{
+		uint64_t unitArcHits;
+		uint64_t unitArcMisses;
+		uint64_t roundedRectHits;
+		uint64_t roundedRectMisses;
+	};
+
+	// Arc and rounded rectangle tessellations are cached per thread and the least recently used are evicted first.
+	// The positioned vertices replace the contents of the caller's buffer so reusing it avoids allocation.
+	const shape_cache_stats& shape_cache_statistics();
+	void clear_shape_cache();
+
 	std::vector<xyz> rect_vertices(const rect& aRect, dimension aPixelAdjust, rect_type aType);
-	std::vector<xyz> arc_vertices(const point& aCentre, dimension aRadius, angle aStartAngle, angle aEndAngle, bool aIncludeCentre, uint32_t aArcSegments = 0);
-	std::vector<xyz> circle_vertices(const point& aCentre, dimension aRadius, angle aStartAngle, bool aIncludeCentre, uint32_t aArcSegments = 0);
-	std::vector<xyz> rounded_rect_vertices(const rect& aRect, dimension aRadius, bool aIncludeCentre, uint32_t aArcSegments = 0);
+	void arc_vertices(std::vector<xyz>& aResult, const point& aCentre, dimension aRadius, angle aStartAngle, angle aEndAngle, bool aIncludeCentre, uint32_t aArcSegments = 0);
+	void circle_vertices(std::vector<xyz>& aResult, const point& aCentre, dimension aRadius, angle aStartAngle, bool aIncludeCentre, uint32_t aArcSegments = 0);
+	void rounded_rect_vertices(std::vector<xyz>& aResult, const rect& aRect, dimension aRadius, bool aIncludeCentre, uint32_t aArcSegments = 0);
+
+	// Appends a triangle list covering a simple polygon of either winding (convex polygons are fanned, concave polygons
+	// are ear clipped); returns false without modifying aTriangles if the polygon is self-intersecting.
+	bool tessellate_polygon(const std::vector<xyz>& aPolygon, std::vector<xyz>& aTriangles);
 }
\ No newline at end of file
@@ -20,7 +20,10 @@
 
 #include <neogfx/neogfx.hpp>
 #include <unordered_set>
+#include <unordered_map>
 #include <mutex>
+#include <atomic>
+#include <array>
 #include <boost/pool/pool_alloc.hpp>
 #include <boost/functional/hash.hpp>
 #include <neolib/timer.hpp>
@@ -29,6 +32,9 @@
 #include <neogfx/game/sprite.hpp>
 #include <neogfx/game/aabb_quadtree.hpp>
 #include <neogfx/game/aabb_octree.hpp>
+#include <neogfx/game/aabb_sweep_and_prune.hpp>
+#include <neogfx/game/barnes_hut_tree.hpp>
+#include <neogfx/game/instanced_sprites.hpp>
 
 namespace neogfx
 {
@@ -36,7 +42,31 @@ namespace neogfx
 	{
 	public:
 		typedef i_physical_object::step_time_interval step_time_interval;
+		enum simulation_mode_e
+		{
+			RealTimeSimulation,		///< steps are aligned to the wall clock
+			FixedTimestepSimulation,	///< fixed steps driven by an accumulator; rendering is interpolated between steps
+			ManualSimulation		///< steps only happen when step() is called (headless runs and replays)
+		};
+		enum broad_phase_e
+		{
+			QuadtreeBroadPhase,
+			OctreeBroadPhase,
+			SweepAndPruneBroadPhase
+		};
+		struct simulation_input
+		{
+			uint32_t code;
+			vec3 value;
+		};
+		struct recorded_input
+		{
+			uint64_t step;
+			simulation_input input;
+		};
+		typedef std::vector<recorded_input> input_log;
 	public:
+		event<const simulation_input&> input_applied;
 		event<step_time_interval> applying_physics;
 		event<step_time_interval> physics_applied;
 		event<step_time_interval> taking_snapshot;
@@ -44,6 +74,8 @@ namespace neogfx
 		event<graphics_context&> sprites_painted;
 		event<i_game_object&, i_game_object&> object_collision;
 		event<i_game_object&> object_clicked;
+	public:
+		struct wrong_broad_phase : std::logic_error { wrong_broad_phase() : std::logic_error("neogfx::sprite_plane::wrong_broad_phase") {} };
 	public:
 		typedef i_physical_object::time_interval time_interval;
 		typedef i_physical_object::optional_time_interval optional_time_interval;
@@ -51,17 +83,33 @@ namespace neogfx
 	public:
 		typedef std::shared_ptr<i_game_object> object_pointer;
 		typedef std::vector<object_pointer> object_list;
-		typedef std::vector<i_shape*> shape_list;
+		typedef std::vector<std::shared_ptr<i_shape>> shape_list;
 		typedef aabb_quadtree<> broad_phase_collision_tree_2d;
 		typedef aabb_octree<> broad_phase_collision_tree_3d;
+		typedef aabb_sweep_and_prune<> broad_phase_sweep_and_prune;
+		typedef barnes_hut_tree<2> gravity_tree_2d;
+		typedef barnes_hut_tree<3> gravity_tree_3d;
 		typedef std::pair<i_collidable_object*, i_collidable_object*> collision_pair;
 		typedef std::unordered_set<collision_pair, boost::hash<collision_pair>, std::equal_to<collision_pair>, boost::fast_pool_allocator<collision_pair>> collision_list;
 	private:
 		typedef std::list<sprite, boost::fast_pool_allocator<sprite>> simple_sprite_list;
 		typedef std::list<physical_object, boost::fast_pool_allocator<physical_object>> simple_object_list;
 		class physics_thread;
+		struct render_snapshot
+		{
+			std::vector<shape_snapshot> shapes;
+			std::size_t count = 0;
+			neogfx::mesh instances;
+			scalar interpolationFactor = 1.0; ///< interpolation_factor() when the snapshot was published
+			boost::optional<chrono::flicks> clock; ///< when interpolationFactor was last brought up to date (FixedTimestepSimulation only)
+			chrono::flicks stepInterval = chrono::flicks{ 1 };
+		};
+		typedef std::array<render_snapshot, 3> render_snapshots;
+		static constexpr uint32_t FreshRenderSnapshot = 0x4;
+		static constexpr uint32_t MaxCatchUpSteps = 8;
 	public:
 		sprite_plane();
+		explicit sprite_plane(simulation_mode_e aSimulationMode); ///< a ManualSimulation plane is headless: it needs no app instance and runs no physics thread
 		sprite_plane(i_widget& aParent);
 		sprite_plane(i_layout& aLayout);
 		~sprite_plane();
@@ -77,6 +125,10 @@ namespace neogfx
 		bool dynamic_update_enabled() const;
 		void enable_dynamic_update(bool aEnableDynamicUpdate);
 		void enable_z_sorting(bool aEnableZSorting);
+		bool barnes_hut_enabled() const;
+		void enable_barnes_hut(bool aEnableBarnesHut); ///< approximate n-body gravity in O(n log n) rather than summing every pair
+		scalar barnes_hut_theta() const;
+		void set_barnes_hut_theta(scalar aTheta);
 	public:
 		void add_sprite(i_sprite& aObject);
 		void add_sprite(std::shared_ptr<i_sprite> aObject);
@@ -105,25 +157,57 @@ namespace neogfx
 		void reserve(std::size_t aCapacity);
 		const object_list& objects() const;
 		void add_object(std::shared_ptr<i_game_object> aObject);
+		const neogfx::instanced_sprites& instanced_sprites() const;
+		neogfx::instanced_sprites& instanced_sprites(); ///< modify only from applying_physics/physics_applied handlers (which run under the physics lock)
 	public:
+		broad_phase_e broad_phase_type() const;
+		void set_broad_phase(broad_phase_e aBroadPhase);
+		const i_broad_phase& broad_phase() const;
+		i_broad_phase& broad_phase();
 		bool is_collision_tree_2d() const;
 		bool is_collision_tree_3d() const;
 		const broad_phase_collision_tree_2d& collision_tree_2d() const;
 		broad_phase_collision_tree_2d& collision_tree_2d();
 		const broad_phase_collision_tree_3d& collision_tree_3d() const;
 		broad_phase_collision_tree_3d& collision_tree_3d();
+		bool is_collision_sweep_and_prune() const;
+		const broad_phase_sweep_and_prune& collision_sweep_and_prune() const;
+		broad_phase_sweep_and_prune& collision_sweep_and_prune();
+	public:
+		simulation_mode_e simulation_mode() const;
+		void set_simulation_mode(simulation_mode_e aMode); ///< choose a deterministic mode before adding objects for reproducible runs
+		scalar interpolation_factor() const;
+		uint64_t step_count() const;
+		void step(uint64_t aSteps = 1);
+		void post_input(uint32_t aCode, const vec3& aValue = vec3{}); ///< applied (via input_applied) at the start of the next step in every simulation mode
+		bool recording() const;
+		void start_recording();
+		void stop_recording();
+		const input_log& recorded_inputs() const;
+		bool replaying() const;
+		void replay(const input_log& aInputs);
+		void stop_replay();
+		uint64_t state_hash() const;
 	public:
 		double update_time() const;
 	private:
+		void start_updates();
 		void do_add_object(std::shared_ptr<i_game_object> aObject);
-		void sort_shapes() const;
+		void sort_shapes();
 		void sort_objects();
+		void build_gravity_tree();
 		void update_objects();
+		bool step_objects();
+		void apply_inputs();
+		void dispatch_collisions(bool aOrdered);
 		bool snapshot();
+		void publish_render_snapshot();
+		render_snapshot& current_render_snapshot() const;
 	private:
-		neolib::callback_timer iUpdater;
+		std::unique_ptr<neolib::callback_timer> iUpdater;
 		bool iEnableDynamicUpdate;
 		bool iEnableZSorting;
+		bool iEnableBarnesHut;
 		bool iNeedsSorting;
 		scalar iG;
 		optional_vec3 iUniformGravity;
@@ -131,15 +215,37 @@ namespace neogfx
 		step_time_interval iStepInterval;
 		object_list iObjects;
 		object_list iNewObjects;
-		mutable shape_list iRenderBuffer;
+		shape_list iRenderBuffer;
+		mutable render_snapshots iRenderSnapshots;
+		uint32_t iBackRenderSnapshot;
+		std::atomic<uint32_t> iReadyRenderSnapshot;
+		mutable uint32_t iFrontRenderSnapshot;
 		simple_sprite_list iSimpleSprites; ///< Simple sprites created by this widget (pointers to which will be available in the main sprite list)
 		simple_object_list iSimpleObjects;
+		neogfx::instanced_sprites iInstancedSprites;
 		object_list::iterator iLastCollidable;
-		mutable boost::optional<broad_phase_collision_tree_2d> iBroadPhaseCollisionTree2d;
-		mutable boost::optional<broad_phase_collision_tree_3d> iBroadPhaseCollisionTree3d;
+		broad_phase_e iBroadPhaseType;
+		std::unique_ptr<i_broad_phase> iBroadPhase;
+		std::vector<point_mass> iGravityBodies;
+		gravity_tree_2d iGravityTree2d;
+		gravity_tree_3d iGravityTree3d;
 		chrono::flicks iUpdateTime;
 		std::atomic<bool> iUpdatedSinceLastSnapshot;
 		bool iTakingSnapshot;
+		simulation_mode_e iSimulationMode;
+		boost::optional<chrono::flicks> iLastClock;
+		chrono::flicks iAccumulator;
+		std::atomic<double> iInterpolationFactor;
+		uint64_t iStepCount;
+		std::mutex iInputMutex;
+		std::vector<simulation_input> iPendingInputs;
+		bool iRecording;
+		uint64_t iRecordingStart;
+		input_log iRecordedInputs;
+		boost::optional<input_log> iReplay;
+		uint64_t iReplayStart;
+		std::size_t iReplayPosition;
+		std::unordered_map<const i_shape*, vec3> iPreviousPositions;
 		mutable std::recursive_mutex iUpdateMutex;
 		std::unique_ptr<physics_thread> iPhysicsThread;
 		collision_list iCollisions;
@@ -47,7 +47,10 @@ namespace neogfx
 		rect bounding_box_2d(bool aWithPosition = true) const override;
 	public:
 		void paint(graphics_context& aGraphicsContext) const override;
+		void take_snapshot(shape_snapshot& aSnapshot) const override;
+		void paint(graphics_context& aGraphicsContext, const shape_snapshot& aSnapshot) const override;
 	private:
+		void paint(graphics_context& aGraphicsContext, const vec3& aPosition) const;
 		size text_extent() const;
 	private:
 		std::string iText;
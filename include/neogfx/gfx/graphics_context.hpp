@@ -55,6 +55,12 @@ namespace neogfx
 		AntiAlias
 	};
 
+	enum class blending_mode
+	{
+		Default,
+		Premultiplied
+	};
+
 	enum class logical_operation
 	{
 		None,
@@ -346,6 +352,8 @@ namespace neogfx
 		void set_origin(const point& aOrigin) const;
 		point origin() const;
 		void flush() const;
+		void begin_layer(const rect& aLayerRect) const;
+		void end_layer(i_texture& aTarget) const;
 		void scissor_on(const rect& aRect) const;
 		void scissor_off() const;
 		void clip_to(const rect& aRect) const;
@@ -355,6 +363,8 @@ namespace neogfx
 		void set_opacity(double aOpacity);
 		neogfx::smoothing_mode smoothing_mode() const;
 		void set_smoothing_mode(neogfx::smoothing_mode aSmoothingMode) const;
+		neogfx::blending_mode blending_mode() const;
+		void set_blending_mode(neogfx::blending_mode aBlendingMode) const;
 		void push_logical_operation(logical_operation aLogicalOperation) const;
 		void pop_logical_operation() const;
 		void line_stipple_on(uint32_t aFactor, uint16_t aPattern) const;
@@ -372,14 +382,14 @@ namespace neogfx
 		void draw_circle(const point& aCentre, dimension aRadius, const pen& aPen, const brush& aFill = brush{}, angle aStartAngle = 0.0) const;
 		void draw_arc(const point& aCentre, dimension aRadius, angle aStartAngle, angle aEndAngle, const pen& aPen, const brush& aFill = brush{}) const;
 		void draw_path(const path& aPath, const pen& aPen, const brush& aFill = brush{}) const;
-		void draw_shape(const i_shape& aShape, const pen& aPen, const brush& aFill = brush{}) const;
+		void draw_shape(const i_mesh& aMesh, const pen& aPen, const brush& aFill = brush{}) const;
 		void draw_focus_rect(const rect& aRect) const;
 		void fill_rect(const rect& aRect, const brush& aFill) const;
 		void fill_rounded_rect(const rect& aRect, dimension aRadius, const brush& aFill) const;
 		void fill_circle(const point& aCentre, dimension aRadius, const brush& aFill) const;
 		void fill_arc(const point& aCentre, dimension aRadius, angle aStartAngle, angle aEndAngle, const brush& aFill) const;
 		void fill_path(const path& aPath, const brush& aFill) const;
-		void fill_shape(const i_shape& aShape, const brush& aFill) const;
+		void fill_shape(const i_mesh& aMesh, const brush& aFill) const;
 		size text_extent(const string& aText, const font& aFont, const glyph_text_cache_usage& aCacheUsage = DontUseGlyphTextCache) const;
 		size text_extent(string::const_iterator aTextBegin, string::const_iterator aTextEnd, const font& aFont, const glyph_text_cache_usage& aCacheUsage = DontUseGlyphTextCache) const;
 		size multiline_text_extent(const string& aText, const font& aFont, const glyph_text_cache_usage& aCacheUsage = DontUseGlyphTextCache) const;
@@ -422,7 +432,7 @@ namespace neogfx
 		void draw_texture(const point& aPoint, const i_texture& aTexture, const rect& aTextureRect, const optional_colour& aColour = optional_colour(), shader_effect aShaderEffect = shader_effect::None) const;
 		void draw_texture(const rect& aRect, const i_texture& aTexture, const rect& aTextureRect, const optional_colour& aColour = optional_colour(), shader_effect aShaderEffect = shader_effect::None) const;
 		void draw_texture(const i_shape& aMap, const i_texture& aTexture, const rect& aTextureRect, const optional_colour& aColour = optional_colour(), shader_effect aShaderEffect = shader_effect::None) const;
-		void draw_textures(const i_shape& aMap, texture_list_pointer aTextures, const optional_colour& aColour = optional_colour(), shader_effect aShaderEffect = shader_effect::None) const;
+		void draw_textures(const i_mesh& aMesh, texture_list_pointer aTextures, const optional_colour& aColour = optional_colour(), shader_effect aShaderEffect = shader_effect::None) const;
 		// implementation
 		// from i_device_metrics
 	public:
@@ -441,6 +451,7 @@ namespace neogfx
 		const i_device_metrics& device_metrics() const override;
 		neogfx::units units() const override;
 		neogfx::units set_units(neogfx::units aUnits) const override;
+		const units_scale& device_units_scale() const override;
 	protected:
 		i_native_graphics_context& native_context() const;
 		// helpers
@@ -462,6 +473,7 @@ namespace neogfx
 		mutable std::pair<vec2, vec2> iLogicalCoordinates;
 		mutable double iOpacity;
 		mutable neogfx::smoothing_mode iSmoothingMode;
+		mutable neogfx::blending_mode iBlendingMode;
 		mutable bool iSubpixelRendering;
 		mutable boost::optional<std::pair<bool, char>> iMnemonic;
 		mutable boost::optional<std::string> iPassword;
@@ -528,6 +540,23 @@ namespace neogfx
 		double iPreviousOpacity;
 	};
 
+	class scoped_blending_mode
+	{
+	public:
+		scoped_blending_mode(graphics_context& aGc, neogfx::blending_mode aBlendingMode) :
+			iGc{ aGc }, iPreviousBlendingMode{ aGc.blending_mode() }
+		{
+			iGc.set_blending_mode(aBlendingMode);
+		}
+		~scoped_blending_mode()
+		{
+			iGc.set_blending_mode(iPreviousBlendingMode);
+		}
+	private:
+		graphics_context& iGc;
+		neogfx::blending_mode iPreviousBlendingMode;
+	};
+
 	class scoped_scissor
 	{
 	public:
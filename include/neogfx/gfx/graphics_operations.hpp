@@ -78,6 +78,11 @@ namespace neogfx
 			smoothing_mode smoothingMode;
 		};
 
+		struct set_blending_mode
+		{
+			blending_mode blendingMode;
+		};
+
 		struct push_logical_operation
 		{
 			logical_operation logicalOperation;
@@ -240,6 +245,7 @@ namespace neogfx
 			reset_clip,
 			set_opacity,
 			set_smoothing_mode,
+			set_blending_mode,
 			push_logical_operation,
 			pop_logical_operation,
 			line_stipple_on,
@@ -279,6 +285,7 @@ namespace neogfx
 			ResetClip,
 			SetOpacity,
 			SetSmoothingMode,
+			SetBlendingMode,
 			PushLogicalOperation,
 			PopLogicalOperation,
 			LineStippleOn,
@@ -308,6 +315,8 @@ namespace neogfx
 
 		std::string to_string(operation_type aOpType);
 
+		const pen* primitive_pen(const operation& aOperation);
+		const brush* primitive_fill(const operation& aOperation);
 		bool batchable(const operation& aLeft, const operation& aRight);
 
 		typedef std::vector<operation> operations;
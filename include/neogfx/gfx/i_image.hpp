@@ -45,5 +45,7 @@ namespace neogfx
 		virtual void resize(const neogfx::size& aNewSize) = 0;
 		virtual colour get_pixel(const point& aPoint) const = 0;
 		virtual void set_pixel(const point& aPoint, const colour& aColour) = 0;
+	public:
+		virtual uint64_t content_hash() const = 0;
 	};
 }
\ No newline at end of file
@@ -32,6 +32,7 @@ namespace neogfx
 	class i_native_surface;
 	class i_native_window;
 	class i_native_graphics_context;
+	class i_image;
 
 	class opengl_standard_vertex_arrays; // todo: abstract
 
@@ -44,6 +45,33 @@ namespace neogfx
 		Software
 	};
 
+	// uniforms of the standard shader programs that are set on every draw; their ids are resolved once when a program is linked
+	enum class shader_uniform : uint32_t
+	{
+		PosViewportTop,
+		PosTopLeft,
+		PosBottomRight,
+		GradientDirection,
+		GradientAngle,
+		GradientStartFrom,
+		GradientSize,
+		GradientShape,
+		GradientCentre,
+		StopCount,
+		FilterSize,
+		StopPositionsTexture,
+		StopColoursTexture,
+		FilterTexture,
+		GuiCoordinates,
+		OutputExtents,
+		GlyphTexture,
+		OutputTexture,
+		Subpixel,
+		Effect,
+		Texture,
+		Count
+	};
+
 	class i_rendering_engine
 	{
 	public:
@@ -54,22 +82,43 @@ namespace neogfx
 		{
 		public:
 			struct variable_not_found : std::logic_error { variable_not_found() : std::logic_error("neogfx::i_rendering_engine::i_shader_program::variable_not_found") {} };
+		public:
+			typedef int32_t uniform_id; // resolved when the program is linked; -1 if the program has no such (active) uniform
 		public:
 			virtual void* handle() const = 0;
 			virtual bool has_projection_matrix() const = 0;
 			virtual void set_projection_matrix(const i_native_graphics_context& aGraphicsContext) = 0;
 			virtual void* variable(const std::string& aVariableName) const = 0;
-			virtual void set_uniform_variable(const std::string& aName, float aValue) = 0;
-			virtual void set_uniform_variable(const std::string& aName, double aValue) = 0;
-			virtual void set_uniform_variable(const std::string& aName, int aValue) = 0;
-			virtual void set_uniform_variable(const std::string& aName, float aValue1, float aValue2) = 0;
-			virtual void set_uniform_variable(const std::string& aName, double aValue1, double aValue2) = 0;
-			virtual void set_uniform_variable(const std::string& aName, const vec4f& aVector) = 0;
-			virtual void set_uniform_variable(const std::string& aName, const vec4& aVector) = 0;
-			virtual void set_uniform_array(const std::string& aName, uint32_t aSize, const float* aArray) = 0;
-			virtual void set_uniform_array(const std::string& aName, uint32_t aSize, const double* aArray) = 0;
-			virtual void set_uniform_matrix(const std::string& aName, const mat44::template rebind<float>::type& aMatrix) = 0;
-			virtual void set_uniform_matrix(const std::string& aName, const mat44::template rebind<double>::type& aMatrix) = 0;
+			virtual uniform_id uniform(const std::string& aName) const = 0;
+			virtual uniform_id uniform(shader_uniform aUniform) const = 0;
+			virtual void set_uniform_variable(uniform_id aUniform, float aValue) = 0;
+			virtual void set_uniform_variable(uniform_id aUniform, double aValue) = 0;
+			virtual void set_uniform_variable(uniform_id aUniform, int aValue) = 0;
+			virtual void set_uniform_variable(uniform_id aUniform, float aValue1, float aValue2) = 0;
+			virtual void set_uniform_variable(uniform_id aUniform, double aValue1, double aValue2) = 0;
+			virtual void set_uniform_variable(uniform_id aUniform, const vec4f& aVector) = 0;
+			virtual void set_uniform_variable(uniform_id aUniform, const vec4& aVector) = 0;
+			virtual void set_uniform_array(uniform_id aUniform, uint32_t aSize, const float* aArray) = 0;
+			virtual void set_uniform_array(uniform_id aUniform, uint32_t aSize, const double* aArray) = 0;
+			virtual void set_uniform_matrix(uniform_id aUniform, const mat44::template rebind<float>::type& aMatrix) = 0;
+			virtual void set_uniform_matrix(uniform_id aUniform, const mat44::template rebind<double>::type& aMatrix) = 0;
+		public:
+			void set_uniform_variable(const std::string& aName, float aValue) { set_uniform_variable(uniform(aName), aValue); }
+			void set_uniform_variable(const std::string& aName, double aValue) { set_uniform_variable(uniform(aName), aValue); }
+			void set_uniform_variable(const std::string& aName, int aValue) { set_uniform_variable(uniform(aName), aValue); }
+			void set_uniform_variable(const std::string& aName, float aValue1, float aValue2) { set_uniform_variable(uniform(aName), aValue1, aValue2); }
+			void set_uniform_variable(const std::string& aName, double aValue1, double aValue2) { set_uniform_variable(uniform(aName), aValue1, aValue2); }
+			void set_uniform_variable(const std::string& aName, const vec4f& aVector) { set_uniform_variable(uniform(aName), aVector); }
+			void set_uniform_variable(const std::string& aName, const vec4& aVector) { set_uniform_variable(uniform(aName), aVector); }
+			void set_uniform_array(const std::string& aName, uint32_t aSize, const float* aArray) { set_uniform_array(uniform(aName), aSize, aArray); }
+			void set_uniform_array(const std::string& aName, uint32_t aSize, const double* aArray) { set_uniform_array(uniform(aName), aSize, aArray); }
+			void set_uniform_matrix(const std::string& aName, const mat44::template rebind<float>::type& aMatrix) { set_uniform_matrix(uniform(aName), aMatrix); }
+			void set_uniform_matrix(const std::string& aName, const mat44::template rebind<double>::type& aMatrix) { set_uniform_matrix(uniform(aName), aMatrix); }
+		public:
+			void set_uniform_variable(shader_uniform aUniform, float aValue) { set_uniform_variable(uniform(aUniform), aValue); }
+			void set_uniform_variable(shader_uniform aUniform, int aValue) { set_uniform_variable(uniform(aUniform), aValue); }
+			void set_uniform_variable(shader_uniform aUniform, float aValue1, float aValue2) { set_uniform_variable(uniform(aUniform), aValue1, aValue2); }
+			void set_uniform_variable(shader_uniform aUniform, const vec4f& aVector) { set_uniform_variable(uniform(aUniform), aVector); }
 		};
 	public:
 		virtual ~i_rendering_engine() {}
@@ -125,6 +174,10 @@ namespace neogfx
 		virtual void subpixel_rendering_off() = 0;
 	public:
 		virtual void render_now() = 0;
+		virtual void render_to_texture(i_widget& aWidget, i_texture& aTarget) = 0;
+		virtual void render_to_texture(i_widget& aWidget, const size& aExtents, dimension aDpiScaleFactor, i_texture& aTarget) = 0;
+		virtual void render_to_image(i_widget& aWidget, i_image& aTarget) = 0;
+		virtual void render_to_image(i_widget& aWidget, const size& aExtents, dimension aDpiScaleFactor, i_image& aTarget) = 0;
 	public:
 		virtual bool process_events() = 0;
 	public:
@@ -39,5 +39,6 @@ namespace neogfx
 		virtual std::unique_ptr<i_native_texture> join_texture(const i_texture& aTexture) = 0;
 		virtual void clear_textures() = 0;
 		virtual std::unique_ptr<i_texture_atlas> create_texture_atlas(const size& aSize = size{ 1024.0, 1024.0 }) = 0;
+		virtual std::size_t texture_memory_usage() const = 0;
 	};
 }
\ No newline at end of file
@@ -27,6 +27,8 @@
 
 namespace neogfx
 {
+	struct decoded_image;
+
 	class image : public i_image
 	{
 	public:
@@ -42,6 +44,7 @@ namespace neogfx
 		image(dimension aDpiScaleFactor = 1.0, texture_sampling aSampling = texture_sampling::NormalMipmap);
 		image(const neogfx::size& aSize, const colour& aColour = colour::Black, dimension aDpiScaleFactor = 1.0, texture_sampling aSampling = texture_sampling::NormalMipmap);
 		image(const std::string& aUri, dimension aDpiScaleFactor = 1.0, texture_sampling aSampling = texture_sampling::NormalMipmap);
+		image(const decoded_image& aDecodedImage, dimension aDpiScaleFactor = 1.0, texture_sampling aSampling = texture_sampling::NormalMipmap);
 		image(const std::string& aImagePattern, const std::unordered_map<std::string, colour>& aColourMap, dimension aDpiScaleFactor = 1.0, texture_sampling aSampling = texture_sampling::NormalMipmap);
 		image(const std::string& aUri, const std::string& aImagePattern, const std::unordered_map<std::string, colour>& aColourMap, dimension aDpiScaleFactor = 1.0, texture_sampling aSampling = texture_sampling::NormalMipmap);
 		~image();
@@ -65,12 +68,12 @@ namespace neogfx
 		void resize(const neogfx::size& aNewSize) override;
 		colour get_pixel(const point& aPoint) const override;
 		void set_pixel(const point& aPoint, const colour& aColour) override;
+	public:
+		uint64_t content_hash() const override;
 	private:
 		bool has_resource() const;
 		const i_resource& resource() const;
-		image_type_e recognize() const;
 		bool load();
-		bool load_png();
 	private:
 		i_resource::pointer iResource;
 		std::string iUri;
@@ -80,5 +83,6 @@ namespace neogfx
 		data_type iData;
 		texture_sampling iSampling;
 		neogfx::size iSize;
+		mutable boost::optional<uint64_t> iContentHash; // memoised until the pixel data is modified
 	};
 }
\ No newline at end of file
@@ -0,0 +1,64 @@
+// image_codec.hpp
+/*
+  neogfx C++ GUI Library
+  Copyright (c) 2018 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <neogfx/neogfx.hpp>
+#include <mutex>
+#include <vector>
+#include <neogfx/core/geometrical.hpp>
+#include <neogfx/gfx/i_image.hpp>
+
+namespace neogfx
+{
+	// Decodes encoded image data into RGBA8 pixels; decode() may be called concurrently from image decoder worker threads.
+	class i_image_codec
+	{
+	public:
+		typedef i_resource::data_type data_type;
+	public:
+		virtual ~i_image_codec() {}
+	public:
+		virtual const std::string& name() const = 0;
+		virtual bool recognize(const void* aData, std::size_t aSize) const = 0;
+		virtual bool decode(const void* aData, std::size_t aSize, data_type& aPixels, size& aExtents, std::string& aError) const = 0;
+	};
+
+	class png_codec : public i_image_codec
+	{
+	public:
+		const std::string& name() const override;
+		bool recognize(const void* aData, std::size_t aSize) const override;
+		bool decode(const void* aData, std::size_t aSize, data_type& aPixels, size& aExtents, std::string& aError) const override;
+	};
+
+	// Codecs registered later take precedence so an application can replace a built-in codec.
+	class image_codecs
+	{
+	public:
+		image_codecs();
+		static image_codecs& instance();
+	public:
+		void register_codec(std::shared_ptr<i_image_codec> aCodec);
+		std::shared_ptr<i_image_codec> find_codec(const void* aData, std::size_t aSize) const;
+	private:
+		mutable std::mutex iMutex;
+		std::vector<std::shared_ptr<i_image_codec>> iCodecs;
+	};
+}
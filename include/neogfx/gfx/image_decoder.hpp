@@ -0,0 +1,122 @@
+// image_decoder.hpp
+/*
+  neogfx C++ GUI Library
+  Copyright (c) 2018 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <neogfx/neogfx.hpp>
+#include <list>
+#include <deque>
+#include <unordered_map>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <thread>
+#include <boost/optional.hpp>
+#include <neogfx/core/geometrical.hpp>
+#include <neogfx/gfx/i_image.hpp>
+
+namespace neogfx
+{
+	struct decoded_image
+	{
+		std::string uri;
+		neogfx::size extents;
+		i_resource::data_type pixels; // RGBA8
+		boost::optional<uint64_t> contentHash; // of pixels; left unset by synchronous loads so that hashing stays lazy
+		std::string error; // empty if decoding succeeded
+	};
+
+	typedef std::shared_ptr<const decoded_image> decoded_image_pointer;
+
+	// URI keyed cache of decoded images bounded by the total size of their pixel data.
+	class decoded_image_cache
+	{
+	public:
+		static constexpr std::size_t DefaultCapacity = 64u * 1024u * 1024u;
+	private:
+		typedef std::list<decoded_image_pointer> entry_list;
+	public:
+		decoded_image_cache(std::size_t aCapacity = DefaultCapacity);
+	public:
+		std::size_t capacity() const;
+		void set_capacity(std::size_t aCapacity);
+		std::size_t size() const;
+		std::size_t count() const;
+		decoded_image_pointer find(const std::string& aUri);
+		void insert(decoded_image_pointer aImage);
+		void remove(const std::string& aUri);
+		void clear();
+	private:
+		void evict();
+	private:
+		mutable std::mutex iMutex;
+		std::size_t iCapacity;
+		std::size_t iSize;
+		entry_list iEntries; // most recently used first
+		std::unordered_map<std::string, entry_list::iterator> iIndex;
+	};
+
+	// Decodes images on a pool of worker threads; requests for a URI already in the cache or already being decoded are 
+	// coalesced. Resources are loaded by the workers so the resource manager must be usable from any thread.
+	class image_decoder
+	{
+	public:
+		typedef std::shared_future<decoded_image_pointer> future;
+		typedef std::function<void(const decoded_image&)> completion;
+		typedef std::function<decoded_image_pointer(const std::string&)> decode_function;
+	private:
+		struct job
+		{
+			std::string uri;
+			std::promise<decoded_image_pointer> promise;
+			future result;
+			std::vector<std::pair<std::thread::id, completion>> completions;
+		};
+		typedef std::shared_ptr<job> job_pointer;
+	public:
+		image_decoder(uint32_t aWorkerCount = 0u, const decode_function& aDecode = decode_function{}); ///< decodes with decode() unless given another decode function
+		~image_decoder();
+		static image_decoder& instance();
+	private:
+		image_decoder(const image_decoder&) = delete;
+		image_decoder& operator=(const image_decoder&) = delete;
+	public:
+		decoded_image_cache& cache();
+		static decoded_image_pointer decode(const std::string& aUri);
+		decoded_image_pointer decode_now(const std::string& aUri);
+		future decode_async(const std::string& aUri);
+		void decode_async(const std::string& aUri, const completion& aCompletion);
+	private:
+		job_pointer enqueue(const std::string& aUri);
+		void start_workers();
+		void work();
+		void complete(job& aJob, decoded_image_pointer aResult);
+	private:
+		uint32_t iWorkerCount;
+		decode_function iDecode;
+		decoded_image_cache iCache;
+		std::mutex iMutex;
+		std::condition_variable iWorkAvailable;
+		std::deque<job_pointer> iQueue;
+		std::unordered_map<std::string, job_pointer> iPending;
+		std::vector<std::thread> iWorkers;
+		bool iStopping;
+	};
+}
@@ -20,6 +20,8 @@
 #pragma once
 
 #include <neogfx/neogfx.hpp>
+#include <unordered_map>
+#include <boost/functional/hash.hpp>
 #include <neogfx/gfx/i_image.hpp>
 #include "i_texture_manager.hpp"
 
@@ -29,20 +31,47 @@ namespace neogfx
 	{
 		friend class texture_wrapper;
 	protected:
-		typedef std::list<std::weak_ptr<i_native_texture>> texture_list;
+		typedef uint64_t texture_id;
+		struct texture_key
+		{
+			std::string uri;
+			i_resource::hash_digest_type contentHash; // only calculated for images without a URI
+		};
+		struct texture_entry
+		{
+			std::weak_ptr<i_native_texture> texture;
+			void* handle;
+			texture_key key;
+		};
+		typedef std::unordered_map<texture_id, texture_entry> texture_list;
+	private:
+		// shared with the deleters of the textures handed out so that entries are purged when their texture is destroyed, even if that happens after the manager is gone
+		struct texture_index
+		{
+			texture_id nextId = 0u;
+			texture_list textures;
+			std::unordered_map<std::string, texture_id> byUri;
+			std::unordered_map<i_resource::hash_digest_type, texture_id, boost::hash<i_resource::hash_digest_type>> byContent;
+			std::unordered_map<void*, texture_id> byHandle;
+			void purge(texture_id aId);
+		};
+	public:
+		texture_manager();
 	public:
 		virtual std::unique_ptr<i_native_texture> join_texture(const i_native_texture& aTexture);
 		virtual std::unique_ptr<i_native_texture> join_texture(const i_texture& aTexture);
 		virtual void clear_textures();
 		virtual std::unique_ptr<i_texture_atlas> create_texture_atlas(const size& aSize = size{ 1024.0, 1024.0 });
+		virtual std::size_t texture_memory_usage() const;
+	public:
+		static std::size_t texture_memory_usage(const size& aStorageExtents, texture_sampling aSampling);
 	protected:
+		static texture_key image_key(const i_image& aImage);
 		const texture_list& textures() const;
-		texture_list& textures();
-		texture_list::const_iterator find_texture(const i_image& aImage) const;
-		texture_list::iterator find_texture(const i_image& aImage);
-		std::unique_ptr<i_native_texture> add_texture(std::shared_ptr<i_native_texture> aTexture);
+		std::shared_ptr<i_native_texture> find_texture(const texture_key& aKey) const;
+		std::unique_ptr<i_native_texture> add_texture(std::shared_ptr<i_native_texture> aTexture, const texture_key& aKey = texture_key{});
 	private:
-		texture_list iTextures;
+		std::shared_ptr<texture_index> iIndex;
 		std::vector<std::unique_ptr<i_texture_atlas>> iTextureAtlases;
 	};
 }
\ No newline at end of file
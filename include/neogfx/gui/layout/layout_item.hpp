@@ -60,6 +60,7 @@ namespace neogfx
 		const i_device_metrics& device_metrics() const override;
 		neogfx::units units() const override;
 		neogfx::units set_units(neogfx::units aUnits) const override;
+		const units_scale& device_units_scale() const override;
 	public:
 		point position() const override;
 		void set_position(const point& aPosition) override;
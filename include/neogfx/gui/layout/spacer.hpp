@@ -87,6 +87,7 @@ namespace neogfx
 		const i_device_metrics& device_metrics() const override;
 		neogfx::units units() const override;
 		neogfx::units set_units(neogfx::units aUnits) const override;
+		const units_scale& device_units_scale() const override;
 	public:
 		void layout_as(const point& aPosition, const size& aSize) override;
 	public:
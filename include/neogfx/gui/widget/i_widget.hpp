@@ -134,6 +134,7 @@ namespace neogfx
 		virtual void set_logical_coordinate_system(const optional_logical_coordinate_system& aLogicalCoordinateSystem) = 0;
 		virtual point position() const = 0;
 		virtual point origin() const = 0;
+		virtual point scroll_origin(const i_widget& aChild) const = 0; // offset of the given child's content when mapped onto this widget
 		virtual void move(const point& aPosition) = 0;
 		virtual void moved() = 0;
 		virtual size extents() const = 0;
@@ -154,6 +155,10 @@ namespace neogfx
 		virtual void paint_non_client(graphics_context& aGraphicsContext) const = 0;
 		virtual void paint_non_client_after(graphics_context& aGraphicsContext) const = 0;
 		virtual void paint(graphics_context& aGraphicsContext) const = 0;
+	public:
+		virtual bool layer_caching() const = 0;
+		virtual void set_layer_caching(bool aLayerCaching) = 0;
+		virtual void invalidate_layer() = 0;
 	public:
 		virtual double opacity() const = 0;
 		virtual void set_opacity(double aOpacity) = 0;
@@ -66,12 +66,14 @@ namespace neogfx
 		const texture& image() const;
 		void set_image(const i_texture& aImage);
 		void set_image(const i_image& aImage);
+		void load_image(const std::string& aImageUri, dimension aDpiScaleFactor = 1.0, texture_sampling aSampling = texture_sampling::NormalMipmap);
 		void set_aspect_ratio(neogfx::aspect_ratio aAspectRatio);
 		void set_placement(cardinal_placement aPlacement);
 		void set_snap(dimension aSnap);
 		void set_dpi_auto_scale(bool aDpiAutoScale);
 	private:
 		texture iTexture;
+		boost::optional<std::string> iPendingImage;
 		neogfx::aspect_ratio iAspectRatio;
 		cardinal_placement iPlacement;
 		dimension iSnap;
@@ -148,7 +148,7 @@ namespace neogfx
 		std::shared_ptr<i_item_selection_model> iSelectionModel;
 		bool iHotTracking;
 		bool iIgnoreNextMouseMove;
-		boost::optional<neolib::callback_timer> iMouseTracker;
+		boost::optional<wheel_timer> iMouseTracker;
 		optional_item_presentation_model_index iEditing;
 		std::shared_ptr<i_item_editor> iEditor;
 		bool iBeginningEdit;
@@ -71,6 +71,7 @@ namespace neogfx
 		point sub_menu_position() const;
 	private:
 		void init();
+		void open_sub_menu();
 		virtual void select_item(bool aOpenAnySubMenu = false);
 	private:
 		sink iSink;
@@ -83,7 +84,7 @@ namespace neogfx
 		text_widget iText;
 		horizontal_spacer iSpacer;
 		text_widget iShortcutText;
-		boost::optional<std::unique_ptr<neolib::callback_timer>> iSubMenuOpener;
+		wheel_timer iSubMenuOpener;
 		mutable boost::optional<std::pair<colour, texture>> iSubMenuArrow;
 	};
 }
\ No newline at end of file
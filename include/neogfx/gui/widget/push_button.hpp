@@ -72,7 +72,7 @@ namespace neogfx
 	private:
 		void init();
 	private:
-		neolib::callback_timer iAnimator;
+		wheel_timer iAnimator;
 		uint32_t iAnimationFrame;
 		push_button_style iStyle;
 		optional_colour iHoverColour;
@@ -68,6 +68,7 @@ namespace neogfx
 	public:
 		void resized() override;
 		rect client_rect(bool aIncludeMargins = true) const override;
+		point scroll_origin(const i_widget& aChild) const override;
 		widget_part hit_test(const point& aPosition) const override;
 	public:
 		void paint_non_client_after(graphics_context& aGraphicsContext) const override;
@@ -101,7 +102,6 @@ namespace neogfx
 	private:
 		scrollbar iVerticalScrollbar;
 		scrollbar iHorizontalScrollbar;
-		point iOldScrollPosition;
 		uint32_t iIgnoreScrollbarUpdates;
 	};
 }
\ No newline at end of file
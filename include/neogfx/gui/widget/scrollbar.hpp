@@ -21,7 +21,7 @@
 
 #include <neogfx/neogfx.hpp>
 #include <neolib/optional.hpp>
-#include <neolib/timer.hpp>
+#include <neogfx/app/timer_wheel.hpp>
 #include "i_scrollbar.hpp"
 #include <neogfx/gfx/graphics_context.hpp>
 
@@ -66,6 +66,8 @@ namespace neogfx
 		void untrack() override;
 	public:
 		static dimension width(scrollbar_style aStyle, const i_units_context& aContext);
+	private:
+		void repeat(wheel_timer& aTimer);
 	private:
 		i_scrollbar_container& iContainer;
 		scrollbar_type iType;
@@ -79,7 +81,7 @@ namespace neogfx
 		value_type iPage;
 		element_e iClickedElement;
 		element_e iHoverElement;
-		boost::optional<std::shared_ptr<neolib::callback_timer>> iTimer;
+		wheel_timer iTimer;
 		bool iPaused;
 		point iThumbClickedPosition;
 		value_type iThumbClickedValue;
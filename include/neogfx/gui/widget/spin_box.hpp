@@ -69,7 +69,7 @@ namespace neogfx
 		vertical_layout iSecondaryLayout;
 		push_button iStepUpButton;
 		push_button iStepDownButton;
-		boost::optional<neolib::callback_timer> iStepper;
+		boost::optional<wheel_timer> iStepper;
 		mutable boost::optional<std::pair<colour, texture>> iUpArrow;
 		mutable boost::optional<std::pair<colour, texture>> iDownArrow;
 	};
@@ -506,6 +506,7 @@ namespace neogfx
 		void set_cursor_glyph_position(position_type aGlyphPosition, bool aMoveAnchor = true);
 	private:
 		void init();
+		void check_style_epoch() const;
 		std::size_t do_insert_text(const std::string& aText, const style& aStyle, bool aMoveCursor, bool aClearFirst);
 		void delete_any_selection();
 		void notify_text_changed();
@@ -531,7 +532,8 @@ namespace neogfx
 		type_e iType;
 		style iDefaultStyle;
 		bool iPersistDefaultStyle;
-		font_info iDefaultFont;
+		mutable font_info iDefaultFont;
+		mutable uint32_t iStyleEpoch;
 		mutable neogfx::cursor iCursor;
 		style_list iStyles;
 		std::u32string iNormalizedTextBuffer;
@@ -557,8 +559,8 @@ namespace neogfx
 		optional_dimension iTabStops;
 		std::string iTabStopHint;
 		mutable boost::optional<std::pair<neogfx::font, dimension>> iCalculatedTabStops;
-		neolib::callback_timer iAnimator;
-		boost::optional<neolib::callback_timer> iDragger;
+		wheel_timer iAnimator;
+		boost::optional<wheel_timer> iDragger;
 		std::unique_ptr<context_menu> iMenu;
 		uint32_t iSuppressTextChangedNotification;
 		uint32_t iWantedToNotfiyTextChanged;
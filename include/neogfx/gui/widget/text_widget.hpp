@@ -84,6 +84,7 @@ namespace neogfx
 		size size_hint_extent() const;
 	private:
 		void init();
+		void check_style_epoch() const;
 	private:
 		sink iSink;
 		std::string iText;
@@ -95,5 +96,6 @@ namespace neogfx
 		text_widget_flags iFlags;
 		neogfx::alignment iAlignment;
 		optional_text_appearance iTextAppearance;
+		mutable uint32_t iStyleEpoch;
 	};
 }
\ No newline at end of file
@@ -21,12 +21,15 @@
 
 #include <neogfx/neogfx.hpp>
 #include <neolib/timer.hpp>
+#include <neogfx/app/timer_wheel.hpp>
 #include <neogfx/core/object.hpp>
 #include <neogfx/core/property.hpp>
 #include <neogfx/gui/widget/i_widget.hpp>
 
 namespace neogfx
 {
+	class widget_layer;
+
 	class widget : public object<i_widget>
 	{
 	public:
@@ -101,6 +104,7 @@ namespace neogfx
 		const i_device_metrics& device_metrics() const override;
 		neogfx::units units() const override;
 		neogfx::units set_units(neogfx::units aUnits) const override;
+		const units_scale& device_units_scale() const override;
 		// i_geometry
 	public:
 		point position() const override;
@@ -136,6 +140,7 @@ namespace neogfx
 		neogfx::logical_coordinate_system logical_coordinate_system() const override;
 		void set_logical_coordinate_system(const optional_logical_coordinate_system& aLogicalCoordinateSystem) override;
 		point origin() const override;
+		point scroll_origin(const i_widget& aChild) const override;
 		void move(const point& aPosition) override;
 		void moved() override;
 		void resize(const size& aSize) override;
@@ -175,6 +180,13 @@ namespace neogfx
 		void paint_non_client(graphics_context& aGraphicsContext) const override;
 		void paint(graphics_context& aGraphicsContext) const override;
 		void paint_non_client_after(graphics_context& aGraphicsContext) const override;
+	public:
+		bool layer_caching() const override;
+		void set_layer_caching(bool aLayerCaching) override;
+		void invalidate_layer() override;
+	public:
+		static std::size_t layer_cache_budget();
+		static void set_layer_cache_budget(std::size_t aBudget);
 	public:
 		double opacity() const override;
 		void set_opacity(double aOpacity) override;
@@ -246,6 +258,9 @@ namespace neogfx
 		i_surface* find_surface() override;
 		const i_window* find_root() const override;
 		i_window* find_root() override;
+	private:
+		void render_layer(graphics_context& aGraphicsContext) const;
+		void render_contents(graphics_context& aGraphicsContext) const;
 		// helpers
 	public:
 		using i_widget::set_size_policy;
@@ -270,6 +285,9 @@ namespace neogfx
 		std::unique_ptr<layout_timer> iLayoutTimer;
 		units_context iUnitsContext;
 		mutable std::pair<optional_rect, optional_rect> iDefaultClipRect;
+		bool iLayerCaching;
+		bool iPreservingLayer;
+		mutable std::unique_ptr<widget_layer> iLayer;
 		// properties
 	public:
 		struct property_category
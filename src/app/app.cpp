@@ -24,6 +24,7 @@
 #include <neolib/raii.hpp>
 #include <neogfx/gfx/image.hpp>
 #include <neogfx/app/app.hpp>
+#include <neogfx/core/units_context.hpp>
 #include <neogfx/hid/surface_manager.hpp>
 #include <neogfx/app/resource_manager.hpp>
 #include <neogfx/gui/window/window.hpp>
@@ -168,7 +169,7 @@ namespace neogfx
 		iActionPaste{ add_action("Paste"_t, ":/neogfx/resources/icons.naa#paste.png").set_shortcut("Ctrl+V") },
 		iActionDelete{ add_action("Delete"_t).set_shortcut("Del") },
 		iActionSelectAll{ add_action("Select All"_t).set_shortcut("Ctrl+A") },
-		iStandardActionManager{ *this, [this](neolib::callback_timer& aTimer)
+		iStandardActionManager{ iTimerWheel, [this](wheel_timer& aTimer)
 		{
 			aTimer.again();
 			if (clipboard().sink_active())
@@ -215,7 +216,14 @@ namespace neogfx
 			}
 		}, 100 },
 		iAppContext{ *this, "neogfx::app::iAppContext" },
-		iAppMessageQueueContext{ *this, "neogfx::app::iAppMessageQueueContext" }
+		iAppMessageQueueContext{ *this, "neogfx::app::iAppMessageQueueContext" },
+		iStyleGeneration{ 0u },
+		iStyleEpochs{},
+		iStyleRelayout{ iTimerWheel, [this](wheel_timer&)
+		{
+			surface_manager().layout_surfaces();
+			surface_manager().invalidate_surfaces();
+		}, 0, false }
 	{
 		iKeyboard->grab_keyboard(*this);
 
@@ -261,6 +269,11 @@ namespace neogfx
 		return *instance;
 	}
 
+	bool app::has_instance()
+	{
+		return sFirstInstance.load() != nullptr;
+	}
+
 	const program_options& app::program_options() const
 	{
 		return iProgramOptions;
@@ -368,6 +381,11 @@ namespace neogfx
 			throw no_audio();
 	}
 
+	timer_wheel& app::timer_wheel()
+	{
+		return iTimerWheel;
+	}
+
 	dimension app::default_dpi_scale_factor() const
 	{
 		return neogfx::default_dpi_scale_factor(surface_manager().display().metrics().ppi());
@@ -410,9 +428,7 @@ namespace neogfx
 		if (iCurrentStyle != existingStyle)
 		{
 			iCurrentStyle = existingStyle;
-			current_style_changed.trigger(style_aspect::Style);
-			surface_manager().layout_surfaces();
-			surface_manager().invalidate_surfaces();
+			current_style_updated(style_aspect::Style);
 		}
 		return iCurrentStyle->second;
 	}
@@ -430,10 +446,32 @@ namespace neogfx
 		return newStyle->second;
 	}
 
+	uint32_t app::style_epoch(style_aspect aAspect) const
+	{
+		uint32_t epoch = 0u;
+		for (std::size_t aspect = 0; aspect < iStyleEpochs.size(); ++aspect)
+			if ((static_cast<uint32_t>(aAspect) & (1u << aspect)) != 0u)
+				epoch = std::max(epoch, iStyleEpochs[aspect]);
+		return epoch;
+	}
+
+	// Widgets compare style_epoch() with the epoch their cached extents, glyphs and textures were built at and rebuild
+	// them when next measured or painted; the relayout and repaint of every surface is coalesced into one deferred pass.
+	void app::current_style_updated(style_aspect aAspect)
+	{
+		++iStyleGeneration;
+		for (std::size_t aspect = 0; aspect < iStyleEpochs.size(); ++aspect)
+			if ((static_cast<uint32_t>(aAspect) & (1u << aspect)) != 0u)
+				iStyleEpochs[aspect] = iStyleGeneration;
+		if ((aAspect & style_aspect::Font) != style_aspect::None)
+			units_context::device_metrics_changed(); // em sizes follow the font
+		current_style_changed.trigger(aAspect);
+		iStyleRelayout.again_if();
+	}
+
 	const std::string& app::translate(const std::string& aTranslatableString, const std::string& aContext) const
 	{
-		// todo: i18n
-		return aTranslatableString;
+		return translation_manager::instance().translate(aTranslatableString, aContext, translation_context_hash(aContext));
 	}
 
 	i_action& app::action_file_new()
@@ -655,6 +693,7 @@ namespace neogfx
 			bool hadStrongSurfaces = surface_manager().any_strong_surfaces();
 			didSome = pump_messages();
 			didSome = (do_io(neolib::yield_type::NoYield) || didSome);
+			didSome = (iTimerWheel.advance() || didSome);
 			didSome = (do_process_events() || didSome);
 			bool lastWindowClosed = hadStrongSurfaces && !surface_manager().any_strong_surfaces();
 			if (!in_exec() && lastWindowClosed)
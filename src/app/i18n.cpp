@@ -19,14 +19,96 @@
 
 #include <neogfx/neogfx.hpp>
 #include <string>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
 #include <neogfx/app/i18n.hpp>
 #include <neogfx/app/app.hpp>
 
 namespace neogfx
 {
+	translation_catalogue::translation_catalogue(const std::string& aLanguage, const translation_entry* aEntries, std::size_t aEntryCount) :
+		iLanguage{ aLanguage }, iEntries{ aEntries }, iEntryCount{ aEntryCount }
+	{
+		if (!std::is_sorted(iEntries, iEntries + iEntryCount, [](const translation_entry& aLeft, const translation_entry& aRight) { return aLeft.key < aRight.key; }))
+			throw entries_not_sorted();
+		iTranslations.reserve(iEntryCount);
+		for (std::size_t i = 0; i < iEntryCount; ++i)
+			iTranslations.emplace_back(iEntries[i].translation);
+	}
+
+	const std::string& translation_catalogue::language() const
+	{
+		return iLanguage;
+	}
+
+	std::size_t translation_catalogue::size() const
+	{
+		return iEntryCount;
+	}
+
+	const std::string* translation_catalogue::find(translation_key aKey, const std::string& aContext, const char* aSource, std::size_t aSourceLength) const
+	{
+		auto entry = std::lower_bound(iEntries, iEntries + iEntryCount, aKey, [](const translation_entry& aEntry, translation_key aKey) { return aEntry.key < aKey; });
+		for (; entry != iEntries + iEntryCount && entry->key == aKey; ++entry)
+			if (std::strlen(entry->source) == aSourceLength && std::memcmp(entry->source, aSource, aSourceLength) == 0 && aContext == entry->context)
+				return &iTranslations[entry - iEntries];
+		return nullptr;
+	}
+
+	translation_manager::translation_manager() :
+		iActiveCatalogues{ nullptr }
+	{
+	}
+
+	translation_manager& translation_manager::instance()
+	{
+		static translation_manager sInstance;
+		return sInstance;
+	}
+
+	void translation_manager::add_catalogue(const std::string& aLanguage, const translation_entry* aEntries, std::size_t aEntryCount)
+	{
+		iCatalogues[aLanguage].push_back(std::make_unique<translation_catalogue>(aLanguage, aEntries, aEntryCount));
+		if (aLanguage == iLanguage)
+			iActiveCatalogues = &iCatalogues[aLanguage];
+	}
+
+	const std::string& translation_manager::language() const
+	{
+		return iLanguage;
+	}
+
+	void translation_manager::set_language(const std::string& aLanguage)
+	{
+		iLanguage = aLanguage;
+		auto catalogues = iCatalogues.find(aLanguage);
+		iActiveCatalogues = (catalogues != iCatalogues.end() ? &catalogues->second : nullptr);
+	}
+
+	const std::string& translation_manager::translate(const std::string& aTranslatableString, const std::string& aContext, translation_key aContextHash) const
+	{
+		auto translation = find(aTranslatableString.c_str(), aTranslatableString.size(), aContext, aContextHash);
+		return translation != nullptr ? *translation : aTranslatableString;
+	}
+
+	const std::string* translation_manager::find(const char* aTranslatableString, std::size_t aStringLength, const std::string& aContext, translation_key aContextHash) const
+	{
+		if (iActiveCatalogues == nullptr)
+			return nullptr;
+		const translation_key key = translation_key_of(aContextHash, aTranslatableString, aStringLength);
+		for (const auto& catalogue : *iActiveCatalogues)
+		{
+			auto translation = catalogue->find(key, aContext, aTranslatableString, aStringLength);
+			if (translation != nullptr)
+				return translation;
+		}
+		return nullptr;
+	}
+
 	translation_context::translation_context(const std::string& aContext)
 	{
-		context_stack().push_back(aContext);
+		context_stack().emplace_back(aContext, translation_context_hash(aContext));
 	}
 
 	translation_context::~translation_context()
@@ -37,29 +119,47 @@ namespace neogfx
 	const std::string& translation_context::context()
 	{
 		if (!context_stack().empty())
-			return context_stack().back();
+			return context_stack().back().first;
 		static const std::string sDefaultContext;
 		return sDefaultContext;
 	}
 
-	std::vector<std::string>& translation_context::context_stack()
+	translation_key translation_context::context_hash()
+	{
+		if (!context_stack().empty())
+			return context_stack().back().second;
+		static const translation_key sDefaultContextHash = translation_context_hash(std::string{});
+		return sDefaultContextHash;
+	}
+
+	std::vector<std::pair<std::string, translation_key>>& translation_context::context_stack()
 	{
-		static std::vector<std::string> sContextStack;
+		static std::vector<std::pair<std::string, translation_key>> sContextStack;
 		return sContextStack;
 	}
 
-	std::string operator "" _t(const char* aTranslatableString, std::size_t aStringLength)
+	const std::string& operator "" _t(const char* aTranslatableString, std::size_t aStringLength)
 	{
-		return translate(std::string{ aTranslatableString, aStringLength });
+		auto translation = translation_manager::instance().find(aTranslatableString, aStringLength, translation_context::context(), translation_context::context_hash());
+		if (translation != nullptr)
+			return *translation;
+		// only ever called with string literals so keying the untranslated copies by address keeps this bounded by the number of literals in the program
+		static std::mutex sUntranslatedMutex;
+		static std::unordered_map<const char*, std::string> sUntranslated;
+		std::lock_guard<std::mutex> lock{ sUntranslatedMutex };
+		auto untranslated = sUntranslated.find(aTranslatableString);
+		if (untranslated == sUntranslated.end())
+			untranslated = sUntranslated.emplace(aTranslatableString, std::string{ aTranslatableString, aStringLength }).first;
+		return untranslated->second;
 	}
 
 	const std::string& translate(const std::string& aTranslatableString)
 	{
-		return translate(aTranslatableString, translation_context::context());
+		return translation_manager::instance().translate(aTranslatableString, translation_context::context(), translation_context::context_hash());
 	}
 
 	const std::string& translate(const std::string& aTranslatableString, const std::string& aContext)
 	{
 		return app::instance().translate(aTranslatableString, aContext);
 	}
-}
\ No newline at end of file
+}
@@ -18,11 +18,9 @@
 */
 
 #include <neogfx/neogfx.hpp>
-#include <sstream>
 #include <boost/filesystem.hpp>
 #include <openssl/sha.h>
 #include <neolib/uri.hpp>
-#include <neolib/zip.hpp>
 #include <neogfx/app/resource.hpp>
 
 namespace neogfx
@@ -42,14 +40,11 @@ namespace neogfx
 			}
 			else // asset archive
 			{
-				neolib::zip archive{uri.path()};
-				for (std::size_t i = 0; i < archive.file_count(); ++i)
+				auto payload = aManager.load_archived_resource(uri.path(), uri.fragment());
+				if (payload != nullptr)
 				{
-					if (archive.file_path(i) == uri.fragment())
-					{
-						archive.extract_to(i, iData);
-						iSize = iData.size();
-					}
+					iPayload = payload;
+					iSize = iPayload->size();
 				}
 			}
 		}
@@ -57,25 +52,11 @@ namespace neogfx
 		{
 			if (!uri.fragment().empty()) // asset archive
 			{
-				auto assetArchive = aManager.load_resource(":/" + uri.path());
-				neolib::zip archive{assetArchive->cdata(), assetArchive->size()};
-				for (std::size_t i = 0; i < archive.file_count(); ++i)
+				auto payload = aManager.load_archived_resource(":/" + uri.path(), uri.fragment());
+				if (payload != nullptr)
 				{
-					if (archive.file_path(i) == uri.fragment())
-					{
-						archive.extract_to(i, iData);
-						iSize = iData.size();
-					}
-					else
-					{
-						neolib::uri otherResource(uri);
-						otherResource.set_fragment(archive.file_path(i));
-						std::ostringstream oss;
-						oss << otherResource;
-						neolib::zip::buffer_type buffer;
-						archive.extract_to(i, buffer);
-						aManager.add_resource(oss.str(), &buffer[0], buffer.size());
-					}
+					iPayload = payload;
+					iSize = iPayload->size();
 				}
 			}
 		}
@@ -93,15 +74,15 @@ namespace neogfx
 
 	bool resource::available() const
 	{
-		return iSize != 0 && iData.size() == iSize;
+		return iSize != 0 && contents().size() == iSize;
 	}
 
 	std::pair<bool, double> resource::downloading() const
 	{
 		if (iSize == 0)
 			return std::make_pair(false, 0.0);
-		else if (iData.size() != iSize)
-			return std::make_pair(true, 100.0 * iData.size() / iSize);
+		else if (contents().size() != iSize)
+			return std::make_pair(true, 100.0 * contents().size() / iSize);
 		else
 			return std::make_pair(false, 100.0);
 	}
@@ -126,9 +107,9 @@ namespace neogfx
 	
 	const void* resource::cdata() const
 	{
-		if (iData.empty())
+		if (contents().empty())
 			throw no_data();
-		return &iData[0];
+		return &contents()[0];
 	}
 
 	const void* resource::data() const
@@ -138,12 +119,17 @@ namespace neogfx
 	
 	void* resource::data()
 	{
+		if (iPayload != nullptr)
+		{
+			iData = *iPayload;
+			iPayload.reset();
+		}
 		return const_cast<void*>(const_cast<const resource*>(this)->data());
 	}
 
 	std::size_t resource::size() const
 	{
-		return iData.size();
+		return contents().size();
 	}
 
 	resource::hash_digest_type resource::hash() const
@@ -152,4 +138,9 @@ namespace neogfx
 		SHA256(static_cast<const uint8_t*>(cdata()), size(), &result[0]);
 		return result;
 	}
+
+	const resource::data_type& resource::contents() const
+	{
+		return iPayload != nullptr ? *iPayload : iData;
+	}
 }
\ No newline at end of file
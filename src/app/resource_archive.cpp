@@ -0,0 +1,102 @@
+// resource_archive.cpp
+/*
+  neogfx C++ GUI Library
+  Copyright (c) 2018 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <neogfx/neogfx.hpp>
+#include <neogfx/app/resource_archive.hpp>
+
+namespace neogfx
+{
+	constexpr std::size_t resource_archive::DefaultPayloadCacheCapacity;
+
+	resource_archive::resource_archive(const std::string& aPath, std::size_t aPayloadCacheCapacity) :
+		iFile{ aPath.c_str(), boost::interprocess::read_only },
+		iMappedFile{ iFile, boost::interprocess::read_only },
+		iZip{ iMappedFile.get_address(), iMappedFile.get_size() },
+		iPayloadCacheCapacity{ aPayloadCacheCapacity },
+		iPayloadCacheSize{ 0u }
+	{
+		index();
+	}
+
+	resource_archive::resource_archive(i_resource::pointer aArchive, std::size_t aPayloadCacheCapacity) :
+		iArchiveResource{ aArchive },
+		iZip{ aArchive->cdata(), aArchive->size() },
+		iPayloadCacheCapacity{ aPayloadCacheCapacity },
+		iPayloadCacheSize{ 0u }
+	{
+		index();
+	}
+
+	std::size_t resource_archive::entry_count() const
+	{
+		return iIndex.size();
+	}
+
+	bool resource_archive::contains(const std::string& aEntryPath) const
+	{
+		return iIndex.find(aEntryPath) != iIndex.end();
+	}
+
+	resource_archive::payload_pointer resource_archive::extract(const std::string& aEntryPath)
+	{
+		auto entry = iIndex.find(aEntryPath);
+		if (entry == iIndex.end())
+			return payload_pointer{};
+		std::lock_guard<std::mutex> lock{ iMutex };
+		auto cached = iPayloadIndex.find(aEntryPath);
+		if (cached != iPayloadIndex.end())
+		{
+			iPayloads.splice(iPayloads.begin(), iPayloads, cached->second);
+			return cached->second->second;
+		}
+		auto payload = std::make_shared<data_type>();
+		iZip.extract_to(entry->second, *payload);
+		if (payload->size() <= iPayloadCacheCapacity)
+		{
+			iPayloads.emplace_front(aEntryPath, payload);
+			iPayloadIndex[aEntryPath] = iPayloads.begin();
+			iPayloadCacheSize += payload->size();
+			evict();
+		}
+		return payload;
+	}
+
+	std::size_t resource_archive::payload_cache_size() const
+	{
+		std::lock_guard<std::mutex> lock{ iMutex };
+		return iPayloadCacheSize;
+	}
+
+	void resource_archive::index()
+	{
+		iIndex.reserve(iZip.file_count());
+		for (std::size_t i = 0; i < iZip.file_count(); ++i)
+			iIndex.emplace(iZip.file_path(i), i);
+	}
+
+	void resource_archive::evict()
+	{
+		while (iPayloadCacheSize > iPayloadCacheCapacity && !iPayloads.empty())
+		{
+			iPayloadCacheSize -= iPayloads.back().second->size();
+			iPayloadIndex.erase(iPayloads.back().first);
+			iPayloads.pop_back();
+		}
+	}
+}
@@ -36,32 +36,74 @@ namespace neogfx
 
 	void resource_manager::add_resource(const std::string& aUri, const void* aResourceData, std::size_t aResourceSize)
 	{
+		std::lock_guard<std::recursive_mutex> lock{ iMutex };
 		iResources[aUri] = i_resource::pointer(std::make_shared<resource>(*this, aUri, aResourceData, aResourceSize));
 	}
 
 	void resource_manager::add_module_resource(const std::string& aUri, const void* aResourceData, std::size_t aResourceSize)
 	{
+		std::lock_guard<std::recursive_mutex> lock{ iMutex };
 		iResources[aUri] = i_resource::pointer(std::make_shared<module_resource>(aUri, aResourceData, aResourceSize));
 	}
 
 	i_resource::pointer resource_manager::load_resource(const std::string& aUri)
 	{
-		auto existing = iResources.find(aUri);
-		if (existing != iResources.end())
 		{
-			if (existing->second.is<i_resource::pointer>())
-				return static_variant_cast<i_resource::pointer>(existing->second);
-			i_resource::weak_pointer ptr = static_variant_cast<i_resource::weak_pointer>(existing->second);
-			if (!ptr.expired())
-				return ptr.lock();
+			std::lock_guard<std::recursive_mutex> lock{ iMutex };
+			auto existing = find_resource(aUri);
+			if (existing != nullptr)
+				return existing;
 		}
+		// constructing a resource reads (and may inflate) its data so the lock is not held meanwhile; if another thread loads the same URI concurrently the resource indexed first wins
 		i_resource::pointer newResource = std::make_shared<resource>(*this, aUri);
+		std::lock_guard<std::recursive_mutex> lock{ iMutex };
+		auto existing = find_resource(aUri);
+		if (existing != nullptr)
+			return existing;
 		iResources[aUri] = i_resource::weak_pointer(newResource);
 		return newResource;
 	}
 
+	std::shared_ptr<const i_resource::data_type> resource_manager::load_archived_resource(const std::string& aArchiveUri, const std::string& aEntryPath)
+	{
+		return archive(aArchiveUri)->extract(aEntryPath);
+	}
+
+	// Archive URIs starting ":/" name module resources; anything else is a file system path that is mapped into memory.
+	// The archive is shared with the caller so that a concurrent clean() cannot destroy it while it is in use.
+	std::shared_ptr<resource_archive> resource_manager::archive(const std::string& aArchiveUri)
+	{
+		{
+			std::lock_guard<std::recursive_mutex> lock{ iMutex };
+			auto existing = iResourceArchives.find(aArchiveUri);
+			if (existing != iResourceArchives.end())
+				return existing->second;
+		}
+		// opening an archive maps and indexes it so, as for resources, the lock is not held meanwhile
+		std::shared_ptr<resource_archive> newArchive;
+		if (aArchiveUri.compare(0, 2, ":/") == 0)
+			newArchive = std::make_shared<resource_archive>(load_resource(aArchiveUri));
+		else
+			newArchive = std::make_shared<resource_archive>(aArchiveUri);
+		std::lock_guard<std::recursive_mutex> lock{ iMutex };
+		// if another thread opened the same archive meanwhile its archive is kept and this one discarded
+		return iResourceArchives.emplace(aArchiveUri, newArchive).first->second;
+	}
+
+	// iMutex must be held by the caller
+	i_resource::pointer resource_manager::find_resource(const std::string& aUri) const
+	{
+		auto existing = iResources.find(aUri);
+		if (existing == iResources.end())
+			return i_resource::pointer{};
+		if (existing->second.is<i_resource::pointer>())
+			return static_variant_cast<const i_resource::pointer&>(existing->second);
+		return static_variant_cast<const i_resource::weak_pointer&>(existing->second).lock();
+	}
+
 	void resource_manager::cleanup()
 	{
+		std::lock_guard<std::recursive_mutex> lock{ iMutex };
 		for (auto i = iResources.begin(); i != iResources.end();)
 		{
 			if (i->second.is<i_resource::weak_pointer>() && static_variant_cast<i_resource::weak_pointer&>(i->second).expired())
@@ -73,6 +115,7 @@ namespace neogfx
 
 	void resource_manager::clean()
 	{
+		std::lock_guard<std::recursive_mutex> lock{ iMutex };
 		decltype(iResources) resources;
 		resources.swap(iResources);
 		decltype(iResourceArchives) resourceArchives;
@@ -170,9 +170,6 @@ namespace neogfx
 	{
 		changed.trigger(aAspect);
 		if (&app::instance().current_style() == this)
-		{
-			app::instance().current_style_changed.trigger(aAspect);
-			app::instance().surface_manager().layout_surfaces();
-		}
+			app::instance().current_style_updated(aAspect);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,274 @@
+// timer_wheel.cpp
+/*
+  neogfx C++ GUI Library
+  Copyright (c) 2018 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <neogfx/neogfx.hpp>
+#include <chrono>
+#include <neogfx/app/timer_wheel.hpp>
+
+namespace neogfx
+{
+	constexpr uint32_t timer_wheel::Levels;
+	constexpr uint32_t timer_wheel::SlotBits;
+	constexpr uint32_t timer_wheel::Slots;
+	constexpr timer_wheel::time_point timer_wheel::SlotMask;
+
+	timer_wheel::timer_wheel() :
+		timer_wheel{ &timer_wheel::steady_clock }
+	{
+	}
+
+	timer_wheel::timer_wheel(const clock& aClock) :
+		iClock{ aClock }, iCurrentTick{ aClock() }, iLevels{}, iOccupied{}, iCount{ 0u }
+	{
+	}
+
+	timer_wheel::~timer_wheel()
+	{
+		for (auto& l : iLevels)
+			for (auto& s : l)
+				for (auto t = s; t != nullptr;)
+				{
+					auto next = t->iNext;
+					t->iLink = nullptr;
+					t->iNext = nullptr;
+					t->iLevel = Levels;
+					t = next;
+				}
+	}
+
+	timer_wheel::time_point timer_wheel::steady_clock()
+	{
+		return static_cast<time_point>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	timer_wheel::time_point timer_wheel::now() const
+	{
+		return iClock();
+	}
+
+	bool timer_wheel::empty() const
+	{
+		return iCount == 0u;
+	}
+
+	std::size_t timer_wheel::count() const
+	{
+		return iCount;
+	}
+
+	// for the lowest level this is exact; for the others it is when the earliest occupied slot is cascaded
+	boost::optional<timer_wheel::time_point> timer_wheel::next_deadline() const
+	{
+		boost::optional<time_point> result;
+		for (uint32_t levelIndex = 0u; levelIndex < Levels; ++levelIndex)
+		{
+			const uint64_t occupied = iOccupied[levelIndex];
+			if (occupied == 0u)
+				continue;
+			const uint32_t shift = SlotBits * levelIndex;
+			const time_point base = ((iCurrentTick >> shift) + 1u) << shift;
+			const uint32_t baseSlot = static_cast<uint32_t>(((iCurrentTick >> shift) + 1u) & SlotMask);
+			const uint64_t rotated = (baseSlot == 0u ? occupied : (occupied >> baseSlot) | (occupied << (Slots - baseSlot)));
+			uint32_t steps = 0u;
+			while ((rotated & (uint64_t{ 1u } << steps)) == 0u)
+				++steps;
+			const time_point tick = base + (static_cast<time_point>(steps) << shift);
+			if (result == boost::none || tick < *result)
+				result = tick;
+		}
+		return result;
+	}
+
+	bool timer_wheel::advance()
+	{
+		return advance(now());
+	}
+
+	bool timer_wheel::advance(time_point aNow)
+	{
+		bool fired = false;
+		while (iCurrentTick < aNow)
+		{
+			auto next = next_deadline();
+			if (next == boost::none || *next > aNow)
+			{
+				iCurrentTick = aNow;
+				break;
+			}
+			iCurrentTick = *next;
+			cascade(iCurrentTick);
+			fired = (expire(iCurrentTick) || fired);
+		}
+		return fired;
+	}
+
+	void timer_wheel::insert(wheel_timer& aTimer, time_point aEarliest)
+	{
+		time_point placement = (aTimer.iDeadline > aEarliest ? aTimer.iDeadline : aEarliest);
+		const time_point delta = placement - iCurrentTick;
+		uint32_t levelIndex = 0u;
+		while (levelIndex < Levels - 1u && delta >= (time_point{ 1u } << (SlotBits * (levelIndex + 1u))))
+			++levelIndex;
+		if (delta >= (time_point{ 1u } << (SlotBits * Levels)))
+			placement = iCurrentTick + (time_point{ 1u } << (SlotBits * Levels)) - 1u;
+		const uint32_t slotIndex = static_cast<uint32_t>((placement >> (SlotBits * levelIndex)) & SlotMask);
+		auto& head = iLevels[levelIndex][slotIndex];
+		aTimer.iNext = head;
+		if (head != nullptr)
+			head->iLink = &aTimer.iNext;
+		head = &aTimer;
+		aTimer.iLink = &head;
+		aTimer.iLevel = levelIndex;
+		aTimer.iSlot = slotIndex;
+		iOccupied[levelIndex] |= (uint64_t{ 1u } << slotIndex);
+		++iCount;
+	}
+
+	void timer_wheel::remove(wheel_timer& aTimer)
+	{
+		*aTimer.iLink = aTimer.iNext;
+		if (aTimer.iNext != nullptr)
+			aTimer.iNext->iLink = aTimer.iLink;
+		if (aTimer.iLevel < Levels)
+		{
+			if (iLevels[aTimer.iLevel][aTimer.iSlot] == nullptr)
+				iOccupied[aTimer.iLevel] &= ~(uint64_t{ 1u } << aTimer.iSlot);
+			--iCount;
+		}
+		aTimer.iLink = nullptr;
+		aTimer.iNext = nullptr;
+		aTimer.iLevel = Levels;
+	}
+
+	void timer_wheel::cascade(time_point aTick)
+	{
+		for (uint32_t levelIndex = Levels - 1u; levelIndex > 0u; --levelIndex)
+		{
+			const uint32_t shift = SlotBits * levelIndex;
+			if ((aTick & ((time_point{ 1u } << shift) - 1u)) != 0u)
+				continue;
+			const uint32_t slotIndex = static_cast<uint32_t>((aTick >> shift) & SlotMask);
+			auto pending = iLevels[levelIndex][slotIndex];
+			iLevels[levelIndex][slotIndex] = nullptr;
+			iOccupied[levelIndex] &= ~(uint64_t{ 1u } << slotIndex);
+			while (pending != nullptr)
+			{
+				auto& t = *pending;
+				pending = t.iNext;
+				--iCount;
+				insert(t, aTick);
+			}
+		}
+	}
+
+	bool timer_wheel::expire(time_point aTick)
+	{
+		const uint32_t slotIndex = static_cast<uint32_t>(aTick & SlotMask);
+		wheel_timer* due = iLevels[0][slotIndex];
+		if (due == nullptr)
+			return false;
+		iLevels[0][slotIndex] = nullptr;
+		iOccupied[0] &= ~(uint64_t{ 1u } << slotIndex);
+		due->iLink = &due;
+		for (auto t = due; t != nullptr; t = t->iNext)
+		{
+			t->iLevel = Levels;
+			--iCount;
+		}
+		// a callback may cancel, reschedule or destroy any timer (including its own) so the due list is consumed one timer at a time
+		try
+		{
+			while (due != nullptr)
+			{
+				auto& t = *due;
+				remove(t);
+				t.iCallback(t);
+			}
+		}
+		catch (...)
+		{
+			while (due != nullptr)
+			{
+				auto& t = *due;
+				remove(t);
+				insert(t, iCurrentTick + 1u);
+			}
+			throw;
+		}
+		return true;
+	}
+
+	wheel_timer::wheel_timer(neogfx::timer_wheel& aWheel, const callback& aCallback, uint32_t aDuration_ms, bool aInitialWait) :
+		iWheel{ aWheel }, iCallback{ aCallback }, iDuration{ aDuration_ms }, iDeadline{ 0u }, iLink{ nullptr }, iNext{ nullptr }, iLevel{ timer_wheel::Levels }, iSlot{ 0u }
+	{
+		if (aInitialWait)
+			again();
+	}
+
+	wheel_timer::~wheel_timer()
+	{
+		cancel();
+	}
+
+	timer_wheel& wheel_timer::timer_wheel() const
+	{
+		return iWheel;
+	}
+
+	uint32_t wheel_timer::duration() const
+	{
+		return iDuration;
+	}
+
+	void wheel_timer::set_duration(uint32_t aDuration_ms, bool aEffectiveImmediately)
+	{
+		iDuration = aDuration_ms;
+		if (aEffectiveImmediately && waiting())
+			again();
+	}
+
+	timer_wheel::time_point wheel_timer::deadline() const
+	{
+		return iDeadline;
+	}
+
+	bool wheel_timer::waiting() const
+	{
+		return iLink != nullptr;
+	}
+
+	void wheel_timer::again()
+	{
+		cancel();
+		iDeadline = iWheel.now() + iDuration;
+		iWheel.insert(*this, iWheel.iCurrentTick + 1u);
+	}
+
+	void wheel_timer::again_if()
+	{
+		if (!waiting())
+			again();
+	}
+
+	void wheel_timer::cancel()
+	{
+		if (waiting())
+			iWheel.remove(*this);
+	}
+}
@@ -22,8 +22,11 @@
 
 namespace neogfx
 {
+	constexpr float audio_beeper_sample::Amplitude;
+	constexpr double audio_beeper_sample::SustainLevel;
+
 	audio_beeper_sample::audio_beeper_sample(const audio_spec& aSpec) : 
-		iSpec{ aSpec }
+		iSpec{ aSpec.frequency(), audio_format::F32, aSpec.channels(), aSpec.samples() }, iSegmentsValid{ false }, iTotalFrames{ 0 }
 	{
 	}
 
@@ -34,14 +37,29 @@ namespace neogfx
 
 	audio_beeper_sample::frame_index audio_beeper_sample::total_frames() const
 	{
-		// todo
-		return 0;
+		std::lock_guard<std::recursive_mutex> lock{ iMutex };
+		update_segments();
+		return iTotalFrames;
 	}
 
 	audio_beeper_sample::frame_index audio_beeper_sample::read(frame_index aPosition, void* aBuffer, frame_index aBufferSize) const
 	{
-		// todo
-		return 0;
+		std::lock_guard<std::recursive_mutex> lock{ iMutex };
+		update_segments();
+		if (aPosition >= iTotalFrames)
+			return 0;
+		const frame_index frameCount = std::min(aBufferSize, iTotalFrames - aPosition);
+		float* output = static_cast<float*>(aBuffer);
+		auto s = std::upper_bound(iSegments.begin(), iSegments.end(), aPosition, [](frame_index aFrame, const segment& aSegment) { return aFrame < aSegment.start; });
+		--s;
+		for (frame_index done = 0; done < frameCount; ++s)
+		{
+			const frame_index offset = aPosition + done - s->start;
+			const frame_index run = std::min(frameCount - done, s->frames - offset);
+			render(*s, offset, output + static_cast<std::size_t>(done) * iSpec.channels(), run);
+			done += run;
+		}
+		return frameCount;
 	}
 
 	audio_beeper_sample::frame_index audio_beeper_sample::write(frame_index aPosition, const void* aBuffer, frame_index aBufferSize)
@@ -51,31 +69,124 @@ namespace neogfx
 
 	void audio_beeper_sample::beep(double aDuration, double aFrequency)
 	{
+		std::lock_guard<std::recursive_mutex> lock{ iMutex };
 		iItems.push_back(item_beep{ aDuration, aFrequency });
+		iSegmentsValid = false;
 	}
 
 	void audio_beeper_sample::beep(const audio_envelope& aEnvelope, double aFrequency)
 	{
+		std::lock_guard<std::recursive_mutex> lock{ iMutex };
 		iItems.push_back(item_envelope{ aEnvelope, aFrequency });
+		iSegmentsValid = false;
 	}
 
 	void audio_beeper_sample::silence(double aDuration)
 	{
+		std::lock_guard<std::recursive_mutex> lock{ iMutex };
 		iItems.push_back(item_silence{ aDuration });
+		iSegmentsValid = false;
 	}
 
 	void audio_beeper_sample::repeat_start(uint32_t aRepeatCount)
 	{
+		std::lock_guard<std::recursive_mutex> lock{ iMutex };
 		iItems.push_back(item_repeat_start{ aRepeatCount });
+		iSegmentsValid = false;
 	}
 
 	void audio_beeper_sample::repeat_end()
 	{
+		std::lock_guard<std::recursive_mutex> lock{ iMutex };
 		iItems.push_back(item_repeat_end{});
+		iSegmentsValid = false;
 	}
 
 	void audio_beeper_sample::clear()
 	{
+		std::lock_guard<std::recursive_mutex> lock{ iMutex };
 		iItems.clear();
+		iSegmentsValid = false;
+	}
+
+	void audio_beeper_sample::update_segments() const
+	{
+		if (iSegmentsValid)
+			return;
+		iSegments.clear();
+		iTotalFrames = 0;
+		auto add = [this](double aDuration, double aFrequency, const audio_envelope* aEnvelope)
+		{
+			const frame_index frames = static_cast<frame_index>(std::lround(std::max(aDuration, 0.0) * iSpec.frequency()));
+			if (frames == 0)
+				return;
+			iSegments.push_back(segment{ iTotalFrames, frames, aFrequency, aEnvelope != nullptr, aEnvelope != nullptr ? *aEnvelope : audio_envelope{} });
+			iTotalFrames += frames;
+		};
+		std::vector<std::pair<std::size_t, uint32_t>> repeats; // first segment of block, repeat count
+		for (const auto& item : iItems)
+		{
+			if (item.is<item_beep>())
+			{
+				const auto& beep = static_variant_cast<const item_beep&>(item);
+				add(beep.duration, beep.frequency, nullptr);
+			}
+			else if (item.is<item_envelope>())
+			{
+				const auto& beep = static_variant_cast<const item_envelope&>(item);
+				add(beep.envelope.attack + beep.envelope.decay + beep.envelope.sustain + beep.envelope.release, beep.frequency, &beep.envelope);
+			}
+			else if (item.is<item_silence>())
+				add(static_variant_cast<const item_silence&>(item).duration, 0.0, nullptr);
+			else if (item.is<item_repeat_start>())
+				repeats.emplace_back(iSegments.size(), static_variant_cast<const item_repeat_start&>(item).repeatCount);
+			else if (item.is<item_repeat_end>() && !repeats.empty())
+			{
+				const std::vector<segment> block{ iSegments.begin() + repeats.back().first, iSegments.end() };
+				for (uint32_t count = 1; count < repeats.back().second; ++count)
+					for (const auto& s : block)
+					{
+						iSegments.push_back(s);
+						iSegments.back().start = iTotalFrames;
+						iTotalFrames += s.frames;
+					}
+				repeats.pop_back();
+			}
+		}
+		iSegmentsValid = true;
+	}
+
+	void audio_beeper_sample::render(const segment& aSegment, frame_index aOffset, float* aBuffer, frame_index aFrameCount) const
+	{
+		const uint32_t channels = iSpec.channels();
+		if (aSegment.frequency <= 0.0)
+		{
+			std::fill(aBuffer, aBuffer + static_cast<std::size_t>(aFrameCount) * channels, 0.0f);
+			return;
+		}
+		const double rate = iSpec.frequency();
+		const double cyclesPerFrame = aSegment.frequency / rate;
+		const audio_envelope& e = aSegment.envelope;
+		for (frame_index frame = 0; frame < aFrameCount; ++frame)
+		{
+			const double position = aOffset + frame;
+			double level = 1.0;
+			if (aSegment.hasEnvelope)
+			{
+				const double time = position / rate;
+				if (time < e.attack)
+					level = time / e.attack;
+				else if (time < e.attack + e.decay)
+					level = 1.0 - (1.0 - SustainLevel) * (time - e.attack) / e.decay;
+				else if (time < e.attack + e.decay + e.sustain)
+					level = SustainLevel;
+				else
+					level = SustainLevel * std::max(1.0 - (time - e.attack - e.decay - e.sustain) / e.release, 0.0);
+			}
+			const double phase = position * cyclesPerFrame - std::floor(position * cyclesPerFrame);
+			const float value = static_cast<float>((phase < 0.5 ? Amplitude : -Amplitude) * level);
+			std::fill(aBuffer, aBuffer + channels, value);
+			aBuffer += channels;
+		}
 	}
 }
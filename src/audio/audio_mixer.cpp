@@ -0,0 +1,280 @@
+// audio_mixer.cpp
+/*
+  neogfx C++ GUI Library
+  Copyright (c) 2018 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <neogfx/neogfx.hpp>
+#include <neogfx/core/simd.hpp>
+#include <neogfx/audio/audio_mixer.hpp>
+
+namespace neogfx
+{
+	namespace
+	{
+		// LSB and SYS formats are treated alike as all supported targets are little-endian.
+		template <typename T>
+		inline void swap_bytes(T* aData, std::size_t aCount)
+		{
+			for (std::size_t index = 0; index < aCount; ++index)
+			{
+				uint8_t* bytes = reinterpret_cast<uint8_t*>(&aData[index]);
+				std::reverse(bytes, bytes + sizeof(T));
+			}
+		}
+
+		template <typename T>
+		inline void to_integer(T* aResult, const float* aSource, std::size_t aCount, double aScale, double aBias)
+		{
+			for (std::size_t index = 0; index < aCount; ++index)
+				aResult[index] = static_cast<T>(std::lround(std::min(std::max(static_cast<double>(aSource[index]), -1.0), 1.0) * aScale + aBias));
+		}
+	}
+
+	constexpr audio_mixer::frame_index audio_mixer::ChunkFrames;
+	constexpr audio_mixer::frame_index audio_mixer::SourceChunkFrames;
+	constexpr uint32_t audio_mixer::MaxSourceChannels;
+	constexpr std::size_t audio_mixer::ReservedRepeatDepth;
+
+	audio_mixer::audio_mixer(const audio_spec& aSpec) :
+		iGain{ 1.0f }
+	{
+		set_spec(aSpec);
+	}
+
+	std::recursive_mutex& audio_mixer::mutex() const
+	{
+		return iMutex;
+	}
+
+	const audio_spec& audio_mixer::spec() const
+	{
+		return iSpec;
+	}
+
+	void audio_mixer::set_spec(const audio_spec& aSpec)
+	{
+		std::lock_guard<std::recursive_mutex> lock{ iMutex };
+		iSpec = aSpec;
+		const std::size_t chunkSize = ChunkFrames * iSpec.channels();
+		iMixBuffer.assign(chunkSize, 0.0f);
+		iSourceBuffer.assign(SourceChunkFrames * MaxSourceChannels, 0.0f);
+		iFromBuffer.assign(chunkSize, 0.0f);
+		iToBuffer.assign(chunkSize, 0.0f);
+		iWeightBuffer.assign(chunkSize, 0.0f);
+		iResampleBuffer.assign(chunkSize, 0.0f);
+	}
+
+	float audio_mixer::gain() const
+	{
+		return iGain;
+	}
+
+	void audio_mixer::set_gain(float aGain)
+	{
+		std::lock_guard<std::recursive_mutex> lock{ iMutex };
+		iGain = aGain;
+	}
+
+	void audio_mixer::add_track(i_audio_track& aTrack)
+	{
+		std::lock_guard<std::recursive_mutex> lock{ iMutex };
+		iCursors.push_back(cursor{ &aTrack, 0u, 0.0 });
+		iCursors.back().repeats.reserve(ReservedRepeatDepth);
+	}
+
+	void audio_mixer::remove_track(i_audio_track& aTrack)
+	{
+		std::lock_guard<std::recursive_mutex> lock{ iMutex };
+		iCursors.erase(std::remove_if(iCursors.begin(), iCursors.end(), [&aTrack](const cursor& aCursor) { return aCursor.track == &aTrack; }), iCursors.end());
+	}
+
+	void audio_mixer::mix(float* aOutput, frame_index aFrameCount)
+	{
+		std::lock_guard<std::recursive_mutex> lock{ iMutex };
+		const uint32_t channels = iSpec.channels();
+		std::fill(aOutput, aOutput + static_cast<std::size_t>(aFrameCount) * channels, 0.0f);
+		for (frame_index done = 0; done < aFrameCount;)
+		{
+			const frame_index chunk = std::min(aFrameCount - done, ChunkFrames);
+			for (auto& c : iCursors)
+				mix(c, aOutput + static_cast<std::size_t>(done) * channels, chunk);
+			done += chunk;
+		}
+	}
+
+	void audio_mixer::render(void* aOutput, frame_index aFrameCount)
+	{
+		std::lock_guard<std::recursive_mutex> lock{ iMutex };
+		uint8_t* output = static_cast<uint8_t*>(aOutput);
+		for (frame_index done = 0; done < aFrameCount;)
+		{
+			const frame_index chunk = std::min(aFrameCount - done, ChunkFrames);
+			mix(&iMixBuffer[0], chunk);
+			convert(&iMixBuffer[0], output + static_cast<std::size_t>(done) * iSpec.frame_size(), static_cast<std::size_t>(chunk) * iSpec.channels());
+			done += chunk;
+		}
+	}
+
+	void audio_mixer::mix(cursor& aCursor, float* aOutput, frame_index aFrameCount)
+	{
+		const uint32_t channels = iSpec.channels();
+		frame_index done = 0;
+		while (done < aFrameCount && aCursor.item < aCursor.track->item_count())
+		{
+			const auto& item = aCursor.track->item(aCursor.item);
+			const bool lastItem = (aCursor.item + 1 == aCursor.track->item_count());
+			if (item.is<i_audio_track::item_sample>())
+			{
+				const frame_index mixed = mix_sample(aCursor, *static_variant_cast<const i_audio_track::item_sample&>(item).sample, aOutput + static_cast<std::size_t>(done) * channels, aFrameCount - done);
+				if (mixed != 0)
+				{
+					done += mixed;
+					continue;
+				}
+				if (lastItem) // wait for the sample to grow (e.g. more beeps being queued)
+					break;
+			}
+			else if (item.is<i_audio_track::item_silence>())
+			{
+				const double frames = static_variant_cast<const i_audio_track::item_silence&>(item).duration * iSpec.frequency();
+				if (aCursor.position < frames)
+				{
+					const frame_index skipped = std::min(aFrameCount - done, static_cast<frame_index>(std::ceil(frames - aCursor.position)));
+					aCursor.position += skipped;
+					done += skipped;
+					continue;
+				}
+			}
+			else if (item.is<i_audio_track::item_repeat_start>())
+				aCursor.repeats.push_back(repeat{ aCursor.item + 1, std::max(static_variant_cast<const i_audio_track::item_repeat_start&>(item).repeatCount, 1u) - 1 });
+			else if (item.is<i_audio_track::item_repeat_end>() && !aCursor.repeats.empty())
+			{
+				if (aCursor.repeats.back().remaining != 0)
+				{
+					--aCursor.repeats.back().remaining;
+					aCursor.item = aCursor.repeats.back().start;
+					aCursor.position = 0.0;
+					continue;
+				}
+				aCursor.repeats.pop_back();
+			}
+			++aCursor.item;
+			aCursor.position = 0.0;
+		}
+	}
+
+	audio_mixer::frame_index audio_mixer::mix_sample(cursor& aCursor, const i_audio_sample& aSample, float* aOutput, frame_index aFrameCount)
+	{
+		const audio_spec& sourceSpec = aSample.spec();
+		if ((sourceSpec.format() != audio_format::F32 && sourceSpec.format() != audio_format::F32SYS) || 
+			sourceSpec.channels() == 0 || sourceSpec.channels() > MaxSourceChannels || sourceSpec.frequency() <= 0)
+			return 0;
+		const frame_index totalFrames = aSample.total_frames();
+		if (aCursor.position >= totalFrames)
+		{
+			aCursor.position = totalFrames;
+			return 0;
+		}
+		const uint32_t sourceChannels = sourceSpec.channels();
+		const uint32_t channels = iSpec.channels();
+		const double step = static_cast<double>(sourceSpec.frequency()) / iSpec.frequency();
+		const frame_index firstFrame = static_cast<frame_index>(aCursor.position);
+		const double offset = aCursor.position - firstFrame;
+		frame_index outputFrames = std::min(aFrameCount, static_cast<frame_index>((SourceChunkFrames - 2 - offset) / step) + 1);
+		const frame_index sourceFrames = static_cast<frame_index>(offset + (outputFrames - 1) * step) + 2;
+		const frame_index readFrames = aSample.read(firstFrame, &iSourceBuffer[0], sourceFrames);
+		if (readFrames == 0)
+			return 0;
+		if (step == 1.0 && offset == 0.0 && sourceChannels == channels)
+		{
+			outputFrames = std::min(outputFrames, readFrames);
+			detail::float_span_kernel::multiply_add(aOutput, &iSourceBuffer[0], iGain, static_cast<std::size_t>(outputFrames) * channels);
+			aCursor.position += outputFrames;
+			return outputFrames;
+		}
+		if (readFrames < sourceFrames)
+			outputFrames = std::min(outputFrames, static_cast<frame_index>((readFrames - 1 - offset) / step) + 1);
+		// gather the interpolation end points (spreading narrower sources across the remaining output channels) then 
+		// interpolate and accumulate a whole run at a time
+		std::size_t index = 0;
+		for (frame_index frame = 0; frame < outputFrames; ++frame)
+		{
+			const double position = offset + frame * step;
+			const frame_index from = static_cast<frame_index>(position);
+			const frame_index to = std::min(from + 1, readFrames - 1);
+			const float weight = static_cast<float>(position - from);
+			for (uint32_t channel = 0; channel < channels; ++channel, ++index)
+			{
+				const uint32_t sourceChannel = std::min(channel, sourceChannels - 1);
+				iFromBuffer[index] = iSourceBuffer[from * sourceChannels + sourceChannel];
+				iToBuffer[index] = iSourceBuffer[to * sourceChannels + sourceChannel];
+				iWeightBuffer[index] = weight;
+			}
+		}
+		detail::float_span_kernel::lerp(&iResampleBuffer[0], &iFromBuffer[0], &iToBuffer[0], &iWeightBuffer[0], index);
+		detail::float_span_kernel::multiply_add(aOutput, &iResampleBuffer[0], iGain, index);
+		aCursor.position += outputFrames * step;
+		return outputFrames;
+	}
+
+	void audio_mixer::convert(const float* aSource, void* aOutput, std::size_t aCount) const
+	{
+		switch (iSpec.format())
+		{
+		case audio_format::F32LSB:
+		case audio_format::F32SYS:
+			std::copy(aSource, aSource + aCount, static_cast<float*>(aOutput));
+			break;
+		case audio_format::F32MSB:
+			std::copy(aSource, aSource + aCount, static_cast<float*>(aOutput));
+			swap_bytes(static_cast<float*>(aOutput), aCount);
+			break;
+		case audio_format::S16LSB:
+		case audio_format::S16SYS:
+			detail::float_span_kernel::to_int16(static_cast<int16_t*>(aOutput), aSource, aCount);
+			break;
+		case audio_format::S16MSB:
+			detail::float_span_kernel::to_int16(static_cast<int16_t*>(aOutput), aSource, aCount);
+			swap_bytes(static_cast<int16_t*>(aOutput), aCount);
+			break;
+		case audio_format::U16LSB:
+		case audio_format::U16SYS:
+			to_integer(static_cast<uint16_t*>(aOutput), aSource, aCount, 32767.0, 32768.0);
+			break;
+		case audio_format::U16MSB:
+			to_integer(static_cast<uint16_t*>(aOutput), aSource, aCount, 32767.0, 32768.0);
+			swap_bytes(static_cast<uint16_t*>(aOutput), aCount);
+			break;
+		case audio_format::S32LSB:
+		case audio_format::S32SYS:
+			to_integer(static_cast<int32_t*>(aOutput), aSource, aCount, 2147483647.0, 0.0);
+			break;
+		case audio_format::S32MSB:
+			to_integer(static_cast<int32_t*>(aOutput), aSource, aCount, 2147483647.0, 0.0);
+			swap_bytes(static_cast<int32_t*>(aOutput), aCount);
+			break;
+		case audio_format::S8:
+			to_integer(static_cast<int8_t*>(aOutput), aSource, aCount, 127.0, 0.0);
+			break;
+		case audio_format::U8:
+			to_integer(static_cast<uint8_t*>(aOutput), aSource, aCount, 127.0, 128.0);
+			break;
+		default:
+			throw unknown_audio_format();
+		}
+	}
+}
@@ -18,14 +18,57 @@
 */
 
 #include <neogfx/neogfx.hpp>
+#include <thread>
+#include <chrono>
+#include <neolib/thread.hpp>
 #include <neogfx/audio/audio_playback_device.hpp>
 #include <neogfx/audio/audio_track.hpp>
 #include <neogfx/audio/audio_beeper.hpp>
 
 namespace neogfx
 {
-	audio_playback_device::audio_playback_device()
+	namespace
 	{
+		struct scoped_reader
+		{
+			std::atomic<uint32_t>& iReaders;
+			scoped_reader(std::atomic<uint32_t>& aReaders) : iReaders{ aReaders } { ++iReaders; }
+			~scoped_reader() { --iReaders; }
+		};
+	}
+
+	class audio_playback_device::feeder_thread : public neolib::thread
+	{
+	public:
+		feeder_thread(audio_playback_device& aOwner) : neolib::thread{ "neogfx::audio_playback_device::feeder_thread" }, iOwner{ aOwner }
+		{
+			start();
+		}
+	public:
+		void exec() override
+		{
+			while (!finished())
+			{
+				iOwner.feed();
+				std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+			}
+		}
+	private:
+		audio_playback_device& iOwner;
+	};
+
+	constexpr uint32_t audio_playback_device::BufferPeriods;
+
+	audio_playback_device::audio_playback_device() : 
+		iDeviceRing{ nullptr },
+		iDeviceReaders{ 0u },
+		iUnderruns{ 0ull }
+	{
+	}
+
+	audio_playback_device::~audio_playback_device()
+	{
+		stop_streaming();
 	}
 
 	i_audio_sample& audio_playback_device::load_sample(const std::string& aUri)
@@ -52,8 +95,9 @@ namespace neogfx
 
 	i_audio_track& audio_playback_device::create_track()
 	{
-		auto newTrack = std::make_shared<audio_track>(spec());
+		auto newTrack = std::make_shared<audio_track>(spec(), mixer().mutex());
 		iTracks.push_back(newTrack);
+		mixer().add_track(*newTrack);
 		return *newTrack;
 	}
 
@@ -62,6 +106,7 @@ namespace neogfx
 		for (auto i = iTracks.begin(); i != iTracks.end(); ++i)
 			if (&**i == &aTrack)
 			{
+				mixer().remove_track(aTrack);
 				iTracks.erase(i);
 				return;
 			}
@@ -73,4 +118,84 @@ namespace neogfx
 			iBeeper = std::make_unique<audio_beeper>(*this);
 		return *iBeeper;
 	}
+
+	audio_mixer& audio_playback_device::mixer()
+	{
+		if (iMixer == nullptr)
+			iMixer = std::make_unique<audio_mixer>(spec());
+		return *iMixer;
+	}
+
+	bool audio_playback_device::streaming() const
+	{
+		return iFeederThread != nullptr;
+	}
+
+	uint64_t audio_playback_device::underruns() const
+	{
+		return iUnderruns;
+	}
+
+	void audio_playback_device::start_streaming()
+	{
+		if (streaming())
+			return;
+		mixer().set_spec(spec());
+		iFeedBuffer.assign(static_cast<std::size_t>(spec().samples()) * spec().frame_size(), spec().silence());
+		iRing = std::make_unique<audio_ring_buffer<uint8_t>>(iFeedBuffer.size() * BufferPeriods);
+		iUnderruns = 0ull;
+		iFeederThread = std::make_unique<feeder_thread>(*this);
+		iDeviceRing = iRing.get();
+	}
+
+	void audio_playback_device::stop_streaming()
+	{
+		if (!streaming())
+			return;
+		// the device may still be calling pull() (e.g. when a subclass stops streaming before closing the device) so 
+		// hide the ring from it and wait for any call in progress to finish before the ring is destroyed
+		iDeviceRing = nullptr;
+		while (iDeviceReaders != 0u)
+			std::this_thread::yield();
+		iFeederThread->abort();
+		iFeederThread.reset();
+		iRing.reset();
+	}
+
+	std::size_t audio_playback_device::buffered() const
+	{
+		scoped_reader reader{ iDeviceReaders };
+		auto ring = iDeviceRing.load();
+		return ring != nullptr ? ring->available() : 0;
+	}
+
+	// Called by the device (typically from its own real-time thread) so must not block or allocate; any shortfall is 
+	// filled with silence and counted as an underrun.
+	void audio_playback_device::pull(void* aBuffer, std::size_t aSize)
+	{
+		uint8_t* buffer = static_cast<uint8_t*>(aBuffer);
+		scoped_reader reader{ iDeviceReaders };
+		auto ring = iDeviceRing.load();
+		if (ring == nullptr)
+		{
+			std::fill(buffer, buffer + aSize, uint8_t{});
+			return;
+		}
+		const std::size_t pulled = ring->read(buffer, aSize);
+		if (pulled < aSize)
+		{
+			std::fill(buffer + pulled, buffer + aSize, iMixer->spec().silence());
+			++iUnderruns;
+		}
+	}
+
+	void audio_playback_device::feed()
+	{
+		// whole feed buffers are written and devices read whole frames so the ring contents stay frame aligned
+		while (iRing->space() >= iFeedBuffer.size())
+		{
+			iMixer->render(&iFeedBuffer[0], iMixer->spec().samples());
+			iRing->write(&iFeedBuffer[0], iFeedBuffer.size());
+		}
+	}
 }
\ No newline at end of file
@@ -22,8 +22,8 @@
 
 namespace neogfx
 {
-	audio_track::audio_track(const audio_spec& aSpec) : 
-		iSpec{ aSpec }
+	audio_track::audio_track(const audio_spec& aSpec, std::recursive_mutex& aMutex) : 
+		iMutex{ aMutex }, iSpec{ aSpec }
 	{
 	}
 
@@ -34,26 +34,31 @@ namespace neogfx
 
 	void audio_track::add_sample(i_audio_sample& aSample)
 	{
+		std::lock_guard<std::recursive_mutex> lock{ iMutex };
 		iItems.push_back(item_sample{ std::shared_ptr<i_audio_sample>{std::shared_ptr<i_audio_sample>{}, &aSample} });
 	}
 
 	void audio_track::add_sample(std::shared_ptr<i_audio_sample> aSample)
 	{
+		std::lock_guard<std::recursive_mutex> lock{ iMutex };
 		iItems.push_back(item_sample{ aSample });
 	}
 
 	void audio_track::add_silence(double aDuration)
 	{
+		std::lock_guard<std::recursive_mutex> lock{ iMutex };
 		iItems.push_back(item_silence{ aDuration });
 	}
 
 	void audio_track::repeat_start(uint32_t aRepeatCount)
 	{
+		std::lock_guard<std::recursive_mutex> lock{ iMutex };
 		iItems.push_back(item_repeat_start{ aRepeatCount });
 	}
 
 	void audio_track::repeat_end()
 	{
+		std::lock_guard<std::recursive_mutex> lock{ iMutex };
 		iItems.push_back(item_repeat_end{});
 	}
 
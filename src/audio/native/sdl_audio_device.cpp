@@ -149,7 +149,20 @@ namespace neogfx
 		set_spec(boost::none);
 	}
 
+	void sdl_audio_device::pause(bool aPause)
+	{
+		if (!is_open())
+			throw not_open();
+		SDL_PauseAudioDevice(iId, aPause ? 1 : 0);
+	}
+
+	void sdl_audio_device::fill(void* aBuffer, std::size_t aSize)
+	{
+		std::fill(static_cast<Uint8*>(aBuffer), static_cast<Uint8*>(aBuffer) + aSize, spec().silence());
+	}
+
 	void sdl_audio_device::callback(void *userdata, Uint8* stream, int len)
 	{
+		static_cast<sdl_audio_device*>(userdata)->fill(stream, static_cast<std::size_t>(len));
 	}
 }
\ No newline at end of file
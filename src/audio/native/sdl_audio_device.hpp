@@ -33,6 +33,9 @@ namespace neogfx
 		bool is_open() const override;
 		void open(const audio_spec& aAudioSpec = audio_spec{}, audio_spec_requirements aRequirements = audio_spec_requirements::RequireNone) override;
 		void close() override;
+	protected:
+		void pause(bool aPause);
+		virtual void fill(void* aBuffer, std::size_t aSize);
 	private:
 		static void callback(void *userdata, Uint8* stream, int len);
 	private:
@@ -29,6 +29,13 @@ namespace neogfx
 	{
 	}
 
+	sdl_audio_playback_device::~sdl_audio_playback_device()
+	{
+		// close here, rather than in a base class destructor, as the device callback calls our fill() override
+		if (is_open())
+			close();
+	}
+
 	const std::string& sdl_audio_playback_device::name() const
 	{
 		return sdl_audio_device::name();
@@ -42,15 +49,23 @@ namespace neogfx
 	void sdl_audio_playback_device::open(const audio_spec& aAudioSpec, audio_spec_requirements aRequirements)
 	{
 		sdl_audio_device::open(aAudioSpec, aRequirements);
+		start_streaming();
+		pause(false);
 	}
 
 	void sdl_audio_playback_device::close()
 	{
 		sdl_audio_device::close();
+		stop_streaming();
 	}
 
 	const audio_spec& sdl_audio_playback_device::spec() const
 	{
 		return sdl_audio_device::spec();
 	}
+
+	void sdl_audio_playback_device::fill(void* aBuffer, std::size_t aSize)
+	{
+		pull(aBuffer, aSize);
+	}
 }
\ No newline at end of file
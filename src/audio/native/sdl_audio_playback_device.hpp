@@ -29,6 +29,7 @@ namespace neogfx
 	{
 	public:
 		sdl_audio_playback_device(const std::string& aName);
+		~sdl_audio_playback_device();
 	public:
 		const std::string& name() const override;
 	public:
@@ -37,5 +38,7 @@ namespace neogfx
 		void close() override;
 	public:
 		const audio_spec& spec() const override;
+	private:
+		void fill(void* aBuffer, std::size_t aSize) override;
 	};
 }
\ No newline at end of file
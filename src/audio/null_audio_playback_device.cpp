@@ -0,0 +1,134 @@
+// null_audio_playback_device.cpp
+/*
+  neogfx C++ GUI Library
+  Copyright (c) 2018 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <neogfx/neogfx.hpp>
+#include <thread>
+#include <neolib/thread.hpp>
+#include <neogfx/audio/null_audio_playback_device.hpp>
+
+namespace neogfx
+{
+	class null_audio_playback_device::consumer_thread : public neolib::thread
+	{
+	public:
+		consumer_thread(null_audio_playback_device& aOwner) : neolib::thread{ "neogfx::null_audio_playback_device::consumer_thread" }, iOwner{ aOwner }
+		{
+			start();
+		}
+	public:
+		void exec() override
+		{
+			while (!finished())
+				iOwner.consume();
+		}
+	private:
+		null_audio_playback_device& iOwner;
+	};
+
+	null_audio_playback_device::null_audio_playback_device(const std::string& aName, const boost::optional<std::string>& aOutputFile, bool aRealTime) :
+		iName{ aName }, iOutputFile{ aOutputFile }, iRealTime{ aRealTime }, iFramesConsumed{ 0ull }
+	{
+	}
+
+	null_audio_playback_device::~null_audio_playback_device()
+	{
+		if (is_open())
+			close();
+	}
+
+	const std::string& null_audio_playback_device::name() const
+	{
+		return iName;
+	}
+
+	bool null_audio_playback_device::is_open() const
+	{
+		return iSpec != boost::none;
+	}
+
+	void null_audio_playback_device::open(const audio_spec& aAudioSpec, audio_spec_requirements)
+	{
+		if (is_open())
+			throw already_open();
+		// any requested spec can be honoured exactly
+		iSpec = audio_spec{ aAudioSpec.frequency(), aAudioSpec.format(), aAudioSpec.channels(), aAudioSpec.samples(), 
+			static_cast<uint32_t>(aAudioSpec.samples()) * aAudioSpec.frame_size(), static_cast<uint8_t>(aAudioSpec.format() == audio_format::U8 ? 0x80 : 0x00) };
+		if (iOutputFile != boost::none)
+		{
+			iOutput.open(*iOutputFile, std::ios::binary | std::ios::trunc);
+			if (!iOutput)
+			{
+				iSpec = boost::none;
+				throw failed_to_open_output_file(*iOutputFile);
+			}
+		}
+		iBuffer.assign(iSpec->size(), iSpec->silence());
+		iFramesConsumed = 0ull;
+		start_streaming();
+		iNextPeriod = std::chrono::steady_clock::now();
+		iConsumerThread = std::make_unique<consumer_thread>(*this);
+	}
+
+	void null_audio_playback_device::close()
+	{
+		if (!is_open())
+			throw not_open();
+		iConsumerThread->abort();
+		iConsumerThread.reset();
+		stop_streaming();
+		if (iOutput.is_open())
+			iOutput.close();
+		iSpec = boost::none;
+	}
+
+	const audio_spec& null_audio_playback_device::spec() const
+	{
+		if (!is_open())
+			throw not_open();
+		return *iSpec;
+	}
+
+	bool null_audio_playback_device::real_time() const
+	{
+		return iRealTime;
+	}
+
+	uint64_t null_audio_playback_device::frames_consumed() const
+	{
+		return iFramesConsumed;
+	}
+
+	void null_audio_playback_device::consume()
+	{
+		if (iRealTime)
+		{
+			iNextPeriod += std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>{ static_cast<double>(iSpec->samples()) / iSpec->frequency() });
+			std::this_thread::sleep_until(iNextPeriod);
+		}
+		else if (buffered() < iBuffer.size())
+		{
+			std::this_thread::yield();
+			return;
+		}
+		pull(&iBuffer[0], iBuffer.size());
+		if (iOutput.is_open())
+			iOutput.write(reinterpret_cast<const char*>(&iBuffer[0]), iBuffer.size());
+		iFramesConsumed += iSpec->samples();
+	}
+}
@@ -0,0 +1,314 @@
+// colour_conversion.cpp
+/*
+  neogfx C++ GUI Library
+  Copyright (c) 2018 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <neogfx/neogfx.hpp>
+#include <cmath>
+#include <array>
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define NEOGFX_COLOUR_CONVERSION_SSE2
+#endif
+#include <neogfx/core/colour_conversion.hpp>
+
+namespace neogfx
+{
+	namespace
+	{
+		const std::size_t kBlockSize = 64;
+
+		inline uint8_t to_component(float aValue)
+		{
+			return static_cast<uint8_t>(std::min(std::max(std::floor(aValue * 255.0f), 0.0f), 255.0f));
+		}
+
+		// branch-free forms of the piecewise hue functions used by hsv_colour::to_rgb and hsl_colour::to_rgb:
+		//   HSV: f(n) = V - VS * max(0, min(k, 4 - k, 1)), k = (n + H/60) mod 6
+		//   HSL: f(n) = L - a * max(-1, min(k - 3, 9 - k, 1)), k = (n + H/30) mod 12, a = S * min(L, 1 - L)
+		inline float hsv_channel(float aN, float aHue, float aSaturation, float aValue)
+		{
+			float k = std::fmod(aN + aHue / 60.0f, 6.0f);
+			return aValue - aValue * aSaturation * std::max(0.0f, std::min(std::min(k, 4.0f - k), 1.0f));
+		}
+
+		inline float hsl_channel(float aN, float aHue, float aSaturation, float aLightness)
+		{
+			float k = std::fmod(aN + aHue / 30.0f, 12.0f);
+			float a = aSaturation * std::min(aLightness, 1.0f - aLightness);
+			return aLightness - a * std::max(-1.0f, std::min(std::min(k - 3.0f, 9.0f - k), 1.0f));
+		}
+
+#ifdef NEOGFX_COLOUR_CONVERSION_SSE2
+		inline __m128 mod_positive(__m128 aValue, __m128 aModulus)
+		{
+			// operands are non-negative so truncation is equivalent to floor
+			__m128 quotient = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_div_ps(aValue, aModulus)));
+			return _mm_sub_ps(aValue, _mm_mul_ps(quotient, aModulus));
+		}
+
+		inline __m128i to_components(__m128 aValue)
+		{
+			// cvtt truncates; values are clamped to [0, 255] so truncation is equivalent to floor
+			__m128 scaled = _mm_min_ps(_mm_max_ps(_mm_mul_ps(aValue, _mm_set1_ps(255.0f)), _mm_setzero_ps()), _mm_set1_ps(255.0f));
+			return _mm_cvttps_epi32(scaled);
+		}
+
+		inline void store_rgba(__m128i aRed, __m128i aGreen, __m128i aBlue, uint8_t aAlpha, uint8_t* aRgba)
+		{
+			__m128i pixels = _mm_or_si128(
+				_mm_or_si128(aRed, _mm_slli_epi32(aGreen, 8)),
+				_mm_or_si128(_mm_slli_epi32(aBlue, 16), _mm_set1_epi32(static_cast<int>(static_cast<uint32_t>(aAlpha) << 24))));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(aRgba), pixels);
+		}
+
+		inline __m128 hsv_channel(__m128 aN, __m128 aHue, __m128 aSaturation, __m128 aValue)
+		{
+			__m128 k = mod_positive(_mm_add_ps(aN, _mm_div_ps(aHue, _mm_set1_ps(60.0f))), _mm_set1_ps(6.0f));
+			__m128 t = _mm_max_ps(_mm_setzero_ps(), _mm_min_ps(_mm_min_ps(k, _mm_sub_ps(_mm_set1_ps(4.0f), k)), _mm_set1_ps(1.0f)));
+			return _mm_sub_ps(aValue, _mm_mul_ps(_mm_mul_ps(aValue, aSaturation), t));
+		}
+
+		inline __m128 hsl_channel(__m128 aN, __m128 aHue, __m128 aSaturation, __m128 aLightness)
+		{
+			__m128 k = mod_positive(_mm_add_ps(aN, _mm_div_ps(aHue, _mm_set1_ps(30.0f))), _mm_set1_ps(12.0f));
+			__m128 a = _mm_mul_ps(aSaturation, _mm_min_ps(aLightness, _mm_sub_ps(_mm_set1_ps(1.0f), aLightness)));
+			__m128 t = _mm_max_ps(_mm_set1_ps(-1.0f), _mm_min_ps(_mm_min_ps(_mm_sub_ps(k, _mm_set1_ps(3.0f)), _mm_sub_ps(_mm_set1_ps(9.0f), k)), _mm_set1_ps(1.0f)));
+			return _mm_sub_ps(aLightness, _mm_mul_ps(a, t));
+		}
+#endif
+
+		float linear_component(float aValue)
+		{
+			return aValue <= 0.04045f ? aValue / 12.92f : std::pow((aValue + 0.055f) / 1.055f, 2.4f);
+		}
+
+		uint8_t srgb_component(float aValue)
+		{
+			aValue = std::min(std::max(aValue, 0.0f), 1.0f);
+			float result = aValue <= 0.0031308f ? aValue * 12.92f : 1.055f * std::pow(aValue, 1.0f / 2.4f) - 0.055f;
+			return static_cast<uint8_t>(std::min(std::max(std::round(result * 255.0f), 0.0f), 255.0f));
+		}
+
+		const std::array<float, 256>& srgb_to_linear_table()
+		{
+			static const std::array<float, 256> sTable = []()
+			{
+				std::array<float, 256> result;
+				for (std::size_t i = 0; i < result.size(); ++i)
+					result[i] = linear_component(static_cast<float>(i) / 255.0f);
+				return result;
+			}();
+			return sTable;
+		}
+
+		template <typename Result>
+		void rgba_to_hue(const uint8_t* aRgba, std::size_t aCount, Result aResult)
+		{
+			for (std::size_t i = 0; i < aCount; ++i, aRgba += 4)
+			{
+				float r = aRgba[0] / 255.0f, g = aRgba[1] / 255.0f, b = aRgba[2] / 255.0f;
+				float M = std::max(std::max(r, g), b);
+				float m = std::min(std::min(r, g), b);
+				float c = M - m;
+				float hue = 0.0f;
+				if (c != 0.0f)
+				{
+					if (M == r)
+						hue = std::fmod((g - b) / c, 6.0f);
+					else if (M == g)
+						hue = (b - r) / c + 2.0f;
+					else
+						hue = (r - g) / c + 4.0f;
+					hue *= 60.0f;
+					if (hue < 0.0f)
+						hue += 360.0f;
+				}
+				aResult(i, hue, M, m, c);
+			}
+		}
+	}
+
+	void hsv_to_rgba(const float* aHue, const float* aSaturation, const float* aValue, std::size_t aCount, uint8_t* aRgba, uint8_t aAlpha)
+	{
+		std::size_t i = 0;
+#ifdef NEOGFX_COLOUR_CONVERSION_SSE2
+		for (; i + 4 <= aCount; i += 4, aRgba += 16)
+		{
+			__m128 hue = _mm_max_ps(_mm_loadu_ps(aHue + i), _mm_setzero_ps());
+			__m128 saturation = _mm_loadu_ps(aSaturation + i);
+			__m128 value = _mm_loadu_ps(aValue + i);
+			store_rgba(
+				to_components(hsv_channel(_mm_set1_ps(5.0f), hue, saturation, value)),
+				to_components(hsv_channel(_mm_set1_ps(3.0f), hue, saturation, value)),
+				to_components(hsv_channel(_mm_set1_ps(1.0f), hue, saturation, value)),
+				aAlpha, aRgba);
+		}
+#endif
+		for (; i < aCount; ++i, aRgba += 4)
+		{
+			float hue = aHue[i] < 0.0f ? 0.0f : aHue[i];
+			aRgba[0] = to_component(hsv_channel(5.0f, hue, aSaturation[i], aValue[i]));
+			aRgba[1] = to_component(hsv_channel(3.0f, hue, aSaturation[i], aValue[i]));
+			aRgba[2] = to_component(hsv_channel(1.0f, hue, aSaturation[i], aValue[i]));
+			aRgba[3] = aAlpha;
+		}
+	}
+
+	void hsv_to_rgba(const hsv_colour* aSource, std::size_t aCount, uint8_t* aRgba)
+	{
+		// gather into planar blocks so the planar kernel (and SSE2) does the work
+		std::array<float, kBlockSize> hue, saturation, value;
+		for (std::size_t block = 0; block < aCount; block += kBlockSize)
+		{
+			auto const count = std::min(kBlockSize, aCount - block);
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				hue[i] = static_cast<float>(aSource[block + i].hue());
+				saturation[i] = static_cast<float>(aSource[block + i].saturation());
+				value[i] = static_cast<float>(aSource[block + i].value());
+			}
+			hsv_to_rgba(&hue[0], &saturation[0], &value[0], count, aRgba + block * 4);
+			for (std::size_t i = 0; i < count; ++i)
+				aRgba[(block + i) * 4 + 3] = to_component(static_cast<float>(aSource[block + i].alpha()));
+		}
+	}
+
+	void hsl_to_rgba(const float* aHue, const float* aSaturation, const float* aLightness, std::size_t aCount, uint8_t* aRgba, uint8_t aAlpha)
+	{
+		std::size_t i = 0;
+#ifdef NEOGFX_COLOUR_CONVERSION_SSE2
+		for (; i + 4 <= aCount; i += 4, aRgba += 16)
+		{
+			__m128 hue = _mm_max_ps(_mm_loadu_ps(aHue + i), _mm_setzero_ps());
+			__m128 saturation = _mm_loadu_ps(aSaturation + i);
+			__m128 lightness = _mm_loadu_ps(aLightness + i);
+			store_rgba(
+				to_components(hsl_channel(_mm_set1_ps(0.0f), hue, saturation, lightness)),
+				to_components(hsl_channel(_mm_set1_ps(8.0f), hue, saturation, lightness)),
+				to_components(hsl_channel(_mm_set1_ps(4.0f), hue, saturation, lightness)),
+				aAlpha, aRgba);
+		}
+#endif
+		for (; i < aCount; ++i, aRgba += 4)
+		{
+			float hue = aHue[i] < 0.0f ? 0.0f : aHue[i];
+			aRgba[0] = to_component(hsl_channel(0.0f, hue, aSaturation[i], aLightness[i]));
+			aRgba[1] = to_component(hsl_channel(8.0f, hue, aSaturation[i], aLightness[i]));
+			aRgba[2] = to_component(hsl_channel(4.0f, hue, aSaturation[i], aLightness[i]));
+			aRgba[3] = aAlpha;
+		}
+	}
+
+	void hsl_to_rgba(const hsl_colour* aSource, std::size_t aCount, uint8_t* aRgba)
+	{
+		// gather into planar blocks so the planar kernel (and SSE2) does the work
+		std::array<float, kBlockSize> hue, saturation, lightness;
+		for (std::size_t block = 0; block < aCount; block += kBlockSize)
+		{
+			auto const count = std::min(kBlockSize, aCount - block);
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				hue[i] = static_cast<float>(aSource[block + i].hue());
+				saturation[i] = static_cast<float>(aSource[block + i].saturation());
+				lightness[i] = static_cast<float>(aSource[block + i].lightness());
+			}
+			hsl_to_rgba(&hue[0], &saturation[0], &lightness[0], count, aRgba + block * 4);
+			for (std::size_t i = 0; i < count; ++i)
+				aRgba[(block + i) * 4 + 3] = to_component(static_cast<float>(aSource[block + i].alpha()));
+		}
+	}
+
+	void rgba_to_hsv(const uint8_t* aRgba, std::size_t aCount, float* aHue, float* aSaturation, float* aValue)
+	{
+		rgba_to_hue(aRgba, aCount, [&](std::size_t aIndex, float aHueDegrees, float aMax, float, float aChroma)
+		{
+			aHue[aIndex] = aHueDegrees;
+			aSaturation[aIndex] = (aChroma == 0.0f ? 0.0f : aChroma / aMax);
+			aValue[aIndex] = aMax;
+		});
+	}
+
+	void rgba_to_hsv(const uint8_t* aRgba, std::size_t aCount, hsv_colour* aResult)
+	{
+		for (std::size_t i = 0; i < aCount; ++i, aRgba += 4)
+			aResult[i] = hsv_colour::from_rgb(colour{ aRgba[0], aRgba[1], aRgba[2], aRgba[3] });
+	}
+
+	void rgba_to_hsl(const uint8_t* aRgba, std::size_t aCount, float* aHue, float* aSaturation, float* aLightness)
+	{
+		rgba_to_hue(aRgba, aCount, [&](std::size_t aIndex, float aHueDegrees, float aMax, float aMin, float aChroma)
+		{
+			float lightness = (aMax + aMin) * 0.5f;
+			aHue[aIndex] = aHueDegrees;
+			aSaturation[aIndex] = (aChroma == 0.0f ? 0.0f : aChroma / (1.0f - std::abs(2.0f * lightness - 1.0f)));
+			aLightness[aIndex] = lightness;
+		});
+	}
+
+	void rgba_to_hsl(const uint8_t* aRgba, std::size_t aCount, hsl_colour* aResult)
+	{
+		for (std::size_t i = 0; i < aCount; ++i, aRgba += 4)
+			aResult[i] = hsl_colour::from_rgb(colour{ aRgba[0], aRgba[1], aRgba[2], aRgba[3] });
+	}
+
+	void srgb_to_linear(const uint8_t* aRgba, std::size_t aCount, float* aLinearRgba)
+	{
+		auto const& table = srgb_to_linear_table();
+		for (std::size_t i = 0; i < aCount; ++i, aRgba += 4, aLinearRgba += 4)
+		{
+			aLinearRgba[0] = table[aRgba[0]];
+			aLinearRgba[1] = table[aRgba[1]];
+			aLinearRgba[2] = table[aRgba[2]];
+			aLinearRgba[3] = aRgba[3] / 255.0f;
+		}
+	}
+
+	void srgb_to_linear(const uint8_t* aRgba, std::size_t aCount, float* aRed, float* aGreen, float* aBlue, float* aAlpha)
+	{
+		auto const& table = srgb_to_linear_table();
+		for (std::size_t i = 0; i < aCount; ++i, aRgba += 4)
+		{
+			aRed[i] = table[aRgba[0]];
+			aGreen[i] = table[aRgba[1]];
+			aBlue[i] = table[aRgba[2]];
+			aAlpha[i] = aRgba[3] / 255.0f;
+		}
+	}
+
+	void linear_to_srgb(const float* aLinearRgba, std::size_t aCount, uint8_t* aRgba)
+	{
+		for (std::size_t i = 0; i < aCount; ++i, aLinearRgba += 4, aRgba += 4)
+		{
+			aRgba[0] = srgb_component(aLinearRgba[0]);
+			aRgba[1] = srgb_component(aLinearRgba[1]);
+			aRgba[2] = srgb_component(aLinearRgba[2]);
+			aRgba[3] = to_component(aLinearRgba[3]);
+		}
+	}
+
+	void linear_to_srgb(const float* aRed, const float* aGreen, const float* aBlue, const float* aAlpha, std::size_t aCount, uint8_t* aRgba)
+	{
+		for (std::size_t i = 0; i < aCount; ++i, aRgba += 4)
+		{
+			aRgba[0] = srgb_component(aRed[i]);
+			aRgba[1] = srgb_component(aGreen[i]);
+			aRgba[2] = srgb_component(aBlue[i]);
+			aRgba[3] = to_component(aAlpha[i]);
+		}
+	}
+}
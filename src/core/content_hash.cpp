@@ -0,0 +1,153 @@
+// content_hash.cpp
+/*
+  neogfx C++ GUI Library
+  Copyright (c) 2018 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <neogfx/neogfx.hpp>
+#include <cstring>
+#include <boost/endian/conversion.hpp>
+#include <neogfx/core/content_hash.hpp>
+
+namespace neogfx
+{
+	namespace
+	{
+		const uint64_t Prime1 = 11400714785074694791ull;
+		const uint64_t Prime2 = 14029467366897019727ull;
+		const uint64_t Prime3 = 1609587929392839161ull;
+		const uint64_t Prime4 = 9650029242287828579ull;
+		const uint64_t Prime5 = 2870177450012600261ull;
+
+		inline uint64_t rotate_left(uint64_t aValue, uint32_t aBits)
+		{
+			return (aValue << aBits) | (aValue >> (64u - aBits));
+		}
+
+		// unaligned little endian loads
+		inline uint64_t read64(const uint8_t* aData)
+		{
+			uint64_t result;
+			std::memcpy(&result, aData, sizeof(result));
+			return boost::endian::little_to_native(result);
+		}
+
+		inline uint32_t read32(const uint8_t* aData)
+		{
+			uint32_t result;
+			std::memcpy(&result, aData, sizeof(result));
+			return boost::endian::little_to_native(result);
+		}
+
+		inline uint64_t round(uint64_t aAccumulator, uint64_t aLane)
+		{
+			aAccumulator += aLane * Prime2;
+			aAccumulator = rotate_left(aAccumulator, 31u);
+			return aAccumulator * Prime1;
+		}
+
+		inline uint64_t merge_round(uint64_t aHash, uint64_t aAccumulator)
+		{
+			aHash ^= round(0u, aAccumulator);
+			return aHash * Prime1 + Prime4;
+		}
+	}
+
+	content_hasher::content_hasher(uint64_t aSeed) :
+		iAccumulators{ { aSeed + Prime1 + Prime2, aSeed + Prime2, aSeed, aSeed - Prime1 } }, iBuffered{ 0u }, iTotalSize{ 0u }, iSeed{ aSeed }
+	{
+	}
+
+	void content_hasher::update(const void* aData, std::size_t aSize)
+	{
+		const uint8_t* next = static_cast<const uint8_t*>(aData);
+		const uint8_t* const end = next + aSize;
+		iTotalSize += aSize;
+		if (iBuffered + aSize < iBuffer.size())
+		{
+			if (aSize != 0u)
+				std::memcpy(&iBuffer[iBuffered], next, aSize);
+			iBuffered += aSize;
+			return;
+		}
+		if (iBuffered != 0u)
+		{
+			const std::size_t fill = iBuffer.size() - iBuffered;
+			std::memcpy(&iBuffer[iBuffered], next, fill);
+			next += fill;
+			for (uint32_t lane = 0u; lane < 4u; ++lane)
+				iAccumulators[lane] = round(iAccumulators[lane], read64(&iBuffer[lane * 8u]));
+			iBuffered = 0u;
+		}
+		auto v1 = iAccumulators[0], v2 = iAccumulators[1], v3 = iAccumulators[2], v4 = iAccumulators[3];
+		for (; end - next >= 32; next += 32)
+		{
+			v1 = round(v1, read64(next));
+			v2 = round(v2, read64(next + 8));
+			v3 = round(v3, read64(next + 16));
+			v4 = round(v4, read64(next + 24));
+		}
+		iAccumulators = { { v1, v2, v3, v4 } };
+		iBuffered = static_cast<std::size_t>(end - next);
+		if (iBuffered != 0u)
+			std::memcpy(&iBuffer[0], next, iBuffered);
+	}
+
+	uint64_t content_hasher::digest() const
+	{
+		uint64_t hash;
+		if (iTotalSize >= 32u)
+		{
+			hash = rotate_left(iAccumulators[0], 1u) + rotate_left(iAccumulators[1], 7u) + rotate_left(iAccumulators[2], 12u) + rotate_left(iAccumulators[3], 18u);
+			for (auto accumulator : iAccumulators)
+				hash = merge_round(hash, accumulator);
+		}
+		else
+			hash = iSeed + Prime5;
+		hash += iTotalSize;
+		const uint8_t* next = &iBuffer[0];
+		const uint8_t* const end = next + iBuffered;
+		for (; end - next >= 8; next += 8)
+		{
+			hash ^= round(0u, read64(next));
+			hash = rotate_left(hash, 27u) * Prime1 + Prime4;
+		}
+		if (end - next >= 4)
+		{
+			hash ^= static_cast<uint64_t>(read32(next)) * Prime1;
+			hash = rotate_left(hash, 23u) * Prime2 + Prime3;
+			next += 4;
+		}
+		for (; next != end; ++next)
+		{
+			hash ^= *next * Prime5;
+			hash = rotate_left(hash, 11u) * Prime1;
+		}
+		hash ^= hash >> 33u;
+		hash *= Prime2;
+		hash ^= hash >> 29u;
+		hash *= Prime3;
+		hash ^= hash >> 32u;
+		return hash;
+	}
+
+	uint64_t content_hash(const void* aData, std::size_t aSize, uint64_t aSeed)
+	{
+		content_hasher hasher{ aSeed };
+		hasher.update(aData, aSize);
+		return hasher.digest();
+	}
+}
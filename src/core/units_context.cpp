@@ -17,13 +17,49 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <atomic>
 #include <neogfx/core/units_context.hpp>
 
 namespace neogfx
 { 
+	units_scale::units_scale() :
+		iValid{ false }
+	{
+		iToDeviceUnits.fill(vector2{ 1.0, 1.0 });
+		iFromDeviceUnits.fill(vector2{ 1.0, 1.0 });
+	}
+
+	units_scale::units_scale(dimension aHorizontalDpi, dimension aVerticalDpi, dimension aEmSize) :
+		iValid{ true }
+	{
+		iToDeviceUnits[static_cast<std::size_t>(units::Pixels)] = vector2{ 1.0, 1.0 };
+		iToDeviceUnits[static_cast<std::size_t>(units::Points)] = vector2{ (1.0 / 72.0) * aHorizontalDpi, (1.0 / 72.0) * aVerticalDpi };
+		iToDeviceUnits[static_cast<std::size_t>(units::Picas)] = vector2{ (1.0 / 6.0) * aHorizontalDpi, (1.0 / 6.0) * aVerticalDpi };
+		iToDeviceUnits[static_cast<std::size_t>(units::Ems)] = vector2{ aEmSize * aHorizontalDpi, aEmSize * aVerticalDpi };
+		iToDeviceUnits[static_cast<std::size_t>(units::Millimetres)] = vector2{ (1.0 / 25.4) * aHorizontalDpi, (1.0 / 25.4) * aVerticalDpi };
+		iToDeviceUnits[static_cast<std::size_t>(units::Centimetres)] = vector2{ (1.0 / 2.54) * aHorizontalDpi, (1.0 / 2.54) * aVerticalDpi };
+		iToDeviceUnits[static_cast<std::size_t>(units::Inches)] = vector2{ aHorizontalDpi, aVerticalDpi };
+		iToDeviceUnits[static_cast<std::size_t>(units::Percentage)] = vector2{ 1.0, 1.0 };
+		iFromDeviceUnits[static_cast<std::size_t>(units::Pixels)] = vector2{ 1.0, 1.0 };
+		iFromDeviceUnits[static_cast<std::size_t>(units::Points)] = vector2{ 72.0 / aHorizontalDpi, 72.0 / aVerticalDpi };
+		iFromDeviceUnits[static_cast<std::size_t>(units::Picas)] = vector2{ 6.0 / aHorizontalDpi, 6.0 / aVerticalDpi };
+		iFromDeviceUnits[static_cast<std::size_t>(units::Ems)] = vector2{ (1.0 / aEmSize) / aHorizontalDpi, (1.0 / aEmSize) / aVerticalDpi };
+		iFromDeviceUnits[static_cast<std::size_t>(units::Millimetres)] = vector2{ 25.4 / aHorizontalDpi, 25.4 / aVerticalDpi };
+		iFromDeviceUnits[static_cast<std::size_t>(units::Centimetres)] = vector2{ 2.54 / aHorizontalDpi, 2.54 / aVerticalDpi };
+		iFromDeviceUnits[static_cast<std::size_t>(units::Inches)] = vector2{ 1.0 / aHorizontalDpi, 1.0 / aVerticalDpi };
+		iFromDeviceUnits[static_cast<std::size_t>(units::Percentage)] = vector2{ 1.0, 1.0 };
+	}
+
+	namespace
+	{
+		// bumped whenever a DPI or the font that em sizes are taken from changes; zero is never a current generation
+		std::atomic<uint32_t> sDeviceMetricsGeneration{ 1u };
+	}
+
 	units_context::units_context(const i_units_context& aSource) :
 		iSource{ aSource },
-		iUnits{ units::Pixels }
+		iUnits{ units::Pixels },
+		iScaleGeneration{ 0u }
 	{
 	}
 
@@ -58,7 +94,271 @@ namespace neogfx
 		iUnits = aUnits;
 		return oldUnits;
 	}
-	
+
+	// The cached scale is only rebuilt after a change has been announced (or while device metrics are still
+	// unavailable) so a conversion is a generation check, a table lookup and a multiply.
+	const units_scale& units_context::device_units_scale() const
+	{
+		auto const generation = sDeviceMetricsGeneration.load(std::memory_order_relaxed);
+		if (iScaleGeneration != generation || !iScale.valid())
+		{
+			if (device_metrics_available())
+			{
+				const auto& metrics = device_metrics();
+				iScale = units_scale{ metrics.horizontal_dpi(), metrics.vertical_dpi(), metrics.em_size() };
+			}
+			else
+				iScale = units_scale{};
+			iScaleGeneration = generation;
+		}
+		return iScale;
+	}
+
+	void units_context::device_metrics_changed()
+	{
+		if (++sDeviceMetricsGeneration == 0u)
+			++sDeviceMetricsGeneration;
+	}
+
+	void units_context::invalidate_device_units_scale() const
+	{
+		iScaleGeneration = 0u;
+	}
+
+	namespace
+	{
+		inline vector2 scaled(const vector2& aValue, const vector2& aFactor)
+		{
+			return aValue * aFactor;
+		}
+
+		inline dimension scaled(dimension aValue, const vector2& aFactor)
+		{
+			return aValue * aFactor[0];
+		}
+
+		inline delta scaled(const delta& aValue, const vector2& aFactor)
+		{
+			return delta{ aValue.dx * aFactor[0], aValue.dy * aFactor[1] };
+		}
+
+		inline size scaled(const size& aValue, const vector2& aFactor)
+		{
+			return size{ aValue.cx * aFactor[0], aValue.cy * aFactor[1] };
+		}
+
+		inline point scaled(const point& aValue, const vector2& aFactor)
+		{
+			return point{ aValue.x * aFactor[0], aValue.y * aFactor[1] };
+		}
+
+		inline rect scaled(const rect& aValue, const vector2& aFactor)
+		{
+			return rect{ scaled(aValue.position(), aFactor), scaled(aValue.extents(), aFactor) };
+		}
+
+		inline margins scaled(const margins& aValue, const vector2& aFactor)
+		{
+			return margins{ aValue.left * aFactor[0], aValue.top * aFactor[1], aValue.right * aFactor[0], aValue.bottom * aFactor[1] };
+		}
+
+		template <typename T>
+		inline T to_device(const i_units_context& aContext, units aUnits, const size& aExtents, const T& aValue)
+		{
+			switch (aUnits)
+			{
+			case units::Pixels:
+				return aValue;
+			case units::Percentage:
+				return scaled(aValue, vector2{ aExtents.cx / 100.0, aExtents.cy / 100.0 });
+			default:
+				{
+					auto const& scale = aContext.device_units_scale();
+					if (!scale.valid())
+						throw units_converter::device_metrics_unavailable();
+					return scaled(aValue, scale.to_device_units(aUnits));
+				}
+			}
+		}
+
+		template <typename T>
+		inline T to_device(const i_units_context& aContext, units aUnits, const T& aValue)
+		{
+			if (aUnits == units::Pixels)
+				return aValue;
+			if (aUnits == units::Percentage)
+			{
+				if (!aContext.device_metrics_available())
+					throw units_converter::device_metrics_unavailable();
+				return to_device(aContext, aUnits, aContext.device_metrics().extents(), aValue);
+			}
+			return to_device(aContext, aUnits, size{}, aValue);
+		}
+
+		template <typename T>
+		inline T from_device(const i_units_context& aContext, units aUnits, const size& aExtents, const T& aValue)
+		{
+			switch (aUnits)
+			{
+			case units::Pixels:
+				return aValue;
+			case units::Percentage:
+				return scaled(aValue, vector2{ 100.0 / aExtents.cx, 100.0 / aExtents.cy });
+			default:
+				{
+					auto const& scale = aContext.device_units_scale();
+					if (!scale.valid())
+						throw units_converter::device_metrics_unavailable();
+					return scaled(aValue, scale.from_device_units(aUnits));
+				}
+			}
+		}
+
+		template <typename T>
+		inline T from_device(const i_units_context& aContext, units aUnits, const T& aValue)
+		{
+			if (aUnits == units::Pixels)
+				return aValue;
+			if (aUnits == units::Percentage)
+			{
+				if (!aContext.device_metrics_available())
+					throw units_converter::device_metrics_unavailable();
+				return from_device(aContext, aUnits, aContext.device_metrics().extents(), aValue);
+			}
+			return from_device(aContext, aUnits, size{}, aValue);
+		}
+	}
+
+	vector2 to_device_units(const i_units_context& aContext, units aUnits, const vector2& aValue)
+	{
+		return to_device(aContext, aUnits, aValue);
+	}
+
+	dimension to_device_units(const i_units_context& aContext, units aUnits, dimension aValue)
+	{
+		return to_device(aContext, aUnits, aValue);
+	}
+
+	delta to_device_units(const i_units_context& aContext, units aUnits, const delta& aValue)
+	{
+		return to_device(aContext, aUnits, aValue);
+	}
+
+	size to_device_units(const i_units_context& aContext, units aUnits, const size& aValue)
+	{
+		return to_device(aContext, aUnits, aValue);
+	}
+
+	point to_device_units(const i_units_context& aContext, units aUnits, const point& aValue)
+	{
+		return to_device(aContext, aUnits, aValue);
+	}
+
+	rect to_device_units(const i_units_context& aContext, units aUnits, const rect& aValue)
+	{
+		return to_device(aContext, aUnits, aValue);
+	}
+
+	margins to_device_units(const i_units_context& aContext, units aUnits, const margins& aValue)
+	{
+		return to_device(aContext, aUnits, aValue);
+	}
+
+	vector2 to_device_units(const i_units_context& aContext, units aUnits, const size& aExtents, const vector2& aValue)
+	{
+		return to_device(aContext, aUnits, aExtents, aValue);
+	}
+
+	dimension to_device_units(const i_units_context& aContext, units aUnits, const size& aExtents, dimension aValue)
+	{
+		return to_device(aContext, aUnits, aExtents, aValue);
+	}
+
+	delta to_device_units(const i_units_context& aContext, units aUnits, const size& aExtents, const delta& aValue)
+	{
+		return to_device(aContext, aUnits, aExtents, aValue);
+	}
+
+	size to_device_units(const i_units_context& aContext, units aUnits, const size& aExtents, const size& aValue)
+	{
+		return to_device(aContext, aUnits, aExtents, aValue);
+	}
+
+	point to_device_units(const i_units_context& aContext, units aUnits, const size& aExtents, const point& aValue)
+	{
+		return to_device(aContext, aUnits, aExtents, aValue);
+	}
+
+	rect to_device_units(const i_units_context& aContext, units aUnits, const size& aExtents, const rect& aValue)
+	{
+		return to_device(aContext, aUnits, aExtents, aValue);
+	}
+
+	vector2 from_device_units(const i_units_context& aContext, units aUnits, const vector2& aValue)
+	{
+		return from_device(aContext, aUnits, aValue);
+	}
+
+	dimension from_device_units(const i_units_context& aContext, units aUnits, dimension aValue)
+	{
+		return from_device(aContext, aUnits, aValue);
+	}
+
+	delta from_device_units(const i_units_context& aContext, units aUnits, const delta& aValue)
+	{
+		return from_device(aContext, aUnits, aValue);
+	}
+
+	size from_device_units(const i_units_context& aContext, units aUnits, const size& aValue)
+	{
+		return from_device(aContext, aUnits, aValue);
+	}
+
+	point from_device_units(const i_units_context& aContext, units aUnits, const point& aValue)
+	{
+		return from_device(aContext, aUnits, aValue);
+	}
+
+	rect from_device_units(const i_units_context& aContext, units aUnits, const rect& aValue)
+	{
+		return from_device(aContext, aUnits, aValue);
+	}
+
+	margins from_device_units(const i_units_context& aContext, units aUnits, const margins& aValue)
+	{
+		return from_device(aContext, aUnits, aValue);
+	}
+
+	vector2 from_device_units(const i_units_context& aContext, units aUnits, const size& aExtents, const vector2& aValue)
+	{
+		return from_device(aContext, aUnits, aExtents, aValue);
+	}
+
+	dimension from_device_units(const i_units_context& aContext, units aUnits, const size& aExtents, dimension aValue)
+	{
+		return from_device(aContext, aUnits, aExtents, aValue);
+	}
+
+	delta from_device_units(const i_units_context& aContext, units aUnits, const size& aExtents, const delta& aValue)
+	{
+		return from_device(aContext, aUnits, aExtents, aValue);
+	}
+
+	size from_device_units(const i_units_context& aContext, units aUnits, const size& aExtents, const size& aValue)
+	{
+		return from_device(aContext, aUnits, aExtents, aValue);
+	}
+
+	point from_device_units(const i_units_context& aContext, units aUnits, const size& aExtents, const point& aValue)
+	{
+		return from_device(aContext, aUnits, aExtents, aValue);
+	}
+
+	rect from_device_units(const i_units_context& aContext, units aUnits, const size& aExtents, const rect& aValue)
+	{
+		return from_device(aContext, aUnits, aExtents, aValue);
+	}
+
 	units_converter::units_converter(const i_units_context& aContext) :
 		iContext(aContext), iSavedUnits(aContext.units())
 	{
@@ -86,329 +386,131 @@ namespace neogfx
 
 	vector2 units_converter::to_device_units(const vector2& aValue) const
 	{
-		return iContext.device_metrics_available() ? to_device_units(iContext.device_metrics().extents(), aValue) : 
-			units() == units::Pixels ? aValue : throw device_metrics_unavailable();
+		return neogfx::to_device_units(iContext, units(), aValue);
 	}
 
 	dimension units_converter::to_device_units(dimension aValue) const
 	{
-		return iContext.device_metrics_available() ? to_device_units(iContext.device_metrics().extents(), size{ aValue, 0 }).cx : 
-			units() == units::Pixels ? aValue : throw device_metrics_unavailable();
+		return neogfx::to_device_units(iContext, units(), aValue);
 	}
 
 	delta units_converter::to_device_units(const delta& aValue) const
 	{
-		return iContext.device_metrics_available() ? to_device_units(iContext.device_metrics().extents(), aValue) : 
-			units() == units::Pixels ? aValue : throw device_metrics_unavailable();
+		return neogfx::to_device_units(iContext, units(), aValue);
 	}
 
 	size units_converter::to_device_units(const size& aValue) const
 	{
-		return iContext.device_metrics_available() ? to_device_units(iContext.device_metrics().extents(), aValue) : 
-			units() == units::Pixels ? aValue : throw device_metrics_unavailable();
+		return neogfx::to_device_units(iContext, units(), aValue);
 	}
 
 	point units_converter::to_device_units(const point& aValue) const
 	{
-		return iContext.device_metrics_available() ? to_device_units(iContext.device_metrics().extents(), aValue) : 
-			units() == units::Pixels ? aValue : throw device_metrics_unavailable();
+		return neogfx::to_device_units(iContext, units(), aValue);
 	}
 
 	rect units_converter::to_device_units(const rect& aValue) const
 	{
-		return iContext.device_metrics_available() ? to_device_units(iContext.device_metrics().extents(), aValue) : 
-			units() == units::Pixels ? aValue : throw device_metrics_unavailable();
+		return neogfx::to_device_units(iContext, units(), aValue);
 	}
 
 	margins units_converter::to_device_units(const margins& aValue) const
 	{
-		return iContext.device_metrics_available() ? margins{
-			to_device_units(iContext.device_metrics().extents(), size{ aValue.left, 0 }).cx,
-			to_device_units(iContext.device_metrics().extents(), size{ 0, aValue.top }).cy,
-			to_device_units(iContext.device_metrics().extents(), size{ aValue.right, 0 }).cx,
-			to_device_units(iContext.device_metrics().extents(), size{ 0, aValue.bottom }).cy } :
-			units() == units::Pixels ? aValue : throw device_metrics_unavailable();
+		return neogfx::to_device_units(iContext, units(), aValue);
 	}
 
 	vector2 units_converter::to_device_units(const size& aExtents, const vector2& aValue) const
 	{
-		if (!iContext.device_metrics_available() && units() != units::Pixels && units() != units::Percentage)
-			throw device_metrics_unavailable();
-		switch (units())
-		{
-		default:
-		case units::Pixels:
-			return aValue;
-		case units::Points:
-			return aValue * vector2((1.0 / 72.0) * static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), (1.0 / 72.0) * static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Picas:
-			return aValue * vector2((1.0 / 6.0) * static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), (1.0 / 6.0) * static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Ems:
-			return aValue * vector2(1.0 * static_cast<dimension>(iContext.device_metrics().em_size()) * static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), 1.0 * static_cast<dimension>(iContext.device_metrics().em_size()) * static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Millimetres:
-			return aValue * vector2((1.0 / 25.4) * static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), (1.0 / 25.4) * static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Centimetres:
-			return aValue * vector2((1.0 / 2.54) * static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), (1.0 / 2.54) * static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Inches:
-			return aValue * vector2(1.0 * static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), 1.0 * static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Percentage:
-			return vector2(aExtents.cx, aExtents.cy) * vector2(aValue[0] / 100.0, aValue[1] / 100.0);
-		}
+		return neogfx::to_device_units(iContext, units(), aExtents, aValue);
 	}
 
 	dimension units_converter::to_device_units(const size& aExtents, dimension aValue) const
 	{
-		if (!iContext.device_metrics_available() && units() != units::Pixels && units() != units::Percentage)
-			throw device_metrics_unavailable();
-		return to_device_units(aExtents, size{ aValue, 0 }).cx;
+		return neogfx::to_device_units(iContext, units(), aExtents, aValue);
 	}
 
 	delta units_converter::to_device_units(const size& aExtents, const delta& aValue) const
 	{
-		if (!iContext.device_metrics_available() && units() != units::Pixels && units() != units::Percentage)
-			throw device_metrics_unavailable();
-		switch (units())
-		{
-		default:
-		case units::Pixels:
-			return aValue;
-		case units::Points:
-			return aValue * delta((1.0/72.0) * static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), (1.0/72.0) * static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Picas:
-			return aValue * delta((1.0/6.0) * static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), (1.0/6.0) * static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Ems:
-			return aValue * delta(1.0 * static_cast<dimension>(iContext.device_metrics().em_size()) * static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), 1.0 * static_cast<dimension>(iContext.device_metrics().em_size()) * static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Millimetres:
-			return aValue * delta((1.0/25.4) * static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), (1.0/25.4) * static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Centimetres:
-			return aValue * delta((1.0/2.54) * static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), (1.0/2.54) * static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Inches:
-			return aValue * delta(1.0 * static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), 1.0 * static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Percentage:
-			return delta(aExtents.to_delta()) * delta(aValue.dx / 100.0, aValue.dy / 100.0);
-		}
+		return neogfx::to_device_units(iContext, units(), aExtents, aValue);
 	}
 
 	size units_converter::to_device_units(const size& aExtents, const size& aValue) const
 	{
-		if (!iContext.device_metrics_available() && units() != units::Pixels && units() != units::Percentage)
-			throw device_metrics_unavailable();
-		switch (units())
-		{
-		default:
-		case units::Pixels:
-			return aValue;
-		case units::Points:
-			return aValue * size((1.0/72.0) * static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), (1.0/72.0) * static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Picas:
-			return aValue * size((1.0/6.0) * static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), (1.0/6.0) * static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Ems:
-			return aValue * size(1.0 * static_cast<dimension>(iContext.device_metrics().em_size()) * static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), 1.0 * static_cast<dimension>(iContext.device_metrics().em_size()) * static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Millimetres:
-			return aValue * size((1.0/25.4) * static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), (1.0/25.4) * static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Centimetres:
-			return aValue * size((1.0/2.54) * static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), (1.0/2.54) * static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Inches:
-			return aValue * size(1.0 * static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), 1.0 * static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Percentage:
-			return size(aExtents) * size(aValue.cx / 100.0, aValue.cy / 100.0);
-		}
+		return neogfx::to_device_units(iContext, units(), aExtents, aValue);
 	}
 
 	point units_converter::to_device_units(const size& aExtents, const point& aValue) const
 	{
-		if (!iContext.device_metrics_available() && units() != units::Pixels && units() != units::Percentage)
-			throw device_metrics_unavailable();
-		switch (units())
-		{
-		default:
-		case units::Pixels:
-			return aValue;
-		case units::Points:
-			return aValue * point((1.0/72.0) * static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), (1.0/72.0) * static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Picas:
-			return aValue * point((1.0/6.0) * static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), (1.0/6.0) * static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Ems:
-			return aValue * point(1.0 * static_cast<dimension>(iContext.device_metrics().em_size()) * static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), 1.0 * static_cast<dimension>(iContext.device_metrics().em_size()) * static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Millimetres:
-			return aValue * point((1.0/25.4) * static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), (1.0/25.4) * static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Centimetres:
-			return aValue * point((1.0/2.54) * static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), (1.0/2.54) * static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Inches:
-			return aValue * point(1.0 * static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), 1.0 * static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Percentage:
-			return point(size(aExtents)) * point(aValue.x / 100.0, aValue.y / 100.0);
-		}
+		return neogfx::to_device_units(iContext, units(), aExtents, aValue);
 	}
 
 	rect units_converter::to_device_units(const size& aExtents, const rect& aValue) const
 	{
-		if (!iContext.device_metrics_available() && units() != units::Pixels && units() != units::Percentage)
-			throw device_metrics_unavailable();
-		return rect(to_device_units(aExtents, aValue.position()), to_device_units(aExtents, aValue.extents()));
+		return neogfx::to_device_units(iContext, units(), aExtents, aValue);
 	}
 
 	vector2 units_converter::from_device_units(const vector2& aValue) const
 	{
-		return iContext.device_metrics_available() ? from_device_units(iContext.device_metrics().extents(), aValue) :
-			units() == units::Pixels ? aValue : throw device_metrics_unavailable();
+		return neogfx::from_device_units(iContext, units(), aValue);
 	}
 
 	dimension units_converter::from_device_units(dimension aValue) const
 	{
-		return iContext.device_metrics_available() ? from_device_units(iContext.device_metrics().extents(), size{ aValue, 0 }).cx :
-			units() == units::Pixels ? aValue : throw device_metrics_unavailable();
+		return neogfx::from_device_units(iContext, units(), aValue);
 	}
 
 	delta units_converter::from_device_units(const delta& aValue) const
 	{
-		return iContext.device_metrics_available() ? from_device_units(iContext.device_metrics().extents(), aValue) :
-			units() == units::Pixels ? aValue : throw device_metrics_unavailable();
+		return neogfx::from_device_units(iContext, units(), aValue);
 	}
 
 	size units_converter::from_device_units(const size& aValue) const
 	{
-		return iContext.device_metrics_available() ? from_device_units(iContext.device_metrics().extents(), aValue) :
-			units() == units::Pixels ? aValue : throw device_metrics_unavailable();
+		return neogfx::from_device_units(iContext, units(), aValue);
 	}
 
 	point units_converter::from_device_units(const point& aValue) const
 	{
-		return iContext.device_metrics_available() ? from_device_units(iContext.device_metrics().extents(), aValue) :
-			units() == units::Pixels ? aValue : throw device_metrics_unavailable();
+		return neogfx::from_device_units(iContext, units(), aValue);
 	}
 
 	rect units_converter::from_device_units(const rect& aValue) const
 	{
-		return iContext.device_metrics_available() ? from_device_units(iContext.device_metrics().extents(), aValue) :
-			units() == units::Pixels ? aValue : throw device_metrics_unavailable();
+		return neogfx::from_device_units(iContext, units(), aValue);
 	}
 
 	margins units_converter::from_device_units(const margins& aValue) const
 	{
-		return iContext.device_metrics_available() ? margins{
-			from_device_units(iContext.device_metrics().extents(), size{ aValue.left, 0 }).cx,
-			from_device_units(iContext.device_metrics().extents(), size{ 0, aValue.top }).cy,
-			from_device_units(iContext.device_metrics().extents(), size{ aValue.right, 0 }).cx,
-			from_device_units(iContext.device_metrics().extents(), size{ 0, aValue.bottom }).cy } :
-			units() == units::Pixels ? aValue : throw device_metrics_unavailable();
+		return neogfx::from_device_units(iContext, units(), aValue);
 	}
 
 	vector2 units_converter::from_device_units(const size& aExtents, const vector2& aValue) const
 	{
-		if (!iContext.device_metrics_available() && units() != units::Pixels && units() != units::Percentage)
-			throw device_metrics_unavailable();
-		switch (units())
-		{
-		default:
-		case units::Pixels:
-			return aValue;
-		case units::Points:
-			return vector2(aValue) * vector2(72.0 / static_cast<scalar>(iContext.device_metrics().horizontal_dpi()), 72.0 / static_cast<scalar>(iContext.device_metrics().vertical_dpi()));
-		case units::Picas:
-			return vector2(aValue) * vector2(6.0 / static_cast<scalar>(iContext.device_metrics().horizontal_dpi()), 6.0 / static_cast<scalar>(iContext.device_metrics().vertical_dpi()));
-		case units::Ems:
-			return vector2(aValue) * vector2((1.0 / static_cast<scalar>(iContext.device_metrics().em_size())) / static_cast<scalar>(iContext.device_metrics().horizontal_dpi()), (1.0 / static_cast<dimension>(iContext.device_metrics().em_size())) / static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Millimetres:
-			return vector2(aValue) * vector2(25.4 / static_cast<scalar>(iContext.device_metrics().horizontal_dpi()), 25.4 / static_cast<scalar>(iContext.device_metrics().vertical_dpi()));
-		case units::Centimetres:
-			return vector2(aValue) * vector2(2.54 / static_cast<scalar>(iContext.device_metrics().horizontal_dpi()), 2.54 / static_cast<scalar>(iContext.device_metrics().vertical_dpi()));
-		case units::Inches:
-			return vector2(aValue) * vector2(1.0 / static_cast<scalar>(iContext.device_metrics().horizontal_dpi()), 1.0 / static_cast<scalar>(iContext.device_metrics().vertical_dpi()));
-		case units::Percentage:
-			return vector2(aValue) / vector2(aExtents.cx, aExtents.cy) * vector2(100.0, 100.0);
-		}
+		return neogfx::from_device_units(iContext, units(), aExtents, aValue);
 	}
 
 	dimension units_converter::from_device_units(const size& aExtents, dimension aValue) const
 	{
-		if (!iContext.device_metrics_available() && units() != units::Pixels && units() != units::Percentage)
-			throw device_metrics_unavailable();
-		return from_device_units(aExtents, size{aValue, 0.0}).cx;
+		return neogfx::from_device_units(iContext, units(), aExtents, aValue);
 	}
 
 	delta units_converter::from_device_units(const size& aExtents, const delta& aValue) const
 	{
-		if (!iContext.device_metrics_available() && units() != units::Pixels && units() != units::Percentage)
-			throw device_metrics_unavailable();
-		switch (units())
-		{
-		default:
-		case units::Pixels:
-			return aValue;
-		case units::Points:
-			return delta(aValue) * delta(72.0 / static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), 72.0 / static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Picas:
-			return delta(aValue) * delta(6.0 / static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), 6.0 / static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Ems:
-			return delta(aValue) * delta((1.0 / static_cast<dimension>(iContext.device_metrics().em_size())) / static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), (1.0 / static_cast<dimension>(iContext.device_metrics().em_size())) / static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Millimetres:
-			return delta(aValue) * delta(25.4 / static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), 25.4 / static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Centimetres:
-			return delta(aValue) * delta(2.54 / static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), 2.54 / static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Inches:
-			return delta(aValue) * delta(1.0 / static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), 1.0 / static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Percentage:
-			return delta(aValue) / delta(aExtents.to_delta()) * delta(100.0, 100.0);
-		}
+		return neogfx::from_device_units(iContext, units(), aExtents, aValue);
 	}
 
 	size units_converter::from_device_units(const size& aExtents, const size& aValue) const
 	{
-		if (!iContext.device_metrics_available() && units() != units::Pixels && units() != units::Percentage)
-			throw device_metrics_unavailable();
-		switch (units())
-		{
-		default:
-		case units::Pixels:
-			return aValue;
-		case units::Points:
-			return size(aValue) * size(72.0 / static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), 72.0 / static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Picas:
-			return size(aValue) * size(6.0 / static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), 6.0 / static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Ems:
-			return size(aValue) * size((1.0 / static_cast<dimension>(iContext.device_metrics().em_size())) / static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), (1.0 / static_cast<dimension>(iContext.device_metrics().em_size())) / static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Millimetres:
-			return size(aValue) * size(25.4 / static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), 25.4 / static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Centimetres:
-			return size(aValue) * size(2.54 / static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), 2.54 / static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Inches:
-			return size(aValue) * size(1.0 / static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), 1.0 / static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Percentage:
-			return size(aValue) / size(aExtents) * size(100.0, 100.0);
-		}
+		return neogfx::from_device_units(iContext, units(), aExtents, aValue);
 	}
 
 	point units_converter::from_device_units(const size& aExtents, const point& aValue) const
 	{
-		if (!iContext.device_metrics_available() && units() != units::Pixels && units() != units::Percentage)
-			throw device_metrics_unavailable();
-		switch (units())
-		{
-		default:
-		case units::Pixels:
-			return aValue;
-		case units::Points:
-			return point(aValue) * point(72.0 / static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), 72.0 / static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Picas:
-			return point(aValue) * point(6.0 / static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), 6.0 / static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Ems:
-			return point(aValue) * point((1.0 / static_cast<dimension>(iContext.device_metrics().em_size())) / static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), (1.0 / static_cast<dimension>(iContext.device_metrics().em_size())) / static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Millimetres:
-			return point(aValue) * point(25.4 / static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), 25.4 / static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Centimetres:
-			return point(aValue) * point(2.54 / static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), 2.54 / static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Inches:
-			return point(aValue) * point(1.0 / static_cast<dimension>(iContext.device_metrics().horizontal_dpi()), 1.0 / static_cast<dimension>(iContext.device_metrics().vertical_dpi()));
-		case units::Percentage:
-			return point(aValue) / point(aExtents) * point(100.0, 100.0);
-		}
+		return neogfx::from_device_units(iContext, units(), aExtents, aValue);
 	}
 
 	rect units_converter::from_device_units(const size& aExtents, const rect& aValue) const
 	{
-		if (!iContext.device_metrics_available() && units() != units::Pixels && units() != units::Percentage)
-			throw device_metrics_unavailable();
-		return rect(from_device_units(aExtents, aValue.position()), from_device_units(aExtents, aValue.extents()));
+		return neogfx::from_device_units(iContext, units(), aExtents, aValue);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,319 @@
+// instanced_sprites.cpp
+/*
+  neogfx C++ GUI Library
+  Copyright (c) 2018 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <neogfx/neogfx.hpp>
+#include <boost/math/constants/constants.hpp>
+#include <neogfx/game/instanced_sprites.hpp>
+
+namespace neogfx
+{
+	instanced_sprites::instanced_sprites()
+	{
+	}
+
+	std::size_t instanced_sprites::count() const
+	{
+		return iPositions.size();
+	}
+
+	void instanced_sprites::reserve(std::size_t aCapacity)
+	{
+		iPositions.reserve(aCapacity);
+		iVelocities.reserve(aCapacity);
+		iAccelerations.reserve(aCapacity);
+		iAngles.reserve(aCapacity);
+		iSpins.reserve(aCapacity);
+		iMasses.reserve(aCapacity);
+		iExtents.reserve(aCapacity);
+		iTextureSources.reserve(aCapacity);
+		iInstances.reserve(aCapacity);
+	}
+
+	instanced_sprites::instance_id instanced_sprites::create(const i_texture& aTexture, const optional_rect& aTextureRect)
+	{
+		return create(aTexture, aTextureRect, (aTextureRect != boost::none ? aTextureRect->extents() : aTexture.extents()).to_vec2());
+	}
+
+	instanced_sprites::instance_id instanced_sprites::create(const i_texture& aTexture, const optional_rect& aTextureRect, const vec2& aExtents)
+	{
+		instance_id newInstance;
+		if (!iFreeInstances.empty())
+		{
+			newInstance = iFreeInstances.back();
+			iFreeInstances.pop_back();
+		}
+		else
+		{
+			newInstance = static_cast<instance_id>(iSlots.size());
+			iSlots.push_back(NoSlot);
+		}
+		iSlots[newInstance] = static_cast<uint32_t>(iPositions.size());
+		iInstances.push_back(newInstance);
+		iPositions.push_back(vec3{});
+		iVelocities.push_back(vec3{});
+		iAccelerations.push_back(vec3{});
+		iAngles.push_back(0.0);
+		iSpins.push_back(0.0);
+		iMasses.push_back(0.0);
+		iExtents.push_back(aExtents);
+		iTextureSources.push_back(texture_source_index(aTexture, aTextureRect));
+		return newInstance;
+	}
+
+	bool instanced_sprites::alive(instance_id aInstance) const
+	{
+		return aInstance < iSlots.size() && iSlots[aInstance] != NoSlot;
+	}
+
+	void instanced_sprites::kill(instance_id aInstance)
+	{
+		// swap the last instance into the vacated slot so that the arrays remain contiguous
+		auto const vacated = slot(aInstance);
+		auto const last = static_cast<uint32_t>(iPositions.size() - 1);
+		if (vacated != last)
+		{
+			iPositions[vacated] = iPositions[last];
+			iVelocities[vacated] = iVelocities[last];
+			iAccelerations[vacated] = iAccelerations[last];
+			iAngles[vacated] = iAngles[last];
+			iSpins[vacated] = iSpins[last];
+			iMasses[vacated] = iMasses[last];
+			iExtents[vacated] = iExtents[last];
+			iTextureSources[vacated] = iTextureSources[last];
+			iInstances[vacated] = iInstances[last];
+			iSlots[iInstances[vacated]] = vacated;
+		}
+		iPositions.pop_back();
+		iVelocities.pop_back();
+		iAccelerations.pop_back();
+		iAngles.pop_back();
+		iSpins.pop_back();
+		iMasses.pop_back();
+		iExtents.pop_back();
+		iTextureSources.pop_back();
+		iInstances.pop_back();
+		iSlots[aInstance] = NoSlot;
+		iFreeInstances.push_back(aInstance);
+	}
+
+	void instanced_sprites::clear()
+	{
+		iPositions.clear();
+		iVelocities.clear();
+		iAccelerations.clear();
+		iAngles.clear();
+		iSpins.clear();
+		iMasses.clear();
+		iExtents.clear();
+		iTextureSources.clear();
+		iInstances.clear();
+		iSlots.clear();
+		iFreeInstances.clear();
+		iTextures.clear();
+	}
+
+	const vec3& instanced_sprites::position(instance_id aInstance) const
+	{
+		return iPositions[slot(aInstance)];
+	}
+
+	void instanced_sprites::set_position(instance_id aInstance, const vec3& aPosition)
+	{
+		iPositions[slot(aInstance)] = aPosition;
+	}
+
+	const vec3& instanced_sprites::velocity(instance_id aInstance) const
+	{
+		return iVelocities[slot(aInstance)];
+	}
+
+	void instanced_sprites::set_velocity(instance_id aInstance, const vec3& aVelocity)
+	{
+		iVelocities[slot(aInstance)] = aVelocity;
+	}
+
+	const vec3& instanced_sprites::acceleration(instance_id aInstance) const
+	{
+		return iAccelerations[slot(aInstance)];
+	}
+
+	void instanced_sprites::set_acceleration(instance_id aInstance, const vec3& aAcceleration)
+	{
+		iAccelerations[slot(aInstance)] = aAcceleration;
+	}
+
+	scalar instanced_sprites::angle_radians(instance_id aInstance) const
+	{
+		return iAngles[slot(aInstance)];
+	}
+
+	void instanced_sprites::set_angle_radians(instance_id aInstance, scalar aAngle)
+	{
+		iAngles[slot(aInstance)] = aAngle;
+	}
+
+	scalar instanced_sprites::spin_radians(instance_id aInstance) const
+	{
+		return iSpins[slot(aInstance)];
+	}
+
+	void instanced_sprites::set_spin_radians(instance_id aInstance, scalar aSpin)
+	{
+		iSpins[slot(aInstance)] = aSpin;
+	}
+
+	scalar instanced_sprites::mass(instance_id aInstance) const
+	{
+		return iMasses[slot(aInstance)];
+	}
+
+	void instanced_sprites::set_mass(instance_id aInstance, scalar aMass)
+	{
+		iMasses[slot(aInstance)] = aMass;
+	}
+
+	const vec2& instanced_sprites::extents(instance_id aInstance) const
+	{
+		return iExtents[slot(aInstance)];
+	}
+
+	void instanced_sprites::set_extents(instance_id aInstance, const vec2& aExtents)
+	{
+		iExtents[slot(aInstance)] = aExtents;
+	}
+
+	const std::vector<vec3>& instanced_sprites::positions() const
+	{
+		return iPositions;
+	}
+
+	const std::vector<vec3>& instanced_sprites::velocities() const
+	{
+		return iVelocities;
+	}
+
+	const std::vector<scalar>& instanced_sprites::angles() const
+	{
+		return iAngles;
+	}
+
+	bool instanced_sprites::update(time_interval aNow, const optional_vec3& aUniformGravity)
+	{
+		if (iTimeOfLastUpdate == boost::none)
+		{
+			iTimeOfLastUpdate = aNow;
+			return false;
+		}
+		const scalar elapsed = aNow - *iTimeOfLastUpdate;
+		iTimeOfLastUpdate = aNow;
+		if (elapsed == 0.0 || iPositions.empty())
+			return false;
+		const vec3 gravity = (aUniformGravity != boost::none ? *aUniformGravity : vec3{});
+		const scalar twoPi = 2.0 * boost::math::constants::pi<scalar>();
+		const std::size_t n = iPositions.size();
+		// same integration as physical_object::apply_physics (acceleration is relative to orientation)
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			const scalar c = std::cos(iAngles[i]);
+			const scalar s = std::sin(iAngles[i]);
+			const vec3& a = iAccelerations[i];
+			vec3 totalAcceleration{ c * a.x + s * a.y, -s * a.x + c * a.y, a.z };
+			if (iMasses[i] != 0.0)
+				totalAcceleration += gravity;
+			const vec3 u = iVelocities[i];
+			const vec3 v = u + totalAcceleration * elapsed;
+			iPositions[i] += (u + v) * (elapsed / 2.0);
+			iVelocities[i] = v;
+		}
+		for (std::size_t i = 0; i < n; ++i)
+			iAngles[i] = std::fmod(iAngles[i] + iSpins[i] * elapsed, twoPi);
+		return true;
+	}
+
+	void instanced_sprites::take_snapshot(mesh& aMesh) const
+	{
+		if (aMesh.vertices() == nullptr)
+			aMesh.set_vertices(std::make_shared<vertex_list>());
+		if (aMesh.textures() == nullptr)
+			aMesh.set_textures(std::make_shared<texture_list>());
+		if (aMesh.faces().empty())
+			aMesh.set_faces(face_list{ std::make_shared<face_list::container>() });
+		auto& vertices = *aMesh.vertices();
+		auto faceList = aMesh.faces();
+		auto& faces = faceList.faces();
+		*aMesh.textures() = iTextures;
+		const std::size_t n = iPositions.size();
+		vertices.resize(n * 4);
+		faces.resize(n * 2);
+		// faces are emitted grouped by native texture (a counting sort over the texture sources) so that the renderer
+		// binds each texture once per frame without having to sort the faces itself
+		std::vector<std::size_t> textureGroups(iTextures.size());
+		std::vector<std::size_t> groupOffsets(iTextures.size() + 1);
+		for (texture_index t = 0; t < iTextures.size(); ++t)
+		{
+			textureGroups[t] = t;
+			for (texture_index other = 0; other < t; ++other)
+				if (iTextures[other].first->native_texture() == iTextures[t].first->native_texture())
+				{
+					textureGroups[t] = textureGroups[other];
+					break;
+				}
+		}
+		for (std::size_t i = 0; i < n; ++i)
+			++groupOffsets[textureGroups[iTextureSources[i]] + 1];
+		for (std::size_t g = 1; g < groupOffsets.size(); ++g)
+			groupOffsets[g] += groupOffsets[g - 1];
+		static const vec2 sCorners[] = { vec2{ -0.5, -0.5 }, vec2{ 0.5, -0.5 }, vec2{ 0.5, 0.5 }, vec2{ -0.5, 0.5 } };
+		static const vec2 sTextureCoordinates[] = { vec2{ 0.0, 0.0 }, vec2{ 1.0, 0.0 }, vec2{ 1.0, 1.0 }, vec2{ 0.0, 1.0 } };
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			// same rotation convention as sprite::transformation_matrix
+			const scalar c = std::cos(iAngles[i]);
+			const scalar s = std::sin(iAngles[i]);
+			const vec3& p = iPositions[i];
+			const vec2& e = iExtents[i];
+			for (std::size_t corner = 0; corner < 4; ++corner)
+			{
+				const scalar x = sCorners[corner].x * e.x;
+				const scalar y = sCorners[corner].y * e.y;
+				vertices[i * 4 + corner] = vertex{ vec3{ p.x + c * x + s * y, p.y - s * x + c * y, p.z }, sTextureCoordinates[corner] };
+			}
+			const vertex_index first = i * 4;
+			const std::size_t quad = groupOffsets[textureGroups[iTextureSources[i]]]++;
+			faces[quad * 2] = face{ triangle{ first + 0, first + 1, first + 2 }, iTextureSources[i] };
+			faces[quad * 2 + 1] = face{ triangle{ first + 0, first + 3, first + 2 }, iTextureSources[i] };
+		}
+	}
+
+	uint32_t instanced_sprites::slot(instance_id aInstance) const
+	{
+		if (!alive(aInstance))
+			throw bad_instance();
+		return iSlots[aInstance];
+	}
+
+	texture_index instanced_sprites::texture_source_index(const i_texture& aTexture, const optional_rect& aTextureRect)
+	{
+		for (texture_index i = 0; i < iTextures.size(); ++i)
+			if (iTextures[i].first->native_texture() == aTexture.native_texture() && iTextures[i].second == aTextureRect)
+				return i;
+		iTextures.push_back(neogfx::texture_source{ to_texture_pointer(aTexture), aTextureRect });
+		return iTextures.size() - 1;
+	}
+}
@@ -504,6 +504,45 @@ namespace neogfx
 			aGraphicsContext.fill_shape(*this, to_brush(*current_frame().colour()));
 	}
 
+	void shape::take_snapshot(shape_snapshot& aSnapshot) const
+	{
+		aSnapshot.position = position();
+		aSnapshot.boundingBox = bounding_box_2d();
+		if (aSnapshot.mesh.vertices() == nullptr)
+			aSnapshot.mesh.set_vertices(std::make_shared<vertex_list>());
+		*aSnapshot.mesh.vertices() = transformed_vertices();
+		aSnapshot.mesh.set_faces(faces());
+		if (frame_count() > 0)
+		{
+			aSnapshot.mesh.set_textures(current_frame().textures());
+			aSnapshot.colour = current_frame().colour();
+		}
+		else
+		{
+			aSnapshot.mesh.set_textures(texture_list_pointer{});
+			aSnapshot.colour = boost::none;
+		}
+	}
+
+	void shape::paint(graphics_context& aGraphicsContext, const shape_snapshot& aSnapshot) const
+	{
+		if (aSnapshot.renderOffset != vec3{})
+		{
+			const auto& offset = aSnapshot.renderOffset;
+			paint(aGraphicsContext, aSnapshot, neogfx::mesh{ aSnapshot.mesh, mat44{ { 1.0, 0.0, 0.0, 0.0 },{ 0.0, 1.0, 0.0, 0.0 },{ 0.0, 0.0, 1.0, 0.0 }, { offset.x, offset.y, offset.z, 1.0 } } });
+		}
+		else
+			paint(aGraphicsContext, aSnapshot, aSnapshot.mesh);
+	}
+
+	void shape::paint(graphics_context& aGraphicsContext, const shape_snapshot& aSnapshot, const i_mesh& aMesh) const
+	{
+		if (aMesh.textures() != nullptr)
+			aGraphicsContext.draw_textures(aMesh, aMesh.textures(), aSnapshot.colour && aSnapshot.colour->is<colour>() ? static_variant_cast<colour>(*aSnapshot.colour) : optional_colour{});
+		else if (aSnapshot.colour != boost::none)
+			aGraphicsContext.fill_shape(aMesh, to_brush(*aSnapshot.colour));
+	}
+
 	void shape::clear_vertices_cache()
 	{
 		if (iDefaultVertices != nullptr)
@@ -18,6 +18,8 @@
 */
 
 #include <neogfx/neogfx.hpp>
+#include <list>
+#include <map>
 #include <neolib/vecarray.hpp>
 #include <neogfx/game/shapes.hpp>
 
@@ -31,87 +33,315 @@ namespace neogfx
 		return std::move(result);
 	};
 
-	std::vector<xyz> arc_vertices(const point& aCentre, dimension aRadius, angle aStartAngle, angle aEndAngle, bool aIncludeCentre, uint32_t aArcSegments)
+	namespace
 	{
-		std::vector<xyz> result;
-		angle arc = (aEndAngle != aStartAngle ? aEndAngle - aStartAngle : boost::math::constants::two_pi<angle>());
-		uint32_t arcSegments = aArcSegments;
-		if (arcSegments == 0)
-			arcSegments = static_cast<uint32_t>(std::ceil(std::sqrt(aRadius) * 10.0) * arc / boost::math::constants::two_pi<angle>());
-		angle theta = arc / static_cast<angle>(arcSegments);
-		result.reserve((arcSegments + (aIncludeCentre ? 2 : 1)) * 2);
-		if (aIncludeCentre)
+		typedef std::tuple<angle, angle, uint32_t> unit_arc_key;
+		typedef std::vector<vec2> unit_arc;
+		typedef std::tuple<dimension, dimension, dimension, bool, uint32_t> rounded_rect_key;
+		typedef std::vector<xyz> rounded_rect_outline;
+
+		const std::size_t kMaxCachedShapes = 1024;
+
+		template <typename Key, typename Value>
+		class lru_shape_map
+		{
+		private:
+			typedef std::list<std::pair<Key, Value>> entry_list;
+			typedef std::map<Key, typename entry_list::iterator> entry_index;
+		public:
+			// returns the cached value (now the most recently used) or nullptr if there is none
+			Value* find(const Key& aKey)
+			{
+				auto existing = iIndex.find(aKey);
+				if (existing == iIndex.end())
+					return nullptr;
+				iEntries.splice(iEntries.begin(), iEntries, existing->second);
+				return &existing->second->second;
+			}
+			// inserts an empty value, evicting the least recently used entry if the map is full
+			Value& insert(const Key& aKey)
+			{
+				if (iEntries.size() >= kMaxCachedShapes)
+				{
+					iIndex.erase(iEntries.back().first);
+					iEntries.pop_back();
+				}
+				iEntries.emplace_front(aKey, Value{});
+				iIndex[aKey] = iEntries.begin();
+				return iEntries.front().second;
+			}
+			void clear()
+			{
+				iIndex.clear();
+				iEntries.clear();
+			}
+		private:
+			entry_list iEntries;
+			entry_index iIndex;
+		};
+
+		struct shape_cache
+		{
+			lru_shape_map<unit_arc_key, unit_arc> unitArcs;
+			lru_shape_map<rounded_rect_key, rounded_rect_outline> roundedRects;
+			shape_cache_stats stats;
+		};
+
+		shape_cache& cache()
+		{
+			thread_local shape_cache tCache = {};
+			return tCache;
+		}
+
+		uint32_t arc_segments(dimension aRadius, angle aArc, uint32_t aArcSegments)
+		{
+			if (aArcSegments != 0)
+				return aArcSegments;
+			return static_cast<uint32_t>(std::ceil(std::sqrt(aRadius) * 10.0) * aArc / boost::math::constants::two_pi<angle>());
+		}
+
+		// Returns the vertices of an arc of the unit circle centred on the origin; the result can be scaled and translated
+		// to produce the same arc for any radius and centre.
+		const unit_arc& unit_arc_vertices(angle aStartAngle, angle aArc, uint32_t aArcSegments)
+		{
+			auto& c = cache();
+			unit_arc_key key{ aStartAngle, aArc, aArcSegments };
+			auto existing = c.unitArcs.find(key);
+			if (existing != nullptr)
+			{
+				++c.stats.unitArcHits;
+				return *existing;
+			}
+			++c.stats.unitArcMisses;
+			auto& result = c.unitArcs.insert(key);
+			if (aArcSegments == 0)
+				return result;
+			result.reserve(aArcSegments);
+			angle theta = aArc / static_cast<angle>(aArcSegments);
+			auto cosTheta = std::cos(theta);
+			auto sinTheta = std::sin(theta);
+			coordinate x = std::cos(aStartAngle);
+			coordinate y = std::sin(aStartAngle);
+			for (uint32_t i = 0; i < aArcSegments; ++i)
+			{
+				result.push_back(vec2{ x, y });
+				coordinate t = x;
+				x = cosTheta * x - sinTheta * y;
+				y = sinTheta * t + cosTheta * y;
+			}
+			return result;
+		}
+
+		inline coordinate cross(const xyz& aOrigin, const xyz& aA, const xyz& aB)
+		{
+			return (aA.x - aOrigin.x) * (aB.y - aOrigin.y) - (aA.y - aOrigin.y) * (aB.x - aOrigin.x);
+		}
+
+		bool segments_intersect(const xyz& aP1, const xyz& aP2, const xyz& aQ1, const xyz& aQ2)
+		{
+			auto d1 = cross(aQ1, aQ2, aP1);
+			auto d2 = cross(aQ1, aQ2, aP2);
+			auto d3 = cross(aP1, aP2, aQ1);
+			auto d4 = cross(aP1, aP2, aQ2);
+			return ((d1 > 0.0 && d2 < 0.0) || (d1 < 0.0 && d2 > 0.0)) && ((d3 > 0.0 && d4 < 0.0) || (d3 < 0.0 && d4 > 0.0));
+		}
+
+		bool self_intersecting(const std::vector<xyz>& aPolygon)
+		{
+			const std::size_t n = aPolygon.size();
+			for (std::size_t i = 0; i < n; ++i)
+				for (std::size_t j = i + 2; j < n; ++j)
+				{
+					if (i == 0 && j == n - 1)
+						continue;
+					if (segments_intersect(aPolygon[i], aPolygon[i + 1], aPolygon[j], aPolygon[(j + 1) % n]))
+						return true;
+				}
+			return false;
+		}
+
+		bool point_in_triangle(const xyz& aPoint, const xyz& aA, const xyz& aB, const xyz& aC)
 		{
-			result.push_back(xyz{ aCentre.x, aCentre.y });
+			auto d1 = cross(aA, aB, aPoint);
+			auto d2 = cross(aB, aC, aPoint);
+			auto d3 = cross(aC, aA, aPoint);
+			bool hasNegative = d1 < 0.0 || d2 < 0.0 || d3 < 0.0;
+			bool hasPositive = d1 > 0.0 || d2 > 0.0 || d3 > 0.0;
+			return !(hasNegative && hasPositive);
 		}
-		auto c = std::cos(theta);
-		auto s = std::sin(theta);
-		auto startCoordinate = mat22{ { std::cos(aStartAngle), std::sin(aStartAngle) },{ -std::sin(aStartAngle), std::cos(aStartAngle) } } *
-			vec2{ aRadius, 0.0 };
-		coordinate x = startCoordinate.x;
-		coordinate y = startCoordinate.y;
-		for (uint32_t i = 0; i < arcSegments; ++i)
+
+		void insert_back_arc_vertices(std::vector<xyz>& aResult, const point& aCentre, dimension aRadius, angle aStartAngle, angle aEndAngle, uint32_t aArcSegments)
+		{
+			angle arc = (aEndAngle != aStartAngle ? aEndAngle - aStartAngle : boost::math::constants::two_pi<angle>());
+			for (const auto& v : unit_arc_vertices(aStartAngle, arc, arc_segments(aRadius, arc, aArcSegments)))
+				aResult.push_back(xyz{ v.x * aRadius + aCentre.x, v.y * aRadius + aCentre.y });
+		}
+
+		// Returns the outline of a rounded rectangle whose top left corner is at the origin; the result is translated
+		// to produce the same outline at any position.
+		const rounded_rect_outline& rounded_rect_outline_vertices(const size& aExtents, dimension aRadius, bool aIncludeCentre, uint32_t aArcSegments)
 		{
-			result.push_back(xyz{ x + aCentre.x, y + aCentre.y });
-			coordinate t = x;
-			x = c * x - s * y;
-			y = s * t + c * y;
+			auto& c = cache();
+			rounded_rect_key key{ aExtents.cx, aExtents.cy, aRadius, aIncludeCentre, aArcSegments };
+			auto existing = c.roundedRects.find(key);
+			if (existing != nullptr)
+			{
+				++c.stats.roundedRectHits;
+				return *existing;
+			}
+			++c.stats.roundedRectMisses;
+			auto& vertices = c.roundedRects.insert(key);
+			const rect r{ point{}, aExtents };
+			const uint32_t cornerSegments = arc_segments(aRadius, boost::math::constants::half_pi<angle>(), aArcSegments);
+			vertices.reserve(cornerSegments * 4 + (aIncludeCentre ? 10 : 9));
+			if (aIncludeCentre)
+			{
+				vertices.push_back(xyz{ r.centre().x, r.centre().y });
+			}
+			vertices.push_back(xyz{ (r.top_left() + point{ 0.0, aRadius }).x, (r.top_left() + point{ 0.0, aRadius }).y });
+			insert_back_arc_vertices(vertices, r.top_left() + point{ aRadius, aRadius }, aRadius,
+				boost::math::constants::pi<coordinate>(), boost::math::constants::pi<coordinate>() * 1.5, aArcSegments);
+			vertices.push_back(xyz{ (r.top_left() + point{ aRadius, 0.0 }).x, (r.top_left() + point{ aRadius, 0.0 }).y });
+			vertices.push_back(xyz{ (r.top_right() + point{ -aRadius, 0.0 }).x, (r.top_right() + point{ -aRadius, 0.0 }).y });
+			insert_back_arc_vertices(vertices, r.top_right() + point{ -aRadius, aRadius }, aRadius,
+				boost::math::constants::pi<coordinate>() * 1.5, boost::math::constants::pi<coordinate>() * 2.0, aArcSegments);
+			vertices.push_back(xyz{ (r.top_right() + point{ 0.0, aRadius }).x, (r.top_right() + point{ 0.0, aRadius }).y });
+			vertices.push_back(xyz{ (r.bottom_right() + point{ 0.0, -aRadius }).x, (r.bottom_right() + point{ 0.0, -aRadius }).y });
+			insert_back_arc_vertices(vertices, r.bottom_right() + point{ -aRadius, -aRadius }, aRadius,
+				0.0, boost::math::constants::pi<coordinate>() * 0.5, aArcSegments);
+			vertices.push_back(xyz{ (r.bottom_right() + point{ -aRadius, 0.0 }).x, (r.bottom_right() + point{ -aRadius, 0.0 }).y });
+			vertices.push_back(xyz{ (r.bottom_left() + point{ aRadius, 0.0 }).x, (r.bottom_left() + point{ aRadius, 0.0 }).y });
+			insert_back_arc_vertices(vertices, r.bottom_left() + point{ aRadius, -aRadius }, aRadius,
+				boost::math::constants::pi<coordinate>() * 0.5, boost::math::constants::pi<coordinate>(), aArcSegments);
+			vertices.push_back(xyz{ (r.bottom_left() + point{ 0.0, -aRadius }).x, (r.bottom_left() + point{ 0.0, -aRadius }).y });
+			vertices.push_back(vertices[aIncludeCentre ? 1 : 0]);
+			return vertices;
 		}
-		return result;
 	}
 
-	std::vector<xyz> circle_vertices(const point& aCentre, dimension aRadius, angle aStartAngle, bool aIncludeCentre, uint32_t aArcSegments)
+	const shape_cache_stats& shape_cache_statistics()
 	{
-		auto result = arc_vertices(aCentre, aRadius, aStartAngle, aStartAngle, aIncludeCentre, aArcSegments);
-		result.push_back(result[aIncludeCentre ? 1 : 0]);
-		return result;
+		return cache().stats;
 	}
 
-	std::vector<xyz> rounded_rect_vertices(const rect& aRect, dimension aRadius, bool aIncludeCentre, uint32_t aArcSegments)
+	void clear_shape_cache()
 	{
-		std::vector<xyz> result;
-		auto topLeft = arc_vertices(
-			aRect.top_left() + point{ aRadius, aRadius },
-			aRadius,
-			boost::math::constants::pi<coordinate>(),
-			boost::math::constants::pi<coordinate>() * 1.5,
-			false, aArcSegments);
-		auto topRight = arc_vertices(
-			aRect.top_right() + point{ -aRadius, aRadius },
-			aRadius,
-			boost::math::constants::pi<coordinate>() * 1.5,
-			boost::math::constants::pi<coordinate>() * 2.0,
-			false, aArcSegments);
-		auto bottomRight = arc_vertices(
-			aRect.bottom_right() + point{ -aRadius, -aRadius },
-			aRadius,
-			0.0,
-			boost::math::constants::pi<coordinate>() * 0.5,
-			false, aArcSegments);
-		auto bottomLeft = arc_vertices(
-			aRect.bottom_left() + point{ aRadius, -aRadius },
-			aRadius,
-			boost::math::constants::pi<coordinate>() * 0.5,
-			boost::math::constants::pi<coordinate>(),
-			false, aArcSegments);
-		result.reserve(topLeft.size() + topRight.size() + bottomRight.size() + bottomLeft.size() + (aIncludeCentre ? 9 : 8));
+		auto& c = cache();
+		c.unitArcs.clear();
+		c.roundedRects.clear();
+		c.stats = shape_cache_stats{};
+	}
+
+	void arc_vertices(std::vector<xyz>& aResult, const point& aCentre, dimension aRadius, angle aStartAngle, angle aEndAngle, bool aIncludeCentre, uint32_t aArcSegments)
+	{
+		aResult.clear();
+		angle arc = (aEndAngle != aStartAngle ? aEndAngle - aStartAngle : boost::math::constants::two_pi<angle>());
+		aResult.reserve(arc_segments(aRadius, arc, aArcSegments) + (aIncludeCentre ? 2 : 1));
 		if (aIncludeCentre)
 		{
-			result.push_back(xyz{ aRect.centre().x, aRect.centre().y });
+			aResult.push_back(xyz{ aCentre.x, aCentre.y });
 		}
-		result.insert(result.end(), xyz{ (aRect.top_left() + point{ 0.0, aRadius }).x, (aRect.top_left() + point{ 0.0, aRadius }).y });
-		result.insert(result.end(), topLeft.begin(), topLeft.end());
-		result.insert(result.end(), xyz{ (aRect.top_left() + point{ aRadius, 0.0 }).x, (aRect.top_left() + point{ aRadius, 0.0 }).y });
-		result.insert(result.end(), xyz{ (aRect.top_right() + point{ -aRadius, 0.0 }).x, (aRect.top_right() + point{ -aRadius, 0.0 }).y });
-		result.insert(result.end(), topRight.begin(), topRight.end());
-		result.insert(result.end(), xyz{ (aRect.top_right() + point{ 0.0, aRadius }).x, (aRect.top_right() + point{ 0.0, aRadius }).y });
-		result.insert(result.end(), xyz{ (aRect.bottom_right() + point{ 0.0, -aRadius }).x, (aRect.bottom_right() + point{ 0.0, -aRadius }).y });
-		result.insert(result.end(), bottomRight.begin(), bottomRight.end());
-		result.insert(result.end(), xyz{ (aRect.bottom_right() + point{ -aRadius, 0.0 }).x, (aRect.bottom_right() + point{ -aRadius, 0.0 }).y });
-		result.insert(result.end(), xyz{ (aRect.bottom_left() + point{ aRadius, 0.0 }).x, (aRect.bottom_left() + point{ aRadius, 0.0 }).y });
-		result.insert(result.end(), bottomLeft.begin(), bottomLeft.end());
-		result.insert(result.end(), xyz{ (aRect.bottom_left() + point{ 0.0, -aRadius }).x, (aRect.bottom_left() + point{ 0.0, -aRadius }).y });
-		result.push_back(result[aIncludeCentre ? 1 : 0]);
-		return result;
+		insert_back_arc_vertices(aResult, aCentre, aRadius, aStartAngle, aEndAngle, aArcSegments);
+	}
+
+	void circle_vertices(std::vector<xyz>& aResult, const point& aCentre, dimension aRadius, angle aStartAngle, bool aIncludeCentre, uint32_t aArcSegments)
+	{
+		arc_vertices(aResult, aCentre, aRadius, aStartAngle, aStartAngle, aIncludeCentre, aArcSegments);
+		if (aResult.size() > (aIncludeCentre ? 1u : 0u))
+			aResult.push_back(aResult[aIncludeCentre ? 1 : 0]);
+	}
+
+	bool tessellate_polygon(const std::vector<xyz>& aPolygon, std::vector<xyz>& aTriangles)
+	{
+		std::vector<xyz> polygon{ aPolygon.begin(), aPolygon.end() };
+		if (polygon.size() > 1 && polygon.front() == polygon.back())
+			polygon.pop_back();
+		const std::size_t n = polygon.size();
+		if (n < 3)
+			return true;
+		coordinate area = 0.0;
+		for (std::size_t i = 0; i < n; ++i)
+			area += polygon[i].x * polygon[(i + 1) % n].y - polygon[(i + 1) % n].x * polygon[i].y;
+		if (area == 0.0)
+			return true;
+		const coordinate winding = (area > 0.0 ? 1.0 : -1.0);
+
+		// convex: every turn is in the direction of the winding and the turns sum to a single revolution
+		bool convex = true;
+		angle totalTurn = 0.0;
+		for (std::size_t i = 0; convex && i < n; ++i)
+		{
+			auto const& previous = polygon[(i + n - 1) % n];
+			auto const& current = polygon[i];
+			auto const& next = polygon[(i + 1) % n];
+			if (cross(previous, current, next) * winding < 0.0)
+				convex = false;
+			else
+				totalTurn += std::abs(std::atan2(cross(previous, current, next),
+					(current.x - previous.x) * (next.x - current.x) + (current.y - previous.y) * (next.y - current.y)));
+		}
+		if (convex && totalTurn < boost::math::constants::pi<angle>() * 3.0)
+		{
+			aTriangles.reserve(aTriangles.size() + (n - 2) * 3);
+			for (std::size_t i = 1; i + 1 < n; ++i)
+			{
+				aTriangles.push_back(polygon[0]);
+				aTriangles.push_back(polygon[i]);
+				aTriangles.push_back(polygon[i + 1]);
+			}
+			return true;
+		}
+
+		if (self_intersecting(polygon))
+			return false;
+
+		std::vector<xyz> triangles;
+		triangles.reserve((n - 2) * 3);
+		std::vector<std::size_t> remaining(n);
+		for (std::size_t i = 0; i < n; ++i)
+			remaining[i] = i;
+		std::size_t i = 0;
+		std::size_t sinceLastEar = 0;
+		while (remaining.size() > 3)
+		{
+			if (sinceLastEar++ > remaining.size())
+				return false; // degenerate input; leave it to the caller's fallback
+			const std::size_t count = remaining.size();
+			auto const& a = polygon[remaining[(i + count - 1) % count]];
+			auto const& b = polygon[remaining[i % count]];
+			auto const& c = polygon[remaining[(i + 1) % count]];
+			bool ear = cross(a, b, c) * winding > 0.0;
+			for (std::size_t j = 0; ear && j < count; ++j)
+			{
+				auto const& p = polygon[remaining[j]];
+				if (p != a && p != b && p != c && point_in_triangle(p, a, b, c))
+					ear = false;
+			}
+			if (ear)
+			{
+				triangles.push_back(a);
+				triangles.push_back(b);
+				triangles.push_back(c);
+				remaining.erase(remaining.begin() + (i % count));
+				sinceLastEar = 0;
+			}
+			else
+				++i;
+			i %= remaining.size();
+		}
+		triangles.push_back(polygon[remaining[0]]);
+		triangles.push_back(polygon[remaining[1]]);
+		triangles.push_back(polygon[remaining[2]]);
+		aTriangles.insert(aTriangles.end(), triangles.begin(), triangles.end());
+		return true;
+	}
+
+	void rounded_rect_vertices(std::vector<xyz>& aResult, const rect& aRect, dimension aRadius, bool aIncludeCentre, uint32_t aArcSegments)
+	{
+		auto const& outline = rounded_rect_outline_vertices(aRect.extents(), aRadius, aIncludeCentre, aArcSegments);
+		aResult.clear();
+		aResult.reserve(outline.size());
+		for (const auto& v : outline)
+			aResult.push_back(xyz{ v.x + aRect.x, v.y + aRect.y });
 	}
 }
\ No newline at end of file
@@ -20,6 +20,8 @@
 #include <neogfx/neogfx.hpp>
 #include <numeric>
 #include <chrono>
+#include <cstring>
+#include <unordered_map>
 #include <neolib/raii.hpp>
 #include <neogfx/app/app.hpp>
 #include <neogfx/game/sprite_plane.hpp>
@@ -48,66 +50,120 @@ namespace neogfx
 	};
 
 	sprite_plane::sprite_plane() : 
-		iUpdater{ app::instance(), [this](neolib::callback_timer& aTimer)
-		{
-			aTimer.again();
-			if (snapshot())
-				update();
-		}, 10 },
 		iEnableDynamicUpdate{ false }, 
 		iEnableZSorting{ false }, 
+		iEnableBarnesHut{ false }, 
+		iNeedsSorting{ false }, 
+		iG{ 6.67408e-11 }, 
+		iStepInterval{ chrono::to_flicks(0.010).count() }, 
+		iBackRenderSnapshot{ 0u }, 
+		iReadyRenderSnapshot{ 1u }, 
+		iFrontRenderSnapshot{ 2u }, 
+		iBroadPhaseType{ QuadtreeBroadPhase }, 
+		iBroadPhase{ std::make_unique<broad_phase_collision_tree_2d>() }, 
+		iUpdateTime{ 0ull },
+		iUpdatedSinceLastSnapshot{ false },
+		iTakingSnapshot{ false },
+		iSimulationMode{ RealTimeSimulation },
+		iAccumulator{ 0 },
+		iInterpolationFactor{ 1.0 },
+		iStepCount{ 0ull },
+		iRecording{ false },
+		iRecordingStart{ 0ull },
+		iReplayStart{ 0ull },
+		iReplayPosition{ 0u }
+	{
+		start_updates();
+	}
+
+	sprite_plane::sprite_plane(simulation_mode_e aSimulationMode) :
+		iEnableDynamicUpdate{ false }, 
+		iEnableZSorting{ false }, 
+		iEnableBarnesHut{ false }, 
 		iNeedsSorting{ false }, 
 		iG{ 6.67408e-11 }, 
 		iStepInterval{ chrono::to_flicks(0.010).count() }, 
+		iBackRenderSnapshot{ 0u }, 
+		iReadyRenderSnapshot{ 1u }, 
+		iFrontRenderSnapshot{ 2u }, 
+		iBroadPhaseType{ QuadtreeBroadPhase }, 
+		iBroadPhase{ std::make_unique<broad_phase_collision_tree_2d>() }, 
 		iUpdateTime{ 0ull },
 		iUpdatedSinceLastSnapshot{ false },
 		iTakingSnapshot{ false },
-		iPhysicsThread{ std::make_unique<physics_thread>(*this) }
+		iSimulationMode{ aSimulationMode },
+		iAccumulator{ 0 },
+		iInterpolationFactor{ 1.0 },
+		iStepCount{ 0ull },
+		iRecording{ false },
+		iRecordingStart{ 0ull },
+		iReplayStart{ 0ull },
+		iReplayPosition{ 0u }
 	{
+		if (iSimulationMode != ManualSimulation)
+			start_updates();
 	}
 
 	sprite_plane::sprite_plane(i_widget& aParent) :
 		widget{ aParent }, 
-		iUpdater{ app::instance(), [this](neolib::callback_timer& aTimer)
-		{
-			aTimer.again();
-			if (snapshot())
-				update();
-		}, 10 },
 		iEnableDynamicUpdate{ false }, 
 		iEnableZSorting{ false }, 
-		iNeedsSorting{ false }, iG{ 6.67408e-11 }, 
+		iEnableBarnesHut{ false }, 
+		iNeedsSorting{ false }, 
+		iG{ 6.67408e-11 }, 
 		iStepInterval{ chrono::to_flicks(0.010).count() }, 
+		iBackRenderSnapshot{ 0u }, 
+		iReadyRenderSnapshot{ 1u }, 
+		iFrontRenderSnapshot{ 2u }, 
+		iBroadPhaseType{ QuadtreeBroadPhase }, 
+		iBroadPhase{ std::make_unique<broad_phase_collision_tree_2d>() }, 
 		iUpdateTime{ 0ull },
 		iUpdatedSinceLastSnapshot{ false },
 		iTakingSnapshot{ false },
-		iPhysicsThread{ std::make_unique<physics_thread>(*this) }
+		iSimulationMode{ RealTimeSimulation },
+		iAccumulator{ 0 },
+		iInterpolationFactor{ 1.0 },
+		iStepCount{ 0ull },
+		iRecording{ false },
+		iRecordingStart{ 0ull },
+		iReplayStart{ 0ull },
+		iReplayPosition{ 0u }
 	{
+		start_updates();
 	}
 
 	sprite_plane::sprite_plane(i_layout& aLayout) :
 		widget{ aLayout }, 
-		iUpdater{ app::instance(), [this](neolib::callback_timer& aTimer)
-		{
-			aTimer.again();
-			if (snapshot())
-				update();
-		}, 10 },
 		iEnableDynamicUpdate{ false }, 
 		iEnableZSorting{ false }, 
+		iEnableBarnesHut{ false }, 
 		iNeedsSorting{ false }, 
 		iG{ 6.67408e-11 }, 
 		iStepInterval{ chrono::to_flicks(0.010).count() }, 
+		iBackRenderSnapshot{ 0u }, 
+		iReadyRenderSnapshot{ 1u }, 
+		iFrontRenderSnapshot{ 2u }, 
+		iBroadPhaseType{ QuadtreeBroadPhase }, 
+		iBroadPhase{ std::make_unique<broad_phase_collision_tree_2d>() }, 
 		iUpdateTime{ 0ull },
 		iUpdatedSinceLastSnapshot{ false },
 		iTakingSnapshot{ false },
-		iPhysicsThread{ std::make_unique<physics_thread>(*this) }
+		iSimulationMode{ RealTimeSimulation },
+		iAccumulator{ 0 },
+		iInterpolationFactor{ 1.0 },
+		iStepCount{ 0ull },
+		iRecording{ false },
+		iRecordingStart{ 0ull },
+		iReplayStart{ 0ull },
+		iReplayPosition{ 0u }
 	{
+		start_updates();
 	}
 
 	sprite_plane::~sprite_plane()
 	{
-		iPhysicsThread->abort();
+		if (iPhysicsThread != nullptr)
+			iPhysicsThread->abort();
 	}
 
 	logical_coordinate_system sprite_plane::logical_coordinate_system() const
@@ -119,18 +175,27 @@ namespace neogfx
 
 	void sprite_plane::paint(graphics_context& aGraphicsContext) const
 	{	
-		std::lock_guard<std::recursive_mutex> lock(iUpdateMutex); // todo: remove this lock once snapshot data added
 		aGraphicsContext.clear_depth_buffer();
 		painting_sprites.trigger(aGraphicsContext);
-		sort_shapes();
-		for (auto s : iRenderBuffer)
+		auto& renderSnapshot = current_render_snapshot();
+		scalar alpha = renderSnapshot.interpolationFactor;
+		if (renderSnapshot.clock != boost::none)
 		{
-			if (s->killed())
-				continue;
-			if (s->bounding_box_2d().intersection(client_rect()).empty())
+			// the accumulator has kept filling since the snapshot was published
+			auto const now = std::chrono::duration_cast<chrono::flicks>(std::chrono::high_resolution_clock::now().time_since_epoch());
+			alpha = std::min(1.0, alpha + static_cast<double>((now - *renderSnapshot.clock).count()) / renderSnapshot.stepInterval.count());
+		}
+		for (std::size_t i = 0; i < renderSnapshot.count; ++i)
+		{
+			auto& s = renderSnapshot.shapes[i];
+			// draw between the previous and the current step; the offset is relative to the current position
+			s.renderOffset = (s.position - s.previousPosition) * (alpha - 1.0);
+			if (s.boundingBox != boost::none && rect{ s.boundingBox->position() + point{ s.renderOffset.x, s.renderOffset.y }, s.boundingBox->extents() }.intersection(client_rect()).empty())
 				continue;
-			s->paint(aGraphicsContext);
+			s.shape->paint(aGraphicsContext, s);
 		}
+		if (renderSnapshot.instances.vertices() != nullptr && !renderSnapshot.instances.vertices()->empty())
+			aGraphicsContext.draw_textures(renderSnapshot.instances, renderSnapshot.instances.textures());
 		aGraphicsContext.flush();
 		sprites_painted.trigger(aGraphicsContext);
 	}
@@ -139,11 +204,11 @@ namespace neogfx
 	{
 		if (aButton == mouse_button::Left)
 		{
-			std::vector<i_collidable_object*> picked;
-			if (is_collision_tree_2d())
-				collision_tree_2d().pick(aPosition.to_vec2(), picked);
-			else
-				collision_tree_3d().pick(aPosition.to_vec2(), picked);
+			i_broad_phase::pick_result picked;
+			{
+				std::lock_guard<std::recursive_mutex> lock(iUpdateMutex);
+				iBroadPhase->pick(aPosition.to_vec2(), picked);
+			}
 			for (auto p : picked)
 				object_clicked.trigger(*p);
 		}
@@ -174,6 +239,31 @@ namespace neogfx
 		iEnableZSorting = aEnableZSorting;
 	}
 
+	bool sprite_plane::barnes_hut_enabled() const
+	{
+		std::lock_guard<std::recursive_mutex> lock(iUpdateMutex);
+		return iEnableBarnesHut;
+	}
+
+	void sprite_plane::enable_barnes_hut(bool aEnableBarnesHut)
+	{
+		std::lock_guard<std::recursive_mutex> lock(iUpdateMutex);
+		iEnableBarnesHut = aEnableBarnesHut;
+	}
+
+	scalar sprite_plane::barnes_hut_theta() const
+	{
+		std::lock_guard<std::recursive_mutex> lock(iUpdateMutex);
+		return iGravityTree2d.theta();
+	}
+
+	void sprite_plane::set_barnes_hut_theta(scalar aTheta)
+	{
+		std::lock_guard<std::recursive_mutex> lock(iUpdateMutex);
+		iGravityTree2d.set_theta(aTheta);
+		iGravityTree3d.set_theta(aTheta);
+	}
+
 	void sprite_plane::add_sprite(i_sprite& aObject)
 	{
 		add_object(std::shared_ptr<i_game_object>(std::shared_ptr<i_game_object>(), &aObject));
@@ -309,27 +399,71 @@ namespace neogfx
 		iNewObjects.push_back(aObject);
 	}
 
+	const instanced_sprites& sprite_plane::instanced_sprites() const
+	{
+		return iInstancedSprites;
+	}
+
+	instanced_sprites& sprite_plane::instanced_sprites()
+	{
+		return iInstancedSprites;
+	}
+
+	sprite_plane::broad_phase_e sprite_plane::broad_phase_type() const
+	{
+		return iBroadPhaseType;
+	}
+
+	void sprite_plane::set_broad_phase(broad_phase_e aBroadPhase)
+	{
+		std::lock_guard<std::recursive_mutex> lock(iUpdateMutex);
+		if (iBroadPhaseType == aBroadPhase)
+			return;
+		std::unique_ptr<i_broad_phase> newBroadPhase;
+		switch (aBroadPhase)
+		{
+		case QuadtreeBroadPhase:
+			newBroadPhase = std::make_unique<broad_phase_collision_tree_2d>();
+			break;
+		case OctreeBroadPhase:
+			newBroadPhase = std::make_unique<broad_phase_collision_tree_3d>();
+			break;
+		case SweepAndPruneBroadPhase:
+			newBroadPhase = std::make_unique<broad_phase_sweep_and_prune>();
+			break;
+		}
+		for (auto o : iObjects)
+			if (o->category() == object_category::Sprite || o->category() == object_category::PhysicalObject)
+				newBroadPhase->insert(o->as_physical_object());
+		iBroadPhase = std::move(newBroadPhase);
+		iBroadPhaseType = aBroadPhase;
+	}
+
+	const i_broad_phase& sprite_plane::broad_phase() const
+	{
+		return *iBroadPhase;
+	}
+
+	i_broad_phase& sprite_plane::broad_phase()
+	{
+		return *iBroadPhase;
+	}
+
 	bool sprite_plane::is_collision_tree_2d() const
 	{
-		return iBroadPhaseCollisionTree2d != boost::none || iBroadPhaseCollisionTree3d == boost::none;
+		return iBroadPhaseType == QuadtreeBroadPhase;
 	}
 
 	bool sprite_plane::is_collision_tree_3d() const 
 	{
-		return iBroadPhaseCollisionTree3d != boost::none;
+		return iBroadPhaseType == OctreeBroadPhase;
 	}
 	
 	const sprite_plane::broad_phase_collision_tree_2d& sprite_plane::collision_tree_2d() const
 	{
-		if (iBroadPhaseCollisionTree2d == boost::none)
-		{
-			iBroadPhaseCollisionTree2d.emplace();
-			iBroadPhaseCollisionTree3d = boost::none;
-			for (auto o : iObjects)
-				if (o->category() == object_category::Sprite || o->category() == object_category::PhysicalObject)
-					iBroadPhaseCollisionTree2d->insert(o->as_physical_object());
-		}
-		return *iBroadPhaseCollisionTree2d;
+		if (!is_collision_tree_2d())
+			throw wrong_broad_phase();
+		return static_cast<const broad_phase_collision_tree_2d&>(*iBroadPhase);
 	}
 
 	sprite_plane::broad_phase_collision_tree_2d& sprite_plane::collision_tree_2d()
@@ -339,15 +473,9 @@ namespace neogfx
 
 	const sprite_plane::broad_phase_collision_tree_3d& sprite_plane::collision_tree_3d() const
 	{
-		if (iBroadPhaseCollisionTree3d == boost::none)
-		{
-			iBroadPhaseCollisionTree3d.emplace();
-			iBroadPhaseCollisionTree2d = boost::none;
-			for (auto o : iObjects)
-				if (o->category() == object_category::Sprite || o->category() == object_category::PhysicalObject)
-					iBroadPhaseCollisionTree3d->insert(o->as_physical_object());
-		}
-		return *iBroadPhaseCollisionTree3d;
+		if (!is_collision_tree_3d())
+			throw wrong_broad_phase();
+		return static_cast<const broad_phase_collision_tree_3d&>(*iBroadPhase);
 	}
 
 	sprite_plane::broad_phase_collision_tree_3d& sprite_plane::collision_tree_3d()
@@ -355,23 +483,51 @@ namespace neogfx
 		return const_cast<broad_phase_collision_tree_3d&>(const_cast<const sprite_plane*>(this)->collision_tree_3d());
 	}
 
+	bool sprite_plane::is_collision_sweep_and_prune() const
+	{
+		return iBroadPhaseType == SweepAndPruneBroadPhase;
+	}
+
+	const sprite_plane::broad_phase_sweep_and_prune& sprite_plane::collision_sweep_and_prune() const
+	{
+		if (!is_collision_sweep_and_prune())
+			throw wrong_broad_phase();
+		return static_cast<const broad_phase_sweep_and_prune&>(*iBroadPhase);
+	}
+
+	sprite_plane::broad_phase_sweep_and_prune& sprite_plane::collision_sweep_and_prune()
+	{
+		return const_cast<broad_phase_sweep_and_prune&>(const_cast<const sprite_plane*>(this)->collision_sweep_and_prune());
+	}
+
+	void sprite_plane::start_updates()
+	{
+		if (iUpdater == nullptr)
+			iUpdater = std::make_unique<neolib::callback_timer>(app::instance(), [this](neolib::callback_timer& aTimer)
+			{
+				aTimer.again();
+				if (snapshot())
+					update();
+			}, 10);
+		if (iPhysicsThread == nullptr)
+			iPhysicsThread = std::make_unique<physics_thread>(*this);
+	}
+
 	void sprite_plane::do_add_object(std::shared_ptr<i_game_object> aObject)
 	{
 		iObjects.push_back(aObject);
 		if (aObject->category() == object_category::Sprite || aObject->category() == object_category::PhysicalObject)
-			is_collision_tree_2d() ? 
-				collision_tree_2d().insert(aObject->as_physical_object()) :
-				collision_tree_3d().insert(aObject->as_physical_object());
+			iBroadPhase->insert(aObject->as_physical_object());
 		if (aObject->category() == object_category::Sprite || aObject->category() == object_category::Shape)
-			iRenderBuffer.push_back(&aObject->as_shape());
+			iRenderBuffer.push_back(std::shared_ptr<i_shape>{ aObject, &aObject->as_shape() });
 		iNeedsSorting = true;
 	}
 
-	void sprite_plane::sort_shapes() const
+	void sprite_plane::sort_shapes()
 	{
 		if (iNeedsSorting)
 		{
-			std::stable_sort(iRenderBuffer.begin(), iRenderBuffer.end(), [this](i_shape* left, i_shape* right) -> bool
+			std::stable_sort(iRenderBuffer.begin(), iRenderBuffer.end(), [this](const std::shared_ptr<i_shape>& left, const std::shared_ptr<i_shape>& right) -> bool
 			{
 				if (left->killed() != right->killed())
 					return left->killed() < right->killed();
@@ -381,7 +537,10 @@ namespace neogfx
 					return false;
 			});
 			while (!iRenderBuffer.empty() && iRenderBuffer.back()->killed())
+			{
+				iPreviousPositions.erase(iRenderBuffer.back().get());
 				iRenderBuffer.pop_back();
+			}
 		}
 	}
 
@@ -399,7 +558,7 @@ namespace neogfx
 					if (left->category() != right->category())
 						return left->category() < right->category();
 					else
-						return &left < &right;
+						return false;
 				}
 				else
 				{
@@ -416,45 +575,138 @@ namespace neogfx
 			while (!iObjects.empty() && iObjects.back()->killed())
 			{
 				if (iObjects.back()->category() == object_category::Sprite || iObjects.back()->category() == object_category::PhysicalObject)
-					is_collision_tree_2d() ?
-					collision_tree_2d().remove(iObjects.back()->as_collidable_object()) :
-					collision_tree_3d().remove(iObjects.back()->as_collidable_object());
+					iBroadPhase->remove(iObjects.back()->as_collidable_object());
 				iObjects.pop_back();
 			}
 			iNeedsSorting = false;
 		}
 	}
 
+	void sprite_plane::build_gravity_tree()
+	{
+		iGravityBodies.clear();
+		for (auto& o : iObjects)
+		{
+			if (o->category() == object_category::Shape)
+				break;
+			if (o->killed())
+				continue;
+			auto& po = o->as_physical_object();
+			if (po.mass() == 0.0)
+				break;
+			iGravityBodies.push_back(point_mass{ &po, po.position(), po.mass() });
+		}
+		if (!is_collision_tree_3d())
+			iGravityTree2d.build(iGravityBodies);
+		else
+			iGravityTree3d.build(iGravityBodies);
+	}
+
 	void sprite_plane::update_objects()
 	{
 		std::lock_guard<std::recursive_mutex> lock(iUpdateMutex);
 		auto nowClock = std::chrono::duration_cast<chrono::flicks>(std::chrono::high_resolution_clock::now().time_since_epoch());
-		auto now = to_step_time(chrono::to_seconds(nowClock), physics_step_interval());
-		if (!iPhysicsTime)
-			iPhysicsTime = now;
-		if (*iPhysicsTime == now)
-			return;
 		bool updated = false;
 		int32_t frames = 0;
-		while (*iPhysicsTime <= now)
+		switch (iSimulationMode)
 		{
-			++frames;
-			applying_physics.trigger(*iPhysicsTime);
-			sort_objects();
-			if (iG != 0.0)
+		case RealTimeSimulation:
+			{
+				auto now = to_step_time(chrono::to_seconds(nowClock), physics_step_interval());
+				if (!iPhysicsTime)
+					iPhysicsTime = now;
+				if (*iPhysicsTime == now)
+					return;
+				while (*iPhysicsTime <= now)
+				{
+					++frames;
+					updated = step_objects() || updated;
+				}
+			}
+			break;
+		case FixedTimestepSimulation:
 			{
-				for (auto& i1 : iObjects)
+				if (!iPhysicsTime)
+					iPhysicsTime = 0;
+				const chrono::flicks stepInterval{ physics_step_interval() };
+				if (iLastClock != boost::none)
+					iAccumulator += nowClock - *iLastClock;
+				iLastClock = nowClock;
+				// drop backlog we could never catch up with rather than spiralling
+				if (iAccumulator > stepInterval * MaxCatchUpSteps)
+					iAccumulator = stepInterval * MaxCatchUpSteps;
+				while (iAccumulator >= stepInterval)
+				{
+					iAccumulator -= stepInterval;
+					++frames;
+					updated = step_objects() || updated;
+				}
+				iInterpolationFactor = static_cast<double>(iAccumulator.count()) / stepInterval.count();
+			}
+			break;
+		case ManualSimulation:
+			return;
+		}
+		if (frames > 0)
+		{
+			if (updated)
+				publish_render_snapshot();
+			iUpdateTime = std::chrono::duration_cast<chrono::flicks>(std::chrono::high_resolution_clock::now().time_since_epoch() - nowClock) / frames;
+		}
+		iUpdatedSinceLastSnapshot = iUpdatedSinceLastSnapshot || updated;
+	}
+
+	bool sprite_plane::step_objects()
+	{
+		bool updated = false;
+		const bool deterministic = (iSimulationMode != RealTimeSimulation);
+		if (deterministic)
+		{
+			// objects only ever enter the simulation at a step boundary
+			if (!iNewObjects.empty())
+			{
+				for (auto& o : iNewObjects)
+					do_add_object(o);
+				iNewObjects.clear();
+				updated = true;
+			}
+		}
+		// inputs are applied at a step boundary in every mode so that none are left queued in real time mode
+		apply_inputs();
+		applying_physics.trigger(*iPhysicsTime);
+		sort_objects();
+		if (iSimulationMode == FixedTimestepSimulation)
+		{
+			// keyed by shape as snapshot() may re-sort the render buffer between steps
+			for (const auto& s : iRenderBuffer)
+				iPreviousPositions[s.get()] = s->position();
+		}
+		if (iG != 0.0)
+		{
+			bool useGravityTree = barnes_hut_enabled();
+			if (useGravityTree)
+				build_gravity_tree();
+			for (auto& i1 : iObjects)
+			{
+				vec3 totalForce;
+				if (i1->category() == object_category::Shape)
+					break;
+				if (i1->killed())
+					continue;
+				auto& o1 = (*i1).as_physical_object();
+				if (o1.mass() == 0.0)
+					break;
+				if (iUniformGravity != boost::none)
+					totalForce = *iUniformGravity * o1.mass();
+				if (useGravityTree)
+				{
+					const point_mass body{ &o1, o1.position(), o1.mass() };
+					totalForce += !is_collision_tree_3d() ?
+						iGravityTree2d.force(body, iG) :
+						iGravityTree3d.force(body, iG);
+				}
+				else
 				{
-					vec3 totalForce;
-					if (i1->category() == object_category::Shape)
-						break;
-					if (i1->killed())
-						continue;
-					auto& o1 = (*i1).as_physical_object();
-					if (o1.mass() == 0.0)
-						break;
-					if (iUniformGravity != boost::none)
-						totalForce = *iUniformGravity * o1.mass();
 					for (auto& i2 : iObjects)
 					{
 						if (i2->category() == object_category::Shape)
@@ -475,39 +727,91 @@ namespace neogfx
 						else
 							break;
 					}
-					bool o1updated = o1.update(from_step_time(*iPhysicsTime), totalForce);
-					updated = (o1updated || updated);
 				}
+				bool o1updated = o1.update(from_step_time(*iPhysicsTime), totalForce);
+				updated = (o1updated || updated);
 			}
-			auto process_collisions = [this, &updated](auto& tree)
-			{
-				if (dynamic_update_enabled())
-					tree.dynamic_update(iObjects.begin(), iObjects.end());
-				else
-					tree.full_update(iObjects.begin(), iObjects.end());
-				tree.collisions(iObjects.begin(), iObjects.end(),
-					[this, &updated](i_collidable_object& o1, i_collidable_object& o2)
-				{
-					iCollisions.insert(std::make_pair(&o1, &o2));
-					updated = true;
-				});
-			};
-			if (is_collision_tree_2d())
-				process_collisions(collision_tree_2d());
-			else
-				process_collisions(collision_tree_3d());
-			for (auto& s : iRenderBuffer)
+		}
+		if (dynamic_update_enabled())
+			iBroadPhase->dynamic_update(iObjects.begin(), iObjects.end());
+		else
+			iBroadPhase->full_update(iObjects.begin(), iObjects.end());
+		iBroadPhase->collisions(iObjects.begin(), iObjects.end(),
+			[this, &updated](i_collidable_object& o1, i_collidable_object& o2)
+		{
+			iCollisions.insert(std::make_pair(&o1, &o2));
+			updated = true;
+		});
+		updated = iInstancedSprites.update(from_step_time(*iPhysicsTime), iUniformGravity) || updated;
+		for (auto& s : iRenderBuffer)
+		{
+			updated = s->update(from_step_time(*iPhysicsTime)) || updated;
+			if (s->killed())
+				iNeedsSorting = true;
+		}
+		if (deterministic)
+			dispatch_collisions(true);
+		physics_applied.trigger(*iPhysicsTime);
+		*iPhysicsTime += physics_step_interval();
+		++iStepCount;
+		return updated;
+	}
+
+	void sprite_plane::apply_inputs()
+	{
+		std::vector<simulation_input> inputs;
+		{
+			std::lock_guard<std::mutex> lock(iInputMutex);
+			inputs.swap(iPendingInputs);
+		}
+		if (iReplay != boost::none)
+		{
+			// live input is ignored while a replay is in progress
+			inputs.clear();
+			const auto& replay = *iReplay;
+			while (iReplayPosition < replay.size() && replay[iReplayPosition].step <= iStepCount - iReplayStart)
+				inputs.push_back(replay[iReplayPosition++].input);
+			if (iReplayPosition == replay.size())
+				iReplay = boost::none;
+		}
+		for (const auto& input : inputs)
+		{
+			if (iRecording)
+				iRecordedInputs.push_back(recorded_input{ iStepCount - iRecordingStart, input });
+			input_applied.trigger(input);
+		}
+	}
+
+	void sprite_plane::dispatch_collisions(bool aOrdered)
+	{
+		if (iCollisions.empty())
+			return;
+		std::vector<collision_pair> collisions{ iCollisions.begin(), iCollisions.end() };
+		iCollisions.clear();
+		if (aOrdered)
+		{
+			// collision_list is hashed on object addresses so impose an order that does not depend on the allocator
+			std::unordered_map<const i_collidable_object*, std::size_t> order;
+			for (std::size_t i = 0; i < iObjects.size() && iObjects[i]->category() != object_category::Shape; ++i)
+				order[&iObjects[i]->as_collidable_object()] = i;
+			for (auto& c : collisions)
+				if (order[c.second] < order[c.first])
+					std::swap(c.first, c.second);
+			std::sort(collisions.begin(), collisions.end(), [&order](const collision_pair& left, const collision_pair& right) -> bool
 			{
-				updated = s->update(from_step_time(*iPhysicsTime)) || updated;
-				if (s->killed())
-					iNeedsSorting = true;
-			}
-			physics_applied.trigger(*iPhysicsTime);
-			*iPhysicsTime += physics_step_interval();
+				return std::make_pair(order[left.first], order[left.second]) < std::make_pair(order[right.first], order[right.second]);
+			});
+		}
+		for (const auto& c : collisions)
+		{
+			if (!c.first->collidable() || !c.second->collidable())
+				continue;
+			c.first->collided(*c.second);
+			c.second->collided(*c.first);
+			object_collision.trigger(*c.first, *c.second);
+			if (c.first->killed() || c.second->killed())
+				iNeedsSorting = true;
 		}
-		if (frames > 0)
-			iUpdateTime = std::chrono::duration_cast<chrono::flicks>(std::chrono::high_resolution_clock::now().time_since_epoch() - nowClock) / frames;
-		iUpdatedSinceLastSnapshot = iUpdatedSinceLastSnapshot || updated;
 	}
 
 	bool sprite_plane::snapshot()
@@ -520,33 +824,197 @@ namespace neogfx
 		
 		std::lock_guard<std::recursive_mutex> lock(iUpdateMutex);
 
-		taking_snapshot.trigger(*iPhysicsTime);
+		if (iPhysicsTime != boost::none)
+			taking_snapshot.trigger(*iPhysicsTime);
 
-		if (iUpdatedSinceLastSnapshot || !iNewObjects.empty())
+		const bool deterministic = (iSimulationMode != RealTimeSimulation);
+		if (iUpdatedSinceLastSnapshot || (!deterministic && !iNewObjects.empty()))
 		{
 			updated = true;
 			iUpdatedSinceLastSnapshot = false;
-			for (const auto& c : iCollisions)
+			dispatch_collisions(false);
+			if (!deterministic)
 			{
-				if (!c.first->collidable() || !c.second->collidable())
-					continue;
-				c.first->collided(*c.second);
-				c.second->collided(*c.first);
-				object_collision.trigger(*c.first, *c.second);
-				if (c.first->killed() || c.second->killed())
-					iNeedsSorting = true;
+				for (auto& o : iNewObjects)
+					do_add_object(o);
+				iNewObjects.clear();
 			}
-			iCollisions.clear();
-			for (auto& o : iNewObjects)
-				do_add_object(o);
-			iNewObjects.clear();
 			if (iNeedsSorting)
 				sort_objects();
+			publish_render_snapshot();
 		}
 		
 		return updated;
 	}
 
+	void sprite_plane::publish_render_snapshot()
+	{
+		auto& back = iRenderSnapshots[iBackRenderSnapshot];
+		back.count = 0;
+		for (const auto& s : iRenderBuffer)
+		{
+			if (s->killed())
+				continue;
+			if (back.count == back.shapes.size())
+				back.shapes.emplace_back();
+			auto& entry = back.shapes[back.count++];
+			entry.shape = s;
+			s->take_snapshot(entry);
+			auto const previousPosition = iPreviousPositions.find(s.get());
+			entry.previousPosition = (previousPosition != iPreviousPositions.end() ? previousPosition->second : entry.position);
+		}
+		for (auto i = back.count; i < back.shapes.size(); ++i)
+			back.shapes[i].shape.reset();
+		iInstancedSprites.take_snapshot(back.instances);
+		back.interpolationFactor = iInterpolationFactor;
+		back.clock = (iSimulationMode == FixedTimestepSimulation ? iLastClock : boost::none);
+		back.stepInterval = chrono::flicks{ physics_step_interval() };
+		// triple buffering: swap the back buffer with the ready buffer, flagging the latter as fresh for the painter
+		iBackRenderSnapshot = iReadyRenderSnapshot.exchange(iBackRenderSnapshot | FreshRenderSnapshot) & ~FreshRenderSnapshot;
+	}
+
+	sprite_plane::render_snapshot& sprite_plane::current_render_snapshot() const
+	{
+		if (iReadyRenderSnapshot.load() & FreshRenderSnapshot)
+			iFrontRenderSnapshot = iReadyRenderSnapshot.exchange(iFrontRenderSnapshot) & ~FreshRenderSnapshot;
+		return iRenderSnapshots[iFrontRenderSnapshot];
+	}
+
+	sprite_plane::simulation_mode_e sprite_plane::simulation_mode() const
+	{
+		return iSimulationMode;
+	}
+
+	void sprite_plane::set_simulation_mode(simulation_mode_e aMode)
+	{
+		std::lock_guard<std::recursive_mutex> lock(iUpdateMutex);
+		if (iSimulationMode == aMode)
+			return;
+		iSimulationMode = aMode;
+		// physics time restarts from zero in the deterministic modes so that runs are independent of the wall clock
+		iPhysicsTime = boost::none;
+		iLastClock = boost::none;
+		iAccumulator = chrono::flicks{ 0 };
+		iInterpolationFactor = 1.0;
+		iPreviousPositions.clear();
+		if (iSimulationMode != ManualSimulation)
+			start_updates();
+	}
+
+	scalar sprite_plane::interpolation_factor() const
+	{
+		return iInterpolationFactor;
+	}
+
+	uint64_t sprite_plane::step_count() const
+	{
+		return iStepCount;
+	}
+
+	void sprite_plane::step(uint64_t aSteps)
+	{
+		std::lock_guard<std::recursive_mutex> lock(iUpdateMutex);
+		if (!iPhysicsTime)
+			iPhysicsTime = 0;
+		bool updated = false;
+		for (uint64_t i = 0; i < aSteps; ++i)
+			updated = step_objects() || updated;
+		if (updated)
+			publish_render_snapshot();
+		iUpdatedSinceLastSnapshot = iUpdatedSinceLastSnapshot || updated;
+	}
+
+	void sprite_plane::post_input(uint32_t aCode, const vec3& aValue)
+	{
+		std::lock_guard<std::mutex> lock(iInputMutex);
+		iPendingInputs.push_back(simulation_input{ aCode, aValue });
+	}
+
+	bool sprite_plane::recording() const
+	{
+		return iRecording;
+	}
+
+	void sprite_plane::start_recording()
+	{
+		std::lock_guard<std::recursive_mutex> lock(iUpdateMutex);
+		iRecording = true;
+		iRecordingStart = iStepCount;
+		iRecordedInputs.clear();
+	}
+
+	void sprite_plane::stop_recording()
+	{
+		std::lock_guard<std::recursive_mutex> lock(iUpdateMutex);
+		iRecording = false;
+	}
+
+	const sprite_plane::input_log& sprite_plane::recorded_inputs() const
+	{
+		return iRecordedInputs;
+	}
+
+	bool sprite_plane::replaying() const
+	{
+		std::lock_guard<std::recursive_mutex> lock(iUpdateMutex);
+		return iReplay != boost::none;
+	}
+
+	void sprite_plane::replay(const input_log& aInputs)
+	{
+		std::lock_guard<std::recursive_mutex> lock(iUpdateMutex);
+		iReplay = aInputs;
+		iReplayStart = iStepCount;
+		iReplayPosition = 0;
+	}
+
+	void sprite_plane::stop_replay()
+	{
+		std::lock_guard<std::recursive_mutex> lock(iUpdateMutex);
+		iReplay = boost::none;
+	}
+
+	uint64_t sprite_plane::state_hash() const
+	{
+		std::lock_guard<std::recursive_mutex> lock(iUpdateMutex);
+		// FNV-1a over the bit patterns of the simulated state; equal hashes after equal step counts mean identical runs
+		uint64_t hash = 14695981039346656037ull;
+		auto combine = [&hash](scalar aValue)
+		{
+			uint64_t bits;
+			std::memcpy(&bits, &aValue, sizeof(bits));
+			for (uint32_t byte = 0; byte < sizeof(bits); ++byte)
+			{
+				hash ^= (bits >> (byte * 8)) & 0xFF;
+				hash *= 1099511628211ull;
+			}
+		};
+		auto combine_vector = [&combine](const vec3& aVector)
+		{
+			combine(aVector.x);
+			combine(aVector.y);
+			combine(aVector.z);
+		};
+		for (const auto& o : iObjects)
+		{
+			if (o->category() == object_category::Shape)
+				break;
+			if (o->killed())
+				continue;
+			const auto& po = o->as_physical_object();
+			combine_vector(po.position());
+			combine_vector(po.velocity());
+			combine_vector(po.angle_radians());
+		}
+		for (const auto& p : iInstancedSprites.positions())
+			combine_vector(p);
+		for (const auto& v : iInstancedSprites.velocities())
+			combine_vector(v);
+		for (auto a : iInstancedSprites.angles())
+			combine(a);
+		return hash;
+	}
+
 	double sprite_plane::update_time() const
 	{
 		return std::chrono::duration_cast<std::chrono::duration<double>>(iUpdateTime).count();
@@ -122,11 +122,28 @@ namespace neogfx
 	}
 
 	void text::paint(graphics_context& aGraphicsContext) const
+	{
+		paint(aGraphicsContext, position());
+	}
+
+	void text::take_snapshot(shape_snapshot& aSnapshot) const
+	{
+		// measuring text needs a graphics context so the bounding box is left to the painting thread
+		aSnapshot.position = position();
+		aSnapshot.boundingBox = boost::none;
+	}
+
+	void text::paint(graphics_context& aGraphicsContext, const shape_snapshot& aSnapshot) const
+	{
+		paint(aGraphicsContext, aSnapshot.position + aSnapshot.renderOffset);
+	}
+
+	void text::paint(graphics_context& aGraphicsContext, const vec3& aPosition) const
 	{
 		aGraphicsContext.set_glyph_text_cache(iGlyphTextCache);
-		auto bb2d = bounding_box_2d();
+		auto bb2d = rect{ point{ origin() + aPosition }, size{ extents() } };
 		bb2d.position() = bb2d.position().ceil();
-		rectangle bb3d{ vec3{ bb2d.x, bb2d.y, position().y }, bb2d.extents().to_vec2() };
+		rectangle bb3d{ vec3{ bb2d.x, bb2d.y, aPosition.y }, bb2d.extents().to_vec2() };
 		if (appearance().has_paper())
 			aGraphicsContext.fill_shape(bb3d, to_brush(appearance().paper()));
 		if (iBorder != boost::none)
@@ -140,7 +157,7 @@ namespace neogfx
 			bb2d.extents() -= size{iMargins->left + iMargins->right, iMargins->bottom + iMargins->top};
 		}
 		auto pos = aGraphicsContext.logical_coordinates().second.y < aGraphicsContext.logical_coordinates().first.y ? bb2d.bottom_left() : bb2d.top_left();
-		aGraphicsContext.draw_multiline_text(vec3{pos.x, pos.y, position().z}, iText, font(), bb2d.extents().cx, appearance(), iAlignment, UseGlyphTextCache);
+		aGraphicsContext.draw_multiline_text(vec3{pos.x, pos.y, aPosition.z}, iText, font(), bb2d.extents().cx, appearance(), iAlignment, UseGlyphTextCache);
 	}
 
 	size text::text_extent() const
@@ -78,6 +78,7 @@ namespace neogfx
 		iLogicalCoordinates{ iSurface.logical_coordinates() },
 		iOpacity{ 1.0 },
 		iSmoothingMode{ neogfx::smoothing_mode::None },
+		iBlendingMode{ neogfx::blending_mode::Default },
 		iSubpixelRendering{ iSurface.rendering_engine().is_subpixel_rendering_on() },
 		iGlyphTextData{ std::make_unique<glyph_text_data>() }
 	{
@@ -94,6 +95,7 @@ namespace neogfx
 		iLogicalCoordinates{ iSurface.logical_coordinates() },
 		iOpacity{ 1.0 },
 		iSmoothingMode{ neogfx::smoothing_mode::None },
+		iBlendingMode{ neogfx::blending_mode::Default },
 		iSubpixelRendering{ iSurface.rendering_engine().is_subpixel_rendering_on() },
 		iGlyphTextData{ std::make_unique<glyph_text_data>() }
 	{
@@ -110,6 +112,7 @@ namespace neogfx
 		iLogicalCoordinates{ iSurface.logical_coordinates() },
 		iOpacity{ 1.0 },
 		iSmoothingMode{ neogfx::smoothing_mode::None },
+		iBlendingMode{ neogfx::blending_mode::Default },
 		iSubpixelRendering{ iSurface.rendering_engine().is_subpixel_rendering_on() },
 		iGlyphTextData{ std::make_unique<glyph_text_data>() }
 	{
@@ -126,6 +129,7 @@ namespace neogfx
 		iLogicalCoordinates{ aOther.logical_coordinates() },
 		iOpacity{ 1.0 },
 		iSmoothingMode{ neogfx::smoothing_mode::None },
+		iBlendingMode{ neogfx::blending_mode::Default },
 		iSubpixelRendering{ iSurface.rendering_engine().is_subpixel_rendering_on() },
 		iGlyphTextData{ std::make_unique<glyph_text_data>() }
 	{
@@ -236,6 +240,7 @@ namespace neogfx
 	void graphics_context::set_default_font(const font& aDefaultFont) const
 	{
 		iDefaultFont = aDefaultFont;
+		iUnitsContext.invalidate_device_units_scale();
 	}
 
 	void graphics_context::set_extents(const size& aExtents) const
@@ -305,15 +310,15 @@ namespace neogfx
 		native_context().enqueue(graphics_operation::draw_path{ path, aPen });
 	}
 
-	void graphics_context::draw_shape(const i_shape& aShape, const pen& aPen, const brush& aFill) const
+	void graphics_context::draw_shape(const i_mesh& aMesh, const pen& aPen, const brush& aFill) const
 	{
 		if (!aFill.empty())
-			fill_shape(aShape, aFill);
+			fill_shape(aMesh, aFill);
 		vec2 toDeviceUnits = to_device_units(vec2{ 1.0, 1.0 });
 		native_context().enqueue(
 			graphics_operation::draw_shape{
 				mesh{ 
-					aShape, 
+					aMesh, 
 					mat44{ 
 						{ toDeviceUnits.x, 0.0, 0.0, 0.0 },
 						{ 0.0, toDeviceUnits.y, 0.0, 0.0 },
@@ -358,13 +363,13 @@ namespace neogfx
 		native_context().enqueue(graphics_operation::fill_path{ path, aFill });
 	}
 
-	void graphics_context::fill_shape(const i_shape& aShape, const brush& aFill) const
+	void graphics_context::fill_shape(const i_mesh& aMesh, const brush& aFill) const
 	{
 		vec2 toDeviceUnits = to_device_units(vec2{ 1.0, 1.0 });
 		native_context().enqueue(
 			graphics_operation::fill_shape{
 				mesh{ 
-					aShape, 
+					aMesh, 
 					mat44{ 
 						{ toDeviceUnits.x, 0.0, 0.0, 0.0 },
 						{ 0.0, toDeviceUnits.y, 0.0, 0.0 },
@@ -684,6 +689,11 @@ namespace neogfx
 		return iUnitsContext.set_units(aUnits);
 	}
 
+	const units_scale& graphics_context::device_units_scale() const
+	{
+		return iUnitsContext.device_units_scale();
+	}
+
 	i_native_graphics_context& graphics_context::native_context() const
 	{
 		if (iNativeGraphicsContext != nullptr)
@@ -703,6 +713,18 @@ namespace neogfx
 		native_context().flush();
 	}
 
+	void graphics_context::begin_layer(const rect& aLayerRect) const
+	{
+		flush();
+		const_cast<i_native_surface&>(iSurface.native_surface()).begin_layer(to_device_units(aLayerRect) + iOrigin);
+	}
+
+	void graphics_context::end_layer(i_texture& aTarget) const
+	{
+		flush();
+		const_cast<i_native_surface&>(iSurface.native_surface()).end_layer(aTarget);
+	}
+
 	void graphics_context::scissor_on(const rect& aRect) const
 	{
 		native_context().enqueue(graphics_operation::scissor_on{ to_device_units(aRect) + iOrigin });
@@ -759,6 +781,20 @@ namespace neogfx
 		}
 	}
 
+	blending_mode graphics_context::blending_mode() const
+	{
+		return iBlendingMode;
+	}
+
+	void graphics_context::set_blending_mode(neogfx::blending_mode aBlendingMode) const
+	{
+		if (iBlendingMode != aBlendingMode)
+		{
+			iBlendingMode = aBlendingMode;
+			native_context().enqueue(graphics_operation::set_blending_mode{ aBlendingMode });
+		}
+	}
+
 	void graphics_context::push_logical_operation(logical_operation aLogicalOperation) const
 	{
 		native_context().enqueue(graphics_operation::push_logical_operation{ aLogicalOperation });
@@ -976,11 +1012,11 @@ namespace neogfx
 		draw_textures(aShape, to_texture_list_pointer(aTexture, aTextureRect), aColour, aShaderEffect);
 	}
 
-	void graphics_context::draw_textures(const i_shape& aShape, texture_list_pointer aTextures, const optional_colour& aColour, shader_effect aShaderEffect) const
+	void graphics_context::draw_textures(const i_mesh& aMesh, texture_list_pointer aTextures, const optional_colour& aColour, shader_effect aShaderEffect) const
 	{
 		vec2 toDeviceUnits = to_device_units(vec2{ 1.0, 1.0 });
 		neogfx::mesh mesh{
-			aShape,
+			aMesh,
 			mat44{
 				{ toDeviceUnits.x, 0.0, 0.0, 0.0 },
 				{ 0.0, toDeviceUnits.y, 0.0, 0.0 },
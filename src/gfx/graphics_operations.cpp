@@ -40,6 +40,7 @@ namespace neogfx
 			case ResetClip: return "ResetClip";
 			case SetOpacity: return "SetOpacity";
 			case SetSmoothingMode: return "SetSmoothingMode";
+			case SetBlendingMode: return "SetBlendingMode";
 			case PushLogicalOperation: return "PushLogicalOperation";
 			case PopLogicalOperation: return "PopLogicalOperation";
 			case LineStippleOn: return "LineStippleOn";
@@ -69,8 +70,56 @@ namespace neogfx
 			}
 		}
 
+		const pen* primitive_pen(const operation& aOperation)
+		{
+			switch (static_cast<operation_type>(aOperation.which()))
+			{
+			case operation_type::DrawLine:
+				return &static_variant_cast<const draw_line&>(aOperation).pen;
+			case operation_type::DrawRect:
+				return &static_variant_cast<const draw_rect&>(aOperation).pen;
+			case operation_type::DrawRoundedRect:
+				return &static_variant_cast<const draw_rounded_rect&>(aOperation).pen;
+			case operation_type::DrawCircle:
+				return &static_variant_cast<const draw_circle&>(aOperation).pen;
+			case operation_type::DrawArc:
+				return &static_variant_cast<const draw_arc&>(aOperation).pen;
+			default:
+				return nullptr;
+			}
+		}
+
+		const brush* primitive_fill(const operation& aOperation)
+		{
+			switch (static_cast<operation_type>(aOperation.which()))
+			{
+			case operation_type::FillRect:
+				return &static_variant_cast<const fill_rect&>(aOperation).fill;
+			case operation_type::FillRoundedRect:
+				return &static_variant_cast<const fill_rounded_rect&>(aOperation).fill;
+			case operation_type::FillCircle:
+				return &static_variant_cast<const fill_circle&>(aOperation).fill;
+			case operation_type::FillArc:
+				return &static_variant_cast<const fill_arc&>(aOperation).fill;
+			default:
+				return nullptr;
+			}
+		}
+
 		bool batchable(const operation& aLeft, const operation& aRight)
 		{
+			// solid colour outline primitives of the same pen width are drawn as a single line list
+			auto leftPen = primitive_pen(aLeft);
+			auto rightPen = primitive_pen(aRight);
+			if (leftPen != nullptr && rightPen != nullptr)
+				return leftPen->width() == rightPen->width() &&
+					leftPen->anti_aliased() == rightPen->anti_aliased() &&
+					leftPen->colour().is<colour>() && rightPen->colour().is<colour>();
+			// solid colour filled primitives are drawn as a single triangle list
+			auto leftFill = primitive_fill(aLeft);
+			auto rightFill = primitive_fill(aRight);
+			if (leftFill != nullptr && rightFill != nullptr)
+				return leftFill->is<colour>() && rightFill->is<colour>();
 			if (aLeft.which() != aRight.which())
 				return false;
 			switch (static_cast<operation_type>(aLeft.which()))
@@ -79,19 +128,6 @@ namespace neogfx
 			case operation_type::DrawPixel:
 			case operation_type::DrawTextures:
 				return true;
-			case operation_type::DrawLine:
-			{
-				auto& left = static_variant_cast<const draw_line&>(aLeft);
-				auto& right = static_variant_cast<const draw_line&>(aRight);
-				return left.pen.width() == right.pen.width() &&
-					left.pen.anti_aliased() == right.pen.anti_aliased();
-			}
-			case operation_type::FillRect:
-			{
-				auto& left = static_variant_cast<const fill_rect&>(aLeft);
-				auto& right = static_variant_cast<const fill_rect&>(aRight);
-				return left.fill.which() == right.fill.which() && left.fill.is<colour>();
-			}
 			case operation_type::FillShape:
 			{
 				auto& left = static_variant_cast<const fill_shape&>(aLeft);
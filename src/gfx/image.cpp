@@ -18,11 +18,12 @@
 */
 
 #include <neogfx/neogfx.hpp>
-#include <libpng/png.h>
-#include <openssl/sha.h>
 #include <neolib/vecarray.hpp>
 #include <neolib/string_utils.hpp>
+#include <neogfx/core/content_hash.hpp>
 #include <neogfx/gfx/image.hpp>
+#include <neogfx/gfx/image_codec.hpp>
+#include <neogfx/gfx/image_decoder.hpp>
 #include <neogfx/app/resource_manager.hpp>
 
 namespace neogfx
@@ -52,8 +53,29 @@ namespace neogfx
 		iColourFormat{ neogfx::colour_format::RGBA8 },
 		iSampling{ aSampling }
 	{
-		if (available())
-			load();
+		auto cached = image_decoder::instance().cache().find(aUri);
+		if (cached != nullptr)
+		{
+			iData = cached->pixels;
+			iSize = cached->extents;
+			iContentHash = cached->contentHash;
+		}
+		else if (available() && load())
+			image_decoder::instance().cache().insert(std::make_shared<decoded_image>(decoded_image{ iUri, iSize, iData, iContentHash }));
+	}
+
+	image::image(const decoded_image& aDecodedImage, dimension aDpiScaleFactor, texture_sampling aSampling) :
+		iUri{ aDecodedImage.uri },
+		iDpiScaleFactor{ aDpiScaleFactor },
+		iColourFormat{ neogfx::colour_format::RGBA8 },
+		iData{ aDecodedImage.pixels },
+		iSampling{ aSampling },
+		iSize{ aDecodedImage.extents }
+	{
+		if (!aDecodedImage.error.empty())
+			iError = aDecodedImage.error;
+		else
+			iContentHash = aDecodedImage.contentHash;
 	}
 
 	image::image(const std::string& aImagePattern, const std::unordered_map<std::string, colour>& aColourMap, dimension aDpiScaleFactor, texture_sampling aSampling) :
@@ -169,6 +191,7 @@ namespace neogfx
 
 	void* image::data()
 	{
+		iContentHash = boost::none;
 		return const_cast<void*>(const_cast<const image*>(this)->data());
 	}
 
@@ -179,8 +202,10 @@ namespace neogfx
 
 	image::hash_digest_type image::hash() const
 	{
-		hash_digest_type result(SHA256_DIGEST_LENGTH);
-		SHA256(static_cast<const uint8_t*>(cdata()), size(), &result[0]);
+		auto const digest = content_hash();
+		hash_digest_type result(sizeof(digest));
+		for (std::size_t i = 0; i < sizeof(digest); ++i)
+			result[i] = static_cast<uint8_t>(digest >> (i * 8u));
 		return result;
 	}
 
@@ -207,6 +232,7 @@ namespace neogfx
 	void image::resize(const neogfx::size& aNewSize)
 	{
 		iSize = aNewSize;
+		iContentHash = boost::none;
 		iData.resize(static_cast<std::size_t>(iSize.cx * iSize.cy * 4));
 	}
 
@@ -226,6 +252,7 @@ namespace neogfx
 
 	void image::set_pixel(const point& aPoint, const colour& aColour)
 	{
+		iContentHash = boost::none;
 		switch (iColourFormat)
 		{
 		case neogfx::colour_format::RGBA8:
@@ -242,6 +269,13 @@ namespace neogfx
 		}
 	}
 
+	uint64_t image::content_hash() const
+	{
+		if (iContentHash == boost::none)
+			iContentHash = neogfx::content_hash(iData.empty() ? nullptr : &iData[0], iData.size());
+		return *iContentHash;
+	}
+
 	bool image::has_resource() const
 	{
 		return iResource != nullptr;
@@ -254,63 +288,18 @@ namespace neogfx
 		return *iResource;
 	}
 
-	image::image_type_e image::recognize() const
-	{
-		if (has_resource())
-		{
-			if (resource().size() > 0)
-			{
-				if (resource().size() >= 4)
-				{
-					const uint8_t* magic = static_cast<const uint8_t*>(resource().data());
-					if (magic[0] == 0x89 && magic[1] == 'P' && magic[2] == 'N' && magic[3] == 'G')
-						return PngImage;
-				}
-			}
-		}
-		return UnknownImage;
-	}
-
 	bool image::load()
 	{
 		if (!available())
 			throw not_available();
-		switch (recognize())
-		{
-		case PngImage:
-			return load_png();
-		default:
+		auto codec = image_codecs::instance().find_codec(resource().cdata(), resource().size());
+		if (codec == nullptr)
 			throw unknown_image_format();
-		}
-	}
-
-	bool image::load_png()
-	{
-		png_image image;
-		std::memset(&image, 0, (sizeof image));
-		image.version = PNG_IMAGE_VERSION;
-		if (png_image_begin_read_from_memory(&image, resource().data(), resource().size()) != 0)
-		{
-			image.format = PNG_FORMAT_RGBA;
-			iData.resize(PNG_IMAGE_SIZE(image));
-			if (png_image_finish_read(&image, NULL, data(), 0, NULL) != 0)
-			{
-				iSize = neogfx::size(image.width, image.height);
-				png_image_free(&image);
-				return true;
-			}
-			else
-			{
-				png_image_free(&image);
-				iError = image.message;
-				return false;
-			}
-		}
-		else
-		{
-			iError = image.message;
-			return false;
-		}
+		iContentHash = boost::none;
+		std::string error;
+		if (codec->decode(resource().cdata(), resource().size(), iData, iSize, error))
+			return true;
+		iError = error;
+		return false;
 	}
-
 }
\ No newline at end of file
@@ -0,0 +1,94 @@
+// image_codec.cpp
+/*
+  neogfx C++ GUI Library
+  Copyright (c) 2018 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <neogfx/neogfx.hpp>
+#include <libpng/png.h>
+#include <neogfx/gfx/image_codec.hpp>
+
+namespace neogfx
+{
+	const std::string& png_codec::name() const
+	{
+		static const std::string sName = "PNG";
+		return sName;
+	}
+
+	bool png_codec::recognize(const void* aData, std::size_t aSize) const
+	{
+		if (aSize < 4)
+			return false;
+		const uint8_t* magic = static_cast<const uint8_t*>(aData);
+		return magic[0] == 0x89 && magic[1] == 'P' && magic[2] == 'N' && magic[3] == 'G';
+	}
+
+	bool png_codec::decode(const void* aData, std::size_t aSize, data_type& aPixels, size& aExtents, std::string& aError) const
+	{
+		png_image image;
+		std::memset(&image, 0, (sizeof image));
+		image.version = PNG_IMAGE_VERSION;
+		if (png_image_begin_read_from_memory(&image, aData, aSize) != 0)
+		{
+			image.format = PNG_FORMAT_RGBA;
+			aPixels.resize(PNG_IMAGE_SIZE(image));
+			if (png_image_finish_read(&image, NULL, &aPixels[0], 0, NULL) != 0)
+			{
+				aExtents = neogfx::size(image.width, image.height);
+				png_image_free(&image);
+				return true;
+			}
+			else
+			{
+				png_image_free(&image);
+				aError = image.message;
+				return false;
+			}
+		}
+		else
+		{
+			aError = image.message;
+			return false;
+		}
+	}
+
+	image_codecs::image_codecs()
+	{
+		register_codec(std::make_shared<png_codec>());
+	}
+
+	image_codecs& image_codecs::instance()
+	{
+		static image_codecs sInstance;
+		return sInstance;
+	}
+
+	void image_codecs::register_codec(std::shared_ptr<i_image_codec> aCodec)
+	{
+		std::lock_guard<std::mutex> lock{ iMutex };
+		iCodecs.push_back(aCodec);
+	}
+
+	std::shared_ptr<i_image_codec> image_codecs::find_codec(const void* aData, std::size_t aSize) const
+	{
+		std::lock_guard<std::mutex> lock{ iMutex };
+		for (auto i = iCodecs.rbegin(); i != iCodecs.rend(); ++i)
+			if ((**i).recognize(aData, aSize))
+				return *i;
+		return std::shared_ptr<i_image_codec>{};
+	}
+}
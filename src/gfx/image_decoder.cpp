@@ -0,0 +1,284 @@
+// image_decoder.cpp
+/*
+  neogfx C++ GUI Library
+  Copyright (c) 2018 Leigh Johnston.  All Rights Reserved.
+  
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <neogfx/neogfx.hpp>
+#include <neogfx/core/content_hash.hpp>
+#include <neogfx/core/event.hpp>
+#include <neogfx/app/resource_manager.hpp>
+#include <neogfx/gfx/image_codec.hpp>
+#include <neogfx/gfx/image_decoder.hpp>
+
+namespace neogfx
+{
+	constexpr std::size_t decoded_image_cache::DefaultCapacity;
+
+	decoded_image_cache::decoded_image_cache(std::size_t aCapacity) :
+		iCapacity{ aCapacity }, iSize{ 0u }
+	{
+	}
+
+	std::size_t decoded_image_cache::capacity() const
+	{
+		std::lock_guard<std::mutex> lock{ iMutex };
+		return iCapacity;
+	}
+
+	void decoded_image_cache::set_capacity(std::size_t aCapacity)
+	{
+		std::lock_guard<std::mutex> lock{ iMutex };
+		iCapacity = aCapacity;
+		evict();
+	}
+
+	std::size_t decoded_image_cache::size() const
+	{
+		std::lock_guard<std::mutex> lock{ iMutex };
+		return iSize;
+	}
+
+	std::size_t decoded_image_cache::count() const
+	{
+		std::lock_guard<std::mutex> lock{ iMutex };
+		return iEntries.size();
+	}
+
+	decoded_image_pointer decoded_image_cache::find(const std::string& aUri)
+	{
+		std::lock_guard<std::mutex> lock{ iMutex };
+		auto existing = iIndex.find(aUri);
+		if (existing == iIndex.end())
+			return decoded_image_pointer{};
+		iEntries.splice(iEntries.begin(), iEntries, existing->second);
+		return *existing->second;
+	}
+
+	void decoded_image_cache::insert(decoded_image_pointer aImage)
+	{
+		std::lock_guard<std::mutex> lock{ iMutex };
+		auto existing = iIndex.find(aImage->uri);
+		if (existing != iIndex.end())
+		{
+			iSize -= (**existing->second).pixels.size();
+			iEntries.erase(existing->second);
+			iIndex.erase(existing);
+		}
+		if (aImage->pixels.size() > iCapacity)
+			return;
+		iEntries.push_front(aImage);
+		iIndex[aImage->uri] = iEntries.begin();
+		iSize += aImage->pixels.size();
+		evict();
+	}
+
+	void decoded_image_cache::remove(const std::string& aUri)
+	{
+		std::lock_guard<std::mutex> lock{ iMutex };
+		auto existing = iIndex.find(aUri);
+		if (existing == iIndex.end())
+			return;
+		iSize -= (**existing->second).pixels.size();
+		iEntries.erase(existing->second);
+		iIndex.erase(existing);
+	}
+
+	void decoded_image_cache::clear()
+	{
+		std::lock_guard<std::mutex> lock{ iMutex };
+		iEntries.clear();
+		iIndex.clear();
+		iSize = 0u;
+	}
+
+	void decoded_image_cache::evict()
+	{
+		while (iSize > iCapacity && !iEntries.empty())
+		{
+			iSize -= iEntries.back()->pixels.size();
+			iIndex.erase(iEntries.back()->uri);
+			iEntries.pop_back();
+		}
+	}
+
+	image_decoder::image_decoder(uint32_t aWorkerCount, const decode_function& aDecode) :
+		iWorkerCount{ aWorkerCount != 0u ? aWorkerCount : std::max(1u, std::min(4u, std::thread::hardware_concurrency() - 1u)) }, 
+		iDecode{ aDecode ? aDecode : decode_function{ &image_decoder::decode } },
+		iStopping{ false }
+	{
+	}
+
+	image_decoder::~image_decoder()
+	{
+		{
+			std::lock_guard<std::mutex> lock{ iMutex };
+			iStopping = true;
+		}
+		iWorkAvailable.notify_all();
+		for (auto& worker : iWorkers)
+			worker.join();
+	}
+
+	image_decoder& image_decoder::instance()
+	{
+		static image_decoder sInstance;
+		return sInstance;
+	}
+
+	decoded_image_cache& image_decoder::cache()
+	{
+		return iCache;
+	}
+
+	decoded_image_pointer image_decoder::decode(const std::string& aUri)
+	{
+		auto result = std::make_shared<decoded_image>();
+		result->uri = aUri;
+		try
+		{
+			auto resource = resource_manager::instance().load_resource(aUri);
+			if (resource->error())
+				result->error = resource->error_string();
+			else if (!resource->available() || resource->size() == 0u)
+				result->error = "neogfx::image_decoder: resource not available";
+			else
+			{
+				auto codec = image_codecs::instance().find_codec(resource->cdata(), resource->size());
+				if (codec == nullptr)
+					result->error = i_image::unknown_image_format().what();
+				else if (!codec->decode(resource->cdata(), resource->size(), result->pixels, result->extents, result->error) && result->error.empty())
+					result->error = "neogfx::image_decoder: " + codec->name() + " decoding failed";
+			}
+		}
+		catch (const std::exception& e)
+		{
+			result->error = e.what();
+		}
+		if (!result->error.empty())
+		{
+			result->pixels.clear();
+			result->extents = size{};
+		}
+		else
+			result->contentHash = neogfx::content_hash(&result->pixels[0], result->pixels.size()); // hashed here so the UI thread never has to
+		return result;
+	}
+
+	decoded_image_pointer image_decoder::decode_now(const std::string& aUri)
+	{
+		auto cached = iCache.find(aUri);
+		if (cached != nullptr)
+			return cached;
+		auto result = iDecode(aUri);
+		if (result->error.empty())
+			iCache.insert(result);
+		return result;
+	}
+
+	image_decoder::future image_decoder::decode_async(const std::string& aUri)
+	{
+		auto cached = iCache.find(aUri);
+		if (cached != nullptr)
+		{
+			std::promise<decoded_image_pointer> ready;
+			ready.set_value(cached);
+			return ready.get_future().share();
+		}
+		std::lock_guard<std::mutex> lock{ iMutex };
+		return enqueue(aUri)->result;
+	}
+
+	// If the image is already cached the completion is called before returning otherwise it is called on the calling 
+	// thread's event queue once decoding finishes.
+	void image_decoder::decode_async(const std::string& aUri, const completion& aCompletion)
+	{
+		auto cached = iCache.find(aUri);
+		if (cached != nullptr)
+		{
+			aCompletion(*cached);
+			return;
+		}
+		std::lock_guard<std::mutex> lock{ iMutex };
+		enqueue(aUri)->completions.emplace_back(std::this_thread::get_id(), aCompletion);
+	}
+
+	image_decoder::job_pointer image_decoder::enqueue(const std::string& aUri)
+	{
+		auto existing = iPending.find(aUri);
+		if (existing != iPending.end())
+			return existing->second;
+		auto newJob = std::make_shared<job>();
+		newJob->uri = aUri;
+		newJob->result = newJob->promise.get_future().share();
+		iPending[aUri] = newJob;
+		iQueue.push_back(newJob);
+		start_workers();
+		iWorkAvailable.notify_one();
+		return newJob;
+	}
+
+	void image_decoder::start_workers()
+	{
+		if (!iWorkers.empty())
+			return;
+		for (uint32_t i = 0u; i < iWorkerCount; ++i)
+			iWorkers.emplace_back([this]() { work(); });
+	}
+
+	void image_decoder::work()
+	{
+		for (;;)
+		{
+			job_pointer next;
+			{
+				std::unique_lock<std::mutex> lock{ iMutex };
+				iWorkAvailable.wait(lock, [this]() { return iStopping || !iQueue.empty(); });
+				if (iStopping)
+					return;
+				next = iQueue.front();
+				iQueue.pop_front();
+			}
+			complete(*next, iDecode(next->uri));
+		}
+	}
+
+	void image_decoder::complete(job& aJob, decoded_image_pointer aResult)
+	{
+		// cache before the job stops being pending so that a concurrent request cannot start a second decode
+		if (aResult->error.empty())
+			iCache.insert(aResult);
+		std::vector<std::pair<std::thread::id, completion>> completions;
+		{
+			std::lock_guard<std::mutex> lock{ iMutex };
+			iPending.erase(aJob.uri);
+			completions.swap(aJob.completions);
+		}
+		aJob.promise.set_value(aResult);
+		for (auto& c : completions)
+		{
+			try
+			{
+				auto callback = c.second;
+				async_event_queue::instance().enqueue_to_thread(c.first, [callback, aResult]() { callback(*aResult); });
+			}
+			catch (const async_event_queue::no_instance&)
+			{
+				// application gone; nobody left to notify
+			}
+		}
+	}
+}
@@ -0,0 +1,160 @@
+// opengl_frame_buffer.cpp
+/*
+  neogfx C++ GUI Library
+  Copyright (c) 2018 Leigh Johnston.  All Rights Reserved.
+
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <neogfx/neogfx.hpp>
+#include "opengl_frame_buffer.hpp"
+
+namespace neogfx
+{
+	opengl_frame_buffer::opengl_frame_buffer(bool aMultisample) :
+		iMultisample{ aMultisample },
+		iHandle{ 0 },
+		iTexture{ 0 },
+		iDepthStencilBuffer{ 0 }
+	{
+	}
+
+	opengl_frame_buffer::~opengl_frame_buffer()
+	{
+		release();
+	}
+
+	bool opengl_frame_buffer::multisample() const
+	{
+		return iMultisample;
+	}
+
+	bool opengl_frame_buffer::allocated() const
+	{
+		return iExtents != size{};
+	}
+
+	const size& opengl_frame_buffer::extents() const
+	{
+		return iExtents;
+	}
+
+	GLuint opengl_frame_buffer::handle() const
+	{
+		if (!allocated())
+			throw not_allocated();
+		return iHandle;
+	}
+
+	GLuint opengl_frame_buffer::texture_handle() const
+	{
+		if (!allocated())
+			throw not_allocated();
+		return iTexture;
+	}
+
+	void opengl_frame_buffer::bind(const size& aMinimumExtents)
+	{
+		if (iExtents.cx < aMinimumExtents.cx || iExtents.cy < aMinimumExtents.cy)
+		{
+			size newExtents{
+				iExtents.cx < aMinimumExtents.cx ? std::ceil(aMinimumExtents.cx * 1.5) : iExtents.cx,
+				iExtents.cy < aMinimumExtents.cy ? std::ceil(aMinimumExtents.cy * 1.5) : iExtents.cy };
+			release();
+			allocate(newExtents);
+		}
+		else
+		{
+			glCheck(glBindFramebuffer(GL_FRAMEBUFFER, iHandle));
+			glCheck(glBindTexture(iMultisample ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D, iTexture));
+			glCheck(glBindRenderbuffer(GL_RENDERBUFFER, iDepthStencilBuffer));
+		}
+		GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+		if (status != GL_NO_ERROR && status != GL_FRAMEBUFFER_COMPLETE)
+			throw failed_to_create_framebuffer(status);
+		GLenum drawBuffers[] = { GL_COLOR_ATTACHMENT0 };
+		glCheck(glDrawBuffers(sizeof(drawBuffers) / sizeof(drawBuffers[0]), drawBuffers));
+	}
+
+	void opengl_frame_buffer::resolve(const rect& aSourceRect, GLuint aTargetFrameBuffer, const rect& aTargetRect, bool aFlipVertically) const
+	{
+		GLint sourceY0 = static_cast<GLint>(aSourceRect.y);
+		GLint sourceY1 = static_cast<GLint>(aSourceRect.y + aSourceRect.cy);
+		GLint targetY0 = static_cast<GLint>(aFlipVertically ? aTargetRect.y + aTargetRect.cy : aTargetRect.y);
+		GLint targetY1 = static_cast<GLint>(aFlipVertically ? aTargetRect.y : aTargetRect.y + aTargetRect.cy);
+		// multisample resolves cannot scale so only non-multisample buffers may be filtered
+		GLenum filter = (!iMultisample && aSourceRect.extents() != aTargetRect.extents() ? GL_LINEAR : GL_NEAREST);
+		// blits are subject to the scissor test
+		GLboolean scissorEnabled;
+		glCheck(glGetBooleanv(GL_SCISSOR_TEST, &scissorEnabled));
+		glCheck(glDisable(GL_SCISSOR_TEST));
+		glCheck(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, aTargetFrameBuffer));
+		glCheck(glBindFramebuffer(GL_READ_FRAMEBUFFER, handle()));
+		glCheck(glBlitFramebuffer(
+			static_cast<GLint>(aSourceRect.x), sourceY0, static_cast<GLint>(aSourceRect.x + aSourceRect.cx), sourceY1,
+			static_cast<GLint>(aTargetRect.x), targetY0, static_cast<GLint>(aTargetRect.x + aTargetRect.cx), targetY1,
+			GL_COLOR_BUFFER_BIT, filter));
+		if (scissorEnabled == GL_TRUE)
+		{
+			glCheck(glEnable(GL_SCISSOR_TEST));
+		}
+	}
+
+	void opengl_frame_buffer::release()
+	{
+		if (!allocated())
+			return;
+		glCheck(glDeleteRenderbuffers(1, &iDepthStencilBuffer));
+		glCheck(glDeleteTextures(1, &iTexture));
+		glCheck(glDeleteFramebuffers(1, &iHandle));
+		iExtents = size{};
+		iHandle = 0;
+		iTexture = 0;
+		iDepthStencilBuffer = 0;
+	}
+
+	void opengl_frame_buffer::allocate(const size& aExtents)
+	{
+		iExtents = aExtents;
+		glCheck(glGenFramebuffers(1, &iHandle));
+		glCheck(glBindFramebuffer(GL_FRAMEBUFFER, iHandle));
+		glCheck(glGenTextures(1, &iTexture));
+		if (iMultisample)
+		{
+			glCheck(glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, iTexture));
+			glCheck(glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, 4, GL_RGBA8, static_cast<GLsizei>(iExtents.cx), static_cast<GLsizei>(iExtents.cy), true));
+			glCheck(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D_MULTISAMPLE, iTexture, 0));
+		}
+		else
+		{
+			glCheck(glBindTexture(GL_TEXTURE_2D, iTexture));
+			glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+			glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+			glCheck(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, static_cast<GLsizei>(iExtents.cx), static_cast<GLsizei>(iExtents.cy), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+			glCheck(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, iTexture, 0));
+		}
+		glCheck(glGenRenderbuffers(1, &iDepthStencilBuffer));
+		glCheck(glBindRenderbuffer(GL_RENDERBUFFER, iDepthStencilBuffer));
+		if (iMultisample)
+		{
+			glCheck(glRenderbufferStorageMultisample(GL_RENDERBUFFER, 4, GL_DEPTH24_STENCIL8, static_cast<GLsizei>(iExtents.cx), static_cast<GLsizei>(iExtents.cy)));
+		}
+		else
+		{
+			glCheck(glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, static_cast<GLsizei>(iExtents.cx), static_cast<GLsizei>(iExtents.cy)));
+		}
+		glCheck(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, iDepthStencilBuffer));
+		glCheck(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER, iDepthStencilBuffer));
+	}
+}
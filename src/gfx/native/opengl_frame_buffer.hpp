@@ -0,0 +1,61 @@
+// opengl_frame_buffer.hpp
+/*
+  neogfx C++ GUI Library
+  Copyright (c) 2018 Leigh Johnston.  All Rights Reserved.
+
+  This program is free software: you can redistribute it and / or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <neogfx/neogfx.hpp>
+#include <neogfx/core/geometrical.hpp>
+#include "opengl.hpp"
+
+namespace neogfx
+{
+	// Frame buffer storage is only ever grown (never shrunk) so that it can be reused across many render passes.
+	class opengl_frame_buffer
+	{
+	public:
+		struct failed_to_create_framebuffer : std::runtime_error {
+			failed_to_create_framebuffer(GLenum aErrorCode) :
+				std::runtime_error("neogfx::opengl_frame_buffer::failed_to_create_framebuffer: Failed to create frame buffer, reason: " + glErrorString(aErrorCode)) {} };
+		struct not_allocated : std::logic_error { not_allocated() : std::logic_error("neogfx::opengl_frame_buffer::not_allocated") {} };
+	public:
+		opengl_frame_buffer(bool aMultisample = true);
+		~opengl_frame_buffer();
+	private:
+		opengl_frame_buffer(const opengl_frame_buffer&) = delete;
+		opengl_frame_buffer& operator=(const opengl_frame_buffer&) = delete;
+	public:
+		bool multisample() const;
+		bool allocated() const;
+		const size& extents() const;
+		GLuint handle() const;
+		GLuint texture_handle() const;
+	public:
+		void bind(const size& aMinimumExtents);
+		void resolve(const rect& aSourceRect, GLuint aTargetFrameBuffer, const rect& aTargetRect, bool aFlipVertically = false) const;
+		void release();
+	private:
+		void allocate(const size& aExtents);
+	private:
+		bool iMultisample;
+		size iExtents;
+		GLuint iHandle;
+		GLuint iTexture;
+		GLuint iDepthStencilBuffer;
+	};
+}
@@ -163,6 +163,38 @@ namespace neogfx
 			return result;
 		}
 
+		inline std::array<uint8_t, 4> solid_colour(const colour& aColour)
+		{
+			return std::array<uint8_t, 4>{{ aColour.red(), aColour.green(), aColour.blue(), aColour.alpha() }};
+		}
+
+		template <typename VertexArrays, typename Vertices>
+		inline void insert_back_line_strip(VertexArrays& aVertexArrays, const Vertices& aLineStrip, const std::array<uint8_t, 4>& aColour)
+		{
+			if (aLineStrip.size() < 2)
+				return;
+			aVertexArrays.need((aLineStrip.size() - 1) * 2);
+			for (std::size_t i = 1; i < aLineStrip.size(); ++i)
+			{
+				aVertexArrays.push_back({ aLineStrip[i - 1], aColour });
+				aVertexArrays.push_back({ aLineStrip[i], aColour });
+			}
+		}
+
+		template <typename VertexArrays, typename Vertices>
+		inline void insert_back_triangle_fan(VertexArrays& aVertexArrays, const Vertices& aTriangleFan, const std::array<uint8_t, 4>& aColour)
+		{
+			if (aTriangleFan.size() < 3)
+				return;
+			aVertexArrays.need((aTriangleFan.size() - 2) * 3);
+			for (std::size_t i = 2; i < aTriangleFan.size(); ++i)
+			{
+				aVertexArrays.push_back({ aTriangleFan[0], aColour });
+				aVertexArrays.push_back({ aTriangleFan[i - 1], aColour });
+				aVertexArrays.push_back({ aTriangleFan[i], aColour });
+			}
+		}
+
 		struct with_textures_t {} with_textures;
 
 		class use_vertex_arrays
@@ -247,6 +279,14 @@ namespace neogfx
 				return *(begin() + aOffset);
 			}
 		public:
+			void need(std::size_t aAmount)
+			{
+				if (room_for(aAmount))
+					return;
+				execute();
+				if (!room_for(aAmount))
+					vertices().reserve(aAmount);
+			}
 			void push_back(const value_type& aVertex)
 			{
 				if (!room_for(1))
@@ -322,9 +362,10 @@ namespace neogfx
 			}
 			bool room_for(std::size_t aAmount) const
 			{
+				// a primitive is never split across a flush so room for the whole of the current (or next) primitive is required
 				auto pvc = primitive_vertex_count();
 				if (pvc != 0)
-					aAmount = std::max(aAmount, (pvc - ((vertices().size() - iStart) % pvc)) % pvc);
+					aAmount = std::max(aAmount, pvc - ((vertices().size() - iStart) % pvc));
 				return room() >= aAmount;
 			}
 			const opengl_standard_vertex_arrays::vertex_array& vertices() const
@@ -365,6 +406,7 @@ namespace neogfx
 		iLogicalCoordinateSystem(aSurface.logical_coordinate_system()),
 		iLogicalCoordinates(aSurface.logical_coordinates()), 
 		iSmoothingMode(neogfx::smoothing_mode::None),
+		iBlendingMode(neogfx::blending_mode::Default),
 		iSubpixelRendering(aRenderingEngine.is_subpixel_rendering_on()),
 		iClipCounter(0),
 		iLineStippleActive(false)
@@ -372,6 +414,7 @@ namespace neogfx
 		iRenderingEngine.activate_context(iSurface);
 		iRenderingEngine.activate_shader_program(*this, iRenderingEngine.default_shader_program());
 		set_smoothing_mode(neogfx::smoothing_mode::AntiAlias);
+		apply_blending_mode();
 	}
 
 	opengl_graphics_context::opengl_graphics_context(i_rendering_engine& aRenderingEngine, const i_native_surface& aSurface, const i_widget& aWidget) :
@@ -380,6 +423,7 @@ namespace neogfx
 		iLogicalCoordinateSystem(aWidget.logical_coordinate_system()),
 		iLogicalCoordinates(aSurface.logical_coordinates()),
 		iSmoothingMode(neogfx::smoothing_mode::None),
+		iBlendingMode(neogfx::blending_mode::Default),
 		iSubpixelRendering(aRenderingEngine.is_subpixel_rendering_on()),
 		iClipCounter(0),
 		iLineStippleActive(false)
@@ -387,6 +431,7 @@ namespace neogfx
 		iRenderingEngine.activate_context(iSurface);
 		iRenderingEngine.activate_shader_program(*this, iRenderingEngine.default_shader_program());
 		set_smoothing_mode(neogfx::smoothing_mode::AntiAlias);
+		apply_blending_mode();
 	}
 
 	opengl_graphics_context::opengl_graphics_context(const opengl_graphics_context& aOther) :
@@ -395,6 +440,7 @@ namespace neogfx
 		iLogicalCoordinateSystem(aOther.iLogicalCoordinateSystem),
 		iLogicalCoordinates(aOther.iLogicalCoordinates),
 		iSmoothingMode(aOther.iSmoothingMode), 
+		iBlendingMode(aOther.iBlendingMode),
 		iSubpixelRendering(aOther.iSubpixelRendering),
 		iClipCounter(0),
 		iLineStippleActive(false)
@@ -402,6 +448,7 @@ namespace neogfx
 		iRenderingEngine.activate_context(iSurface);
 		iRenderingEngine.activate_shader_program(*this, iRenderingEngine.default_shader_program());
 		set_smoothing_mode(iSmoothingMode);
+		apply_blending_mode();
 	}
 
 	opengl_graphics_context::~opengl_graphics_context()
@@ -431,7 +478,26 @@ namespace neogfx
 
 	const std::pair<vec2, vec2>& opengl_graphics_context::logical_coordinates() const
 	{
-		return get_logical_coordinates(surface().surface_size(), iLogicalCoordinateSystem, iLogicalCoordinates);
+		get_logical_coordinates(surface().surface_size(), iLogicalCoordinateSystem, iLogicalCoordinates);
+		if (surface().is_rendering_offscreen())
+		{
+			// map the offscreen widget, rather than the whole surface, onto the viewport
+			const rect sourceRect = surface().offscreen_widget().non_client_rect();
+			switch (iLogicalCoordinateSystem)
+			{
+			case neogfx::logical_coordinate_system::Specified:
+				break;
+			case neogfx::logical_coordinate_system::AutomaticGui:
+				iLogicalCoordinates.first = vec2{ sourceRect.left(), sourceRect.bottom() };
+				iLogicalCoordinates.second = vec2{ sourceRect.right(), sourceRect.top() };
+				break;
+			case neogfx::logical_coordinate_system::AutomaticGame:
+				iLogicalCoordinates.first = vec2{ sourceRect.left(), surface().surface_size().cy - sourceRect.bottom() };
+				iLogicalCoordinates.second = vec2{ sourceRect.right(), surface().surface_size().cy - sourceRect.top() };
+				break;
+			}
+		}
+		return iLogicalCoordinates;
 	}
 
 	void opengl_graphics_context::set_logical_coordinates(const std::pair<vec2, vec2>& aCoordinates) const
@@ -498,6 +564,10 @@ namespace neogfx
 				for (auto op = opBatch.first; op != opBatch.second; ++op)
 					set_smoothing_mode(static_variant_cast<const graphics_operation::set_smoothing_mode&>(*op).smoothingMode);
 				break;
+			case graphics_operation::operation_type::SetBlendingMode:
+				for (auto op = opBatch.first; op != opBatch.second; ++op)
+					set_blending_mode(static_variant_cast<const graphics_operation::set_blending_mode&>(*op).blendingMode);
+				break;
 			case graphics_operation::operation_type::PushLogicalOperation:
 				for (auto op = opBatch.first; op != opBatch.second; ++op)
 					push_logical_operation(static_variant_cast<const graphics_operation::push_logical_operation&>(*op).logicalOperation);
@@ -542,39 +612,11 @@ namespace neogfx
 					draw_pixel(static_variant_cast<const graphics_operation::draw_pixel&>(*op).point, static_variant_cast<const graphics_operation::draw_pixel&>(*op).colour);
 				break;
 			case graphics_operation::operation_type::DrawLine:
-				for (auto op = opBatch.first; op != opBatch.second; ++op)
-				{
-					const auto& args = static_cast<const graphics_operation::draw_line&>(*op);
-					draw_line(args.from, args.to, args.pen);
-				}
-				break;
 			case graphics_operation::operation_type::DrawRect:
-				for (auto op = opBatch.first; op != opBatch.second; ++op)
-				{
-					const auto& args = static_cast<const graphics_operation::draw_rect&>(*op);
-					draw_rect(args.rect, args.pen);
-				}
-				break;
 			case graphics_operation::operation_type::DrawRoundedRect:
-				for (auto op = opBatch.first; op != opBatch.second; ++op)
-				{
-					const auto& args = static_cast<const graphics_operation::draw_rounded_rect&>(*op);
-					draw_rounded_rect(args.rect, args.radius, args.pen);
-				}
-				break;
 			case graphics_operation::operation_type::DrawCircle:
-				for (auto op = opBatch.first; op != opBatch.second; ++op)
-				{
-					const auto& args = static_cast<const graphics_operation::draw_circle&>(*op);
-					draw_circle(args.centre, args.radius, args.pen, args.startAngle);
-				}
-				break;
 			case graphics_operation::operation_type::DrawArc:
-				for (auto op = opBatch.first; op != opBatch.second; ++op)
-				{
-					const auto& args = static_cast<const graphics_operation::draw_arc&>(*op);
-					draw_arc(args.centre, args.radius, args.startAngle, args.endAngle, args.pen);
-				}
+				draw_primitives(opBatch);
 				break;
 			case graphics_operation::operation_type::DrawPath:
 				for (auto op = opBatch.first; op != opBatch.second; ++op)
@@ -591,28 +633,10 @@ namespace neogfx
 				}
 				break;
 			case graphics_operation::operation_type::FillRect:
-				fill_rect(opBatch);
-				break;
 			case graphics_operation::operation_type::FillRoundedRect:
-				for (auto op = opBatch.first; op != opBatch.second; ++op)
-				{
-					const auto& args = static_cast<const graphics_operation::fill_rounded_rect&>(*op);
-					fill_rounded_rect(args.rect, args.radius, args.fill);
-				}
-				break;
 			case graphics_operation::operation_type::FillCircle:
-				for (auto op = opBatch.first; op != opBatch.second; ++op)
-				{
-					const auto& args = static_cast<const graphics_operation::fill_circle&>(*op);
-					fill_circle(args.centre, args.radius, args.fill);
-				}
-				break;
 			case graphics_operation::operation_type::FillArc:
-				for (auto op = opBatch.first; op != opBatch.second; ++op)
-				{
-					const auto& args = static_cast<const graphics_operation::fill_arc&>(*op);
-					fill_arc(args.centre, args.radius, args.startAngle, args.endAngle, args.fill);
-				}
+				fill_primitives(opBatch);
 				break;
 			case graphics_operation::operation_type::FillPath:
 				for (auto op = opBatch.first; op != opBatch.second; ++op)
@@ -675,27 +699,40 @@ namespace neogfx
 
 	void opengl_graphics_context::apply_scissor()
 	{
-		auto sr = *scissor_rect();
+		auto sr = surface().to_viewport(*scissor_rect());
 		GLint x = static_cast<GLint>(std::ceil(sr.x));
-		GLint y = static_cast<GLint>(std::ceil(rendering_area(false).cy - sr.cy - sr.y));
+		GLint y = static_cast<GLint>(std::ceil(sr.y));
 		GLsizei cx = static_cast<GLsizei>(std::ceil(sr.cx));
 		GLsizei cy = static_cast<GLsizei>(std::ceil(sr.cy));
 		glCheck(glScissor(x, y, cx, cy));
 	}
 
+	void opengl_graphics_context::apply_blending_mode()
+	{
+		glCheck(glEnable(GL_BLEND));
+		switch (iBlendingMode)
+		{
+		case neogfx::blending_mode::Default:
+			// destination alpha accumulates coverage so that offscreen layers hold premultiplied colour
+			glCheck(glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA));
+			break;
+		case neogfx::blending_mode::Premultiplied:
+			glCheck(glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA));
+			break;
+		}
+	}
+
 	void opengl_graphics_context::clip_to(const rect& aRect)
 	{
 		if (iClipCounter++ == 0)
 		{
-			glCheck(glClear(GL_STENCIL_BUFFER_BIT));
 			glCheck(glEnable(GL_STENCIL_TEST));
 		}
 		glCheck(glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE));
 		glCheck(glDepthMask(GL_FALSE));
 		glCheck(glStencilOp(GL_REPLACE, GL_KEEP, GL_KEEP));  // draw 1s on test fail (always)
 		glCheck(glStencilMask(static_cast<GLuint>(-1)));
-		glCheck(glStencilFunc(GL_NEVER, 0, static_cast<GLuint>(-1)));
-		fill_rect(rendering_area(), colour::White);
+		glCheck(glClear(GL_STENCIL_BUFFER_BIT));
 		glCheck(glStencilFunc(GL_NEVER, 1, static_cast<GLuint>(-1)));
 		fill_rect(aRect, colour::White);
 		glCheck(glStencilFunc(GL_NEVER, 1, static_cast<GLuint>(-1)));
@@ -710,15 +747,13 @@ namespace neogfx
 	{
 		if (iClipCounter++ == 0)
 		{
-			glCheck(glClear(GL_STENCIL_BUFFER_BIT));
 			glCheck(glEnable(GL_STENCIL_TEST));
 		}
 		glCheck(glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE));
 		glCheck(glDepthMask(GL_FALSE));
 		glCheck(glStencilOp(GL_REPLACE, GL_KEEP, GL_KEEP));  // draw 1s on test fail (always)
 		glCheck(glStencilMask(static_cast<GLuint>(-1)));
-		glCheck(glStencilFunc(GL_NEVER, 0, static_cast<GLuint>(-1)));
-		fill_rect(rendering_area(), colour::White);
+		glCheck(glClear(GL_STENCIL_BUFFER_BIT));
 		glCheck(glStencilFunc(GL_EQUAL, 1, static_cast<GLuint>(-1)));
 		for (std::size_t i = 0; i < aPath.paths().size(); ++i)
 		{
@@ -791,6 +826,17 @@ namespace neogfx
 		}
 	}
 
+	neogfx::blending_mode opengl_graphics_context::blending_mode() const
+	{
+		return iBlendingMode;
+	}
+
+	void opengl_graphics_context::set_blending_mode(neogfx::blending_mode aBlendingMode)
+	{
+		iBlendingMode = aBlendingMode;
+		apply_blending_mode();
+	}
+
 	void opengl_graphics_context::push_logical_operation(logical_operation aLogicalOperation)
 	{
 		iLogicalOperationStack.push_back(aLogicalOperation);
@@ -826,43 +872,29 @@ namespace neogfx
 	{
 		basic_rect<float> boundingBox{ aBoundingBox };
 		iShaderProgramStack.emplace_back(*this, iRenderingEngine, iRenderingEngine.gradient_shader_program());
-		iRenderingEngine.gradient_shader_program().set_uniform_variable("posViewportTop", static_cast<float>(logical_coordinates().first.y));
-		iRenderingEngine.gradient_shader_program().set_uniform_variable("posTopLeft", boundingBox.top_left().x, boundingBox.top_left().y);
-		iRenderingEngine.gradient_shader_program().set_uniform_variable("posBottomRight", boundingBox.bottom_right().x, boundingBox.bottom_right().y);
-		iRenderingEngine.gradient_shader_program().set_uniform_variable("nGradientDirection", static_cast<int>(aGradient.direction()));
-		iRenderingEngine.gradient_shader_program().set_uniform_variable("radGradientAngle", aGradient.orientation().is<double>() ? static_cast<float>(static_variant_cast<double>(aGradient.orientation())) : 0.0f);
-		iRenderingEngine.gradient_shader_program().set_uniform_variable("nGradientStartFrom", aGradient.orientation().is<gradient::corner_e>() ? static_cast<int>(static_variant_cast<gradient::corner_e>(aGradient.orientation())) : -1);
-		iRenderingEngine.gradient_shader_program().set_uniform_variable("nGradientSize", static_cast<int>(aGradient.size()));
-		iRenderingEngine.gradient_shader_program().set_uniform_variable("nGradientShape", static_cast<int>(aGradient.shape()));
+		iRenderingEngine.gradient_shader_program().set_uniform_variable(shader_uniform::PosViewportTop, static_cast<float>(logical_coordinates().first.y));
+		iRenderingEngine.gradient_shader_program().set_uniform_variable(shader_uniform::PosTopLeft, boundingBox.top_left().x, boundingBox.top_left().y);
+		iRenderingEngine.gradient_shader_program().set_uniform_variable(shader_uniform::PosBottomRight, boundingBox.bottom_right().x, boundingBox.bottom_right().y);
+		iRenderingEngine.gradient_shader_program().set_uniform_variable(shader_uniform::GradientDirection, static_cast<int>(aGradient.direction()));
+		iRenderingEngine.gradient_shader_program().set_uniform_variable(shader_uniform::GradientAngle, aGradient.orientation().is<double>() ? static_cast<float>(static_variant_cast<double>(aGradient.orientation())) : 0.0f);
+		iRenderingEngine.gradient_shader_program().set_uniform_variable(shader_uniform::GradientStartFrom, aGradient.orientation().is<gradient::corner_e>() ? static_cast<int>(static_variant_cast<gradient::corner_e>(aGradient.orientation())) : -1);
+		iRenderingEngine.gradient_shader_program().set_uniform_variable(shader_uniform::GradientSize, static_cast<int>(aGradient.size()));
+		iRenderingEngine.gradient_shader_program().set_uniform_variable(shader_uniform::GradientShape, static_cast<int>(aGradient.shape()));
 		basic_point<float> gradientCentre = (aGradient.centre() != boost::none ? *aGradient.centre() : point{});
-		iRenderingEngine.gradient_shader_program().set_uniform_variable("posGradientCentre", gradientCentre.x, gradientCentre.y);
-		auto combinedStops = aGradient.combined_stops();
-		iGradientStopPositions.reserve(combinedStops.size());
-		iGradientStopColours.reserve(combinedStops.size());
-		iGradientStopPositions.clear();
-		iGradientStopColours.clear();
-		for (const auto& stop : combinedStops)
-		{
-			iGradientStopPositions.push_back(static_cast<float>(stop.first));
-			iGradientStopColours.push_back(std::array<float, 4>{ {stop.second.red<float>(), stop.second.green<float>(), stop.second.blue<float>(), stop.second.alpha<float>()}});
-		}
-		iRenderingEngine.gradient_shader_program().set_uniform_variable("nStopCount", static_cast<int>(iGradientStopPositions.size()));
-		iRenderingEngine.gradient_shader_program().set_uniform_variable("nFilterSize", static_cast<int>(opengl_renderer::GRADIENT_FILTER_SIZE));
-		auto filter = static_gaussian_filter<float, opengl_renderer::GRADIENT_FILTER_SIZE>(static_cast<float>(aGradient.smoothness() * 10.0));
+		iRenderingEngine.gradient_shader_program().set_uniform_variable(shader_uniform::GradientCentre, gradientCentre.x, gradientCentre.y);
 		// todo: remove the following cast when gradient textures abstracted in rendering engine base class interface
-		auto& gradientTextures = static_cast<opengl_renderer&>(iRenderingEngine).gradient_textures(); 
+		auto& gradientTextures = static_cast<opengl_renderer&>(iRenderingEngine).gradient_textures(aGradient);
+		iRenderingEngine.gradient_shader_program().set_uniform_variable(shader_uniform::StopCount, static_cast<int>(gradientTextures.stopCount));
+		iRenderingEngine.gradient_shader_program().set_uniform_variable(shader_uniform::FilterSize, static_cast<int>(opengl_renderer::GRADIENT_FILTER_SIZE));
 		glCheck(glActiveTexture(GL_TEXTURE2));
-		glCheck(glBindTexture(GL_TEXTURE_RECTANGLE, gradientTextures[0]));
-		glCheck(glTexSubImage2D(GL_TEXTURE_RECTANGLE, 0, 0, 0, iGradientStopPositions.size(), 1, GL_RED, GL_FLOAT, &iGradientStopPositions[0]));
+		glCheck(glBindTexture(GL_TEXTURE_RECTANGLE, gradientTextures.textures[0]));
 		glCheck(glActiveTexture(GL_TEXTURE3));
-		glCheck(glBindTexture(GL_TEXTURE_RECTANGLE, gradientTextures[1]));
-		glCheck(glTexSubImage2D(GL_TEXTURE_RECTANGLE, 0, 0, 0, iGradientStopColours.size(), 1, GL_RGBA, GL_FLOAT, &iGradientStopColours[0]));
+		glCheck(glBindTexture(GL_TEXTURE_RECTANGLE, gradientTextures.textures[1]));
 		glCheck(glActiveTexture(GL_TEXTURE4));
-		glCheck(glBindTexture(GL_TEXTURE_RECTANGLE, gradientTextures[2]));
-		glCheck(glTexSubImage2D(GL_TEXTURE_RECTANGLE, 0, 0, 0, opengl_renderer::GRADIENT_FILTER_SIZE, opengl_renderer::GRADIENT_FILTER_SIZE, GL_RED, GL_FLOAT, &filter[0][0]));
-		iRenderingEngine.gradient_shader_program().set_uniform_variable("texStopPositions", 2);
-		iRenderingEngine.gradient_shader_program().set_uniform_variable("texStopColours", 3);
-		iRenderingEngine.gradient_shader_program().set_uniform_variable("texFilter", 4);
+		glCheck(glBindTexture(GL_TEXTURE_RECTANGLE, gradientTextures.textures[2]));
+		iRenderingEngine.gradient_shader_program().set_uniform_variable(shader_uniform::StopPositionsTexture, 2);
+		iRenderingEngine.gradient_shader_program().set_uniform_variable(shader_uniform::StopColoursTexture, 3);
+		iRenderingEngine.gradient_shader_program().set_uniform_variable(shader_uniform::FilterTexture, 4);
 		glCheck(glActiveTexture(GL_TEXTURE1));
 	}
 
@@ -988,7 +1020,8 @@ namespace neogfx
 		}
 
 		double pixelAdjust = pixel_adjust(aPen);
-		auto vertices = rounded_rect_vertices(aRect + point{ pixelAdjust, pixelAdjust }, aRadius, false);
+		auto& vertices = iTempVertices;
+		rounded_rect_vertices(vertices, aRect + point{ pixelAdjust, pixelAdjust }, aRadius, false);
 
 		glCheck(glLineWidth(static_cast<GLfloat>(aPen.width())));
 		{
@@ -1016,7 +1049,8 @@ namespace neogfx
 			gradient_on(gradient, gradient.rect() != boost::none ? *gradient.rect() : rect{ aCentre - size{aRadius, aRadius}, size{aRadius * 2.0, aRadius * 2.0 } });
 		}
 
-		auto vertices = circle_vertices(aCentre, aRadius, aStartAngle, false);
+		auto& vertices = iTempVertices;
+		circle_vertices(vertices, aCentre, aRadius, aStartAngle, false);
 
 		glCheck(glLineWidth(static_cast<GLfloat>(aPen.width())));
 		{
@@ -1044,7 +1078,8 @@ namespace neogfx
 			gradient_on(gradient, gradient.rect() != boost::none ? *gradient.rect() : rect{ aCentre - size{ aRadius, aRadius }, size{ aRadius * 2.0, aRadius * 2.0 } });
 		}
 
-		auto vertices = line_loop_to_lines(arc_vertices(aCentre, aRadius, aStartAngle, aEndAngle, false));;
+		arc_vertices(iTempVertices, aCentre, aRadius, aStartAngle, aEndAngle, false);
+		auto vertices = line_loop_to_lines(iTempVertices);
 
 		glCheck(glLineWidth(static_cast<GLfloat>(aPen.width())));
 		{
@@ -1172,7 +1207,8 @@ namespace neogfx
 		if (aFill.is<gradient>())
 			gradient_on(static_variant_cast<const gradient&>(aFill), aRect);
 
-		auto vertices = rounded_rect_vertices(aRect, aRadius, true);
+		auto& vertices = iTempVertices;
+		rounded_rect_vertices(vertices, aRect, aRadius, true);
 		
 		{
 			use_vertex_arrays vertexArrays{ *this, GL_TRIANGLE_FAN, vertices.size() };
@@ -1197,7 +1233,8 @@ namespace neogfx
 		if (aFill.is<gradient>())
 			gradient_on(static_variant_cast<const gradient&>(aFill), rect{ aCentre - point{ aRadius, aRadius }, size{ aRadius * 2.0 } });
 
-		auto vertices = circle_vertices(aCentre, aRadius, 0.0, true);
+		auto& vertices = iTempVertices;
+		circle_vertices(vertices, aCentre, aRadius, 0.0, true);
 
 		{
 			use_vertex_arrays vertexArrays{ *this, GL_TRIANGLE_FAN, vertices.size() };
@@ -1222,7 +1259,8 @@ namespace neogfx
 		if (aFill.is<gradient>())
 			gradient_on(static_variant_cast<const gradient&>(aFill), rect{ aCentre - point{ aRadius, aRadius }, size{ aRadius * 2.0 } });
 
-		auto vertices = arc_vertices(aCentre, aRadius, aStartAngle, aEndAngle, true);
+		auto& vertices = iTempVertices;
+		arc_vertices(vertices, aCentre, aRadius, aStartAngle, aEndAngle, true);
 
 		{
 			use_vertex_arrays vertexArrays{ *this, GL_TRIANGLE_FAN, vertices.size() };
@@ -1244,44 +1282,107 @@ namespace neogfx
 
 	void opengl_graphics_context::fill_path(const path& aPath, const brush& aFill)
 	{
-		for (std::size_t i = 0; i < aPath.paths().size(); ++i)
+		auto fillColour = aFill.is<colour>() ?
+			std::array <uint8_t, 4>{{
+				static_variant_cast<const colour&>(aFill).red(),
+				static_variant_cast<const colour&>(aFill).green(),
+				static_variant_cast<const colour&>(aFill).blue(),
+				static_variant_cast<const colour&>(aFill).alpha()}} :
+			std::array <uint8_t, 4>{};
+
+		if (aPath.shape() != path::ConvexPolygon)
 		{
-			if (aPath.paths()[i].size() > 2)
+			if (aFill.is<gradient>())
+				gradient_on(static_variant_cast<const gradient&>(aFill), aPath.bounding_rect());
+			for (std::size_t i = 0; i < aPath.paths().size(); ++i)
 			{
-				clip_to(aPath, 0.0);
-				point min = aPath.paths()[i][0];
-				point max = min;
-				for (auto const& pt : aPath.paths()[i])
-				{
-					min = min.min(pt);
-					max = max.max(pt);
-				}
-
-				if (aFill.is<gradient>())
-					gradient_on(static_variant_cast<const gradient&>(aFill), rect{ point{ min.x, min.y }, size{ max.x - min.y, max.y - min.y } });
-
-				auto vertices = aPath.to_vertices(aPath.paths()[i]);
-
+				if (aPath.paths()[i].size() > 2)
 				{
+					auto vertices = aPath.to_vertices(aPath.paths()[i]);
 					use_vertex_arrays vertexArrays{ *this, path_shape_to_gl_mode(aPath.shape()), vertices.size() };
 					for (const auto& v : vertices)
-					{
-						vertexArrays.push_back({v, aFill.is<colour>() ?
-							std::array <uint8_t, 4>{{
-								static_variant_cast<const colour&>(aFill).red(),
-								static_variant_cast<const colour&>(aFill).green(),
-								static_variant_cast<const colour&>(aFill).blue(),
-								static_variant_cast<const colour&>(aFill).alpha()}} :
-							std::array <uint8_t, 4>{}});
-					}
+						vertexArrays.push_back({ v, fillColour });
 				}
+			}
+			if (aFill.is<gradient>())
+				gradient_off();
+			return;
+		}
 
-				reset_clip();
+		std::vector<std::vector<xyz>> polygons;
+		for (auto const& subPath : aPath.paths())
+		{
+			if (subPath.size() > 2)
+			{
+				polygons.emplace_back();
+				polygons.back().reserve(subPath.size());
+				for (auto const& pt : subPath)
+					polygons.back().push_back(xyz{ pt.x + aPath.position().x, pt.y + aPath.position().y });
+			}
+		}
+		if (polygons.empty())
+			return;
 
-				if (aFill.is<gradient>())
-					gradient_off();
+		auto const boundingRect = aPath.bounding_rect();
+
+		if (aFill.is<gradient>())
+			gradient_on(static_variant_cast<const gradient&>(aFill), boundingRect);
+
+		// a single simple polygon (the common case) is tessellated and drawn directly without touching the stencil buffer
+		std::vector<xyz> triangles;
+		if (polygons.size() == 1 && tessellate_polygon(polygons[0], triangles))
+		{
+			use_vertex_arrays vertexArrays{ *this, GL_TRIANGLES, triangles.size() };
+			for (const auto& v : triangles)
+				vertexArrays.push_back({ v, fillColour });
+		}
+		else
+		{
+			// self-intersecting or multiple polygons: stencil then cover according to the path's fill rule, restricting
+			// all stencil work to the path's bounding box
+			scissor_on(boundingRect);
+			if (iClipCounter++ == 0)
+			{
+				glCheck(glEnable(GL_STENCIL_TEST));
+			}
+			glCheck(glStencilMask(static_cast<GLuint>(-1)));
+			glCheck(glClear(GL_STENCIL_BUFFER_BIT));
+			glCheck(glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE));
+			glCheck(glDepthMask(GL_FALSE));
+			glCheck(glStencilFunc(GL_ALWAYS, 0, static_cast<GLuint>(-1)));
+			if (aPath.fill_rule() == path::EvenOdd)
+			{
+				glCheck(glStencilOp(GL_KEEP, GL_KEEP, GL_INVERT));
 			}
+			else
+			{
+				glCheck(glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_KEEP, GL_INCR_WRAP));
+				glCheck(glStencilOpSeparate(GL_BACK, GL_KEEP, GL_KEEP, GL_DECR_WRAP));
+			}
+			for (auto const& polygon : polygons)
+			{
+				use_vertex_arrays vertexArrays{ *this, GL_TRIANGLE_FAN, polygon.size() };
+				for (const auto& v : polygon)
+					vertexArrays.push_back({ v, fillColour });
+			}
+			glCheck(glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE));
+			glCheck(glDepthMask(GL_TRUE));
+			glCheck(glStencilMask(0x00));
+			glCheck(glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP));
+			glCheck(glStencilFunc(GL_NOTEQUAL, 0, static_cast<GLuint>(-1)));
+			{
+				use_vertex_arrays vertexArrays{ *this, GL_TRIANGLES, 6u };
+				auto newVertices = insert_back_rect_vertices(vertexArrays, boundingRect, 0.0, rect_type::FilledTriangles);
+				for (auto i = newVertices; i != vertexArrays.end(); ++i)
+					i->rgba = colour_to_vec4f(fillColour);
+			}
+			glCheck(glStencilFunc(GL_EQUAL, 1, static_cast<GLuint>(-1)));
+			reset_clip();
+			scissor_off();
 		}
+
+		if (aFill.is<gradient>())
+			gradient_off();
 	}
 
 	void opengl_graphics_context::fill_shape(const graphics_operation::batch& aFillShapeOps)
@@ -1336,6 +1437,187 @@ namespace neogfx
 			gradient_off();
 	}
 
+	void opengl_graphics_context::draw_primitives(const graphics_operation::batch& aDrawOps)
+	{
+		auto const& firstOp = *aDrawOps.first;
+		const pen& firstPen = *graphics_operation::primitive_pen(firstOp);
+
+		if (!firstPen.colour().is<colour>())
+		{
+			// gradient pens are never batched
+			switch (firstOp.which())
+			{
+			case graphics_operation::operation_type::DrawLine:
+				{
+					const auto& args = static_variant_cast<const graphics_operation::draw_line&>(firstOp);
+					draw_line(args.from, args.to, args.pen);
+				}
+				break;
+			case graphics_operation::operation_type::DrawRect:
+				{
+					const auto& args = static_variant_cast<const graphics_operation::draw_rect&>(firstOp);
+					draw_rect(args.rect, args.pen);
+				}
+				break;
+			case graphics_operation::operation_type::DrawRoundedRect:
+				{
+					const auto& args = static_variant_cast<const graphics_operation::draw_rounded_rect&>(firstOp);
+					draw_rounded_rect(args.rect, args.radius, args.pen);
+				}
+				break;
+			case graphics_operation::operation_type::DrawCircle:
+				{
+					const auto& args = static_variant_cast<const graphics_operation::draw_circle&>(firstOp);
+					draw_circle(args.centre, args.radius, args.pen, args.startAngle);
+				}
+				break;
+			case graphics_operation::operation_type::DrawArc:
+				{
+					const auto& args = static_variant_cast<const graphics_operation::draw_arc&>(firstOp);
+					draw_arc(args.centre, args.radius, args.startAngle, args.endAngle, args.pen);
+				}
+				break;
+			}
+			return;
+		}
+
+		double pixelAdjust = pixel_adjust(firstPen);
+
+		glCheck(glLineWidth(static_cast<GLfloat>(firstPen.width())));
+		{
+			use_vertex_arrays vertexArrays{ *this, GL_LINES };
+			temp_vec3_buffer<8> rectVertices;
+			for (auto op = aDrawOps.first; op != aDrawOps.second; ++op)
+			{
+				switch (op->which())
+				{
+				case graphics_operation::operation_type::DrawLine:
+					{
+						const auto& args = static_variant_cast<const graphics_operation::draw_line&>(*op);
+						auto penColour = solid_colour(static_variant_cast<const colour&>(args.pen.colour()));
+						vertexArrays.need(2u);
+						vertexArrays.push_back({ xyz{ args.from.x + pixelAdjust, args.from.y + pixelAdjust }, penColour });
+						vertexArrays.push_back({ xyz{ args.to.x + pixelAdjust, args.to.y + pixelAdjust }, penColour });
+					}
+					break;
+				case graphics_operation::operation_type::DrawRect:
+					{
+						const auto& args = static_variant_cast<const graphics_operation::draw_rect&>(*op);
+						auto penColour = solid_colour(static_variant_cast<const colour&>(args.pen.colour()));
+						calc_rect_vertices(rectVertices, args.rect, pixelAdjust, rect_type::Outline);
+						vertexArrays.need(rectVertices.size());
+						for (const auto& v : rectVertices)
+							vertexArrays.push_back({ v, penColour });
+					}
+					break;
+				case graphics_operation::operation_type::DrawRoundedRect:
+					{
+						const auto& args = static_variant_cast<const graphics_operation::draw_rounded_rect&>(*op);
+						rounded_rect_vertices(iTempVertices, args.rect + point{ pixelAdjust, pixelAdjust }, args.radius, false);
+						insert_back_line_strip(vertexArrays, iTempVertices, solid_colour(static_variant_cast<const colour&>(args.pen.colour())));
+					}
+					break;
+				case graphics_operation::operation_type::DrawCircle:
+					{
+						const auto& args = static_variant_cast<const graphics_operation::draw_circle&>(*op);
+						circle_vertices(iTempVertices, args.centre, args.radius, args.startAngle, false);
+						insert_back_line_strip(vertexArrays, iTempVertices, solid_colour(static_variant_cast<const colour&>(args.pen.colour())));
+					}
+					break;
+				case graphics_operation::operation_type::DrawArc:
+					{
+						const auto& args = static_variant_cast<const graphics_operation::draw_arc&>(*op);
+						arc_vertices(iTempVertices, args.centre, args.radius, args.startAngle, args.endAngle, false);
+						insert_back_line_strip(vertexArrays, iTempVertices, solid_colour(static_variant_cast<const colour&>(args.pen.colour())));
+					}
+					break;
+				}
+			}
+		}
+		glCheck(glLineWidth(1.0f));
+	}
+
+	void opengl_graphics_context::fill_primitives(const graphics_operation::batch& aFillOps)
+	{
+		auto const& firstOp = *aFillOps.first;
+		const brush& firstFill = *graphics_operation::primitive_fill(firstOp);
+
+		if (!firstFill.is<colour>())
+		{
+			// gradient fills are never batched
+			switch (firstOp.which())
+			{
+			case graphics_operation::operation_type::FillRect:
+				fill_rect(aFillOps);
+				break;
+			case graphics_operation::operation_type::FillRoundedRect:
+				{
+					const auto& args = static_variant_cast<const graphics_operation::fill_rounded_rect&>(firstOp);
+					fill_rounded_rect(args.rect, args.radius, args.fill);
+				}
+				break;
+			case graphics_operation::operation_type::FillCircle:
+				{
+					const auto& args = static_variant_cast<const graphics_operation::fill_circle&>(firstOp);
+					fill_circle(args.centre, args.radius, args.fill);
+				}
+				break;
+			case graphics_operation::operation_type::FillArc:
+				{
+					const auto& args = static_variant_cast<const graphics_operation::fill_arc&>(firstOp);
+					fill_arc(args.centre, args.radius, args.startAngle, args.endAngle, args.fill);
+				}
+				break;
+			}
+			return;
+		}
+
+		use_shader_program usp{ *this, iRenderingEngine, iRenderingEngine.default_shader_program() };
+
+		use_vertex_arrays vertexArrays{ *this, GL_TRIANGLES };
+		temp_vec3_buffer<8> rectVertices;
+		for (auto op = aFillOps.first; op != aFillOps.second; ++op)
+		{
+			switch (op->which())
+			{
+			case graphics_operation::operation_type::FillRect:
+				{
+					const auto& args = static_variant_cast<const graphics_operation::fill_rect&>(*op);
+					auto fillColour = solid_colour(static_variant_cast<const colour&>(args.fill));
+					calc_rect_vertices(rectVertices, args.rect, 0.0, rect_type::FilledTriangles);
+					vertexArrays.need(rectVertices.size());
+					for (const auto& v : rectVertices)
+						vertexArrays.push_back({ v, fillColour });
+				}
+				break;
+			case graphics_operation::operation_type::FillRoundedRect:
+				{
+					const auto& args = static_variant_cast<const graphics_operation::fill_rounded_rect&>(*op);
+					if (!args.rect.empty())
+					{
+						rounded_rect_vertices(iTempVertices, args.rect, args.radius, true);
+						insert_back_triangle_fan(vertexArrays, iTempVertices, solid_colour(static_variant_cast<const colour&>(args.fill)));
+					}
+				}
+				break;
+			case graphics_operation::operation_type::FillCircle:
+				{
+					const auto& args = static_variant_cast<const graphics_operation::fill_circle&>(*op);
+					circle_vertices(iTempVertices, args.centre, args.radius, 0.0, true);
+					insert_back_triangle_fan(vertexArrays, iTempVertices, solid_colour(static_variant_cast<const colour&>(args.fill)));
+				}
+				break;
+			case graphics_operation::operation_type::FillArc:
+				{
+					const auto& args = static_variant_cast<const graphics_operation::fill_arc&>(*op);
+					arc_vertices(iTempVertices, args.centre, args.radius, args.startAngle, args.endAngle, true);
+					insert_back_triangle_fan(vertexArrays, iTempVertices, solid_colour(static_variant_cast<const colour&>(args.fill)));
+				}
+				break;
+			}
+		}
+	}
+
 	namespace
 	{
 		void texture_vertices(const size& aTextureStorageSize, const rect& aTextureRect, const std::pair<vec2, vec2>& aLogicalCoordinates, std::vector<vec2>& aResult)
@@ -1491,8 +1773,7 @@ namespace neogfx
 
 		glCheck(glBindTexture(GL_TEXTURE_2D, reinterpret_cast<GLuint>(firstGlyphTexture.texture().native_texture()->handle())));
 
-		glCheck(glEnable(GL_BLEND));
-		glCheck(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+		apply_blending_mode();
 
 		disable_anti_alias daa(*this);
 
@@ -1505,13 +1786,14 @@ namespace neogfx
 			rendering_engine().vertex_arrays().instantiate_with_texture_coords(*this, shader);
 
 			bool guiCoordinates = (logical_coordinates().first.y > logical_coordinates().second.y);
-			shader.set_uniform_variable("guiCoordinates", guiCoordinates);
-			shader.set_uniform_variable("outputExtents", static_cast<float>(iSurface.surface_size().cx), static_cast<float>(iSurface.surface_size().cy));
+			shader.set_uniform_variable(shader_uniform::GuiCoordinates, guiCoordinates);
+			const size outputExtents = iSurface.to_viewport(rendering_area(false)).extents();
+			shader.set_uniform_variable(shader_uniform::OutputExtents, static_cast<float>(outputExtents.cx), static_cast<float>(outputExtents.cy));
 			
-			shader.set_uniform_variable("glyphTexture", 1);
+			shader.set_uniform_variable(shader_uniform::GlyphTexture, 1);
 
 			if (firstOp.glyph.subpixel() && firstGlyphTexture.subpixel())
-				shader.set_uniform_variable("outputTexture", 2);
+				shader.set_uniform_variable(shader_uniform::OutputTexture, 2);
 
 			glCheck(glTextureBarrier());
 
@@ -1571,15 +1853,15 @@ namespace neogfx
 						*/}
 						break;
 					}
-					shader.set_uniform_variable("subpixel", static_cast<int>(firstGlyphTexture.subpixel()));
-					shader.set_uniform_variable("effect", static_cast<int>(firstOp.appearance.effect().type()));
+					shader.set_uniform_variable(shader_uniform::Subpixel, static_cast<int>(firstGlyphTexture.subpixel()));
+					shader.set_uniform_variable(shader_uniform::Effect, static_cast<int>(firstOp.appearance.effect().type()));
 					vertexArrays.draw(count, barrier_partitions(firstOp.appearance.effect()));
 				}
 			}
 			else if (pass == 2)
 			{
-				shader.set_uniform_variable("subpixel", static_cast<int>(firstGlyphTexture.subpixel()));
-				shader.set_uniform_variable("effect", 0);
+				shader.set_uniform_variable(shader_uniform::Subpixel, static_cast<int>(firstGlyphTexture.subpixel()));
+				shader.set_uniform_variable(shader_uniform::Effect, 0);
 			}
 		}
 
@@ -1593,10 +1875,8 @@ namespace neogfx
 
 	void opengl_graphics_context::draw_textures(const i_mesh& aMesh, const optional_colour& aColour, shader_effect aShaderEffect)
 	{
-		auto face_cmp = [&aMesh](const face& aLhs, const face& aRhs) { return (*aMesh.textures())[aLhs.texture].first->native_texture()->handle() < (*aMesh.textures())[aRhs.texture].first->native_texture()->handle(); };
-		if (!std::is_sorted(aMesh.faces().begin(), aMesh.faces().end(), face_cmp))
-			std::sort(aMesh.faces().begin(), aMesh.faces().end(), face_cmp);
-
+		// faces are drawn in the order given; meshes should keep faces sharing a texture together (as instanced_sprites
+		// does) as each change of texture costs a flush
 		colour colourizationColour{ 0xFF, 0xFF, 0xFF, 0xFF };
 		if (aColour != boost::none)
 			colourizationColour = *aColour;
@@ -1604,33 +1884,35 @@ namespace neogfx
 		auto transformedVertices = aMesh.transformed_vertices(); // todo: have vertex shader do this transformation
 
 		use_shader_program usp{ *this, iRenderingEngine, iRenderingEngine.texture_shader_program() };
-		iRenderingEngine.active_shader_program().set_uniform_variable("effect", static_cast<int>(aShaderEffect));
+		iRenderingEngine.active_shader_program().set_uniform_variable(shader_uniform::Effect, static_cast<int>(aShaderEffect));
 
 		glCheck(glActiveTexture(GL_TEXTURE1));
-		glCheck(glEnable(GL_BLEND));
-		glCheck(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+		apply_blending_mode();
 		GLint previousTexture;
 		glCheck(glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture));
-		glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
 
 		{
 			use_vertex_arrays vertexArrays{ *this, GL_TRIANGLES, with_textures };
 
 			GLuint textureHandle = 0;
 			bool first = true;
-			bool newTexture = false;
+			std::size_t facesWithTexture = 0;
 			for (auto const& f : aMesh.faces())
 			{
 				auto const& texture = *(*aMesh.textures())[f.texture].first;
 
 				if (first || textureHandle != reinterpret_cast<GLuint>(texture.native_texture()->handle()))
 				{
-					newTexture = true;
+					// draw the faces batched so far while their texture is still bound
+					if (!first)
+						vertexArrays.execute();
+					facesWithTexture = 0;
 					textureHandle = reinterpret_cast<GLuint>(texture.native_texture()->handle());
-					glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, texture.sampling() == texture_sampling::NormalMipmap ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR));
 					glCheck(glBindTexture(GL_TEXTURE_2D, textureHandle));
+					glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, texture.sampling() == texture_sampling::NormalMipmap ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR));
+					glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
 					if (first)
-						iRenderingEngine.active_shader_program().set_uniform_variable("tex", 1);
+						iRenderingEngine.active_shader_program().set_uniform_variable(shader_uniform::Texture, 1);
 				}
 
 				auto textureRect = (*aMesh.textures())[f.texture].second ? *(*aMesh.textures())[f.texture].second : rect{ point{ 0.0, 0.0 }, texture.extents() };
@@ -1640,12 +1922,9 @@ namespace neogfx
 				iTempTextureCoords.clear();
 				texture_vertices(texture.storage_extents(), textureRect + point{ 1.0, 1.0 }, logical_coordinates(), iTempTextureCoords);
 
-				if (newTexture)
-				{
-					newTexture = false;
-					if (!first)
-						vertexArrays.execute();
-				}
+				// reserve a whole quad (two faces) at a time so that a flush never falls inside a sprite
+				if (facesWithTexture++ % 2 == 0)
+					vertexArrays.need(6);
 
 				for (auto vi : f.vertices)
 				{
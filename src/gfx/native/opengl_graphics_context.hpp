@@ -79,6 +79,8 @@ namespace neogfx
 		void reset_clip();
 		neogfx::smoothing_mode smoothing_mode() const;
 		void set_smoothing_mode(neogfx::smoothing_mode aSmoothingMode);
+		neogfx::blending_mode blending_mode() const;
+		void set_blending_mode(neogfx::blending_mode aBlendingMode);
 		void push_logical_operation(logical_operation aLogicalOperation);
 		void pop_logical_operation();
 		void line_stipple_on(uint32_t aFactor, uint16_t aPattern);
@@ -104,11 +106,14 @@ namespace neogfx
 		void fill_arc(const point& aCentre, dimension aRadius, angle aStartAngle, angle aEndAngle, const brush& aFill);
 		void fill_path(const path& aPath, const brush& aFill);
 		void fill_shape(const graphics_operation::batch& aFillShapeOps);
+		void draw_primitives(const graphics_operation::batch& aDrawOps);
+		void fill_primitives(const graphics_operation::batch& aFillOps);
 		void draw_glyph(const graphics_operation::batch& aDrawGlyphOps);
 		void draw_textures(const i_mesh& aMesh, const optional_colour& aColour, shader_effect aShaderEffect);
 	private:
 		std::size_t max_operations(const graphics_operation::operation& aOperation);
 		void apply_scissor();
+		void apply_blending_mode();
 		void apply_logical_operation();
 		void gradient_on(const gradient& aGradient, const rect& aBoundingBox);
 		void gradient_off();
@@ -120,6 +125,7 @@ namespace neogfx
 		neogfx::logical_coordinate_system iLogicalCoordinateSystem;
 		mutable std::pair<vec2, vec2> iLogicalCoordinates;
 		neogfx::smoothing_mode iSmoothingMode; 
+		neogfx::blending_mode iBlendingMode;
 		bool iSubpixelRendering;
 		std::vector<logical_operation> iLogicalOperationStack;
 		std::list<use_shader_program> iShaderProgramStack;
@@ -128,10 +134,9 @@ namespace neogfx
 		mutable optional_rect iScissorRect;
 		GLint iPreviousTexture;
 		bool iLineStippleActive;
-		std::vector<float> iGradientStopPositions;
-		std::vector<std::array<float, 4>> iGradientStopColours;
 		font iLastDrawGlyphFallbackFont;
 		boost::optional<uint8_t> iLastDrawGlyphFallbackFontIndex;
 		std::vector<vec2> iTempTextureCoords;
+		std::vector<xyz> iTempVertices;
 	};
 }
\ No newline at end of file
@@ -18,6 +18,10 @@
 */
 
 #include <neogfx/neogfx.hpp>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
 #include <boost/filesystem.hpp>
 
 #ifdef _WIN32
@@ -27,6 +31,7 @@
 #endif
 
 #include <neogfx/core/numerical.hpp>
+#include <neogfx/gfx/graphics_context.hpp>
 #include "opengl_renderer.hpp"
 #include "../../gui/window/native/opengl_window.hpp"
 
@@ -65,9 +70,38 @@ namespace neogfx
 			iWidgets.erase(iterWidget);
 	}
 
+	namespace
+	{
+		const std::array<const char*, static_cast<std::size_t>(shader_uniform::Count)> sStandardUniformNames =
+		{{
+			"posViewportTop",
+			"posTopLeft",
+			"posBottomRight",
+			"nGradientDirection",
+			"radGradientAngle",
+			"nGradientStartFrom",
+			"nGradientSize",
+			"nGradientShape",
+			"posGradientCentre",
+			"nStopCount",
+			"nFilterSize",
+			"texStopPositions",
+			"texStopColours",
+			"texFilter",
+			"guiCoordinates",
+			"outputExtents",
+			"glyphTexture",
+			"outputTexture",
+			"subpixel",
+			"effect",
+			"tex"
+		}};
+	}
+
 	opengl_renderer::shader_program::shader_program(GLuint aHandle, bool aHasProjectionMatrix) :
-		iHandle(aHandle), iHasProjectionMatrix(aHasProjectionMatrix)
+		iHandle(aHandle), iHasProjectionMatrix(aHasProjectionMatrix), iProjectionMatrix(-1)
 	{
+		iStandardUniforms.fill(-1);
 	}
 
 	void* opengl_renderer::shader_program::handle() const
@@ -97,7 +131,7 @@ namespace neogfx
 				{ 0.0, 2.0 / (top - bottom), 0.0, -(top + bottom) / (top - bottom) },
 				{ 0.0, 0.0, -2.0 / (zFar - zNear), -(zFar + zNear) / (zFar - zNear) },
 				{ 0.0, 0.0, 0.0, 1.0 } }.transposed();
-			set_uniform_matrix("uProjectionMatrix", basic_matrix<float, 4, 4>{ orthoMatrix });
+			set_uniform_matrix(iProjectionMatrix, basic_matrix<float, 4, 4>{ orthoMatrix });
 		}
 	}
 
@@ -110,92 +144,72 @@ namespace neogfx
 		return reinterpret_cast<void*>(v->second);
 	}
 
-	void opengl_renderer::shader_program::set_uniform_variable(const std::string& aName, float aValue)
+	opengl_renderer::shader_program::uniform_id opengl_renderer::shader_program::uniform(const std::string& aName) const
 	{
-		glUniform1f(uniform_location(aName), aValue);
-		GLenum errorCode = glGetError();
-		if (errorCode != GL_NO_ERROR)
-			throw shader_program_error(errorCode);
+		auto u = iUniforms.find(aName);
+		if (u == iUniforms.end())
+			return -1;
+		return u->second;
 	}
 
-	void opengl_renderer::shader_program::set_uniform_variable(const std::string& aName, double aValue)
+	opengl_renderer::shader_program::uniform_id opengl_renderer::shader_program::uniform(shader_uniform aUniform) const
 	{
-		glUniform1d(uniform_location(aName), aValue);
-		GLenum errorCode = glGetError();
-		if (errorCode != GL_NO_ERROR)
-			throw shader_program_error(errorCode);
+		return iStandardUniforms[static_cast<std::size_t>(aUniform)];
 	}
 
-	void opengl_renderer::shader_program::set_uniform_variable(const std::string& aName, int aValue)
+	void opengl_renderer::shader_program::set_uniform_variable(uniform_id aUniform, float aValue)
 	{
-		glUniform1i(uniform_location(aName), aValue);
-		GLenum errorCode = glGetError();
-		if (errorCode != GL_NO_ERROR)
-			throw shader_program_error(errorCode);
+		glUniform1f(aUniform, aValue);
 	}
 
-	void opengl_renderer::shader_program::set_uniform_variable(const std::string& aName, double aValue1, double aValue2)
+	void opengl_renderer::shader_program::set_uniform_variable(uniform_id aUniform, double aValue)
 	{
-		glUniform2d(uniform_location(aName), aValue1, aValue2);
-		GLenum errorCode = glGetError();
-		if (errorCode != GL_NO_ERROR)
-			throw shader_program_error(errorCode);
+		glUniform1d(aUniform, aValue);
 	}
 
-	void opengl_renderer::shader_program::set_uniform_variable(const std::string& aName, float aValue1, float aValue2)
+	void opengl_renderer::shader_program::set_uniform_variable(uniform_id aUniform, int aValue)
 	{
-		glUniform2f(uniform_location(aName), aValue1, aValue2);
-		GLenum errorCode = glGetError();
-		if (errorCode != GL_NO_ERROR)
-			throw shader_program_error(errorCode);
+		glUniform1i(aUniform, aValue);
 	}
 
-	void opengl_renderer::shader_program::set_uniform_variable(const std::string& aName, const vec4f& aVector)
+	void opengl_renderer::shader_program::set_uniform_variable(uniform_id aUniform, double aValue1, double aValue2)
 	{
-		glUniform4f(uniform_location(aName), aVector[0], aVector[1], aVector[2], aVector[3]);
-		GLenum errorCode = glGetError();
-		if (errorCode != GL_NO_ERROR)
-			throw shader_program_error(errorCode);
+		glUniform2d(aUniform, aValue1, aValue2);
 	}
 
-	void opengl_renderer::shader_program::set_uniform_variable(const std::string& aName, const vec4& aVector)
+	void opengl_renderer::shader_program::set_uniform_variable(uniform_id aUniform, float aValue1, float aValue2)
 	{
-		glUniform4d(uniform_location(aName), aVector[0], aVector[1], aVector[2], aVector[3]);
-		GLenum errorCode = glGetError();
-		if (errorCode != GL_NO_ERROR)
-			throw shader_program_error(errorCode);
+		glUniform2f(aUniform, aValue1, aValue2);
 	}
 
-	void opengl_renderer::shader_program::set_uniform_array(const std::string& aName, uint32_t aSize, const float* aArray)
+	void opengl_renderer::shader_program::set_uniform_variable(uniform_id aUniform, const vec4f& aVector)
 	{
-		glUniform1fv(uniform_location(aName), aSize, aArray);
-		GLenum errorCode = glGetError();
-		if (errorCode != GL_NO_ERROR)
-			throw shader_program_error(errorCode);
+		glUniform4f(aUniform, aVector[0], aVector[1], aVector[2], aVector[3]);
 	}
 
-	void opengl_renderer::shader_program::set_uniform_array(const std::string& aName, uint32_t aSize, const double* aArray)
+	void opengl_renderer::shader_program::set_uniform_variable(uniform_id aUniform, const vec4& aVector)
 	{
-		glUniform1dv(uniform_location(aName), aSize, aArray);
-		GLenum errorCode = glGetError();
-		if (errorCode != GL_NO_ERROR)
-			throw shader_program_error(errorCode);
+		glUniform4d(aUniform, aVector[0], aVector[1], aVector[2], aVector[3]);
 	}
 
-	void opengl_renderer::shader_program::set_uniform_matrix(const std::string& aName, const mat44::template rebind<float>::type& aMatrix)
+	void opengl_renderer::shader_program::set_uniform_array(uniform_id aUniform, uint32_t aSize, const float* aArray)
 	{
-		glUniformMatrix4fv(uniform_location(aName), 1, false, aMatrix.data());
-		GLenum errorCode = glGetError();
-		if (errorCode != GL_NO_ERROR)
-			throw shader_program_error(errorCode);
+		glUniform1fv(aUniform, aSize, aArray);
 	}
 
-	void opengl_renderer::shader_program::set_uniform_matrix(const std::string& aName, const mat44::template rebind<double>::type& aMatrix)
+	void opengl_renderer::shader_program::set_uniform_array(uniform_id aUniform, uint32_t aSize, const double* aArray)
 	{
-		glUniformMatrix4dv(uniform_location(aName), 1, false, aMatrix.data());
-		GLenum errorCode = glGetError();
-		if (errorCode != GL_NO_ERROR)
-			throw shader_program_error(errorCode);
+		glUniform1dv(aUniform, aSize, aArray);
+	}
+
+	void opengl_renderer::shader_program::set_uniform_matrix(uniform_id aUniform, const mat44::template rebind<float>::type& aMatrix)
+	{
+		glUniformMatrix4fv(aUniform, 1, false, aMatrix.data());
+	}
+
+	void opengl_renderer::shader_program::set_uniform_matrix(uniform_id aUniform, const mat44::template rebind<double>::type& aMatrix)
+	{
+		glUniformMatrix4dv(aUniform, 1, false, aMatrix.data());
 	}
 
 	GLuint opengl_renderer::shader_program::register_variable(const std::string& aVariableName)
@@ -210,13 +224,47 @@ namespace neogfx
 		return iHandle < aRhs.iHandle;
 	}
 
-	GLint opengl_renderer::shader_program::uniform_location(const std::string& aName)
+	void opengl_renderer::shader_program::resolve_uniforms()
 	{
-		GLint var = glGetUniformLocation(iHandle, aName.c_str());
-		GLenum errorCode = glGetError();
-		if (errorCode != GL_NO_ERROR)
-			throw shader_program_error(errorCode);
-		return var;
+		iUniforms.clear();
+		GLint uniformCount = 0;
+		glCheck(glGetProgramiv(iHandle, GL_ACTIVE_UNIFORMS, &uniformCount));
+		GLint maxNameLength = 0;
+		glCheck(glGetProgramiv(iHandle, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength));
+		std::vector<GLchar> name(std::max<GLint>(maxNameLength, 1));
+		for (GLint i = 0; i < uniformCount; ++i)
+		{
+			GLsizei nameLength = 0;
+			GLint size = 0;
+			GLenum type = 0;
+			glCheck(glGetActiveUniform(iHandle, static_cast<GLuint>(i), static_cast<GLsizei>(name.size()), &nameLength, &size, &type, &name[0]));
+			auto const uniformName = uniform_name(std::string{ &name[0], static_cast<std::size_t>(nameLength) });
+			iUniforms[uniformName] = glCheck(glGetUniformLocation(iHandle, uniformName.c_str()));
+		}
+		iProjectionMatrix = uniform("uProjectionMatrix");
+		resolve_standard_uniforms(iUniforms, iStandardUniforms);
+	}
+
+	std::string opengl_renderer::shader_program::uniform_name(const std::string& aActiveUniformName)
+	{
+		// arrays are reported as "name[0]" but are set by their plain name
+		if (aActiveUniformName.size() > 3 && aActiveUniformName.compare(aActiveUniformName.size() - 3, 3, "[0]") == 0)
+			return aActiveUniformName.substr(0, aActiveUniformName.size() - 3);
+		return aActiveUniformName;
+	}
+
+	const char* opengl_renderer::shader_program::standard_uniform_name(shader_uniform aUniform)
+	{
+		return sStandardUniformNames.at(static_cast<std::size_t>(aUniform));
+	}
+
+	void opengl_renderer::shader_program::resolve_standard_uniforms(const uniform_map& aUniforms, standard_uniform_list& aStandardUniforms)
+	{
+		for (std::size_t u = 0; u < aStandardUniforms.size(); ++u)
+		{
+			auto existing = aUniforms.find(sStandardUniformNames[u]);
+			aStandardUniforms[u] = (existing != aUniforms.end() ? existing->second : -1);
+		}
 	}
 
 	opengl_renderer::opengl_renderer(neogfx::renderer aRenderer) :
@@ -233,11 +281,9 @@ namespace neogfx
 	opengl_renderer::~opengl_renderer()
 	{
 		iVertexArrays.reset();
-		if (iGradientTextures != boost::none)
+		for (auto& g : iGradientCache)
 		{
-			glCheck(glDeleteTextures(1, &(*iGradientTextures)[0]));
-			glCheck(glDeleteTextures(1, &(*iGradientTextures)[1]));
-			glCheck(glDeleteTextures(1, &(*iGradientTextures)[2]));
+			glCheck(glDeleteTextures(static_cast<GLsizei>(g.textures.size()), &g.textures[0]));
 		}
 	}
 
@@ -257,6 +303,16 @@ namespace neogfx
 		std::cout << "OpenGL renderer: " << reinterpret_cast<const char*>(glGetString(GL_RENDERER)) << std::endl;
 		std::cout << "OpenGL version: " << reinterpret_cast<const char*>(glGetString(GL_VERSION)) << std::endl;
 		std::cout << "OpenGL shading language version: " << reinterpret_cast<const char*>(glGetString(GL_SHADING_LANGUAGE_VERSION)) << std::endl;
+
+		if (GLEW_ARB_get_program_binary)
+		{
+			GLint binaryFormats = 0;
+			glCheck(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormats));
+			if (binaryFormats > 0)
+				iProgramBinaryCache = std::string{ reinterpret_cast<const char*>(glGetString(GL_VENDOR)) } + "|" +
+					reinterpret_cast<const char*>(glGetString(GL_RENDERER)) + "|" +
+					reinterpret_cast<const char*>(glGetString(GL_VERSION));
+		}
 			
 		iDefaultProgram = create_shader_program(
 			shaders
@@ -837,36 +893,92 @@ namespace neogfx
 		}
 	}
 
-	const std::array<GLuint, 3>& opengl_renderer::gradient_textures() const
+	const opengl_renderer::cached_gradient& opengl_renderer::gradient_textures(const gradient& aGradient)
 	{
 		// todo: use texture class
 		glCheck(glEnable(GL_TEXTURE_RECTANGLE));
-		if (iGradientTextures == boost::none)
+		// only the stops and the smoothness affect texture contents; everything else is a shader uniform
+		iGradientKey.clear();
+		iGradientKey.push_back(aGradient.smoothness());
+		iGradientKey.push_back(static_cast<double>(aGradient.colour_stop_count()));
+		for (auto s = aGradient.colour_begin(); s != aGradient.colour_end(); ++s)
 		{
-			iGradientTextures.emplace(std::array<GLuint, 3>{});
-			glCheck(glGenTextures(1, &(*iGradientTextures)[0]));
-			glCheck(glGenTextures(1, &(*iGradientTextures)[1]));
-			glCheck(glGenTextures(1, &(*iGradientTextures)[2]));
-			GLint previousTexture;
-			glCheck(glGetIntegerv(GL_TEXTURE_BINDING_RECTANGLE, &previousTexture));
-			glCheck(glBindTexture(GL_TEXTURE_RECTANGLE, (*iGradientTextures)[0]));
-			glCheck(glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
-			glCheck(glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
-			static const std::array<float, gradient::MaxStops> sZeroStopPositions = {};
-			glCheck(glTexImage2D(GL_TEXTURE_RECTANGLE, 0, GL_R32F, static_cast<GLsizei>(gradient::MaxStops), 1, 0, GL_RED, GL_FLOAT, &sZeroStopPositions[0]));
-			glCheck(glBindTexture(GL_TEXTURE_RECTANGLE, (*iGradientTextures)[1]));
-			glCheck(glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
-			glCheck(glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
-			static const std::array<std::array<uint8_t, 4>, gradient::MaxStops> sZeroStopColours = {};
-			glCheck(glTexImage2D(GL_TEXTURE_RECTANGLE, 0, GL_RGBA, static_cast<GLsizei>(gradient::MaxStops), 1, 0, GL_RGBA, GL_FLOAT, &sZeroStopColours[0]));
-			glCheck(glBindTexture(GL_TEXTURE_RECTANGLE, (*iGradientTextures)[2]));
-			glCheck(glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
-			glCheck(glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
-			static const std::array<float, GRADIENT_FILTER_SIZE * GRADIENT_FILTER_SIZE> sFilter = {};
-			glCheck(glTexImage2D(GL_TEXTURE_RECTANGLE, 0, GL_R32F, GRADIENT_FILTER_SIZE, GRADIENT_FILTER_SIZE, 0, GL_RED, GL_FLOAT, &sFilter[0]));
-			glCheck(glBindTexture(GL_TEXTURE_RECTANGLE, previousTexture));
+			iGradientKey.push_back(s->first);
+			iGradientKey.push_back(static_cast<double>(s->second.value()));
 		}
-		return *iGradientTextures;
+		for (auto s = aGradient.alpha_begin(); s != aGradient.alpha_end(); ++s)
+		{
+			iGradientKey.push_back(s->first);
+			iGradientKey.push_back(static_cast<double>(s->second));
+		}
+		auto existing = iGradientCacheIndex.find(iGradientKey);
+		if (existing != iGradientCacheIndex.end())
+		{
+			iGradientCache.splice(iGradientCache.begin(), iGradientCache, existing->second);
+			return iGradientCache.front();
+		}
+		if (iGradientCache.size() >= GRADIENT_CACHE_SIZE)
+		{
+			// recycle the least recently used entry's textures
+			iGradientCacheIndex.erase(iGradientCache.back().key);
+			iGradientCache.splice(iGradientCache.begin(), iGradientCache, std::prev(iGradientCache.end()));
+		}
+		else
+		{
+			iGradientCache.emplace_front();
+			glCheck(glGenTextures(static_cast<GLsizei>(iGradientCache.front().textures.size()), &iGradientCache.front().textures[0]));
+		}
+		auto& entry = iGradientCache.front();
+		entry.key = iGradientKey;
+		iGradientCacheIndex[entry.key] = iGradientCache.begin();
+		auto combinedStops = aGradient.combined_stops();
+		entry.stopCount = static_cast<uint32_t>(combinedStops.size());
+		std::vector<float> stopPositions;
+		std::vector<std::array<float, 4>> stopColours;
+		stopPositions.reserve(combinedStops.size());
+		stopColours.reserve(combinedStops.size());
+		for (const auto& stop : combinedStops)
+		{
+			stopPositions.push_back(static_cast<float>(stop.first));
+			stopColours.push_back(std::array<float, 4>{ {stop.second.red<float>(), stop.second.green<float>(), stop.second.blue<float>(), stop.second.alpha<float>()}});
+		}
+		auto filter = static_gaussian_filter<float, GRADIENT_FILTER_SIZE>(static_cast<float>(aGradient.smoothness() * 10.0));
+		GLint previousTexture;
+		glCheck(glGetIntegerv(GL_TEXTURE_BINDING_RECTANGLE, &previousTexture));
+		glCheck(glBindTexture(GL_TEXTURE_RECTANGLE, entry.textures[0]));
+		glCheck(glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+		glCheck(glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+		glCheck(glTexImage2D(GL_TEXTURE_RECTANGLE, 0, GL_R32F, static_cast<GLsizei>(stopPositions.size()), 1, 0, GL_RED, GL_FLOAT, &stopPositions[0]));
+		glCheck(glBindTexture(GL_TEXTURE_RECTANGLE, entry.textures[1]));
+		glCheck(glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+		glCheck(glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+		glCheck(glTexImage2D(GL_TEXTURE_RECTANGLE, 0, GL_RGBA, static_cast<GLsizei>(stopColours.size()), 1, 0, GL_RGBA, GL_FLOAT, &stopColours[0]));
+		glCheck(glBindTexture(GL_TEXTURE_RECTANGLE, entry.textures[2]));
+		glCheck(glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+		glCheck(glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+		glCheck(glTexImage2D(GL_TEXTURE_RECTANGLE, 0, GL_R32F, GRADIENT_FILTER_SIZE, GRADIENT_FILTER_SIZE, 0, GL_RED, GL_FLOAT, &filter[0][0]));
+		glCheck(glBindTexture(GL_TEXTURE_RECTANGLE, previousTexture));
+		return entry;
+	}
+
+	void opengl_renderer::render_to_texture(i_widget& aWidget, i_texture& aTarget)
+	{
+		render_to_texture(aWidget, aTarget.extents(), 1.0, aTarget);
+	}
+
+	void opengl_renderer::render_to_texture(i_widget& aWidget, const size& aExtents, dimension aDpiScaleFactor, i_texture& aTarget)
+	{
+		aWidget.surface().native_surface().render_to_texture(aWidget, aExtents, aDpiScaleFactor, aTarget);
+	}
+
+	void opengl_renderer::render_to_image(i_widget& aWidget, i_image& aTarget)
+	{
+		render_to_image(aWidget, aWidget.extents(), 1.0, aTarget);
+	}
+
+	void opengl_renderer::render_to_image(i_widget& aWidget, const size& aExtents, dimension aDpiScaleFactor, i_image& aTarget)
+	{
+		aWidget.surface().native_surface().render_to_image(aWidget, aExtents, aDpiScaleFactor, aTarget);
 	}
 
 	bool opengl_renderer::process_events()
@@ -918,18 +1030,43 @@ namespace neogfx
 		return 0;
 	}
 
+	std::string opengl_renderer::program_cache_key(const std::string& aDriver, const shaders& aShaders, const std::vector<std::string>& aVariables)
+	{
+		// FNV-1a; the separator keeps ("ab", "c") and ("a", "bc") apart
+		uint64_t hash = 14695981039346656037ull;
+		auto combine = [&hash](const std::string& aText)
+		{
+			for (auto ch : aText)
+			{
+				hash ^= static_cast<uint8_t>(ch);
+				hash *= 1099511628211ull;
+			}
+			hash ^= 0xFF;
+			hash *= 1099511628211ull;
+		};
+		combine(aDriver);
+		for (const auto& s : aShaders)
+		{
+			combine(s.first);
+			combine(std::to_string(s.second));
+		}
+		for (const auto& v : aVariables)
+			combine(v);
+		std::ostringstream key;
+		key << std::hex << std::setw(16) << std::setfill('0') << hash;
+		return key.str();
+	}
+
 	opengl_renderer::shader_programs::iterator opengl_renderer::create_shader_program(const shaders& aShaders, const std::vector<std::string>& aVariables)
 	{
 		GLuint programHandle = glCheck(glCreateProgram());
 		if (0 == programHandle)
 			throw failed_to_create_shader_program("Failed to create shader program object");
 		bool hasProjectionMatrix = false;
-		for (auto& s : aShaders)
+		shaders sources = aShaders;
+		for (auto& s : sources)
 		{
-			GLuint shader = glCheck(glCreateShader(s.second));
-			if (0 == shader)
-				throw failed_to_create_shader_program("Failed to create shader object");
-			std::string source = s.first;
+			std::string& source = s.first;
 			if (source.find("uProjectionMatrix") != std::string::npos)
 				hasProjectionMatrix = true;
 			if (renderer() == neogfx::renderer::DirectX)
@@ -941,31 +1078,154 @@ namespace neogfx
 				else if ((v = source.find("#version 150")) != std::string::npos)
 					source.replace(v, VERSION_STRING_LENGTH, "#version 110");
 			}
-			const char* codeArray[] = { source.c_str() };
-			glCheck(glShaderSource(shader, 1, codeArray, NULL));
-			glCheck(glCompileShader(shader));
-			GLint result;
-			glCheck(glGetShaderiv(shader, GL_COMPILE_STATUS, &result));
-			if (GL_FALSE == result)
-			{
-				GLint buflen;
-				glCheck(glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &buflen));
-				std::vector<GLchar> buf(buflen);
-				glCheck(glGetShaderInfoLog(shader, buf.size(), NULL, &buf[0]));
-				std::string error(&buf[0]);
-				throw failed_to_create_shader_program(error);
-			}
-			glCheck(glAttachShader(programHandle, shader));
 		}
 		shader_program program(programHandle, hasProjectionMatrix);
 		for (auto& v : aVariables)
 			glCheck(glBindAttribLocation(programHandle, program.register_variable(v), v.c_str()));
 		auto s = iShaderPrograms.insert(iShaderPrograms.end(), program);
-		glCheck(glLinkProgram(programHandle));
-		GLint result;
-		glCheck(glGetProgramiv(programHandle, GL_LINK_STATUS, &result));
-		if (GL_FALSE == result)
-			throw failed_to_create_shader_program("Failed to link");
+		std::string cacheKey;
+		if (iProgramBinaryCache != boost::none)
+			cacheKey = program_cache_key(*iProgramBinaryCache, sources, aVariables);
+		if (cacheKey.empty() || !load_program_binary(cacheKey, programHandle))
+		{
+			for (auto& source : sources)
+			{
+				GLuint shader = glCheck(glCreateShader(source.second));
+				if (0 == shader)
+					throw failed_to_create_shader_program("Failed to create shader object");
+				const char* codeArray[] = { source.first.c_str() };
+				glCheck(glShaderSource(shader, 1, codeArray, NULL));
+				glCheck(glCompileShader(shader));
+				GLint result;
+				glCheck(glGetShaderiv(shader, GL_COMPILE_STATUS, &result));
+				if (GL_FALSE == result)
+				{
+					GLint buflen;
+					glCheck(glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &buflen));
+					std::vector<GLchar> buf(buflen);
+					glCheck(glGetShaderInfoLog(shader, buf.size(), NULL, &buf[0]));
+					std::string error(&buf[0]);
+					throw failed_to_create_shader_program(error);
+				}
+				glCheck(glAttachShader(programHandle, shader));
+			}
+			if (!cacheKey.empty())
+			{
+				glCheck(glProgramParameteri(programHandle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+			}
+			glCheck(glLinkProgram(programHandle));
+			GLint result;
+			glCheck(glGetProgramiv(programHandle, GL_LINK_STATUS, &result));
+			if (GL_FALSE == result)
+				throw failed_to_create_shader_program("Failed to link");
+			if (!cacheKey.empty())
+				save_program_binary(cacheKey, programHandle);
+		}
+		s->resolve_uniforms();
 		return s;
 	}
-}
\ No newline at end of file
+
+	// Program binaries are kept per user as they are only as trustworthy as the directory they are loaded from; the
+	// shared temporary directory is never used. Empty if the platform has no per user cache directory to offer.
+	boost::filesystem::path opengl_renderer::program_binary_directory()
+	{
+		boost::filesystem::path base;
+#ifdef _WIN32
+		if (auto localAppData = std::getenv("LOCALAPPDATA"))
+			base = localAppData;
+#else
+		if (auto xdgCacheHome = std::getenv("XDG_CACHE_HOME"))
+			base = xdgCacheHome;
+		else if (auto home = std::getenv("HOME"))
+		{
+#ifdef __APPLE__
+			base = boost::filesystem::path{ home } / "Library" / "Caches";
+#else
+			base = boost::filesystem::path{ home } / ".cache";
+#endif
+		}
+#endif
+		if (base.empty() || !base.is_absolute())
+			return boost::filesystem::path{};
+		return base / "neogfx" / "shader_cache";
+	}
+
+	namespace
+	{
+		boost::filesystem::path program_binary_path(const std::string& aKey)
+		{
+			auto const directory = opengl_renderer::program_binary_directory();
+			if (directory.empty())
+				return directory;
+			return directory / (aKey + ".bin");
+		}
+	}
+
+	bool opengl_renderer::load_program_binary(const std::string& aKey, GLuint aProgram) const
+	{
+		boost::system::error_code ec;
+		auto const path = program_binary_path(aKey);
+		if (path.empty() || !boost::filesystem::exists(path, ec))
+			return false;
+		std::ifstream input{ path.string(), std::ios::in | std::ios::binary };
+		GLenum format = 0;
+		if (!input.read(reinterpret_cast<char*>(&format), sizeof(format)))
+			return false;
+		std::vector<char> binary{ std::istreambuf_iterator<char>{ input }, std::istreambuf_iterator<char>{} };
+		if (binary.empty())
+			return false;
+		// a driver update can invalidate saved binaries in which case we fall back to compiling from source; errors
+		// left pending by earlier calls are drained first so that they are not taken as the binary being rejected
+		for (uint32_t pending = 0; pending < 16u && glGetError() != GL_NO_ERROR; ++pending)
+			;
+		glProgramBinary(aProgram, format, &binary[0], static_cast<GLsizei>(binary.size()));
+		GLint result = GL_FALSE;
+		if (glGetError() == GL_NO_ERROR)
+		{
+			glCheck(glGetProgramiv(aProgram, GL_LINK_STATUS, &result));
+		}
+		if (GL_FALSE == result)
+		{
+			boost::filesystem::remove(path, ec);
+			return false;
+		}
+		return true;
+	}
+
+	void opengl_renderer::save_program_binary(const std::string& aKey, GLuint aProgram) const
+	{
+		GLint length = 0;
+		glCheck(glGetProgramiv(aProgram, GL_PROGRAM_BINARY_LENGTH, &length));
+		if (length <= 0)
+			return;
+		std::vector<char> binary(static_cast<std::size_t>(length));
+		GLenum format = 0;
+		glCheck(glGetProgramBinary(aProgram, length, nullptr, &format, &binary[0]));
+		boost::system::error_code ec;
+		auto const path = program_binary_path(aKey);
+		if (path.empty())
+			return;
+		boost::filesystem::create_directories(path.parent_path(), ec);
+		if (ec)
+			return;
+		// written to a temporary file that is then renamed over the cache entry so that an interrupted write never
+		// leaves a truncated binary behind
+		auto const temporaryPath = path.parent_path() / boost::filesystem::unique_path(aKey + ".%%%%-%%%%-%%%%.tmp", ec);
+		if (ec)
+			return;
+		{
+			std::ofstream output{ temporaryPath.string(), std::ios::out | std::ios::binary | std::ios::trunc };
+			output.write(reinterpret_cast<const char*>(&format), sizeof(format));
+			output.write(&binary[0], binary.size());
+			output.close();
+			if (!output)
+			{
+				boost::filesystem::remove(temporaryPath, ec);
+				return;
+			}
+		}
+		boost::filesystem::rename(temporaryPath, path, ec);
+		if (ec)
+			boost::filesystem::remove(temporaryPath, ec);
+	}
+}
@@ -22,6 +22,10 @@
 #include <neogfx/neogfx.hpp>
 #include <set>
 #include <map>
+#include <unordered_map>
+#include <array>
+#include <boost/functional/hash.hpp>
+#include <boost/filesystem/path.hpp>
 #include "opengl.hpp"
 #include <neogfx/gfx/i_rendering_engine.hpp>
 #include <neogfx/gfx/text/font_manager.hpp>
@@ -64,6 +68,12 @@ namespace neogfx
 		{
 		public:
 			typedef std::map<std::string, GLuint> variable_map;
+			typedef std::unordered_map<std::string, uniform_id> uniform_map;
+			typedef std::array<uniform_id, static_cast<std::size_t>(shader_uniform::Count)> standard_uniform_list;
+		public:
+			using i_shader_program::set_uniform_variable;
+			using i_shader_program::set_uniform_array;
+			using i_shader_program::set_uniform_matrix;
 		public:
 			shader_program(GLuint aHandle, bool aHasProjectionMatrix);
 		public:
@@ -71,31 +81,43 @@ namespace neogfx
 			bool has_projection_matrix() const override;
 			void set_projection_matrix(const i_native_graphics_context& aGraphicsContext) override;
 			void* variable(const std::string& aVariableName) const override;
-			void set_uniform_variable(const std::string& aName, float aValue) override;
-			void set_uniform_variable(const std::string& aName, double aValue) override;
-			void set_uniform_variable(const std::string& aName, int aValue) override;
-			void set_uniform_variable(const std::string& aName, float aValue1, float aValue2) override;
-			void set_uniform_variable(const std::string& aName, double aValue1, double aValue2) override;
-			void set_uniform_variable(const std::string& aName, const vec4f& aVector) override;
-			void set_uniform_variable(const std::string& aName, const vec4& aVector) override;
-			void set_uniform_array(const std::string& aName, uint32_t aSize, const float* aArray) override;
-			void set_uniform_array(const std::string& aName, uint32_t aSize, const double* aArray) override;
-			void set_uniform_matrix(const std::string& aName, const mat44::template rebind<float>::type& aMatrix) override;
-			void set_uniform_matrix(const std::string& aName, const mat44::template rebind<double>::type& aMatrix) override;
+			uniform_id uniform(const std::string& aName) const override;
+			uniform_id uniform(shader_uniform aUniform) const override;
+			void set_uniform_variable(uniform_id aUniform, float aValue) override;
+			void set_uniform_variable(uniform_id aUniform, double aValue) override;
+			void set_uniform_variable(uniform_id aUniform, int aValue) override;
+			void set_uniform_variable(uniform_id aUniform, float aValue1, float aValue2) override;
+			void set_uniform_variable(uniform_id aUniform, double aValue1, double aValue2) override;
+			void set_uniform_variable(uniform_id aUniform, const vec4f& aVector) override;
+			void set_uniform_variable(uniform_id aUniform, const vec4& aVector) override;
+			void set_uniform_array(uniform_id aUniform, uint32_t aSize, const float* aArray) override;
+			void set_uniform_array(uniform_id aUniform, uint32_t aSize, const double* aArray) override;
+			void set_uniform_matrix(uniform_id aUniform, const mat44::template rebind<float>::type& aMatrix) override;
+			void set_uniform_matrix(uniform_id aUniform, const mat44::template rebind<double>::type& aMatrix) override;
 		public:
 			GLuint register_variable(const std::string& aVariableName);
+			void resolve_uniforms();
+		public:
+			static std::string uniform_name(const std::string& aActiveUniformName);
+			static const char* standard_uniform_name(shader_uniform aUniform);
+			static void resolve_standard_uniforms(const uniform_map& aUniforms, standard_uniform_list& aStandardUniforms);
 		public:
 			bool operator<(const shader_program& aRhs) const;
-		private:
-			GLint uniform_location(const std::string& aName);
 		private:
 			GLuint iHandle;
 			bool iHasProjectionMatrix;
 			std::pair<vec2, vec2> iLogicalCoordinates;
 			variable_map iVariables;
+			uniform_map iUniforms;
+			standard_uniform_list iStandardUniforms;
+			uniform_id iProjectionMatrix;
 		};
-	private:
+	public:
 		typedef std::vector<std::pair<std::string, GLenum>> shaders;
+	public:
+		static std::string program_cache_key(const std::string& aDriver, const shaders& aShaders, const std::vector<std::string>& aVariables);
+		static boost::filesystem::path program_binary_directory();
+	private:
 		typedef std::list<shader_program> shader_programs;
 	public:
 		opengl_renderer(neogfx::renderer aRenderer);
@@ -130,7 +152,20 @@ namespace neogfx
 		void subpixel_rendering_off() override;
 	public:
 		static const uint32_t GRADIENT_FILTER_SIZE = 15;
-		const std::array<GLuint, 3>& gradient_textures() const; // todo: use texture class and add to base class interface
+		static const std::size_t GRADIENT_CACHE_SIZE = 64;
+		typedef std::vector<double> gradient_key;
+		struct cached_gradient
+		{
+			gradient_key key;
+			std::array<GLuint, 3> textures; // stop positions, stop colours, filter
+			uint32_t stopCount;
+		};
+		const cached_gradient& gradient_textures(const gradient& aGradient); // todo: use texture class and add to base class interface
+	public:
+		void render_to_texture(i_widget& aWidget, i_texture& aTarget) override;
+		void render_to_texture(i_widget& aWidget, const size& aExtents, dimension aDpiScaleFactor, i_texture& aTarget) override;
+		void render_to_image(i_widget& aWidget, i_image& aTarget) override;
+		void render_to_image(i_widget& aWidget, const size& aExtents, dimension aDpiScaleFactor, i_image& aTarget) override;
 	public:
 		bool process_events() override;
 	public:
@@ -139,6 +174,8 @@ namespace neogfx
 		uint32_t frame_counter(uint32_t aDuration) const override;
 	private:
 		shader_programs::iterator create_shader_program(const shaders& aShaders, const std::vector<std::string>& aVariables);
+		bool load_program_binary(const std::string& aKey, GLuint aProgram) const;
+		void save_program_binary(const std::string& aKey, GLuint aProgram) const;
 	private:
 		neogfx::renderer iRenderer;
 		opengl_texture_manager iTextureManager;
@@ -151,7 +188,10 @@ namespace neogfx
 		shader_programs::iterator iGlyphSubpixelProgram;
 		shader_programs::iterator iGradientProgram;
 		bool iSubpixelRendering;
-		mutable boost::optional<std::array<GLuint, 3>> iGradientTextures;
+		boost::optional<std::string> iProgramBinaryCache; // driver identification; none if the driver cannot save program binaries
+		gradient_key iGradientKey;
+		std::list<cached_gradient> iGradientCache; // most recently used first
+		std::unordered_map<gradient_key, std::list<cached_gradient>::iterator, boost::hash<gradient_key>> iGradientCacheIndex;
 		mutable boost::optional<opengl_standard_vertex_arrays> iVertexArrays;
 		std::map<uint32_t, neogfx::frame_counter> iFrameCounters;
 	};
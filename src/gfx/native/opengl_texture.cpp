@@ -27,7 +27,7 @@ namespace neogfx
 		iDpiScaleFactor{ aDpiScaleFactor },
 		iSampling{ aSampling },
 		iSize{ aExtents },
-		iStorageSize{ size{ std::max(std::pow(2.0, std::ceil(std::log2(iSize.cx + 2))), 16.0), std::max(std::pow(2.0, std::ceil(std::log2(iSize.cy + 2))), 16.0) } },
+		iStorageSize{ iSize.cx + 2, iSize.cy + 2 },
 		iHandle{ 0 },
 		iUri{ "neogfx::opengl_texture::internal" }
 	{
@@ -53,20 +53,9 @@ namespace neogfx
 			{
 				if (iSampling == texture_sampling::Multisample)
 					throw multisample_texture_initialization_unsupported();
-				std::vector<uint8_t> data(iStorageSize.cx * 4 * iStorageSize.cy);
-				for (std::size_t y = 1; y < 1 + iSize.cy; ++y)
-					for (std::size_t x = 1; x < 1 + iSize.cx; ++x)
-					{
-						data[y * iStorageSize.cx * 4 + x * 4 + 0] = aColour->red();
-						data[y * iStorageSize.cx * 4 + x * 4 + 1] = aColour->green();
-						data[y * iStorageSize.cx * 4 + x * 4 + 2] = aColour->blue();
-						data[y * iStorageSize.cx * 4 + x * 4 + 3] = aColour->alpha();
-					}
-				glCheck(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, static_cast<GLsizei>(iStorageSize.cx), static_cast<GLsizei>(iStorageSize.cy), 0, GL_RGBA, GL_UNSIGNED_BYTE, &data[0]));
-				if (iSampling == texture_sampling::NormalMipmap)
-				{
-					glCheck(glGenerateMipmap(GL_TEXTURE_2D));
-				}
+				const std::array<uint8_t, 4> texel{ { aColour->red(), aColour->green(), aColour->blue(), aColour->alpha() } };
+				std::vector<std::array<uint8_t, 4>> data(iSize.cx * iSize.cy, texel);
+				upload(data.empty() ? nullptr : &data[0], iSize.cx);
 			}
 			else
 			{
@@ -96,7 +85,7 @@ namespace neogfx
 		iDpiScaleFactor{ aImage.dpi_scale_factor() },
 		iSampling{ aImage.sampling() },
 		iSize{ aImage.extents() },
-		iStorageSize{size{std::max(std::pow(2.0, std::ceil(std::log2(iSize.cx + 2))), 16.0), std::max(std::pow(2.0, std::ceil(std::log2(iSize.cy + 2))), 16.0)}},
+		iStorageSize{ iSize.cx + 2, iSize.cy + 2 },
 		iHandle{ 0 },
 		iUri{ aImage.uri() }
 	{
@@ -120,17 +109,8 @@ namespace neogfx
 			{
 			case colour_format::RGBA8:
 				{
-					const uint8_t* imageData = static_cast<const uint8_t*>(aImage.data());
-					std::vector<uint8_t> data(iStorageSize.cx * 4 * iStorageSize.cy);
-					for (std::size_t y = 1; y < 1 + iSize.cy; ++y)
-						for (std::size_t x = 1; x < 1 + iSize.cx; ++x)
-							for (std::size_t c = 0; c < 4; ++c)
-								data[y * iStorageSize.cx * 4 + x * 4 + c] = imageData[(y - 1) * iSize.cx * 4 + (x - 1) * 4 + c];
-					glCheck(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, static_cast<GLsizei>(iStorageSize.cx), static_cast<GLsizei>(iStorageSize.cy), 0, GL_RGBA, GL_UNSIGNED_BYTE, &data[0]));
-					if (iSampling == texture_sampling::NormalMipmap)
-					{
-						glCheck(glGenerateMipmap(GL_TEXTURE_2D));
-					}
+					// image rows are uploaded straight from the image; no staging copy
+					upload(aImage.data(), iSize.cx);
 				}
 				break;
 			default:
@@ -146,6 +126,28 @@ namespace neogfx
 		}
 	}
 
+	void opengl_texture::upload(const void* aPixels, uint32_t aRowLength)
+	{
+		glCheck(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, static_cast<GLsizei>(iStorageSize.cx), static_cast<GLsizei>(iStorageSize.cy), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+		// the 1 pixel border is kept transparent so that linear filtering at the edges of the image fades to nothing
+		std::vector<std::array<uint8_t, 4>> border(std::max(iStorageSize.cx, iStorageSize.cy));
+		glCheck(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+		glCheck(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, static_cast<GLsizei>(iStorageSize.cx), 1, GL_RGBA, GL_UNSIGNED_BYTE, &border[0]));
+		glCheck(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, static_cast<GLint>(iStorageSize.cy - 1), static_cast<GLsizei>(iStorageSize.cx), 1, GL_RGBA, GL_UNSIGNED_BYTE, &border[0]));
+		glCheck(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 1, static_cast<GLsizei>(iStorageSize.cy), GL_RGBA, GL_UNSIGNED_BYTE, &border[0]));
+		glCheck(glTexSubImage2D(GL_TEXTURE_2D, 0, static_cast<GLint>(iStorageSize.cx - 1), 0, 1, static_cast<GLsizei>(iStorageSize.cy), GL_RGBA, GL_UNSIGNED_BYTE, &border[0]));
+		if (aPixels != nullptr && iSize.cx != 0 && iSize.cy != 0)
+		{
+			glCheck(glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(aRowLength)));
+			glCheck(glTexSubImage2D(GL_TEXTURE_2D, 0, 1, 1, static_cast<GLsizei>(iSize.cx), static_cast<GLsizei>(iSize.cy), GL_RGBA, GL_UNSIGNED_BYTE, aPixels));
+			glCheck(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+		}
+		if (iSampling == texture_sampling::NormalMipmap)
+		{
+			glCheck(glGenerateMipmap(GL_TEXTURE_2D));
+		}
+	}
+
 	opengl_texture::~opengl_texture()
 	{
 		glCheck(glDeleteTextures(1, &iHandle));
@@ -46,6 +46,8 @@ namespace neogfx
 		void* handle() const override;
 		bool is_resident() const override;
 		const std::string& uri() const override;
+	private:
+		void upload(const void* aPixels, uint32_t aRowLength);
 	private:
 		dimension iDpiScaleFactor;
 		texture_sampling iSampling;
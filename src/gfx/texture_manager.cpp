@@ -27,8 +27,8 @@ namespace neogfx
 	class texture_wrapper : public i_native_texture
 	{
 	public:
-		texture_wrapper(texture_manager::texture_list::iterator aTexture) :
-			iTexture(aTexture->lock())
+		texture_wrapper(std::shared_ptr<i_native_texture> aTexture) :
+			iTexture(aTexture)
 		{
 		}
 		~texture_wrapper()
@@ -72,15 +72,43 @@ namespace neogfx
 		std::shared_ptr<i_native_texture> iTexture;
 	};
 
+	void texture_manager::texture_index::purge(texture_id aId)
+	{
+		auto existing = textures.find(aId);
+		if (existing == textures.end())
+			return;
+		auto const& entry = existing->second;
+		auto byHandleEntry = byHandle.find(entry.handle);
+		if (byHandleEntry != byHandle.end() && byHandleEntry->second == aId)
+			byHandle.erase(byHandleEntry);
+		if (!entry.key.uri.empty())
+		{
+			auto byUriEntry = byUri.find(entry.key.uri);
+			if (byUriEntry != byUri.end() && byUriEntry->second == aId)
+				byUri.erase(byUriEntry);
+		}
+		if (!entry.key.contentHash.empty())
+		{
+			auto byContentEntry = byContent.find(entry.key.contentHash);
+			if (byContentEntry != byContent.end() && byContentEntry->second == aId)
+				byContent.erase(byContentEntry);
+		}
+		textures.erase(existing);
+	}
+
+	texture_manager::texture_manager() :
+		iIndex{ std::make_shared<texture_index>() }
+	{
+	}
+
 	std::unique_ptr<i_native_texture> texture_manager::join_texture(const i_native_texture& aTexture)
 	{
-		for (auto i = iTextures.begin(); i != iTextures.end(); ++i)
+		auto existing = iIndex->byHandle.find(aTexture.handle());
+		if (existing != iIndex->byHandle.end())
 		{
-			if (i->expired())
-				continue;
-			auto p = i->lock();
-			if (aTexture.handle() == p->handle())
-				return std::make_unique<texture_wrapper>(i);
+			auto p = iIndex->textures.find(existing->second)->second.texture.lock();
+			if (p != nullptr)
+				return std::make_unique<texture_wrapper>(p);
 		}
 		throw texture_not_found();
 	}
@@ -92,7 +120,10 @@ namespace neogfx
 
 	void texture_manager::clear_textures()
 	{
-		iTextures.clear();
+		iIndex->textures.clear();
+		iIndex->byUri.clear();
+		iIndex->byContent.clear();
+		iIndex->byHandle.clear();
 	}
 
 	std::unique_ptr<i_texture_atlas> texture_manager::create_texture_atlas(const size& aSize)
@@ -100,51 +131,100 @@ namespace neogfx
 		return std::make_unique<texture_atlas>(*this, aSize);
 	}
 
-	const texture_manager::texture_list& texture_manager::textures() const
+	std::size_t texture_manager::texture_memory_usage() const
 	{
-		return iTextures;
+		std::size_t total = 0;
+		for (const auto& t : iIndex->textures)
+		{
+			auto p = t.second.texture.lock();
+			if (p != nullptr)
+				total += texture_memory_usage(p->storage_extents(), p->sampling());
+		}
+		return total;
 	}
 
-	texture_manager::texture_list& texture_manager::textures()
+	std::size_t texture_manager::texture_memory_usage(const size& aStorageExtents, texture_sampling aSampling)
 	{
-		return iTextures;
+		// RGBA8 texels; a full mipmap chain adds a third again and multisample textures hold four samples per texel
+		std::size_t bytes = static_cast<std::size_t>(aStorageExtents.cx) * static_cast<std::size_t>(aStorageExtents.cy) * 4u;
+		switch (aSampling)
+		{
+		case texture_sampling::NormalMipmap:
+			bytes += bytes / 3u;
+			break;
+		case texture_sampling::Multisample:
+			bytes *= 4u;
+			break;
+		default:
+			break;
+		}
+		return bytes;
 	}
 
-	texture_manager::texture_list::const_iterator texture_manager::find_texture(const i_image& aImage) const
+	texture_manager::texture_key texture_manager::image_key(const i_image& aImage)
 	{
-		for (auto i = iTextures.begin(); i != iTextures.end(); ++i)
+		texture_key result{ aImage.uri() };
+		if (result.uri.empty() && aImage.size() != 0)
 		{
-			auto p = i->lock();
-			if (!aImage.uri().empty() && aImage.uri() == p->uri())
-				return i;
+			// identical pixel data only yields an identical texture if the image attributes also match
+			result.contentHash = aImage.hash();
+			auto append = [&result](const void* aValue, std::size_t aSize)
+			{
+				result.contentHash.insert(result.contentHash.end(), static_cast<const uint8_t*>(aValue), static_cast<const uint8_t*>(aValue) + aSize);
+			};
+			auto const extents = aImage.extents();
+			auto const sampling = aImage.sampling();
+			auto const dpiScaleFactor = aImage.dpi_scale_factor();
+			append(&extents.cx, sizeof(extents.cx));
+			append(&extents.cy, sizeof(extents.cy));
+			append(&sampling, sizeof(sampling));
+			append(&dpiScaleFactor, sizeof(dpiScaleFactor));
 		}
-		return iTextures.end();
+		return result;
 	}
 
-	texture_manager::texture_list::iterator texture_manager::find_texture(const i_image& aImage)
+	const texture_manager::texture_list& texture_manager::textures() const
 	{
-		for (auto i = iTextures.begin(); i != iTextures.end(); ++i)
+		return iIndex->textures;
+	}
+
+	std::shared_ptr<i_native_texture> texture_manager::find_texture(const texture_key& aKey) const
+	{
+		boost::optional<texture_id> id;
+		if (!aKey.uri.empty())
 		{
-			if (i->expired())
-				continue;
-			auto p = i->lock();
-			if (!aImage.uri().empty() && aImage.uri() == p->uri())
-				return i;
+			auto existing = iIndex->byUri.find(aKey.uri);
+			if (existing != iIndex->byUri.end())
+				id = existing->second;
 		}
-		return iTextures.end();
+		else if (!aKey.contentHash.empty())
+		{
+			auto existing = iIndex->byContent.find(aKey.contentHash);
+			if (existing != iIndex->byContent.end())
+				id = existing->second;
+		}
+		if (id == boost::none)
+			return std::shared_ptr<i_native_texture>{};
+		return iIndex->textures.find(*id)->second.texture.lock();
 	}
 
-	std::unique_ptr<i_native_texture> texture_manager::add_texture(std::shared_ptr<i_native_texture> aTexture)
+	std::unique_ptr<i_native_texture> texture_manager::add_texture(std::shared_ptr<i_native_texture> aTexture, const texture_key& aKey)
 	{
-		// cleanup opportunity
-		for (auto i = iTextures.begin(); i != iTextures.end();)
+		auto const id = iIndex->nextId++;
+		std::weak_ptr<texture_index> index = iIndex;
+		// the deleter owns the texture so the index entry is purged before the texture itself is destroyed
+		std::shared_ptr<i_native_texture> tracked{ aTexture.get(), [index, id, aTexture](i_native_texture*)
 		{
-			if (i->expired())
-				i = iTextures.erase(i);
-			else
-				++i;
-		}
-		auto newTexture = iTextures.insert(iTextures.end(), aTexture);
-		return std::make_unique<texture_wrapper>(newTexture);
+			auto i = index.lock();
+			if (i != nullptr)
+				i->purge(id);
+		} };
+		iIndex->textures[id] = texture_entry{ tracked, tracked->handle(), aKey };
+		iIndex->byHandle[tracked->handle()] = id;
+		if (!aKey.uri.empty())
+			iIndex->byUri[aKey.uri] = id;
+		else if (!aKey.contentHash.empty())
+			iIndex->byContent[aKey.contentHash] = id;
+		return std::make_unique<texture_wrapper>(tracked);
 	}
 }
\ No newline at end of file
@@ -18,6 +18,7 @@
 */
 
 #include <neogfx/neogfx.hpp>
+#include <neogfx/core/colour_conversion.hpp>
 #include <neogfx/gfx/image.hpp>
 #include <neogfx/gui/dialog/colour_dialog.hpp>
 
@@ -490,16 +491,54 @@ namespace neogfx
 		if (iUpdateTexture)
 		{
 			iUpdateTexture = false;
-			for (uint32_t y = 0; y < 256; ++y)
+			auto const channel = iOwner.current_channel();
+			if (channel == ChannelHue || channel == ChannelSaturation || channel == ChannelValue ||
+				(channel == ChannelAlpha && iOwner.current_mode() == ModeHSV))
 			{
-				for (uint32_t z = 0; z < 256; ++z)
+				// see colour_at_position; x varies along each row, y down each column
+				auto const hsv = iOwner.selected_colour_as_hsv(true);
+				std::vector<float> hue(256 * 256), saturation(256 * 256), value(256 * 256);
+				for (uint32_t y = 0; y < 256; ++y)
 				{
-					auto r = colour_at_position(point{ static_cast<coordinate>(y), static_cast<coordinate>(255 - z) });
-					colour rgbColour = (r.is<hsv_colour>() ? static_variant_cast<const hsv_colour&>(r).to_rgb() : static_variant_cast<const colour&>(r));
-					iPixels[255 - z][y][0] = rgbColour.red();
-					iPixels[255 - z][y][1] = rgbColour.green();
-					iPixels[255 - z][y][2] = rgbColour.blue();
-					iPixels[255 - z][y][3] = 255; // alpha
+					for (uint32_t x = 0; x < 256; ++x)
+					{
+						auto const i = y * 256 + x;
+						auto const along = x / 255.0f;
+						auto const down = (255 - y) / 255.0f;
+						hue[i] = static_cast<float>(hsv.hue());
+						saturation[i] = static_cast<float>(hsv.saturation());
+						value[i] = static_cast<float>(hsv.value());
+						switch (channel)
+						{
+						case ChannelSaturation:
+							hue[i] = along * 360.0f;
+							value[i] = down;
+							break;
+						case ChannelValue:
+							hue[i] = along * 360.0f;
+							saturation[i] = down;
+							break;
+						default:
+							saturation[i] = along;
+							value[i] = down;
+							break;
+						}
+					}
+				}
+				hsv_to_rgba(&hue[0], &saturation[0], &value[0], 256 * 256, &iPixels[0][0][0]);
+			}
+			else
+			{
+				for (uint32_t y = 0; y < 256; ++y)
+				{
+					for (uint32_t x = 0; x < 256; ++x)
+					{
+						colour rgb = static_variant_cast<const colour&>(colour_at_position(point{ static_cast<coordinate>(x), static_cast<coordinate>(y) }));
+						iPixels[y][x][0] = rgb.red();
+						iPixels[y][x][1] = rgb.green();
+						iPixels[y][x][2] = rgb.blue();
+						iPixels[y][x][3] = 255; // alpha
+					}
 				}
 			}
 			iTexture.set_pixels(rect{ point{}, size{256, 256} }, &iPixels[0][0][0]);
@@ -661,6 +661,11 @@ namespace neogfx
 		return iUnitsContext.set_units(aUnits);
 	}
 
+	const units_scale& layout::device_units_scale() const
+	{
+		return iUnitsContext.device_units_scale();
+	}
+
 	layout::item_list::const_iterator layout::cbegin() const
 	{
 		return iItems.cbegin();
@@ -210,6 +210,11 @@ namespace neogfx
 		return parent_layout().set_units(aUnits);
 	}
 
+	const units_scale& layout_item::device_units_scale() const
+	{
+		return parent_layout().device_units_scale();
+	}
+
 	point layout_item::position() const
 	{
 		return subject().position();
@@ -321,6 +321,11 @@ namespace neogfx
 		return iUnitsContext.set_units(aUnits);
 	}
 
+	const units_scale& spacer::device_units_scale() const
+	{
+		return iUnitsContext.device_units_scale();
+	}
+
 	void spacer::layout_as(const point&, const size& aSize)
 	{
 		set_extents(aSize);
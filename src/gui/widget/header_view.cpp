@@ -28,11 +28,11 @@
 
 namespace neogfx
 {
-	class header_view::updater : private neolib::callback_timer
+	class header_view::updater : private wheel_timer
 	{
 	public:
 		updater(header_view& aParent) :
-			neolib::callback_timer{ app::instance(), [this, &aParent](neolib::callback_timer&)
+			wheel_timer{ app::instance().timer_wheel(), [this, &aParent](wheel_timer&)
 			{
 				neolib::destroyed_flag destroyed{ *this };
 				neolib::destroyed_flag surfaceDestroyed{ aParent.surface().as_lifetime() };
@@ -19,6 +19,7 @@
 
 #include <neogfx/neogfx.hpp>
 #include <neogfx/gui/widget/image_widget.hpp>
+#include <neogfx/gfx/image_decoder.hpp>
 
 
 namespace neogfx
@@ -210,6 +211,7 @@ namespace neogfx
 
 	void image_widget::set_image(const i_texture& aTexture)
 	{
+		iPendingImage = boost::none;
 		size oldSize = minimum_size();
 		iTexture = aTexture;
 		image_changed.trigger();
@@ -220,6 +222,7 @@ namespace neogfx
 
 	void image_widget::set_image(const i_image& aImage)
 	{
+		iPendingImage = boost::none;
 		size oldSize = minimum_size();
 		iTexture = aImage;
 		image_changed.trigger();
@@ -228,6 +231,19 @@ namespace neogfx
 		update();
 	}
 
+	// The current image is kept as a placeholder until the new one has been decoded; if decoding fails the placeholder remains.
+	void image_widget::load_image(const std::string& aImageUri, dimension aDpiScaleFactor, texture_sampling aSampling)
+	{
+		iPendingImage = aImageUri;
+		destroyed_flag destroyed{ *this };
+		image_decoder::instance().decode_async(aImageUri, [this, destroyed, aDpiScaleFactor, aSampling](const decoded_image& aDecodedImage)
+		{
+			if (destroyed || iPendingImage != aDecodedImage.uri || !aDecodedImage.error.empty())
+				return;
+			set_image(neogfx::image{ aDecodedImage, aDpiScaleFactor, aSampling });
+		});
+	}
+
 	void image_widget::set_aspect_ratio(aspect_ratio aAspectRatio)
 	{
 		if (iAspectRatio != aAspectRatio)
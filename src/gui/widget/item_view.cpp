@@ -305,7 +305,7 @@ namespace neogfx
 			}			
 			if (capturing())
 			{
-				iMouseTracker.emplace(app::instance(), [this](neolib::callback_timer& aTimer)
+				iMouseTracker.emplace(app::instance().timer_wheel(), [this](wheel_timer& aTimer)
 				{
 					aTimer.again();
 					auto item = item_at(root().mouse_position() - origin());
@@ -777,7 +777,7 @@ namespace neogfx
 		if (presentation_model().cell_colour(newIndex, item_cell_colour_type::Background) != optional_colour{})
 			editor().set_background_colour(presentation_model().cell_colour(newIndex, item_cell_colour_type::Background));
 		editor().set_margins(presentation_model().cell_margins(*this));
-		editor().move(cell_rect(newIndex).position());
+		editor().move(cell_rect(newIndex).position() + scroll_origin(editor()));
 		editor().resize(cell_rect(newIndex).extents());
 		if (editor_has_text_edit())
 		{
@@ -898,7 +898,7 @@ namespace neogfx
 		}
 		if (editing() != boost::none)
 		{
-			editor().move(cell_rect(*editing()).position());
+			editor().move(cell_rect(*editing()).position() + scroll_origin(editor()));
 			editor().resize(cell_rect(*editing()).extents());
 		}
 	}
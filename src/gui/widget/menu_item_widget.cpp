@@ -26,19 +26,22 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 namespace neogfx
 {
 	menu_item_widget::menu_item_widget(i_menu& aMenu, i_menu_item& aMenuItem) :
-		iMenu{ aMenu }, iMenuItem{ aMenuItem }, iLayout{ *this }, iIcon{ iLayout, texture{}, aspect_ratio::Keep }, iText{ iLayout }, iSpacer{ iLayout }, iShortcutText{ iLayout }
+		iMenu{ aMenu }, iMenuItem{ aMenuItem }, iLayout{ *this }, iIcon{ iLayout, texture{}, aspect_ratio::Keep }, iText{ iLayout }, iSpacer{ iLayout }, iShortcutText{ iLayout },
+		iSubMenuOpener{ app::instance().timer_wheel(), [this](wheel_timer&) { open_sub_menu(); }, 250, false }
 	{
 		init();
 	}
 
 	menu_item_widget::menu_item_widget(i_widget& aParent, i_menu& aMenu, i_menu_item& aMenuItem) :
-		widget{ aParent }, iMenu{ aMenu }, iMenuItem{ aMenuItem }, iLayout{ *this }, iIcon{ iLayout, texture{}, aspect_ratio::Keep }, iText{ iLayout }, iSpacer{ iLayout }, iShortcutText{ iLayout }
+		widget{ aParent }, iMenu{ aMenu }, iMenuItem{ aMenuItem }, iLayout{ *this }, iIcon{ iLayout, texture{}, aspect_ratio::Keep }, iText{ iLayout }, iSpacer{ iLayout }, iShortcutText{ iLayout },
+		iSubMenuOpener{ app::instance().timer_wheel(), [this](wheel_timer&) { open_sub_menu(); }, 250, false }
 	{
 		init();
 	}
 
 	menu_item_widget::menu_item_widget(i_layout& aLayout, i_menu& aMenu, i_menu_item& aMenuItem) :
-		widget{ aLayout }, iMenu{ aMenu }, iMenuItem{ aMenuItem }, iLayout{ *this }, iIcon{ iLayout, texture{}, aspect_ratio::Keep }, iText{ iLayout }, iSpacer{ iLayout }, iShortcutText{ iLayout }
+		widget{ aLayout }, iMenu{ aMenu }, iMenuItem{ aMenuItem }, iLayout{ *this }, iIcon{ iLayout, texture{}, aspect_ratio::Keep }, iText{ iLayout }, iSpacer{ iLayout }, iShortcutText{ iLayout },
+		iSubMenuOpener{ app::instance().timer_wheel(), [this](wheel_timer&) { open_sub_menu(); }, 250, false }
 	{
 		init();
 	}
@@ -46,7 +49,7 @@ namespace neogfx
 	menu_item_widget::~menu_item_widget()
 	{
 		app::instance().remove_mnemonic(*this);
-		iSubMenuOpener.reset();
+		iSubMenuOpener.cancel();
 	}
 
 	i_menu& menu_item_widget::menu() const
@@ -199,7 +202,7 @@ namespace neogfx
 		widget::mouse_left();
 		update();
 		if (menu().has_selected_item() && menu().selected_item() == (menu().find(menu_item())) &&
-			(menu_item().type() == i_menu_item::Action || (!menu_item().sub_menu().is_open() && !iSubMenuOpener)))
+			(menu_item().type() == i_menu_item::Action || (!menu_item().sub_menu().is_open() && !iSubMenuOpener.waiting())))
 			menu().clear_selection();
 	}
 
@@ -374,28 +377,27 @@ namespace neogfx
 				app::instance().help().activate(*this);
 			else if (menu_item().type() == i_menu_item::SubMenu && menu_item().open_any_sub_menu() && menu().type() == i_menu::Popup)
 			{
-				if (!iSubMenuOpener)
-				{
-					iSubMenuOpener = std::make_unique<neolib::callback_timer>(app::instance(), [this](neolib::callback_timer&)
-					{
-						destroyed_flag destroyed{ *this };
-						if (!menu_item().sub_menu().is_open())
-							menu().open_sub_menu.trigger(menu_item().sub_menu());
-						if (!destroyed)
-							update();
-						iSubMenuOpener.reset();
-					}, 250);
-				}
+				if (!iSubMenuOpener.waiting())
+					iSubMenuOpener.again();
 			}
 		});
 		iSink += menu_item().deselected([this]()
 		{
 			if (menu_item().type() == i_menu_item::Action)
 				app::instance().help().deactivate(*this);
-			iSubMenuOpener.reset();
+			iSubMenuOpener.cancel();
 		});
 	}
 
+	void menu_item_widget::open_sub_menu()
+	{
+		destroyed_flag destroyed{ *this };
+		if (!menu_item().sub_menu().is_open())
+			menu().open_sub_menu.trigger(menu_item().sub_menu());
+		if (!destroyed)
+			update();
+	}
+
 	void menu_item_widget::select_item(bool aOpenAnySubMenu)
 	{
 		destroyed_flag destroyed{ *this };
@@ -114,6 +114,16 @@ namespace neogfx
 		return result;
 	}
 
+	point scrollable_widget::scroll_origin(const i_widget& aChild) const
+	{
+		point result = units_converter(*this).from_device_units(point{ static_cast<coordinate>(horizontal_scrollbar().position()), static_cast<coordinate>(vertical_scrollbar().position()) });
+		if ((scrolling_disposition(aChild) & neogfx::scrolling_disposition::ScrollChildWidgetHorizontally) == neogfx::scrolling_disposition::DontScrollChildWidget)
+			result.x = 0.0;
+		if ((scrolling_disposition(aChild) & neogfx::scrolling_disposition::ScrollChildWidgetVertically) == neogfx::scrolling_disposition::DontScrollChildWidget)
+			result.y = 0.0;
+		return result;
+	}
+
 	widget_part scrollable_widget::hit_test(const point& aPosition) const
 	{
 		if (vertical_scrollbar().visible() && vertical_scrollbar().element_at(*this, aPosition + origin()) != scrollbar::ElementNone)
@@ -372,31 +382,18 @@ namespace neogfx
 		}
 	}
 
-	void scrollable_widget::scrollbar_updated(const i_scrollbar& aScrollbar, i_scrollbar::update_reason_e)
+	void scrollable_widget::scrollbar_updated(const i_scrollbar& aScrollbar, i_scrollbar::update_reason_e aReason)
 	{
-		if (!iIgnoreScrollbarUpdates)
+		// children keep their laid out positions and are offset by scroll_origin() instead so scrolling is a single
+		// invalidation; the cached layers of children are not invalidated and so are redrawn at their new offset as is
+		if (!iIgnoreScrollbarUpdates && (aReason == i_scrollbar::ScrolledUp || aReason == i_scrollbar::ScrolledDown))
 		{
-			point scrollPosition = units_converter(*this).from_device_units(point(static_cast<coordinate>(horizontal_scrollbar().position()), static_cast<coordinate>(vertical_scrollbar().position())));
-			if (iOldScrollPosition != scrollPosition)
-			{
-				for (auto& c : children())
-				{
-					point delta = -(scrollPosition - iOldScrollPosition);
-					if (aScrollbar.type() == scrollbar_type::Horizontal || (scrolling_disposition(*c) & neogfx::scrolling_disposition::ScrollChildWidgetVertically) == neogfx::scrolling_disposition::DontScrollChildWidget)
-						delta.y = 0.0;
-					if (aScrollbar.type() == scrollbar_type::Vertical || (scrolling_disposition(*c) & neogfx::scrolling_disposition::ScrollChildWidgetHorizontally) == neogfx::scrolling_disposition::DontScrollChildWidget)
-						delta.x = 0.0;
-					c->move(c->position() + delta);
-				}
-				if (aScrollbar.type() == scrollbar_type::Vertical)
-				{
-					iOldScrollPosition.y = scrollPosition.y;
-				}
-				else if (aScrollbar.type() == scrollbar_type::Horizontal)
-				{
-					iOldScrollPosition.x = scrollPosition.x;
-				}
-			}
+			// scrolled children have still moved on screen so they are notified as they were when scrolling moved them
+			auto const axis = (aScrollbar.type() == scrollbar_type::Vertical ? 
+				neogfx::scrolling_disposition::ScrollChildWidgetVertically : neogfx::scrolling_disposition::ScrollChildWidgetHorizontally);
+			for (auto& c : children())
+				if ((scrolling_disposition(*c) & axis) == axis)
+					c->moved();
 		}
 		update(true);
 	}
@@ -413,11 +410,6 @@ namespace neogfx
 
 	void scrollable_widget::update_scrollbar_visibility()
 	{
-		point savedScrollbarPositions{ horizontal_scrollbar().position(), vertical_scrollbar().position() };
-		if ((scrolling_disposition() & neogfx::scrolling_disposition::ScrollChildWidgetVertically) == neogfx::scrolling_disposition::ScrollChildWidgetVertically)
-			vertical_scrollbar().set_position(0.0);
-		if ((scrolling_disposition() & neogfx::scrolling_disposition::ScrollChildWidgetHorizontally) == neogfx::scrolling_disposition::ScrollChildWidgetHorizontally)
-			horizontal_scrollbar().set_position(0.0);
 		{
 			neolib::scoped_counter sc(iIgnoreScrollbarUpdates);
 			update_scrollbar_visibility(UsvStageInit);
@@ -430,10 +422,11 @@ namespace neogfx
 			}
 			update_scrollbar_visibility(UsvStageDone);
 		}
+		// child positions are never scrolled so the scroll positions need only be clamped to their new ranges
 		if ((scrolling_disposition() & neogfx::scrolling_disposition::ScrollChildWidgetVertically) == neogfx::scrolling_disposition::ScrollChildWidgetVertically)
-			vertical_scrollbar().set_position(savedScrollbarPositions.y);
+			vertical_scrollbar().set_position(vertical_scrollbar().position());
 		if ((scrolling_disposition() & neogfx::scrolling_disposition::ScrollChildWidgetHorizontally) == neogfx::scrolling_disposition::ScrollChildWidgetHorizontally)
-			horizontal_scrollbar().set_position(savedScrollbarPositions.x);
+			horizontal_scrollbar().set_position(horizontal_scrollbar().position());
 	}
 
 	void scrollable_widget::update_scrollbar_visibility(usv_stage_e aStage)
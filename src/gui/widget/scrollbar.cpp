@@ -36,6 +36,7 @@ namespace neogfx
 		iPage(0.0),
 		iClickedElement(ElementNone),
 		iHoverElement(ElementNone),
+		iTimer(app::instance().timer_wheel(), [this](wheel_timer& aTimer) { repeat(aTimer); }, 0, false),
 		iPaused(false)
 	{
 	}
@@ -504,43 +505,23 @@ namespace neogfx
 		{
 		case ElementUpButton:
 			set_position(position() - step());
-			iTimer = std::make_shared<neolib::callback_timer>(app::instance(), [this](neolib::callback_timer& aTimer)
-			{
-				aTimer.set_duration(50);
-				aTimer.again();
-				if (!iPaused)
-					set_position(position() - step());
-			}, 500);
+			iTimer.set_duration(500);
+			iTimer.again();
 			break;
 		case ElementDownButton:
 			set_position(position() + step());
-			iTimer = std::make_shared<neolib::callback_timer>(app::instance(), [this](neolib::callback_timer& aTimer)
-			{
-				aTimer.set_duration(50);
-				aTimer.again();
-				if (!iPaused)
-					set_position(position() + step());
-			}, 500);
+			iTimer.set_duration(500);
+			iTimer.again();
 			break;
 		case ElementPageUpArea:
 			set_position(position() - page());
-			iTimer = std::make_shared<neolib::callback_timer>(app::instance(), [this](neolib::callback_timer& aTimer)
-			{
-				aTimer.set_duration(50);
-				aTimer.again();
-				if (!iPaused)
-					set_position(position() - page());
-			}, 500);
+			iTimer.set_duration(500);
+			iTimer.again();
 			break;
 		case ElementPageDownArea:
 			set_position(position() + page());
-			iTimer = std::make_shared<neolib::callback_timer>(app::instance(), [this](neolib::callback_timer& aTimer)
-			{
-				aTimer.set_duration(50);
-				aTimer.again();
-				if (!iPaused)
-					set_position(position() + page());
-			}, 500);
+			iTimer.set_duration(500);
+			iTimer.again();
 			break;
 		case ElementThumb:
 			iThumbClickedPosition = iContainer.as_widget().root().mouse_position();
@@ -556,7 +537,7 @@ namespace neogfx
 		if (iClickedElement == ElementNone)
 			throw element_not_clicked();
 		iClickedElement = ElementNone;
-		iTimer.reset();
+		iTimer.cancel();
 		iPaused = false;
 	}
 
@@ -593,25 +574,8 @@ namespace neogfx
 		if (iScrollTrackPosition == boost::none)
 		{
 			iScrollTrackPosition = iContainer.as_widget().root().mouse_position();
-			iTimer = std::make_shared<neolib::callback_timer>(app::instance(), [this](neolib::callback_timer& aTimer)
-			{
-				aTimer.again();
-				point delta = iContainer.as_widget().root().mouse_position() - *iScrollTrackPosition;
-				scoped_units su(iContainer.as_widget(), units::Pixels);
-				rect g = iContainer.scrollbar_geometry(iContainer.as_widget(), *this);
-				if (iType == scrollbar_type::Vertical)
-				{
-					g.y = element_geometry(iContainer.as_widget(), ElementUpButton).bottom() + 1.0;
-					g.cy = element_geometry(iContainer.as_widget(), ElementDownButton).top() - 1.0 - g.y;
-					set_position(position() + static_cast<value_type>(delta.y * 0.25f / g.height()) * (maximum() - minimum()));
-				}
-				else
-				{
-					g.x = element_geometry(iContainer.as_widget(), ElementUpButton).right() + 1.0;
-					g.cx = element_geometry(iContainer.as_widget(), ElementDownButton).left() - 1.0 - g.x;
-					set_position(position() + static_cast<value_type>(delta.x * 0.25f / g.width()) * (maximum() - minimum()));
-				}
-			}, 50);
+			iTimer.set_duration(50);
+			iTimer.again();
 		}
 	}
 
@@ -620,7 +584,7 @@ namespace neogfx
 		if (iScrollTrackPosition != boost::none)
 		{
 			iScrollTrackPosition.reset();
-			iTimer.reset();
+			iTimer.cancel();
 		}
 	}
 
@@ -641,4 +605,49 @@ namespace neogfx
 		uc.set_units(uc.saved_units());
 		return uc.from_device_units(w);
 	}
+
+	void scrollbar::repeat(wheel_timer& aTimer)
+	{
+		if (iScrollTrackPosition != boost::none)
+		{
+			aTimer.again();
+			point delta = iContainer.as_widget().root().mouse_position() - *iScrollTrackPosition;
+			scoped_units su(iContainer.as_widget(), units::Pixels);
+			rect g = iContainer.scrollbar_geometry(iContainer.as_widget(), *this);
+			if (iType == scrollbar_type::Vertical)
+			{
+				g.y = element_geometry(iContainer.as_widget(), ElementUpButton).bottom() + 1.0;
+				g.cy = element_geometry(iContainer.as_widget(), ElementDownButton).top() - 1.0 - g.y;
+				set_position(position() + static_cast<value_type>(delta.y * 0.25f / g.height()) * (maximum() - minimum()));
+			}
+			else
+			{
+				g.x = element_geometry(iContainer.as_widget(), ElementUpButton).right() + 1.0;
+				g.cx = element_geometry(iContainer.as_widget(), ElementDownButton).left() - 1.0 - g.x;
+				set_position(position() + static_cast<value_type>(delta.x * 0.25f / g.width()) * (maximum() - minimum()));
+			}
+			return;
+		}
+		aTimer.set_duration(50);
+		aTimer.again();
+		if (iPaused)
+			return;
+		switch (iClickedElement)
+		{
+		case ElementUpButton:
+			set_position(position() - step());
+			break;
+		case ElementDownButton:
+			set_position(position() + step());
+			break;
+		case ElementPageUpArea:
+			set_position(position() - page());
+			break;
+		case ElementPageDownArea:
+			set_position(position() + page());
+			break;
+		default:
+			break;
+		}
+	}
 }
\ No newline at end of file
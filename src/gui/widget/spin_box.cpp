@@ -182,7 +182,7 @@ namespace neogfx
 		auto step_up = [this]()
 		{
 			set_normalized_value(std::max(0.0, std::min(1.0, normalized_value() + normalized_step_value())), true);
-			iStepper.emplace(app::instance(), [this](neolib::callback_timer& aTimer)
+			iStepper.emplace(app::instance().timer_wheel(), [this](wheel_timer& aTimer)
 			{
 				aTimer.set_duration(125, true);
 				aTimer.again();
@@ -204,7 +204,7 @@ namespace neogfx
 		auto step_down = [this]()
 		{
 			set_normalized_value(std::max(0.0, std::min(1.0, normalized_value() - normalized_step_value())), true);
-			iStepper.emplace(app::instance(), [this](neolib::callback_timer& aTimer)
+			iStepper.emplace(app::instance().timer_wheel(), [this](wheel_timer& aTimer)
 			{
 				aTimer.set_duration(125, true);
 				aTimer.again();
@@ -74,7 +74,7 @@ namespace neogfx
 		auto scrlLock = std::make_shared<label>();
 		scrlLock->text().set_size_hint("SCRL");
 		iLayout.add(scrlLock);
-		iUpdater = std::make_unique<neolib::callback_timer>(app::instance(), [insertLock, capsLock, numLock, scrlLock](neolib::callback_timer& aTimer)
+		iUpdater = std::make_unique<wheel_timer>(app::instance().timer_wheel(), [insertLock, capsLock, numLock, scrlLock](wheel_timer& aTimer)
 		{
 			aTimer.again();
 			const auto& keyboard = app::instance().keyboard();
@@ -35,7 +35,7 @@ namespace neogfx
 		};
 	public:
 		close_button(i_tab& aParent) :
-			push_button{ aParent.as_widget().layout() }, iParent{ aParent }, iTextureState{ Unknown }, iUpdater{ app::instance(), [this](neolib::callback_timer& aTimer) { aTimer.again(); update_appearance(); }, 20 }
+			push_button{ aParent.as_widget().layout() }, iParent{ aParent }, iTextureState{ Unknown }, iUpdater{ app::instance().timer_wheel(), [this](wheel_timer& aTimer) { aTimer.again(); update_appearance(); }, 20 }
 		{
 			set_margins(neogfx::margins{ 2.0 });
 			iSink += app::instance().current_style_changed([this](style_aspect aAspect) { if ((aAspect & style_aspect::Colour) == style_aspect::Colour) update_textures(); });
@@ -178,7 +178,7 @@ namespace neogfx
 		sink iSink;
 		mutable boost::optional<std::pair<colour, texture>> iTextures[3];
 		texture_index_e iTextureState;
-		neolib::callback_timer iUpdater;
+		wheel_timer iUpdater;
 	};
 
 	tab_button::tab_button(i_tab_container& aContainer, const std::string& aText, bool aClosable, bool aStandardImageSize) :
@@ -165,7 +165,7 @@ namespace neogfx
 		iGlyphColumns{ 1 },
 		iCursorAnimationStartTime{ app::instance().program_elapsed_ms() },
 		iTabStopHint{ "0000" },
-		iAnimator{ app::instance(), [this](neolib::callback_timer&)
+		iAnimator{ app::instance().timer_wheel(), [this](wheel_timer&)
 		{
 			iAnimator.again();
 			animate();
@@ -184,7 +184,7 @@ namespace neogfx
 		iGlyphColumns{ 1 },
 		iCursorAnimationStartTime{ app::instance().program_elapsed_ms() },
 		iTabStopHint{ "0000" },
-		iAnimator{ app::instance(), [this](neolib::callback_timer&)
+		iAnimator{ app::instance().timer_wheel(), [this](wheel_timer&)
 		{
 			iAnimator.again();
 			animate();
@@ -203,7 +203,7 @@ namespace neogfx
 		iGlyphColumns{ 1 },
 		iCursorAnimationStartTime{ app::instance().program_elapsed_ms() },
 		iTabStopHint{ "0000" },
-		iAnimator{ app::instance(), [this](neolib::callback_timer&)
+		iAnimator{ app::instance().timer_wheel(), [this](wheel_timer&)
 		{
 			iAnimator.again();
 			animate();
@@ -233,6 +233,7 @@ namespace neogfx
 
 	size text_edit::minimum_size(const optional_size& aAvailableSpace) const
 	{
+		check_style_epoch();
 		if (has_minimum_size())
 			return scrollable_widget::minimum_size(aAvailableSpace);
 		scoped_units su{ *this, units::Pixels };
@@ -266,6 +267,7 @@ namespace neogfx
 
 	void text_edit::paint(graphics_context& aGraphicsContext) const
 	{
+		check_style_epoch();
 		scrollable_widget::paint(aGraphicsContext);
 		coordinate x = 0.0;
 		rect clipRect = default_clip_rect().intersection(client_rect(false));
@@ -991,7 +993,7 @@ namespace neogfx
 		{
 			if (!capturing())
 				set_capture();
-			iDragger.emplace(app::instance(), [this](neolib::callback_timer& aTimer)
+			iDragger.emplace(app::instance().timer_wheel(), [this](wheel_timer& aTimer)
 			{
 				aTimer.again();
 				set_cursor_position(root().mouse_position() - origin(), false);
@@ -1353,14 +1355,7 @@ namespace neogfx
 	void text_edit::init()
 	{
 		iDefaultFont = app::instance().current_style().font_info();
-		iSink += app::instance().current_style_changed([this](style_aspect)
-		{
-			if (iDefaultFont != app::instance().current_style().font_info())
-			{
-				iDefaultFont = app::instance().current_style().font_info();
-				refresh_paragraph(iText.begin(), 0);
-			}
-		});
+		iStyleEpoch = app::instance().style_epoch(style_aspect::Font);
 		iSink += app::instance().rendering_engine().subpixel_rendering_changed([this]()
 		{
 			refresh_paragraph(iText.begin(), 0);
@@ -1386,6 +1381,20 @@ namespace neogfx
 		});
 	}
 
+	void text_edit::check_style_epoch() const
+	{
+		const uint32_t epoch = app::instance().style_epoch(style_aspect::Font);
+		if (iStyleEpoch == epoch)
+			return;
+		iStyleEpoch = epoch;
+		if (iDefaultFont != app::instance().current_style().font_info())
+		{
+			iDefaultFont = app::instance().current_style().font_info();
+			// glyphs are document state so they are rebuilt here, when first measured or painted after the change
+			const_cast<text_edit&>(*this).refresh_paragraph(iText.begin(), 0);
+		}
+	}
+
 	std::size_t text_edit::do_insert_text(const std::string& aText, const style& aStyle, bool aMoveCursor, bool aClearFirst)
 	{
 		bool accept = true;
@@ -76,6 +76,7 @@ namespace neogfx
 
 	void text_widget::paint(graphics_context& aGraphicsContext) const
 	{
+		check_style_epoch();
 		scoped_mnemonics sm(aGraphicsContext, app::instance().keyboard().is_key_pressed(ScanCode_LALT) || app::instance().keyboard().is_key_pressed(ScanCode_RALT));
 		aGraphicsContext.set_glyph_text_cache(iGlyphTextCache);
 		size textSize = text_extent();
@@ -261,6 +262,7 @@ namespace neogfx
 
 	size text_widget::text_extent() const
 	{
+		check_style_epoch();
 		if (iTextExtent != boost::none)
 			return *iTextExtent;
 		else if (!has_surface())
@@ -284,6 +286,7 @@ namespace neogfx
 
 	size text_widget::size_hint_extent() const
 	{
+		check_style_epoch();
 		if (iSizeHintExtent != boost::none)
 			return *iSizeHintExtent;
 		else if (!has_surface())
@@ -311,18 +314,7 @@ namespace neogfx
 	{
 		set_margins(neogfx::margins{ 0.0 });
 		set_ignore_mouse_events(true);
-		iSink += app::instance().current_style_changed([this](style_aspect aAspect)
-		{
-			if (!has_font() && (aAspect & style_aspect::Font) == style_aspect::Font)
-			{
-				iTextExtent = boost::none;
-				iSizeHintExtent = boost::none;
-				iGlyphTextCache = glyph_text{};
-				if (has_parent_layout())
-					parent_layout().invalidate();
-				update();
-			}
-		});
+		iStyleEpoch = app::instance().style_epoch(style_aspect::Font);
 		iSink += app::instance().rendering_engine().subpixel_rendering_changed([this]()
 		{
 			iTextExtent = boost::none;
@@ -333,4 +325,19 @@ namespace neogfx
 			update();
 		});
 	}
+
+	void text_widget::check_style_epoch() const
+	{
+		// the style's font only matters if we don't have our own; the relayout that follows a style change is done by the app
+		const uint32_t epoch = app::instance().style_epoch(style_aspect::Font);
+		if (iStyleEpoch == epoch)
+			return;
+		iStyleEpoch = epoch;
+		if (!has_font())
+		{
+			iTextExtent = boost::none;
+			iSizeHintExtent = boost::none;
+			iGlyphTextCache = glyph_text{};
+		}
+	}
 }
\ No newline at end of file
@@ -19,19 +19,22 @@
 
 #include <neogfx/neogfx.hpp>
 #include <unordered_map>
+#include <list>
 #include <neolib/raii.hpp>
 #include <neogfx/app/app.hpp>
+#include <neogfx/gfx/texture.hpp>
 #include <neogfx/gui/widget/widget.hpp>
 #include <neogfx/gui/layout/i_layout.hpp>
 #include <neogfx/hid/i_surface_window.hpp>
+#include "../../hid/native/i_native_surface.hpp"
 
 namespace neogfx
 {
-	class widget::layout_timer : public pause_rendering, neolib::callback_timer
+	class widget::layout_timer : public pause_rendering, wheel_timer
 	{
 	public:
-		layout_timer(i_window& aWindow, neolib::async_task& aIoTask, std::function<void(callback_timer&)> aCallback) :
-			pause_rendering{ aWindow }, neolib::callback_timer{ aIoTask, aCallback, 0 }
+		layout_timer(i_window& aWindow, neogfx::timer_wheel& aTimerWheel, const callback& aCallback) :
+			pause_rendering{ aWindow }, wheel_timer{ aTimerWheel, aCallback, 0 }
 		{
 		}
 		~layout_timer()
@@ -39,6 +42,109 @@ namespace neogfx
 		}
 	};
 
+	class widget_layer
+	{
+	private:
+		typedef std::list<widget_layer*> lru_list;
+		struct cache
+		{
+			std::size_t budget = 64 * 1024 * 1024;
+			std::size_t used = 0;
+			lru_list lru;
+		};
+	public:
+		widget_layer() :
+			iValid{ false }, iBytes{ 0 }
+		{
+		}
+		~widget_layer()
+		{
+			release();
+		}
+	public:
+		static std::size_t budget()
+		{
+			return layer_cache().budget;
+		}
+		static void set_budget(std::size_t aBudget)
+		{
+			layer_cache().budget = aBudget;
+			evict(nullptr);
+		}
+	public:
+		bool valid() const
+		{
+			return iValid && iTexture != boost::none;
+		}
+		void invalidate()
+		{
+			iValid = false;
+		}
+		void validate()
+		{
+			iValid = true;
+		}
+		const i_texture& texture() const
+		{
+			return *iTexture;
+		}
+		i_texture& target(const size& aExtents)
+		{
+			if (iTexture == boost::none || iTexture->extents() != aExtents)
+			{
+				release();
+				iTexture = neogfx::texture{ aExtents, 1.0, texture_sampling::Normal };
+				iBytes = static_cast<std::size_t>(iTexture->storage_extents().cx * iTexture->storage_extents().cy * 4);
+				layer_cache().used += iBytes;
+				iLruPosition = layer_cache().lru.insert(layer_cache().lru.begin(), this);
+				evict(this);
+			}
+			else
+				touch();
+			return *iTexture;
+		}
+		void touch()
+		{
+			if (iTexture != boost::none)
+				layer_cache().lru.splice(layer_cache().lru.begin(), layer_cache().lru, iLruPosition);
+		}
+		void release()
+		{
+			if (iTexture == boost::none)
+				return;
+			layer_cache().lru.erase(iLruPosition);
+			layer_cache().used -= iBytes;
+			iBytes = 0;
+			iTexture = boost::none;
+			iValid = false;
+		}
+	private:
+		static cache& layer_cache()
+		{
+			static cache sCache;
+			return sCache;
+		}
+		static void evict(const widget_layer* aExcept)
+		{
+			auto& c = layer_cache();
+			auto i = c.lru.end();
+			while (c.used > c.budget && i != c.lru.begin())
+			{
+				auto victim = *--i;
+				if (victim != aExcept)
+				{
+					i = std::next(i);
+					victim->release();
+				}
+			}
+		}
+	private:
+		optional_texture iTexture;
+		bool iValid;
+		std::size_t iBytes;
+		lru_list::iterator iLruPosition;
+	};
+
 	i_widget* widget::debug;
 
 	widget::widget() :
@@ -51,7 +157,9 @@ namespace neogfx
 		iLinkAfter{ nullptr },
 		iParentLayout{ nullptr },
 		iLayoutInProgress{ 0 },
-		iUnitsContext{ *this }
+		iUnitsContext{ *this },
+		iLayerCaching{ false },
+		iPreservingLayer{ false }
 	{
 	}
 	
@@ -65,7 +173,9 @@ namespace neogfx
 		iLinkAfter{ nullptr },
 		iParentLayout{ nullptr },
 		iLayoutInProgress{ 0 },
-		iUnitsContext{ *this }
+		iUnitsContext{ *this },
+		iLayerCaching{ false },
+		iPreservingLayer{ false }
 	{
 		aParent.add(*this);
 	}
@@ -80,7 +190,9 @@ namespace neogfx
 		iLinkAfter{ nullptr },
 		iParentLayout{ nullptr },
 		iLayoutInProgress{ 0 },
-		iUnitsContext{ *this }
+		iUnitsContext{ *this },
+		iLayerCaching{ false },
+		iPreservingLayer{ false }
 	{
 		aLayout.add(*this);
 	}
@@ -88,7 +200,7 @@ namespace neogfx
 	widget::~widget()
 	{
 		unlink();
-		if (app::instance().keyboard().is_keyboard_grabbed_by(*this))
+		if (app::has_instance() && app::instance().keyboard().is_keyboard_grabbed_by(*this))
 			app::instance().keyboard().ungrab_keyboard(*this);
 		remove_all();
 		{
@@ -141,6 +253,11 @@ namespace neogfx
 		return iUnitsContext.set_units(aUnits);
 	}
 
+	const units_scale& widget::device_units_scale() const
+	{
+		return iUnitsContext.device_units_scale();
+	}
+
 	bool widget::is_singular() const
 	{
 		return iSingular;
@@ -213,6 +330,7 @@ namespace neogfx
 
 	void widget::parent_changed()
 	{
+		iUnitsContext.invalidate_device_units_scale(); // may now be on a surface with a different DPI
 		if (!is_root() && has_managing_layout())
 			managing_layout().layout_items(true);
 	}
@@ -697,7 +815,7 @@ namespace neogfx
 		{
 			if (!iLayoutTimer)
 			{
-				iLayoutTimer = std::make_unique<layout_timer>(root(), app::instance(), [this](neolib::callback_timer&)
+				iLayoutTimer = std::make_unique<layout_timer>(root(), app::instance().timer_wheel(), [this](wheel_timer&)
 				{
 					if (root().has_native_window())
 					{
@@ -777,15 +895,21 @@ namespace neogfx
 	point widget::origin() const
 	{
 		if (!is_root() && has_parent())
-			return position() + parent().origin();
+			return position() - parent().scroll_origin(*this) + parent().origin();
 		else
 			return point{};
 	}
 
+	point widget::scroll_origin(const i_widget&) const
+	{
+		return point{};
+	}
+
 	void widget::move(const point& aPosition)
 	{
 		if (Position != units_converter(*this).to_device_units(aPosition))
 		{
+			neolib::scoped_flag sf{ iPreservingLayer };
 			update(true);
 			Position.assign(units_converter(*this).to_device_units(aPosition), false);
 			update(true);
@@ -844,7 +968,7 @@ namespace neogfx
 		{
 			for (const auto& c : children())
 				if (c->visible() && to_client_coordinates(c->non_client_rect()).contains(aPosition))
-					return c->get_widget_at(aPosition - c->position());
+					return c->get_widget_at(aPosition - (c->position() - scroll_origin(*c)));
 		}
 		return *this;
 	}
@@ -1028,6 +1152,10 @@ namespace neogfx
 			return;
 		if (aUpdateRect.empty())
 			return;
+		if (!iPreservingLayer)
+			invalidate_layer();
+		else if (has_parent() && !is_root())
+			parent().invalidate_layer();
 		surface().invalidate_surface(to_window_coordinates(aUpdateRect));
 	}
 
@@ -1051,7 +1179,9 @@ namespace neogfx
 		rect clipRect = to_client_coordinates(non_client_rect());
 		if (!aIncludeNonClient)
 			clipRect = clipRect.intersection(client_rect());
-		if (has_parent() && !is_root())
+		// a widget rendered offscreen is not clipped by its ancestors
+		bool offscreenRoot = surface().native_surface().is_rendering_offscreen() && &surface().native_surface().offscreen_widget() == this;
+		if (has_parent() && !is_root() && !offscreenRoot)
 			clipRect = clipRect.intersection(to_client_coordinates(parent().to_window_coordinates(parent().default_clip_rect())));
 		return *(cachedRect = clipRect);
 	}
@@ -1070,14 +1200,56 @@ namespace neogfx
 
 		iDefaultClipRect = std::make_pair(boost::none, boost::none);
 
-		const rect updateRect = update_rect();
+		// a layer can only be reused if it was captured whilst fully visible; offscreen renders bypass layers as they have their own viewport
+		if (layer_caching() && !surface().native_surface().is_rendering_offscreen() && default_clip_rect(true) == to_client_coordinates(non_client_rect()))
+			render_layer(aGraphicsContext);
+		else
+		{
+			scoped_opacity sc{ aGraphicsContext, opacity() };
+			render_contents(aGraphicsContext);
+		}
+	}
 
-		const rect nonClientClipRect = default_clip_rect(true).intersection(updateRect);
+	void widget::render_layer(graphics_context& aGraphicsContext) const
+	{
+		const rect nonClientClipRect = default_clip_rect(true).intersection(update_rect());
+
+		if (iLayer == nullptr)
+			iLayer = std::make_unique<widget_layer>();
+		if (!iLayer->valid())
+		{
+			auto& target = iLayer->target(extents().ceil());
+			const double previousOpacity = aGraphicsContext.opacity();
+			aGraphicsContext.set_opacity(1.0);
+			aGraphicsContext.set_extents(extents());
+			aGraphicsContext.set_origin(origin());
+			aGraphicsContext.begin_layer(rect{ point{}, extents() });
+			render_contents(aGraphicsContext);
+			aGraphicsContext.end_layer(target);
+			aGraphicsContext.set_opacity(previousOpacity);
+			iLayer->validate();
+		}
+		else
+			iLayer->touch();
 
 		aGraphicsContext.set_extents(extents());
 		aGraphicsContext.set_origin(origin());
 
 		scoped_opacity sc{ aGraphicsContext, opacity() };
+		scoped_scissor scissor(aGraphicsContext, nonClientClipRect);
+		// the layer was captured onto a transparent background so its colour is already multiplied by its alpha
+		scoped_blending_mode sbm{ aGraphicsContext, blending_mode::Premultiplied };
+		aGraphicsContext.draw_texture(point{}, iLayer->texture());
+	}
+
+	void widget::render_contents(graphics_context& aGraphicsContext) const
+	{
+		const rect updateRect = update_rect();
+
+		const rect nonClientClipRect = default_clip_rect(true).intersection(updateRect);
+
+		aGraphicsContext.set_extents(extents());
+		aGraphicsContext.set_origin(origin());
 
 		{
 			scoped_scissor scissor(aGraphicsContext, nonClientClipRect);
@@ -1137,6 +1309,40 @@ namespace neogfx
 		// do nothing
 	}
 
+	bool widget::layer_caching() const
+	{
+		return iLayerCaching;
+	}
+
+	void widget::set_layer_caching(bool aLayerCaching)
+	{
+		if (iLayerCaching != aLayerCaching)
+		{
+			iLayerCaching = aLayerCaching;
+			if (!iLayerCaching)
+				iLayer.reset();
+			update(true);
+		}
+	}
+
+	void widget::invalidate_layer()
+	{
+		if (iLayer != nullptr)
+			iLayer->invalidate();
+		if (has_parent() && !is_root())
+			parent().invalidate_layer();
+	}
+
+	std::size_t widget::layer_cache_budget()
+	{
+		return widget_layer::budget();
+	}
+
+	void widget::set_layer_cache_budget(std::size_t aBudget)
+	{
+		widget_layer::set_budget(aBudget);
+	}
+
 	double widget::opacity() const
 	{
 		return Opacity;
@@ -1146,6 +1352,7 @@ namespace neogfx
 	{
 		if (Opacity != aOpacity)
 		{
+			neolib::scoped_flag sf{ iPreservingLayer };
 			Opacity = aOpacity;
 			update(true);
 		}
@@ -1472,7 +1679,7 @@ namespace neogfx
 	void widget::mouse_button_pressed(mouse_button aButton, const point& aPosition, key_modifiers_e aKeyModifiers)
 	{
 		if (aButton == mouse_button::Middle && has_parent())
-			parent().mouse_button_pressed(aButton, aPosition + position(), aKeyModifiers);
+			parent().mouse_button_pressed(aButton, aPosition + position() - parent().scroll_origin(*this), aKeyModifiers);
 		else if (capture_ok(hit_test(aPosition)) && can_capture())
 			set_capture(capture_reason::MouseEvent);
 	}
@@ -1480,7 +1687,7 @@ namespace neogfx
 	void widget::mouse_button_double_clicked(mouse_button aButton, const point& aPosition, key_modifiers_e aKeyModifiers)
 	{
 		if (aButton == mouse_button::Middle && has_parent())
-			parent().mouse_button_double_clicked(aButton, aPosition + position(), aKeyModifiers);
+			parent().mouse_button_double_clicked(aButton, aPosition + position() - parent().scroll_origin(*this), aKeyModifiers);
 		else if (capture_ok(hit_test(aPosition)) && can_capture())
 			set_capture(capture_reason::MouseEvent);
 	}
@@ -1488,7 +1695,7 @@ namespace neogfx
 	void widget::mouse_button_released(mouse_button aButton, const point& aPosition)
 	{
 		if (aButton == mouse_button::Middle && has_parent())
-			parent().mouse_button_released(aButton, aPosition + position());
+			parent().mouse_button_released(aButton, aPosition + position() - parent().scroll_origin(*this));
 		else if (capturing())
 			release_capture(capture_reason::MouseEvent);
 	}
@@ -25,6 +25,7 @@
 
 #include <neolib/raii.hpp>
 #include <neogfx/app/app.hpp>
+#include <neogfx/core/units_context.hpp>
 #include <neogfx/gfx/i_rendering_engine.hpp>
 #include <neogfx/hid/i_surface_manager.hpp>
 #include <neogfx/hid/i_surface_window.hpp>
@@ -372,6 +373,7 @@ namespace neogfx
 	{
 		surface_manager().display(surface_window()).update_dpi();
 		iPixelDensityDpi = boost::none;
+		units_context::device_metrics_changed();
 		surface_window().handle_dpi_changed();
 		surface_manager().dpi_changed.trigger(surface_window());
 	}
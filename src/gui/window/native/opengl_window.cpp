@@ -19,10 +19,17 @@
 
 #include <neogfx/neogfx.hpp>
 #include <numeric>
+#include <neolib/raii.hpp>
 #include <neogfx/app/app.hpp>
+#include <neogfx/core/units_context.hpp>
+#include <neogfx/gfx/i_texture.hpp>
+#include <neogfx/gfx/i_sub_texture.hpp>
+#include <neogfx/gfx/i_image.hpp>
 #include <neogfx/hid/i_surface_window.hpp>
+#include <neogfx/gui/widget/i_widget.hpp>
 #include "opengl_window.hpp"
 #include "..\..\..\gfx\native\opengl_helpers.hpp"
+#include "..\..\..\gfx\native\i_native_texture.hpp"
 #ifdef _WIN32
 #include <D2d1.h>
 #endif
@@ -36,6 +43,7 @@ namespace neogfx
 		iFrameRate{ 60 },
 		iFrameCounter{ 0 },
 		iLastFrameTime{ 0 },
+		iOffscreenResolveBuffer{ false },
 		iRendering{ false },
 		iPaused{ 0 }
 	{
@@ -175,55 +183,15 @@ namespace neogfx
 
 		rendering_engine().activate_context(*this);
 
-		glCheck(glViewport(0, 0, static_cast<GLsizei>(extents().cx), static_cast<GLsizei>(extents().cy)));
-		glCheck(glEnable(GL_MULTISAMPLE));
-		glCheck(glEnable(GL_BLEND));
-		glCheck(glEnable(GL_DEPTH_TEST));
-		glCheck(glDepthFunc(GL_LEQUAL));
-		if (iFrameBufferSize.cx < static_cast<double>(extents().cx) || iFrameBufferSize.cy < static_cast<double>(extents().cy))
-		{
-			if (iFrameBufferSize != size{})
-			{
-				glCheck(glDeleteRenderbuffers(1, &iDepthStencilBuffer));
-				glCheck(glDeleteTextures(1, &iFrameBufferTexture));
-				glCheck(glDeleteFramebuffers(1, &iFrameBuffer));
-			}
-			iFrameBufferSize = size(
-				iFrameBufferSize.cx < extents().cx ? extents().cx * 1.5f : iFrameBufferSize.cx,
-				iFrameBufferSize.cy < extents().cy ? extents().cy * 1.5f : iFrameBufferSize.cy);
-			glCheck(glGenFramebuffers(1, &iFrameBuffer));
-			glCheck(glBindFramebuffer(GL_FRAMEBUFFER, iFrameBuffer));
-			glCheck(glGenTextures(1, &iFrameBufferTexture));
-			glCheck(glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, iFrameBufferTexture));
-			glCheck(glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, 4, GL_RGBA8, static_cast<GLsizei>(iFrameBufferSize.cx), static_cast<GLsizei>(iFrameBufferSize.cy), true));
-			glCheck(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D_MULTISAMPLE, iFrameBufferTexture, 0));
-			glCheck(glGenRenderbuffers(1, &iDepthStencilBuffer));
-			glCheck(glBindRenderbuffer(GL_RENDERBUFFER, iDepthStencilBuffer));
-			glCheck(glRenderbufferStorageMultisample(GL_RENDERBUFFER, 4, GL_DEPTH24_STENCIL8, static_cast<GLsizei>(iFrameBufferSize.cx), static_cast<GLsizei>(iFrameBufferSize.cy)));
-			glCheck(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, iDepthStencilBuffer));
-			glCheck(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER, iDepthStencilBuffer));
-		}
-		else
-		{
-			glCheck(glBindFramebuffer(GL_FRAMEBUFFER, iFrameBuffer));
-			glCheck(glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, iFrameBufferTexture));
-			glCheck(glBindRenderbuffer(GL_RENDERBUFFER, iDepthStencilBuffer));
-		}
+		prepare_render();
+		iFrameBuffer.bind(extents());
 		glCheck(glClear(GL_DEPTH_BUFFER_BIT));
-		GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
-		if (status != GL_NO_ERROR && status != GL_FRAMEBUFFER_COMPLETE)
-			throw failed_to_create_framebuffer(status);
-		glCheck(glBindFramebuffer(GL_FRAMEBUFFER, iFrameBuffer));
-		GLenum drawBuffers[] = { GL_COLOR_ATTACHMENT0 };
-		glCheck(glDrawBuffers(sizeof(drawBuffers) / sizeof(drawBuffers[0]), drawBuffers));
 
 		glCheck(surface_window().native_window_render(invalidated_area()));
 
 		rendering_engine().vertex_arrays().execute();
 
-		glCheck(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0));
-		glCheck(glBindFramebuffer(GL_READ_FRAMEBUFFER, iFrameBuffer));
-		glCheck(glBlitFramebuffer(0, 0, static_cast<GLint>(extents().cx), static_cast<GLint>(extents().cy), 0, 0, static_cast<GLint>(extents().cx), static_cast<GLint>(extents().cy), GL_COLOR_BUFFER_BIT, GL_NEAREST));
+		iFrameBuffer.resolve(rect{ point{}, extents() }, 0, rect{ point{}, extents() });
 
 		display();
 
@@ -256,12 +224,125 @@ namespace neogfx
 
 	void* opengl_window::rendering_target_texture_handle() const
 	{
-		return reinterpret_cast<void*>(iFrameBufferTexture);
+		return reinterpret_cast<void*>(active_frame_buffer().texture_handle());
 	}
 
 	size opengl_window::rendering_target_texture_extents() const
 	{
-		return iFrameBufferSize;
+		return active_frame_buffer().extents();
+	}
+
+	void opengl_window::render_to_texture(i_widget& aWidget, const size& aExtents, dimension aDpiScaleFactor, i_texture& aTarget)
+	{
+		if (aTarget.sampling() == texture_sampling::Multisample)
+			throw unsupported_render_target();
+		const rect sourceRect = render_offscreen(aWidget, aExtents, aDpiScaleFactor);
+		if (sourceRect.empty())
+			return;
+		copy_to_texture(sourceRect, aTarget);
+		glCheck(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+	}
+
+	void opengl_window::render_to_image(i_widget& aWidget, const size& aExtents, dimension aDpiScaleFactor, i_image& aTarget)
+	{
+		if (aTarget.colour_format() != colour_format::RGBA8)
+			throw unsupported_render_target();
+		const rect sourceRect = render_offscreen(aWidget, aExtents, aDpiScaleFactor);
+		aTarget.resize(sourceRect.extents());
+		const auto width = static_cast<std::size_t>(sourceRect.cx);
+		const auto height = static_cast<std::size_t>(sourceRect.cy);
+		if (width == 0 || height == 0)
+			return;
+		std::vector<uint8_t> pixels(width * height * 4);
+		glCheck(glBindFramebuffer(GL_READ_FRAMEBUFFER, iOffscreenResolveBuffer.handle()));
+		glCheck(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+		glCheck(glReadPixels(static_cast<GLint>(sourceRect.x), static_cast<GLint>(sourceRect.y), static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]));
+		glCheck(glBindFramebuffer(GL_READ_FRAMEBUFFER, 0));
+		uint8_t* imageData = static_cast<uint8_t*>(aTarget.data());
+		for (std::size_t y = 0; y < height; ++y)
+			std::copy(&pixels[(height - 1 - y) * width * 4], &pixels[(height - 1 - y) * width * 4] + width * 4, &imageData[y * width * 4]);
+	}
+
+	bool opengl_window::is_rendering_offscreen() const
+	{
+		return iOffscreenTarget != boost::none;
+	}
+
+	const i_widget& opengl_window::offscreen_widget() const
+	{
+		if (!is_rendering_offscreen())
+			throw not_rendering_offscreen();
+		return *iOffscreenTarget->widget;
+	}
+
+	rect opengl_window::to_viewport(const rect& aSurfaceRect) const
+	{
+		if (!is_rendering_offscreen())
+			return to_frame_buffer_rect(aSurfaceRect);
+		// the offscreen source rectangle is stretched over the whole of the target so scale and translate accordingly
+		const rect& sourceRect = iOffscreenTarget->sourceRect;
+		const size scale = iOffscreenTarget->extents / sourceRect.extents();
+		return rect{
+			point{ (aSurfaceRect.x - sourceRect.x) * scale.cx, (sourceRect.bottom() - aSurfaceRect.bottom()) * scale.cy },
+			aSurfaceRect.extents() * scale };
+	}
+
+	void opengl_window::begin_layer(const rect& aLayerRect)
+	{
+		rendering_engine().vertex_arrays().execute();
+		const rect layerRect = aLayerRect.intersection(rect{ point{}, extents() }).ceil();
+		iLayers.push_back(std::make_pair(layerRect, iInvalidatedArea));
+		if (iLayerBuffers.size() < iLayers.size())
+			iLayerBuffers.push_back(std::make_unique<opengl_frame_buffer>());
+		// everything within the layer must be painted so it can be recomposited later
+		iInvalidatedArea = layerRect;
+		active_frame_buffer().bind(extents());
+		const rect frameBufferRect = to_frame_buffer_rect(layerRect);
+		GLboolean scissorEnabled;
+		GLint previousScissorBox[4];
+		glCheck(glGetBooleanv(GL_SCISSOR_TEST, &scissorEnabled));
+		glCheck(glGetIntegerv(GL_SCISSOR_BOX, previousScissorBox));
+		glCheck(glEnable(GL_SCISSOR_TEST));
+		glCheck(glScissor(static_cast<GLint>(frameBufferRect.x), static_cast<GLint>(frameBufferRect.y), static_cast<GLsizei>(frameBufferRect.cx), static_cast<GLsizei>(frameBufferRect.cy)));
+		glCheck(glClearColor(0.0f, 0.0f, 0.0f, 0.0f));
+		glCheck(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT));
+		glCheck(glScissor(previousScissorBox[0], previousScissorBox[1], previousScissorBox[2], previousScissorBox[3]));
+		if (scissorEnabled != GL_TRUE)
+		{
+			glCheck(glDisable(GL_SCISSOR_TEST));
+		}
+	}
+
+	void opengl_window::end_layer(i_texture& aTarget)
+	{
+		if (iLayers.empty())
+			throw no_layer();
+		if (aTarget.sampling() == texture_sampling::Multisample)
+			throw unsupported_render_target();
+		rendering_engine().vertex_arrays().execute();
+		const rect frameBufferRect = to_frame_buffer_rect(iLayers.back().first);
+		const opengl_frame_buffer& layerBuffer = active_frame_buffer();
+		iOffscreenResolveBuffer.bind(extents());
+		layerBuffer.resolve(frameBufferRect, iOffscreenResolveBuffer.handle(), frameBufferRect);
+		copy_to_texture(frameBufferRect, aTarget);
+		iInvalidatedArea = iLayers.back().second;
+		iLayers.pop_back();
+		active_frame_buffer().bind(extents());
+	}
+
+	dimension opengl_window::horizontal_dpi() const
+	{
+		return native_window::horizontal_dpi() * (is_rendering_offscreen() ? iOffscreenTarget->densityScale : 1.0);
+	}
+
+	dimension opengl_window::vertical_dpi() const
+	{
+		return native_window::vertical_dpi() * (is_rendering_offscreen() ? iOffscreenTarget->densityScale : 1.0);
+	}
+
+	dimension opengl_window::ppi() const
+	{
+		return native_window::ppi() * (is_rendering_offscreen() ? iOffscreenTarget->densityScale : 1.0);
 	}
 
 	bool opengl_window::metrics_available() const
@@ -282,12 +363,13 @@ namespace neogfx
 	void opengl_window::set_destroying()
 	{
 		native_window::set_destroying();
-		if (iFrameBufferSize != size{})
+		if (iFrameBuffer.allocated() || iOffscreenFrameBuffer.allocated() || iOffscreenResolveBuffer.allocated() || !iLayerBuffers.empty())
 		{
 			rendering_engine().activate_context(*this);
-			glCheck(glDeleteRenderbuffers(1, &iDepthStencilBuffer));
-			glCheck(glDeleteTextures(1, &iFrameBufferTexture));
-			glCheck(glDeleteFramebuffers(1, &iFrameBuffer));
+			iFrameBuffer.release();
+			iOffscreenFrameBuffer.release();
+			iOffscreenResolveBuffer.release();
+			iLayerBuffers.clear();
 		}
 	}
 
@@ -295,4 +377,114 @@ namespace neogfx
 	{
 		native_window::set_destroyed();
 	}
+
+	const opengl_frame_buffer& opengl_window::active_frame_buffer() const
+	{
+		if (!iLayers.empty())
+			return *iLayerBuffers[iLayers.size() - 1];
+		return is_rendering_offscreen() ? iOffscreenFrameBuffer : iFrameBuffer;
+	}
+
+	opengl_frame_buffer& opengl_window::active_frame_buffer()
+	{
+		return const_cast<opengl_frame_buffer&>(const_cast<const opengl_window*>(this)->active_frame_buffer());
+	}
+
+	rect opengl_window::to_frame_buffer_rect(const rect& aRect) const
+	{
+		return rect{ point{ aRect.x, extents().cy - aRect.bottom() }, aRect.extents() };
+	}
+
+	void opengl_window::copy_to_texture(const rect& aFrameBufferRect, i_texture& aTarget)
+	{
+		rect targetRect{ point{ 1.0, 1.0 }, aTarget.extents() };
+		if (aTarget.type() == i_texture::SubTexture)
+			targetRect.position() += aTarget.as_sub_texture().atlas_location().position();
+		GLuint targetTexture = reinterpret_cast<GLuint>(aTarget.native_texture()->handle());
+		GLuint targetFrameBuffer;
+		glCheck(glGenFramebuffers(1, &targetFrameBuffer));
+		glCheck(glBindFramebuffer(GL_FRAMEBUFFER, targetFrameBuffer));
+		glCheck(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, targetTexture, 0));
+		// texture rows are stored top-down whereas frame buffer rows are stored bottom-up
+		iOffscreenResolveBuffer.resolve(aFrameBufferRect, targetFrameBuffer, targetRect, true);
+		glCheck(glDeleteFramebuffers(1, &targetFrameBuffer));
+		if (aTarget.sampling() == texture_sampling::NormalMipmap)
+		{
+			GLint previousTexture;
+			glCheck(glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture));
+			glCheck(glBindTexture(GL_TEXTURE_2D, targetTexture));
+			glCheck(glGenerateMipmap(GL_TEXTURE_2D));
+			glCheck(glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(previousTexture)));
+		}
+	}
+
+	void opengl_window::prepare_render()
+	{
+		const size viewportExtents = is_rendering_offscreen() ? iOffscreenTarget->extents : extents();
+		glCheck(glViewport(0, 0, static_cast<GLsizei>(viewportExtents.cx), static_cast<GLsizei>(viewportExtents.cy)));
+		glCheck(glEnable(GL_MULTISAMPLE));
+		glCheck(glEnable(GL_BLEND));
+		glCheck(glEnable(GL_DEPTH_TEST));
+		glCheck(glDepthFunc(GL_LEQUAL));
+	}
+
+	rect opengl_window::render_offscreen(i_widget& aWidget, const size& aExtents, dimension aDpiScaleFactor)
+	{
+		if (iRendering)
+			throw busy_rendering();
+		const size targetExtents = (aExtents * aDpiScaleFactor).ceil();
+		if (targetExtents.empty())
+			return rect{};
+		const auto savedInvalidatedArea = iInvalidatedArea;
+		const size savedExtents = units_converter(aWidget).to_device_units(aWidget.extents());
+		// while the offscreen target is set the window reports a pixel density matching the requested DPI so the widget is 
+		// laid out at the target's extents and DPI, one device pixel per target pixel, and then laid out again as it was
+		const dimension nativePpi = native_window::ppi();
+		const dimension densityScale = nativePpi > 0.0 ? ppi_for_dpi_scale_factor(nativePpi, aDpiScaleFactor) / nativePpi : 1.0;
+		iOffscreenTarget = offscreen_target{ &aWidget, rect{}, targetExtents, densityScale };
+		auto restoreLayout = [&]()
+		{
+			iOffscreenTarget = boost::none;
+			scoped_units su{ aWidget, units::Pixels };
+			aWidget.resize(savedExtents);
+			aWidget.layout_items();
+			iInvalidatedArea = savedInvalidatedArea;
+		};
+		try
+		{
+			{
+				scoped_units su{ aWidget, units::Pixels };
+				aWidget.resize(targetExtents);
+			}
+			aWidget.layout_items();
+			const rect sourceRect = aWidget.non_client_rect();
+			iOffscreenTarget->sourceRect = sourceRect;
+			// widgets only paint themselves if they intersect the invalidated area so temporarily replace it with the source rectangle
+			iInvalidatedArea = sourceRect;
+			neolib::scoped_flag sf{ iRendering };
+			rendering_engine().activate_context(*this);
+			prepare_render();
+			iOffscreenFrameBuffer.bind(targetExtents);
+			glCheck(glClearColor(0.0f, 0.0f, 0.0f, 0.0f));
+			glCheck(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT));
+			{
+				// only the widget subtree is rendered; graphics contexts map its rectangle onto the whole target
+				graphics_context gc{ aWidget };
+				aWidget.render(gc);
+			}
+			rendering_engine().vertex_arrays().execute();
+			iOffscreenResolveBuffer.bind(targetExtents);
+			// resolve multisampling
+			const rect frameBufferRect{ point{}, targetExtents };
+			iOffscreenFrameBuffer.resolve(frameBufferRect, iOffscreenResolveBuffer.handle(), frameBufferRect);
+			glCheck(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+			restoreLayout();
+			return frameBufferRect;
+		}
+		catch (...)
+		{
+			restoreLayout();
+			throw;
+		}
+	}
 }
\ No newline at end of file
@@ -29,6 +29,7 @@
 #include "../../../gfx/native/opengl.hpp"
 #include "../../../gfx/native/i_native_graphics_context.hpp"
 #include "../../../gfx/native/opengl_texture.hpp"
+#include "../../../gfx/native/opengl_frame_buffer.hpp"
 #include "native_window.hpp"
 
 namespace neogfx
@@ -37,12 +38,19 @@ namespace neogfx
 
 	class opengl_window : public native_window
 	{
+	private:
+		struct offscreen_target
+		{
+			const i_widget* widget;
+			rect sourceRect;
+			size extents;
+			dimension densityScale; // applied to the window's pixel density so that the widget lays out at the requested DPI
+		};
 	public:
-		struct failed_to_create_framebuffer : std::runtime_error { 
-			failed_to_create_framebuffer(GLenum aErrorCode) : 
-				std::runtime_error("neogfx::opengl_window::failed_to_create_framebuffer: Failed to create frame buffer, reason: " + glErrorString(aErrorCode)) {} };
 		struct busy_rendering : std::logic_error { busy_rendering() : std::logic_error("neogfx::opengl_window::busy_rendering") {} };
 		struct bad_pause_count : std::logic_error { bad_pause_count() : std::logic_error("neogfx::opengl_window::bad_pause_count") {} };
+		struct no_layer : std::logic_error { no_layer() : std::logic_error("neogfx::opengl_window::no_layer") {} };
+		struct unsupported_render_target : std::logic_error { unsupported_render_target() : std::logic_error("neogfx::opengl_window::unsupported_render_target") {} };
 	public:
 		opengl_window(i_rendering_engine& aRenderingEngine, i_surface_manager& aSurfaceManager, i_surface_window& aWindow);
 		~opengl_window();
@@ -67,7 +75,17 @@ namespace neogfx
 		bool is_rendering() const override;
 		void* rendering_target_texture_handle() const override;
 		size rendering_target_texture_extents() const override;
+		void render_to_texture(i_widget& aWidget, const size& aExtents, dimension aDpiScaleFactor, i_texture& aTarget) override;
+		void render_to_image(i_widget& aWidget, const size& aExtents, dimension aDpiScaleFactor, i_image& aTarget) override;
+		bool is_rendering_offscreen() const override;
+		const i_widget& offscreen_widget() const override;
+		rect to_viewport(const rect& aSurfaceRect) const override;
+		void begin_layer(const rect& aLayerRect) override;
+		void end_layer(i_texture& aTarget) override;
 	public:
+		dimension horizontal_dpi() const override;
+		dimension vertical_dpi() const override;
+		dimension ppi() const override;
 		bool metrics_available() const override;
 		size extents() const override;
 	protected:
@@ -76,20 +94,29 @@ namespace neogfx
 		void set_destroyed() override;
 	private:
 		virtual void display() = 0;
+	private:
+		const opengl_frame_buffer& active_frame_buffer() const;
+		opengl_frame_buffer& active_frame_buffer();
+		rect to_frame_buffer_rect(const rect& aRect) const;
+		void copy_to_texture(const rect& aFrameBufferRect, i_texture& aTarget);
+		void prepare_render();
+		rect render_offscreen(i_widget& aWidget, const size& aExtents, dimension aDpiScaleFactor);
 	private:
 		i_surface_window& iSurfaceWindow;
 		neogfx::logical_coordinate_system iLogicalCoordinateSystem;
 		mutable std::pair<vec2, vec2> iLogicalCoordinates;
-		GLuint iFrameBuffer;
-		GLuint iFrameBufferTexture;
-		GLuint iDepthStencilBuffer;
-		size iFrameBufferSize;
+		opengl_frame_buffer iFrameBuffer;
+		opengl_frame_buffer iOffscreenFrameBuffer;
+		opengl_frame_buffer iOffscreenResolveBuffer;
+		std::vector<std::unique_ptr<opengl_frame_buffer>> iLayerBuffers;
+		std::vector<std::pair<rect, boost::optional<rect>>> iLayers;
 		boost::optional<rect> iInvalidatedArea;
 		uint64_t iFrameCounter;
 		boost::optional<uint32_t> iFrameRate;
 		uint64_t iLastFrameTime;
 		std::deque<double> iFpsData;
 		bool iRendering;
+		boost::optional<offscreen_target> iOffscreenTarget;
 		uint32_t iPaused;
 	};
 }
\ No newline at end of file
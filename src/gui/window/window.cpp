@@ -561,7 +561,9 @@ namespace neogfx
 
 	void window::resized()
 	{
-		window_manager().resize_window(*this, widget::extents());
+		// an offscreen render lays the window out at the size of its target without touching the native window
+		if (!has_native_surface() || !native_surface().is_rendering_offscreen())
+			window_manager().resize_window(*this, widget::extents());
 		scrollable_widget::resized();
 		update(true);
 	}
@@ -890,12 +892,6 @@ namespace neogfx
 		else
 			layout_items(true);
 
-		iSink += app::instance().current_style_changed([this](style_aspect aAspect)
-		{
-			if ((aAspect & style_aspect::Colour) == style_aspect::Colour)
-				surface().native_surface().invalidate(surface().surface_size());
-		});
-
 		init_scrollbars();
 	}
 
@@ -30,6 +30,8 @@ namespace neogfx
 	class i_rendering_engine;
 	class i_native_graphics_context;
 	class i_widget;
+	class i_texture;
+	class i_image;
 
 	class i_native_surface : public i_object
 	{
@@ -37,6 +39,7 @@ namespace neogfx
 		struct no_parent : std::logic_error { no_parent() : std::logic_error("neogfx::i_native_surface::no_parent") {} };
 		struct context_mismatch : std::logic_error { context_mismatch() : std::logic_error("neogfx::i_native_surface::context_mismatch") {} };
 		struct no_invalidated_area : std::logic_error { no_invalidated_area() : std::logic_error("neogfx::i_native_surface::no_invalidated_area") {} };
+		struct not_rendering_offscreen : std::logic_error { not_rendering_offscreen() : std::logic_error("neogfx::i_native_surface::not_rendering_offscreen") {} };
 	public:
 		virtual ~i_native_surface() {}
 	public:
@@ -77,6 +80,13 @@ namespace neogfx
 		virtual bool is_rendering() const = 0;
 		virtual void* rendering_target_texture_handle() const = 0;
 		virtual size rendering_target_texture_extents() const = 0;
+		virtual void render_to_texture(i_widget& aWidget, const size& aExtents, dimension aDpiScaleFactor, i_texture& aTarget) = 0;
+		virtual void render_to_image(i_widget& aWidget, const size& aExtents, dimension aDpiScaleFactor, i_image& aTarget) = 0;
+		virtual bool is_rendering_offscreen() const = 0;
+		virtual const i_widget& offscreen_widget() const = 0;
+		virtual rect to_viewport(const rect& aSurfaceRect) const = 0;
+		virtual void begin_layer(const rect& aLayerRect) = 0;
+		virtual void end_layer(i_texture& aTarget) = 0;
 		virtual std::unique_ptr<i_native_graphics_context> create_graphics_context() const = 0;
 		virtual std::unique_ptr<i_native_graphics_context> create_graphics_context(const i_widget& aWidget) const = 0;
 	};
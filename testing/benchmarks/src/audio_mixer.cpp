@@ -0,0 +1,58 @@
+#include <neolib/neolib.hpp>
+#include <vector>
+#include <memory>
+#include <neogfx/audio/audio_mixer.hpp>
+#include <neogfx/audio/audio_track.hpp>
+#include <neogfx/audio/audio_beeper_sample.hpp>
+#include "benchmark.hpp"
+
+namespace
+{
+	using namespace neogfx;
+
+	volatile uint8_t sink; // keeps the rendering from being optimised away
+
+	const audio_mixer::frame_index kBlockFrames = 1024u;
+	const std::size_t kBlocks = 200u;
+
+	// Renders aTrackCount tracks of beeps, half of them at a source rate that needs resampling, without a device.
+	void render_benchmark(audio_format aFormat, const std::string& aFormatName, std::size_t aTrackCount)
+	{
+		const audio_spec outputSpec{ 48000, aFormat, 2, static_cast<uint16_t>(kBlockFrames) };
+		audio_mixer mixer{ outputSpec };
+		std::vector<std::shared_ptr<audio_beeper_sample>> samples;
+		std::vector<std::unique_ptr<audio_track>> tracks;
+		for (std::size_t i = 0; i < aTrackCount; ++i)
+		{
+			const audio_spec sourceSpec{ i % 2 == 0 ? 48000 : 44100, audio_format::F32, 1 };
+			samples.push_back(std::make_shared<audio_beeper_sample>(sourceSpec));
+			samples.back()->beep(60.0, 220.0 * (i + 1)); // long enough to outlast every block rendered
+			tracks.push_back(std::make_unique<audio_track>(sourceSpec, mixer.mutex()));
+			tracks.back()->add_sample(samples.back());
+			mixer.add_track(*tracks.back());
+		}
+		std::vector<uint8_t> output(static_cast<std::size_t>(kBlockFrames) * outputSpec.frame_size());
+		mixer.render(&output[0], kBlockFrames); // first render expands the beeper segments
+		double const ms = benchmarks::time_ms([&]()
+		{
+			mixer.render(&output[0], kBlockFrames);
+			sink = output[0];
+		}, kBlocks);
+		double const blockMs = kBlockFrames * 1000.0 / outputSpec.frequency();
+		benchmarks::report("render, " + aFormatName + ", " + std::to_string(aTrackCount) + " track(s), " + std::to_string(kBlockFrames) + " frames", ms);
+		std::cout << "  real time factor: " << blockMs / ms << "x" << std::endl;
+		for (auto& track : tracks)
+			mixer.remove_track(*track);
+	}
+
+	void audio_mixer_benchmark()
+	{
+		for (std::size_t tracks : { 1u, 8u, 32u })
+		{
+			render_benchmark(audio_format::F32, "F32", tracks);
+			render_benchmark(audio_format::S16, "S16", tracks);
+		}
+	}
+
+	benchmarks::register_benchmark s1{ "audio_mixer", audio_mixer_benchmark };
+}
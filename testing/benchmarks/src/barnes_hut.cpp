@@ -0,0 +1,85 @@
+#include <neolib/neolib.hpp>
+#include <vector>
+#include <random>
+#include <neogfx/game/barnes_hut_tree.hpp>
+#include "benchmark.hpp"
+
+namespace
+{
+	using namespace neogfx;
+
+	const scalar kG = 6.67408e-11;
+
+	std::vector<point_mass> make_bodies(std::size_t aCount)
+	{
+		std::mt19937 rng{ 42u };
+		std::uniform_real_distribution<scalar> position{ -1000.0, 1000.0 };
+		std::uniform_real_distribution<scalar> mass{ 1.0e6, 1.0e9 };
+		std::vector<point_mass> result;
+		result.reserve(aCount);
+		for (std::size_t i = 0; i < aCount; ++i)
+			result.push_back(point_mass{ reinterpret_cast<const void*>(i + 1), vec3{ position(rng), position(rng), 0.0 }, mass(rng) });
+		return result;
+	}
+
+	// The all-pairs sum that physical objects perform when Barnes-Hut is disabled.
+	void direct_sum(const std::vector<point_mass>& aBodies, std::vector<vec3>& aForces)
+	{
+		aForces.assign(aBodies.size(), vec3{});
+		for (std::size_t i = 0; i < aBodies.size(); ++i)
+			for (std::size_t j = i + 1; j < aBodies.size(); ++j)
+			{
+				vec3 r = aBodies[i].position - aBodies[j].position;
+				scalar distance = r.magnitude();
+				if (distance == 0.0)
+					continue;
+				vec3 force = -kG * aBodies[i].mass * aBodies[j].mass * r / (distance * distance * distance);
+				aForces[i] += force;
+				aForces[j] -= force;
+			}
+	}
+
+	void barnes_hut(barnes_hut_tree<2>& aTree, const std::vector<point_mass>& aBodies, std::vector<vec3>& aForces)
+	{
+		aForces.resize(aBodies.size());
+		aTree.build(aBodies);
+		for (std::size_t i = 0; i < aBodies.size(); ++i)
+			aForces[i] = aTree.force(aBodies[i], kG);
+	}
+
+	scalar mean_relative_error(const std::vector<vec3>& aExact, const std::vector<vec3>& aApproximate)
+	{
+		scalar total = 0.0;
+		for (std::size_t i = 0; i < aExact.size(); ++i)
+			if (aExact[i].magnitude() != 0.0)
+				total += (aApproximate[i] - aExact[i]).magnitude() / aExact[i].magnitude();
+		return aExact.empty() ? 0.0 : total / aExact.size();
+	}
+
+	void barnes_hut_benchmark()
+	{
+		for (std::size_t count : { 250u, 1000u, 4000u })
+		{
+			auto const bodies = make_bodies(count);
+			std::vector<vec3> exact;
+			std::vector<vec3> approximate;
+			barnes_hut_tree<2> tree;
+			std::size_t const iterations = count <= 1000u ? 20u : 2u;
+			benchmarks::report("direct sum, " + std::to_string(count) + " bodies", benchmarks::time_ms([&]()
+			{
+				direct_sum(bodies, exact);
+			}, iterations));
+			for (scalar theta : { 0.5, 1.0 })
+			{
+				tree.set_theta(theta);
+				benchmarks::report("barnes-hut (theta " + std::to_string(theta).substr(0, 3) + "), " + std::to_string(count) + " bodies", benchmarks::time_ms([&]()
+				{
+					barnes_hut(tree, bodies, approximate);
+				}, iterations));
+				std::cout << "  mean relative force error: " << mean_relative_error(exact, approximate) << std::endl;
+			}
+		}
+	}
+
+	benchmarks::register_benchmark sBarnesHut{ "barnes_hut", barnes_hut_benchmark };
+}
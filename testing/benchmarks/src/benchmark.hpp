@@ -0,0 +1,50 @@
+#pragma once
+
+#include <neogfx/neogfx.hpp>
+#include <string>
+#include <vector>
+#include <functional>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+
+namespace benchmarks
+{
+	typedef std::function<void()> benchmark_function;
+
+	struct benchmark
+	{
+		std::string name;
+		benchmark_function function;
+	};
+
+	inline std::vector<benchmark>& registry()
+	{
+		static std::vector<benchmark> sBenchmarks;
+		return sBenchmarks;
+	}
+
+	struct register_benchmark
+	{
+		register_benchmark(const std::string& aName, benchmark_function aFunction)
+		{
+			registry().push_back(benchmark{ aName, aFunction });
+		}
+	};
+
+	// Returns the mean number of milliseconds taken by a call of aFunction over aIterations calls.
+	template <typename Function>
+	inline double time_ms(Function aFunction, std::size_t aIterations = 1)
+	{
+		auto const start = std::chrono::high_resolution_clock::now();
+		for (std::size_t i = 0; i < aIterations; ++i)
+			aFunction();
+		auto const end = std::chrono::high_resolution_clock::now();
+		return std::chrono::duration<double, std::milli>(end - start).count() / static_cast<double>(aIterations);
+	}
+
+	inline void report(const std::string& aWhat, double aMilliseconds)
+	{
+		std::cout << "  " << std::left << std::setw(48) << aWhat << std::right << std::setw(12) << std::fixed << std::setprecision(6) << aMilliseconds << " ms" << std::endl;
+	}
+}
@@ -0,0 +1,119 @@
+#include <neolib/neolib.hpp>
+#include <vector>
+#include <memory>
+#include <random>
+#include <neogfx/game/physical_object.hpp>
+#include <neogfx/game/aabb_quadtree.hpp>
+#include <neogfx/game/aabb_octree.hpp>
+#include <neogfx/game/aabb_sweep_and_prune.hpp>
+#include "benchmark.hpp"
+
+namespace
+{
+	using namespace neogfx;
+
+	const scalar kWorldHalfExtent = 2000.0;
+	const std::size_t kSteps = 50;
+
+	// A square physical object that drifts at a constant velocity, wrapping around the edges of the world.
+	class body : public physical_object
+	{
+	public:
+		body(const vec3& aPosition, const vec3& aVelocity, scalar aHalfSize) :
+			iVelocity{ aVelocity }, iHalfSize{ aHalfSize }
+		{
+			set_position(aPosition);
+			update_aabb();
+		}
+	public:
+		const neogfx::aabb& aabb() const override
+		{
+			return iAabb;
+		}
+		void move()
+		{
+			vec3 newPosition = position() + iVelocity;
+			for (uint32_t i = 0; i < 2; ++i)
+				if (newPosition[i] < -kWorldHalfExtent)
+					newPosition[i] += kWorldHalfExtent * 2.0;
+				else if (newPosition[i] > kWorldHalfExtent)
+					newPosition[i] -= kWorldHalfExtent * 2.0;
+			set_position(newPosition);
+			update_aabb();
+		}
+	private:
+		void update_aabb()
+		{
+			iAabb = neogfx::aabb{ position() - vec3{ iHalfSize, iHalfSize, 0.0 }, position() + vec3{ iHalfSize, iHalfSize, 0.0 } };
+		}
+	private:
+		vec3 iVelocity;
+		scalar iHalfSize;
+		neogfx::aabb iAabb;
+	};
+
+	i_broad_phase::object_list make_bodies(std::size_t aCount)
+	{
+		std::mt19937 rng{ 42u };
+		std::uniform_real_distribution<scalar> position{ -kWorldHalfExtent, kWorldHalfExtent };
+		std::uniform_real_distribution<scalar> velocity{ -4.0, 4.0 };
+		std::uniform_real_distribution<scalar> halfSize{ 2.0, 12.0 };
+		i_broad_phase::object_list result;
+		result.reserve(aCount);
+		for (std::size_t i = 0; i < aCount; ++i)
+			result.push_back(std::make_shared<body>(vec3{ position(rng), position(rng), 0.0 }, vec3{ velocity(rng), velocity(rng), 0.0 }, halfSize(rng)));
+		return result;
+	}
+
+	// Runs kSteps simulation steps through the i_broad_phase interface, as sprite_plane does, returning the number of
+	// candidate pairs found so that the broad phases can be checked against each other.
+	std::size_t run(i_broad_phase& aBroadPhase, i_broad_phase::object_list& aObjects, bool aDynamicUpdate)
+	{
+		for (auto& o : aObjects)
+			aBroadPhase.insert(o->as_collidable_object());
+		std::size_t pairs = 0;
+		for (std::size_t step = 0; step < kSteps; ++step)
+		{
+			for (auto& o : aObjects)
+				static_cast<body&>(*o).move();
+			if (aDynamicUpdate)
+				aBroadPhase.dynamic_update(aObjects.begin(), aObjects.end());
+			else
+				aBroadPhase.full_update(aObjects.begin(), aObjects.end());
+			aBroadPhase.collisions(aObjects.begin(), aObjects.end(), [&pairs](i_collidable_object&, i_collidable_object&)
+			{
+				++pairs;
+			});
+		}
+		return pairs;
+	}
+
+	template <typename BroadPhase>
+	void measure(const std::string& aName, std::size_t aCount)
+	{
+		for (bool dynamicUpdate : { false, true })
+		{
+			auto objects = make_bodies(aCount);
+			std::unique_ptr<i_broad_phase> broadPhase = std::make_unique<BroadPhase>();
+			std::size_t pairs = 0;
+			double const ms = benchmarks::time_ms([&]()
+			{
+				pairs = run(*broadPhase, objects, dynamicUpdate);
+			});
+			benchmarks::report(aName + (dynamicUpdate ? " (dynamic), " : " (full), ") + std::to_string(aCount) + " objects", ms / kSteps);
+			std::cout << "  candidate pairs: " << pairs << std::endl;
+		}
+	}
+
+	void broad_phase_benchmark()
+	{
+		for (std::size_t count : { 500u, 2000u, 8000u })
+		{
+			measure<aabb_quadtree<>>("quadtree", count);
+			measure<aabb_octree<>>("octree", count);
+			measure<aabb_sweep_and_prune<>>("sweep and prune", count);
+		}
+	}
+
+	benchmarks::register_benchmark sBroadPhase{ "broad_phase", broad_phase_benchmark };
+}
@@ -0,0 +1,116 @@
+#include <neolib/neolib.hpp>
+#include <vector>
+#include <random>
+#include <neogfx/core/colour.hpp>
+#include <neogfx/core/colour_conversion.hpp>
+#include "benchmark.hpp"
+
+namespace
+{
+	using namespace neogfx;
+
+	volatile uint32_t sink; // keeps the conversions from being optimised away
+
+	// the size of the colour dialog's picker texture
+	const std::size_t kPixels = 256u * 256u;
+
+	struct planar
+	{
+		std::vector<float> hue;
+		std::vector<float> saturation;
+		std::vector<float> valueOrLightness;
+	};
+
+	planar make_input()
+	{
+		std::mt19937 rng{ 42u };
+		std::uniform_real_distribution<float> unit{ 0.0f, 1.0f };
+		planar result;
+		for (std::size_t i = 0; i < kPixels; ++i)
+		{
+			result.hue.push_back(unit(rng) * 360.0f);
+			result.saturation.push_back(unit(rng));
+			result.valueOrLightness.push_back(unit(rng));
+		}
+		return result;
+	}
+
+	void colour_conversion_benchmark()
+	{
+		auto const input = make_input();
+		std::vector<uint8_t> rgba(kPixels * 4u);
+		std::string const what = " (256x256)";
+		const std::size_t iterations = 20u;
+
+		benchmarks::report("hsv_colour::to_rgb, per pixel" + what, benchmarks::time_ms([&]()
+		{
+			for (std::size_t i = 0; i < kPixels; ++i)
+			{
+				colour rgb = hsv_colour{ input.hue[i], input.saturation[i], input.valueOrLightness[i] }.to_rgb();
+				rgba[i * 4u] = rgb.red();
+				rgba[i * 4u + 1u] = rgb.green();
+				rgba[i * 4u + 2u] = rgb.blue();
+				rgba[i * 4u + 3u] = 0xFF;
+			}
+			sink += rgba[0];
+		}, iterations));
+		benchmarks::report("hsv_to_rgba, planar" + what, benchmarks::time_ms([&]()
+		{
+			hsv_to_rgba(&input.hue[0], &input.saturation[0], &input.valueOrLightness[0], kPixels, &rgba[0]);
+			sink += rgba[0];
+		}, iterations));
+		std::vector<hsv_colour> hsv;
+		for (std::size_t i = 0; i < kPixels; ++i)
+			hsv.emplace_back(input.hue[i], input.saturation[i], input.valueOrLightness[i]);
+		benchmarks::report("hsv_to_rgba, hsv_colour array" + what, benchmarks::time_ms([&]()
+		{
+			hsv_to_rgba(&hsv[0], hsv.size(), &rgba[0]);
+			sink += rgba[0];
+		}, iterations));
+
+		benchmarks::report("hsl_colour::to_rgb, per pixel" + what, benchmarks::time_ms([&]()
+		{
+			for (std::size_t i = 0; i < kPixels; ++i)
+			{
+				colour rgb = hsl_colour{ input.hue[i], input.saturation[i], input.valueOrLightness[i] }.to_rgb();
+				rgba[i * 4u] = rgb.red();
+				rgba[i * 4u + 1u] = rgb.green();
+				rgba[i * 4u + 2u] = rgb.blue();
+				rgba[i * 4u + 3u] = 0xFF;
+			}
+			sink += rgba[0];
+		}, iterations));
+		benchmarks::report("hsl_to_rgba, planar" + what, benchmarks::time_ms([&]()
+		{
+			hsl_to_rgba(&input.hue[0], &input.saturation[0], &input.valueOrLightness[0], kPixels, &rgba[0]);
+			sink += rgba[0];
+		}, iterations));
+
+		std::vector<float> hue(kPixels), saturation(kPixels), value(kPixels);
+		benchmarks::report("hsv_colour::from_rgb, per pixel" + what, benchmarks::time_ms([&]()
+		{
+			for (std::size_t i = 0; i < kPixels; ++i)
+				hsv[i] = hsv_colour::from_rgb(colour{ rgba[i * 4u], rgba[i * 4u + 1u], rgba[i * 4u + 2u], rgba[i * 4u + 3u] });
+			sink += static_cast<uint32_t>(hsv[0].value() * 255.0);
+		}, iterations));
+		benchmarks::report("rgba_to_hsv, planar" + what, benchmarks::time_ms([&]()
+		{
+			rgba_to_hsv(&rgba[0], kPixels, &hue[0], &saturation[0], &value[0]);
+			sink += static_cast<uint32_t>(value[0] * 255.0f);
+		}, iterations));
+
+		std::vector<float> linear(kPixels * 4u);
+		benchmarks::report("srgb_to_linear" + what, benchmarks::time_ms([&]()
+		{
+			srgb_to_linear(&rgba[0], kPixels, &linear[0]);
+			sink += static_cast<uint32_t>(linear[0] * 255.0f);
+		}, iterations));
+		benchmarks::report("linear_to_srgb" + what, benchmarks::time_ms([&]()
+		{
+			linear_to_srgb(&linear[0], kPixels, &rgba[0]);
+			sink += rgba[0];
+		}, iterations));
+	}
+
+	benchmarks::register_benchmark s1{ "colour_conversion", colour_conversion_benchmark };
+}
@@ -0,0 +1,59 @@
+#include <neolib/neolib.hpp>
+#include <vector>
+#include <random>
+#include <openssl/sha.h>
+#include <neogfx/core/content_hash.hpp>
+#include <neogfx/gfx/image.hpp>
+#include "benchmark.hpp"
+
+namespace
+{
+	using namespace neogfx;
+
+	volatile uint64_t sink; // keeps the hashing from being optimised away
+
+	std::vector<uint8_t> make_buffer(std::size_t aSize)
+	{
+		std::mt19937 rng{ 42u };
+		std::vector<uint8_t> result(aSize);
+		for (auto& b : result)
+			b = static_cast<uint8_t>(rng());
+		return result;
+	}
+
+	// The SHA-256 that image::hash() used before images were given a 64-bit content hash; resources still use it.
+	void content_hash_benchmark()
+	{
+		for (std::size_t bytes : { 64u * 1024u, 1024u * 1024u, 16u * 1024u * 1024u, 64u * 1024u * 1024u })
+		{
+			auto const buffer = make_buffer(bytes);
+			std::size_t const iterations = bytes <= 1024u * 1024u ? 100u : 4u;
+			std::string const what = std::to_string(bytes / 1024u) + " KiB";
+			double const sha256 = benchmarks::time_ms([&]()
+			{
+				uint8_t digest[SHA256_DIGEST_LENGTH];
+				SHA256(&buffer[0], buffer.size(), digest);
+				sink += digest[0];
+			}, iterations);
+			double const contentHash = benchmarks::time_ms([&]()
+			{
+				sink += content_hash(&buffer[0], buffer.size());
+			}, iterations);
+			benchmarks::report("SHA-256, " + what, sha256);
+			benchmarks::report("content_hash, " + what, contentHash);
+			std::cout << "  speedup: " << sha256 / contentHash << "x" << std::endl;
+		}
+		// an image is hashed once and the hash memoised until its pixels change
+		image img{ size{ 1024.0, 1024.0 }, colour::Red };
+		benchmarks::report("image::hash(), first call, 1024x1024", benchmarks::time_ms([&]()
+		{
+			sink += img.hash()[0];
+		}));
+		benchmarks::report("image::hash(), memoised, 1024x1024", benchmarks::time_ms([&]()
+		{
+			sink += img.hash()[0];
+		}, 1000u));
+	}
+
+	benchmarks::register_benchmark s1{ "content_hash", content_hash_benchmark };
+}
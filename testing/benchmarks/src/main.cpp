@@ -0,0 +1,30 @@
+#include <neolib/neolib.hpp>
+#include <iostream>
+#include <string>
+#include "benchmark.hpp"
+
+// Runs every registered benchmark or only those named on the command line.
+int main(int argc, char* argv[])
+{
+	int ran = 0;
+	for (auto const& b : benchmarks::registry())
+	{
+		bool selected = (argc < 2);
+		for (int i = 1; !selected && i < argc; ++i)
+			selected = (b.name == argv[i]);
+		if (!selected)
+			continue;
+		std::cout << b.name << ":" << std::endl;
+		b.function();
+		++ran;
+	}
+	if (ran == 0)
+	{
+		std::cerr << "no benchmarks selected; available:";
+		for (auto const& b : benchmarks::registry())
+			std::cerr << " " << b.name;
+		std::cerr << std::endl;
+		return 1;
+	}
+	return 0;
+}
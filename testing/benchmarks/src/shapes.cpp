@@ -0,0 +1,68 @@
+#include <neolib/neolib.hpp>
+#include <vector>
+#include <neogfx/game/shapes.hpp>
+#include "benchmark.hpp"
+
+namespace
+{
+	using namespace neogfx;
+
+	const std::size_t kIterations = 100000;
+
+	// The allocate-per-call path that arc_vertices() and rounded_rect_vertices() used to take.
+	std::vector<xyz> allocating_rounded_rect(const rect& aRect, dimension aRadius)
+	{
+		std::vector<xyz> result;
+		rounded_rect_vertices(result, aRect, aRadius, true);
+		return result;
+	}
+
+	void shapes_benchmark()
+	{
+		std::vector<xyz> buffer;
+		volatile std::size_t sink = 0;
+
+		clear_shape_cache();
+		benchmarks::report("rounded rect (cold, new buffer each call)", benchmarks::time_ms([&]()
+		{
+			clear_shape_cache();
+			sink = sink + allocating_rounded_rect(rect{ point{ 10.0, 10.0 }, size{ 120.0, 32.0 } }, 6.0).size();
+		}, kIterations / 10));
+
+		clear_shape_cache();
+		benchmarks::report("rounded rect (cached, new buffer each call)", benchmarks::time_ms([&]()
+		{
+			sink = sink + allocating_rounded_rect(rect{ point{ 10.0, 10.0 }, size{ 120.0, 32.0 } }, 6.0).size();
+		}, kIterations));
+
+		clear_shape_cache();
+		benchmarks::report("rounded rect (cached, reused buffer)", benchmarks::time_ms([&]()
+		{
+			rounded_rect_vertices(buffer, rect{ point{ 10.0, 10.0 }, size{ 120.0, 32.0 } }, 6.0, true);
+			sink = sink + buffer.size();
+		}, kIterations));
+
+		clear_shape_cache();
+		benchmarks::report("circle (cached, reused buffer)", benchmarks::time_ms([&]()
+		{
+			circle_vertices(buffer, point{ 100.0, 100.0 }, 24.0, 0.0, true);
+			sink = sink + buffer.size();
+		}, kIterations));
+
+		// more distinct shapes than the cache holds but a small hot set: LRU eviction keeps the hot set resident
+		clear_shape_cache();
+		std::size_t next = 0;
+		benchmarks::report("rounded rect (hot set + churn, reused buffer)", benchmarks::time_ms([&]()
+		{
+			const bool hot = (next % 4 != 0);
+			const dimension width = hot ? 100.0 + (next % 8) : 1000.0 + (next % 4096);
+			++next;
+			rounded_rect_vertices(buffer, rect{ point{ 10.0, 10.0 }, size{ width, 32.0 } }, 6.0, true);
+			sink = sink + buffer.size();
+		}, kIterations));
+		auto const& stats = shape_cache_statistics();
+		std::cout << "  rounded rect cache hits/misses: " << stats.roundedRectHits << "/" << stats.roundedRectMisses << std::endl;
+	}
+
+	benchmarks::register_benchmark sShapes{ "shapes", shapes_benchmark };
+}
@@ -0,0 +1,160 @@
+#include <neolib/neolib.hpp>
+#include <vector>
+#include <random>
+#include <neogfx/core/numerical.hpp>
+#include "benchmark.hpp"
+
+namespace
+{
+	using namespace neogfx;
+
+	volatile double sink; // keeps the arithmetic from being optimised away
+
+	const std::size_t kCount = 4096u;
+	const std::size_t kIterations = 200u;
+
+	// The plain loops that basic_vector and basic_matrix used before they went through the SIMD kernels.
+	template <typename T, uint32_t Size>
+	struct scalar_kernel
+	{
+		static void add(T* aLeft, const T* aRight) { for (uint32_t index = 0; index < Size; ++index) aLeft[index] += aRight[index]; }
+		static void multiply(T* aLeft, T aRight) { for (uint32_t index = 0; index < Size; ++index) aLeft[index] *= aRight; }
+		static double sum_of_squares(const T* aValue) { double result = 0.0; for (uint32_t index = 0; index < Size; ++index) result += aValue[index] * aValue[index]; return result; }
+		static void multiply44(const T* aLeft, const T* aRight, T* aResult)
+		{
+			for (uint32_t column = 0; column < 4; ++column)
+				for (uint32_t row = 0; row < 4; ++row)
+				{
+					T sum{};
+					for (uint32_t index = 0; index < 4; ++index)
+						sum += aLeft[index * 4 + row] * aRight[column * 4 + index];
+					aResult[column * 4 + row] = sum;
+				}
+		}
+		static void transform44(const T* aMatrix, const T* aVector, T* aResult)
+		{
+			for (uint32_t row = 0; row < 4; ++row)
+			{
+				T sum{};
+				for (uint32_t index = 0; index < 4; ++index)
+					sum += aMatrix[index * 4 + row] * aVector[index];
+				aResult[row] = sum;
+			}
+		}
+	};
+
+	template <typename T>
+	std::vector<T> make_values(std::size_t aCount)
+	{
+		std::mt19937 rng{ 42u };
+		std::uniform_real_distribution<double> distribution{ -1.0, 1.0 };
+		std::vector<T> result(aCount);
+		for (auto& value : result)
+			value = static_cast<T>(distribution(rng));
+		return result;
+	}
+
+	template <typename T, uint32_t Size>
+	void vector_benchmark(const std::string& aType)
+	{
+		typedef detail::vector_kernel<T, Size> simd;
+		typedef scalar_kernel<T, Size> scalar;
+		auto left = make_values<T>(kCount * Size);
+		auto const right = make_values<T>(kCount * Size);
+		std::string const what = aType + std::to_string(Size) + " x " + std::to_string(kCount);
+		benchmarks::report("add, scalar, " + what, benchmarks::time_ms([&]()
+		{
+			for (std::size_t i = 0; i < kCount; ++i)
+				scalar::add(&left[i * Size], &right[i * Size]);
+			sink += left[0];
+		}, kIterations));
+		benchmarks::report("add, simd, " + what, benchmarks::time_ms([&]()
+		{
+			for (std::size_t i = 0; i < kCount; ++i)
+				simd::add(&left[i * Size], &right[i * Size]);
+			sink += left[0];
+		}, kIterations));
+		benchmarks::report("scale, scalar, " + what, benchmarks::time_ms([&]()
+		{
+			for (std::size_t i = 0; i < kCount; ++i)
+				scalar::multiply(&left[i * Size], static_cast<T>(0.5));
+			sink += left[0];
+		}, kIterations));
+		benchmarks::report("scale, simd, " + what, benchmarks::time_ms([&]()
+		{
+			for (std::size_t i = 0; i < kCount; ++i)
+				simd::multiply(&left[i * Size], static_cast<T>(0.5));
+			sink += left[0];
+		}, kIterations));
+		benchmarks::report("sum of squares, scalar, " + what, benchmarks::time_ms([&]()
+		{
+			double total = 0.0;
+			for (std::size_t i = 0; i < kCount; ++i)
+				total += scalar::sum_of_squares(&right[i * Size]);
+			sink += total;
+		}, kIterations));
+		benchmarks::report("sum of squares, simd, " + what, benchmarks::time_ms([&]()
+		{
+			double total = 0.0;
+			for (std::size_t i = 0; i < kCount; ++i)
+				total += simd::sum_of_squares(&right[i * Size]);
+			sink += total;
+		}, kIterations));
+	}
+
+	template <typename T>
+	void matrix_benchmark(const std::string& aType)
+	{
+		typedef detail::matrix44_kernel<T> simd;
+		typedef scalar_kernel<T, 4> scalar;
+		auto const matrices = make_values<T>(kCount * 16u);
+		auto const vectors = make_values<T>(kCount * 4u);
+		std::vector<T> result(kCount * 16u);
+		std::string const what = aType + " 4x4 x " + std::to_string(kCount);
+		benchmarks::report("multiply, scalar, " + what, benchmarks::time_ms([&]()
+		{
+			for (std::size_t i = 0; i + 1 < kCount; ++i)
+				scalar::multiply44(&matrices[i * 16u], &matrices[(i + 1) * 16u], &result[i * 16u]);
+			sink += result[0];
+		}, kIterations / 4u));
+		benchmarks::report("multiply, simd, " + what, benchmarks::time_ms([&]()
+		{
+			for (std::size_t i = 0; i + 1 < kCount; ++i)
+				simd::multiply(&matrices[i * 16u], &matrices[(i + 1) * 16u], &result[i * 16u]);
+			sink += result[0];
+		}, kIterations / 4u));
+		benchmarks::report("transform, scalar, " + what, benchmarks::time_ms([&]()
+		{
+			for (std::size_t i = 0; i < kCount; ++i)
+				scalar::transform44(&matrices[i * 16u], &vectors[i * 4u], &result[i * 4u]);
+			sink += result[0];
+		}, kIterations));
+		benchmarks::report("transform, simd, " + what, benchmarks::time_ms([&]()
+		{
+			for (std::size_t i = 0; i < kCount; ++i)
+				simd::transform(&matrices[i * 16u], &vectors[i * 4u], &result[i * 4u]);
+			sink += result[0];
+		}, kIterations));
+	}
+
+	void simd_benchmark()
+	{
+		vector_benchmark<float, 4>("float");
+		vector_benchmark<double, 2>("double");
+		vector_benchmark<double, 3>("double");
+		vector_benchmark<double, 4>("double");
+		matrix_benchmark<float>("float");
+		matrix_benchmark<double>("double");
+		// what basic_vector itself costs, magnitude() included
+		auto const values = make_values<double>(kCount * 3u);
+		benchmarks::report("vector3::magnitude() x " + std::to_string(kCount), benchmarks::time_ms([&]()
+		{
+			double total = 0.0;
+			for (std::size_t i = 0; i < kCount; ++i)
+				total += vector3{ values[i * 3u], values[i * 3u + 1u], values[i * 3u + 2u] }.magnitude();
+			sink += total;
+		}, kIterations));
+	}
+
+	benchmarks::register_benchmark s1{ "simd", simd_benchmark };
+}
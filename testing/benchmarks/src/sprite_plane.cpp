@@ -0,0 +1,52 @@
+#include <neolib/neolib.hpp>
+#include <random>
+#include <neogfx/game/sprite_plane.hpp>
+#include "benchmark.hpp"
+
+namespace
+{
+	using namespace neogfx;
+
+	const uint64_t kSteps = 100u;
+
+	// a headless plane stepped by hand, so every run simulates exactly the same thing
+	void populate(sprite_plane& aPlane, std::size_t aCount)
+	{
+		std::mt19937 rng{ 42u };
+		std::uniform_real_distribution<scalar> position{ -1000.0, 1000.0 };
+		std::uniform_real_distribution<scalar> mass{ 1.0e6, 1.0e9 };
+		aPlane.set_uniform_gravity();
+		for (std::size_t i = 0; i < aCount; ++i)
+		{
+			auto& body = aPlane.create_physical_object();
+			body.set_position(vec3{ position(rng), position(rng), 0.0 });
+			body.set_mass(mass(rng));
+		}
+	}
+
+	void sprite_plane_benchmark()
+	{
+		for (std::size_t count : { 100u, 500u, 1000u })
+		{
+			for (bool barnesHut : { false, true })
+			{
+				uint64_t hashes[2] = {};
+				double elapsed = 0.0;
+				for (auto& hash : hashes)
+				{
+					sprite_plane plane{ sprite_plane::ManualSimulation };
+					plane.enable_barnes_hut(barnesHut);
+					populate(plane, count);
+					plane.step(); // objects join the simulation at the first step
+					elapsed = benchmarks::time_ms([&]() { plane.step(); }, kSteps);
+					hash = plane.state_hash();
+				}
+				benchmarks::report("step, " + std::to_string(count) + " bodies" + (barnesHut ? ", Barnes-Hut" : ", all pairs"), elapsed);
+				if (hashes[0] != hashes[1])
+					std::cout << "  warning: runs diverged" << std::endl;
+			}
+		}
+	}
+
+	benchmarks::register_benchmark s1{ "sprite_plane", sprite_plane_benchmark };
+}
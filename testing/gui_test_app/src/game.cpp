@@ -156,7 +156,7 @@ void create_game(ng::i_layout& aLayout)
 	spritePlane.sprites_painted([&spritePlane](ng::graphics_context& aGraphicsContext)
 	{
 		aGraphicsContext.draw_text(ng::point{ 0.0, 0.0 }, "Hello, World!", spritePlane.font().with_style(ng::font_info::Underline), ng::colour::White);
-		if (ng::app::instance().keyboard().is_key_pressed(ng::ScanCode_C))
+		if (ng::app::instance().keyboard().is_key_pressed(ng::ScanCode_C) && spritePlane.is_collision_tree_2d())
 			spritePlane.collision_tree_2d().visit_aabbs([&aGraphicsContext](const neogfx::aabb_2d& aAabb)
 			{
 				ng::rect aabb{ ng::point{ aAabb.min }, ng::point{ aAabb.max } };
@@ -205,6 +205,10 @@ void create_game(ng::i_layout& aLayout)
 			spritePlane.enable_dynamic_update(true);
 		else if (keyboard.is_key_pressed(ng::ScanCode_F))
 			spritePlane.enable_dynamic_update(false);
+		if (keyboard.is_key_pressed(ng::ScanCode_S))
+			spritePlane.set_broad_phase(ng::sprite_plane::SweepAndPruneBroadPhase);
+		else if (keyboard.is_key_pressed(ng::ScanCode_Q))
+			spritePlane.set_broad_phase(ng::sprite_plane::QuadtreeBroadPhase);
 
 		std::ostringstream oss;
 		oss << "VELOCITY:  " << spaceshipSprite.velocity().magnitude() << " m/s" << "\n";
@@ -214,12 +218,19 @@ void create_game(ng::i_layout& aLayout)
 
 	~~~~spritePlane.physics_applied([debugInfo, &spritePlane](ng::sprite_plane::step_time_interval)
 	{
-		debugInfo->set_value(
-			"Objects: " + boost::lexical_cast<std::string>(spritePlane.objects().size()) + "\n" +
-			"Collision tree (quadtree) size: " + boost::lexical_cast<std::string>(spritePlane.collision_tree_2d().count()) + "\n" +
-			"Collision tree (quadtree) depth: " + boost::lexical_cast<std::string>(spritePlane.collision_tree_2d().depth()) + "\n" +
-			"Collision tree (quadtree) update type: " + (spritePlane.dynamic_update_enabled() ? "dynamic" : "full") + "\n" +
-			"Physics update time: " + boost::str(boost::format("%.6f") % spritePlane.update_time()) + " s");
+		if (spritePlane.is_collision_sweep_and_prune())
+			debugInfo->set_value(
+				"Objects: " + boost::lexical_cast<std::string>(spritePlane.objects().size()) + "\n" +
+				"Broad phase (sweep and prune) size: " + boost::lexical_cast<std::string>(spritePlane.collision_sweep_and_prune().count()) + "\n" +
+				"Broad phase (sweep and prune) update type: " + (spritePlane.dynamic_update_enabled() ? "dynamic" : "full") + "\n" +
+				"Physics update time: " + boost::str(boost::format("%.6f") % spritePlane.update_time()) + " s");
+		else
+			debugInfo->set_value(
+				"Objects: " + boost::lexical_cast<std::string>(spritePlane.objects().size()) + "\n" +
+				"Collision tree (quadtree) size: " + boost::lexical_cast<std::string>(spritePlane.collision_tree_2d().count()) + "\n" +
+				"Collision tree (quadtree) depth: " + boost::lexical_cast<std::string>(spritePlane.collision_tree_2d().depth()) + "\n" +
+				"Collision tree (quadtree) update type: " + (spritePlane.dynamic_update_enabled() ? "dynamic" : "full") + "\n" +
+				"Physics update time: " + boost::str(boost::format("%.6f") % spritePlane.update_time()) + " s");
 	});
 
 	spritePlane.mouse_event([&spritePlane, &spaceshipSprite](const neogfx::mouse_event& e)
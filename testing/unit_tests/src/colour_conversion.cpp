@@ -0,0 +1,248 @@
+#include <neogfx/neogfx.hpp>
+#include <vector>
+#include <cstdlib>
+#include <neogfx/core/colour.hpp>
+#include <neogfx/core/colour_conversion.hpp>
+#include "test.hpp"
+
+namespace
+{
+	// the planar kernels process four pixels at a time when SSE2 is available; an odd count also exercises the scalar tail
+	const std::size_t kOddCount = 7u;
+
+	bool within_one(uint8_t aLhs, uint8_t aRhs)
+	{
+		return std::abs(static_cast<int>(aLhs) - static_cast<int>(aRhs)) <= 1;
+	}
+
+	bool within_one(const uint8_t* aRgba, const neogfx::colour& aColour)
+	{
+		return within_one(aRgba[0], aColour.red()) && within_one(aRgba[1], aColour.green()) && within_one(aRgba[2], aColour.blue());
+	}
+
+	bool equal(const uint8_t* aRgba, uint8_t aRed, uint8_t aGreen, uint8_t aBlue, uint8_t aAlpha)
+	{
+		return aRgba[0] == aRed && aRgba[1] == aGreen && aRgba[2] == aBlue && aRgba[3] == aAlpha;
+	}
+
+	struct planar
+	{
+		std::vector<float> hue;
+		std::vector<float> saturation;
+		std::vector<float> valueOrLightness;
+		void push_back(float aHue, float aSaturation, float aValueOrLightness)
+		{
+			hue.push_back(aHue);
+			saturation.push_back(aSaturation);
+			valueOrLightness.push_back(aValueOrLightness);
+		}
+		std::size_t size() const { return hue.size(); }
+	};
+
+	planar sweep()
+	{
+		planar result;
+		for (float hue = 0.0f; hue < 360.0f; hue += 7.5f)
+			for (float saturation = 0.0f; saturation <= 1.0f; saturation += 0.25f)
+				for (float valueOrLightness = 0.0f; valueOrLightness <= 1.0f; valueOrLightness += 0.125f)
+					result.push_back(hue, saturation, valueOrLightness);
+		// keep the scalar tail in play
+		result.push_back(123.0f, 0.5f, 0.5f);
+		return result;
+	}
+
+	std::vector<uint8_t> rgb_grid()
+	{
+		std::vector<uint8_t> result;
+		for (int r = 0; r < 256; r += 17)
+			for (int g = 0; g < 256; g += 15)
+				for (int b = 0; b < 256; b += 51)
+				{
+					result.push_back(static_cast<uint8_t>(r));
+					result.push_back(static_cast<uint8_t>(g));
+					result.push_back(static_cast<uint8_t>(b));
+					result.push_back(static_cast<uint8_t>((r + g + b) & 0xFF));
+				}
+		return result;
+	}
+
+	void hsv_matches_hsv_colour()
+	{
+		auto const input = sweep();
+		std::vector<uint8_t> rgba(input.size() * 4);
+		neogfx::hsv_to_rgba(&input.hue[0], &input.saturation[0], &input.valueOrLightness[0], input.size(), &rgba[0]);
+		for (std::size_t i = 0; i < input.size(); ++i)
+		{
+			auto const expected = neogfx::hsv_colour{ input.hue[i], input.saturation[i], input.valueOrLightness[i] }.to_rgb();
+			UNIT_TEST_CHECK(within_one(&rgba[i * 4], expected));
+			UNIT_TEST_CHECK(rgba[i * 4 + 3] == 0xFF);
+		}
+	}
+
+	void hsl_matches_hsl_colour()
+	{
+		auto const input = sweep();
+		std::vector<uint8_t> rgba(input.size() * 4);
+		neogfx::hsl_to_rgba(&input.hue[0], &input.saturation[0], &input.valueOrLightness[0], input.size(), &rgba[0]);
+		for (std::size_t i = 0; i < input.size(); ++i)
+		{
+			auto const expected = neogfx::hsl_colour{ input.hue[i], input.saturation[i], input.valueOrLightness[i] }.to_rgb();
+			UNIT_TEST_CHECK(within_one(&rgba[i * 4], expected));
+			UNIT_TEST_CHECK(rgba[i * 4 + 3] == 0xFF);
+		}
+	}
+
+	void object_input_matches_planar()
+	{
+		auto const input = sweep();
+		std::vector<neogfx::hsv_colour> hsv;
+		std::vector<neogfx::hsl_colour> hsl;
+		for (std::size_t i = 0; i < input.size(); ++i)
+		{
+			hsv.emplace_back(input.hue[i], input.saturation[i], input.valueOrLightness[i], 0.5);
+			hsl.emplace_back(input.hue[i], input.saturation[i], input.valueOrLightness[i], 0.5);
+		}
+		std::vector<uint8_t> fromPlanar(input.size() * 4);
+		std::vector<uint8_t> fromObjects(input.size() * 4);
+		neogfx::hsv_to_rgba(&input.hue[0], &input.saturation[0], &input.valueOrLightness[0], input.size(), &fromPlanar[0], 127u);
+		neogfx::hsv_to_rgba(&hsv[0], hsv.size(), &fromObjects[0]);
+		for (std::size_t i = 0; i < input.size(); ++i)
+		{
+			UNIT_TEST_CHECK(within_one(fromPlanar[i * 4], fromObjects[i * 4]));
+			UNIT_TEST_CHECK(within_one(fromPlanar[i * 4 + 1], fromObjects[i * 4 + 1]));
+			UNIT_TEST_CHECK(within_one(fromPlanar[i * 4 + 2], fromObjects[i * 4 + 2]));
+			UNIT_TEST_CHECK(fromPlanar[i * 4 + 3] == 127u);
+			UNIT_TEST_CHECK(fromObjects[i * 4 + 3] == 127u);
+		}
+		neogfx::hsl_to_rgba(&input.hue[0], &input.saturation[0], &input.valueOrLightness[0], input.size(), &fromPlanar[0], 127u);
+		neogfx::hsl_to_rgba(&hsl[0], hsl.size(), &fromObjects[0]);
+		for (std::size_t i = 0; i < input.size(); ++i)
+		{
+			UNIT_TEST_CHECK(within_one(fromPlanar[i * 4], fromObjects[i * 4]));
+			UNIT_TEST_CHECK(within_one(fromPlanar[i * 4 + 1], fromObjects[i * 4 + 1]));
+			UNIT_TEST_CHECK(within_one(fromPlanar[i * 4 + 2], fromObjects[i * 4 + 2]));
+			UNIT_TEST_CHECK(fromObjects[i * 4 + 3] == 127u);
+		}
+	}
+
+	// hsv_colour and hsl_colour wrap hue into [0, 360) when it is set so hue 360 is red, as is hue 0; the planar
+	// kernels take raw floats and wrap the same way. Negative hues are clamped to 0 (red) by the planar kernels
+	// whereas hsv_colour::to_rgb produces no chroma for them.
+	void hue_360_is_red()
+	{
+		std::vector<float> hue(kOddCount, 360.0f);
+		hue[0] = 0.0f;
+		hue[1] = 720.0f;
+		hue[kOddCount - 1] = -60.0f;
+		std::vector<float> one(kOddCount, 1.0f);
+		std::vector<float> half(kOddCount, 0.5f);
+		std::vector<uint8_t> rgba(kOddCount * 4);
+		neogfx::hsv_to_rgba(&hue[0], &one[0], &one[0], kOddCount, &rgba[0]);
+		for (std::size_t i = 0; i < kOddCount; ++i)
+			UNIT_TEST_CHECK(equal(&rgba[i * 4], 0xFF, 0x00, 0x00, 0xFF));
+		neogfx::hsl_to_rgba(&hue[0], &one[0], &half[0], kOddCount, &rgba[0]);
+		for (std::size_t i = 0; i < kOddCount; ++i)
+			UNIT_TEST_CHECK(equal(&rgba[i * 4], 0xFF, 0x00, 0x00, 0xFF));
+		auto const hsv = neogfx::hsv_colour{ 360.0, 1.0, 1.0 }.to_rgb();
+		UNIT_TEST_CHECK(hsv.red() == 0xFF && hsv.green() == 0x00 && hsv.blue() == 0x00);
+		auto const hsl = neogfx::hsl_colour{ 360.0, 1.0, 0.5 }.to_rgb();
+		UNIT_TEST_CHECK(hsl.red() == 0xFF && hsl.green() == 0x00 && hsl.blue() == 0x00);
+	}
+
+	void hsv_round_trip()
+	{
+		auto const rgba = rgb_grid();
+		auto const count = rgba.size() / 4;
+		std::vector<float> hue(count), saturation(count), value(count);
+		neogfx::rgba_to_hsv(&rgba[0], count, &hue[0], &saturation[0], &value[0]);
+		std::vector<neogfx::hsv_colour> objects(count);
+		neogfx::rgba_to_hsv(&rgba[0], count, &objects[0]);
+		std::vector<uint8_t> result(rgba.size());
+		neogfx::hsv_to_rgba(&hue[0], &saturation[0], &value[0], count, &result[0]);
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			UNIT_TEST_CHECK(hue[i] >= 0.0f && hue[i] < 360.0f);
+			UNIT_TEST_CHECK(unit_tests::approximately_equal(hue[i], objects[i].hue(), 1.0e-4));
+			UNIT_TEST_CHECK(unit_tests::approximately_equal(saturation[i], objects[i].saturation(), 1.0e-5));
+			UNIT_TEST_CHECK(unit_tests::approximately_equal(value[i], objects[i].value(), 1.0e-5));
+			UNIT_TEST_CHECK(unit_tests::approximately_equal(rgba[i * 4 + 3] / 255.0, objects[i].alpha()));
+			for (std::size_t c = 0; c < 3; ++c)
+				UNIT_TEST_CHECK(within_one(result[i * 4 + c], rgba[i * 4 + c]));
+		}
+	}
+
+	void hsl_round_trip()
+	{
+		auto const rgba = rgb_grid();
+		auto const count = rgba.size() / 4;
+		std::vector<float> hue(count), saturation(count), lightness(count);
+		neogfx::rgba_to_hsl(&rgba[0], count, &hue[0], &saturation[0], &lightness[0]);
+		std::vector<neogfx::hsl_colour> objects(count);
+		neogfx::rgba_to_hsl(&rgba[0], count, &objects[0]);
+		std::vector<uint8_t> result(rgba.size());
+		neogfx::hsl_to_rgba(&hue[0], &saturation[0], &lightness[0], count, &result[0]);
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			UNIT_TEST_CHECK(hue[i] >= 0.0f && hue[i] < 360.0f);
+			UNIT_TEST_CHECK(unit_tests::approximately_equal(hue[i], objects[i].hue(), 1.0e-4));
+			UNIT_TEST_CHECK(unit_tests::approximately_equal(saturation[i], objects[i].saturation(), 1.0e-4));
+			UNIT_TEST_CHECK(unit_tests::approximately_equal(lightness[i], objects[i].lightness(), 1.0e-5));
+			for (std::size_t c = 0; c < 3; ++c)
+				UNIT_TEST_CHECK(within_one(result[i * 4 + c], rgba[i * 4 + c]));
+		}
+	}
+
+	void srgb_round_trip()
+	{
+		std::vector<uint8_t> rgba;
+		for (int i = 0; i < 256; ++i)
+		{
+			rgba.push_back(static_cast<uint8_t>(i));
+			rgba.push_back(static_cast<uint8_t>(255 - i));
+			rgba.push_back(static_cast<uint8_t>(i ^ 0x5A));
+			rgba.push_back(static_cast<uint8_t>(i));
+		}
+		auto const count = rgba.size() / 4;
+		std::vector<float> interleaved(rgba.size());
+		neogfx::srgb_to_linear(&rgba[0], count, &interleaved[0]);
+		std::vector<float> red(count), green(count), blue(count), alpha(count);
+		neogfx::srgb_to_linear(&rgba[0], count, &red[0], &green[0], &blue[0], &alpha[0]);
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			UNIT_TEST_CHECK(interleaved[i * 4] == red[i]);
+			UNIT_TEST_CHECK(interleaved[i * 4 + 1] == green[i]);
+			UNIT_TEST_CHECK(interleaved[i * 4 + 2] == blue[i]);
+			UNIT_TEST_CHECK(interleaved[i * 4 + 3] == alpha[i]);
+			UNIT_TEST_CHECK(unit_tests::approximately_equal(alpha[i], i / 255.0, 1.0e-6));
+		}
+		UNIT_TEST_CHECK(red[0] == 0.0f);
+		UNIT_TEST_CHECK(unit_tests::approximately_equal(red[255], 1.0, 1.0e-6));
+		// mid grey is about 21.6% linear
+		UNIT_TEST_CHECK(unit_tests::approximately_equal(red[128], 0.2158605, 1.0e-4));
+		for (std::size_t i = 1; i < count; ++i)
+			UNIT_TEST_CHECK(red[i] > red[i - 1]);
+		std::vector<uint8_t> fromInterleaved(rgba.size());
+		neogfx::linear_to_srgb(&interleaved[0], count, &fromInterleaved[0]);
+		std::vector<uint8_t> fromPlanar(rgba.size());
+		neogfx::linear_to_srgb(&red[0], &green[0], &blue[0], &alpha[0], count, &fromPlanar[0]);
+		UNIT_TEST_CHECK(fromInterleaved == rgba);
+		UNIT_TEST_CHECK(fromPlanar == rgba);
+	}
+
+	void linear_to_srgb_clamps()
+	{
+		const float linear[] = { -0.5f, 1.5f, 0.0f, 2.0f };
+		uint8_t rgba[4];
+		neogfx::linear_to_srgb(linear, 1u, rgba);
+		UNIT_TEST_CHECK(equal(rgba, 0x00, 0xFF, 0x00, 0xFF));
+	}
+
+	unit_tests::register_test s1{ "colour_conversion.hsv_matches_hsv_colour", hsv_matches_hsv_colour };
+	unit_tests::register_test s2{ "colour_conversion.hsl_matches_hsl_colour", hsl_matches_hsl_colour };
+	unit_tests::register_test s3{ "colour_conversion.object_input_matches_planar", object_input_matches_planar };
+	unit_tests::register_test s4{ "colour_conversion.hue_360_is_red", hue_360_is_red };
+	unit_tests::register_test s5{ "colour_conversion.hsv_round_trip", hsv_round_trip };
+	unit_tests::register_test s6{ "colour_conversion.hsl_round_trip", hsl_round_trip };
+	unit_tests::register_test s7{ "colour_conversion.srgb_round_trip", srgb_round_trip };
+	unit_tests::register_test s8{ "colour_conversion.linear_to_srgb_clamps", linear_to_srgb_clamps };
+}
@@ -0,0 +1,158 @@
+#include <neogfx/neogfx.hpp>
+#include <atomic>
+#include <future>
+#include <neogfx/gfx/image_decoder.hpp>
+#include "test.hpp"
+
+namespace
+{
+	neogfx::decoded_image_pointer make_image(const std::string& aUri, std::size_t aBytes)
+	{
+		auto result = std::make_shared<neogfx::decoded_image>();
+		result->uri = aUri;
+		result->extents = neogfx::size{ static_cast<neogfx::dimension>(aBytes / 4u), 1.0 };
+		result->pixels.assign(aBytes, 0xFFu);
+		return result;
+	}
+
+	bool cached(neogfx::decoded_image_cache& aCache, const std::string& aUri)
+	{
+		return aCache.find(aUri) != nullptr;
+	}
+
+	void cache_evicts_least_recently_used()
+	{
+		neogfx::decoded_image_cache cache{ 300u };
+		cache.insert(make_image("a", 100u));
+		cache.insert(make_image("b", 100u));
+		cache.insert(make_image("c", 100u));
+		UNIT_TEST_CHECK(cache.size() == 300u);
+		UNIT_TEST_CHECK(cache.count() == 3u);
+		// touching "a" leaves "b" as the least recently used
+		UNIT_TEST_CHECK(cached(cache, "a"));
+		cache.insert(make_image("d", 100u));
+		UNIT_TEST_CHECK(cache.size() == 300u);
+		UNIT_TEST_CHECK(cache.count() == 3u);
+		UNIT_TEST_CHECK(!cached(cache, "b"));
+		UNIT_TEST_CHECK(cached(cache, "a"));
+		UNIT_TEST_CHECK(cached(cache, "c"));
+		UNIT_TEST_CHECK(cached(cache, "d"));
+		// a larger image can evict more than one entry; the finds above left "a" then "c" least recently used
+		cache.insert(make_image("e", 200u));
+		UNIT_TEST_CHECK(cache.size() == 300u);
+		UNIT_TEST_CHECK(cache.count() == 2u);
+		UNIT_TEST_CHECK(cached(cache, "e"));
+		UNIT_TEST_CHECK(cached(cache, "d"));
+		UNIT_TEST_CHECK(!cached(cache, "a"));
+		UNIT_TEST_CHECK(!cached(cache, "c"));
+	}
+
+	void cache_replaces_entry_for_same_uri()
+	{
+		neogfx::decoded_image_cache cache{ 300u };
+		auto first = make_image("a", 100u);
+		auto second = make_image("a", 150u);
+		cache.insert(first);
+		cache.insert(second);
+		UNIT_TEST_CHECK(cache.count() == 1u);
+		UNIT_TEST_CHECK(cache.size() == 150u);
+		UNIT_TEST_CHECK(cache.find("a") == second);
+	}
+
+	void cache_rejects_oversized_images()
+	{
+		neogfx::decoded_image_cache cache{ 300u };
+		cache.insert(make_image("a", 100u));
+		cache.insert(make_image("huge", 301u));
+		UNIT_TEST_CHECK(!cached(cache, "huge"));
+		UNIT_TEST_CHECK(cached(cache, "a"));
+		UNIT_TEST_CHECK(cache.size() == 100u);
+		// an image exactly the capacity fits, displacing everything else
+		cache.insert(make_image("full", 300u));
+		UNIT_TEST_CHECK(cached(cache, "full"));
+		UNIT_TEST_CHECK(cache.count() == 1u);
+		// an oversized replacement drops the stale entry rather than keeping it
+		cache.insert(make_image("full", 400u));
+		UNIT_TEST_CHECK(!cached(cache, "full"));
+		UNIT_TEST_CHECK(cache.size() == 0u);
+	}
+
+	void cache_shrinks_with_capacity()
+	{
+		neogfx::decoded_image_cache cache{ 400u };
+		cache.insert(make_image("a", 100u));
+		cache.insert(make_image("b", 100u));
+		cache.insert(make_image("c", 100u));
+		cache.insert(make_image("d", 100u));
+		UNIT_TEST_CHECK(cached(cache, "b"));
+		cache.set_capacity(200u);
+		UNIT_TEST_CHECK(cache.capacity() == 200u);
+		UNIT_TEST_CHECK(cache.size() == 200u);
+		UNIT_TEST_CHECK(cached(cache, "b"));
+		UNIT_TEST_CHECK(cached(cache, "d"));
+		UNIT_TEST_CHECK(!cached(cache, "a"));
+		UNIT_TEST_CHECK(!cached(cache, "c"));
+		cache.set_capacity(0u);
+		UNIT_TEST_CHECK(cache.size() == 0u);
+		UNIT_TEST_CHECK(cache.count() == 0u);
+	}
+
+	// a decoder whose decodes are counted and held until released, so that requests can be made while a decode is in flight
+	struct gated_decoder
+	{
+		std::atomic<uint32_t> decodes{ 0u };
+		std::promise<void> gate;
+		std::shared_future<void> opened = gate.get_future().share();
+		neogfx::image_decoder decoder{ 2u, [this](const std::string& aUri)
+		{
+			++decodes;
+			opened.wait();
+			return make_image(aUri, 64u);
+		} };
+	};
+
+	void decoder_merges_duplicate_requests()
+	{
+		gated_decoder d;
+		auto first = d.decoder.decode_async("a");
+		auto second = d.decoder.decode_async("a");
+		auto other = d.decoder.decode_async("b");
+		d.gate.set_value();
+		UNIT_TEST_CHECK(first.get() != nullptr);
+		// one decode serves both requests
+		UNIT_TEST_CHECK(first.get() == second.get());
+		UNIT_TEST_CHECK(other.get() != first.get());
+		UNIT_TEST_CHECK(d.decodes == 2u);
+		// later requests are served from the cache
+		UNIT_TEST_CHECK(d.decoder.decode_async("a").get() == first.get());
+		UNIT_TEST_CHECK(d.decoder.decode_now("b") == other.get());
+		const neogfx::decoded_image* completed = nullptr;
+		d.decoder.decode_async("a", [&completed](const neogfx::decoded_image& aImage) { completed = &aImage; });
+		UNIT_TEST_CHECK(completed == first.get().get());
+		UNIT_TEST_CHECK(d.decodes == 2u);
+	}
+
+	void decoder_does_not_cache_failures()
+	{
+		std::atomic<uint32_t> decodes{ 0u };
+		neogfx::image_decoder decoder{ 1u, [&decodes](const std::string& aUri)
+		{
+			++decodes;
+			auto result = std::make_shared<neogfx::decoded_image>();
+			result->uri = aUri;
+			result->error = "bad image";
+			return neogfx::decoded_image_pointer{ result };
+		} };
+		UNIT_TEST_CHECK(decoder.decode_now("bad")->error == "bad image");
+		UNIT_TEST_CHECK(decoder.decode_async("bad").get()->error == "bad image");
+		UNIT_TEST_CHECK(decodes == 2u);
+		UNIT_TEST_CHECK(decoder.cache().count() == 0u);
+	}
+
+	unit_tests::register_test s1{ "image_decoder.cache_evicts_least_recently_used", cache_evicts_least_recently_used };
+	unit_tests::register_test s2{ "image_decoder.cache_replaces_entry_for_same_uri", cache_replaces_entry_for_same_uri };
+	unit_tests::register_test s3{ "image_decoder.cache_rejects_oversized_images", cache_rejects_oversized_images };
+	unit_tests::register_test s4{ "image_decoder.cache_shrinks_with_capacity", cache_shrinks_with_capacity };
+	unit_tests::register_test s5{ "image_decoder.decoder_merges_duplicate_requests", decoder_merges_duplicate_requests };
+	unit_tests::register_test s6{ "image_decoder.decoder_does_not_cache_failures", decoder_does_not_cache_failures };
+}
@@ -0,0 +1,40 @@
+#include <neolib/neolib.hpp>
+#include <iostream>
+#include <string>
+#include "test.hpp"
+
+// Runs every registered test or only those named on the command line; the exit code is the number of failures.
+int main(int argc, char* argv[])
+{
+	int ran = 0;
+	int failed = 0;
+	for (auto const& t : unit_tests::registry())
+	{
+		bool selected = (argc < 2);
+		for (int i = 1; !selected && i < argc; ++i)
+			selected = (t.name == argv[i]);
+		if (!selected)
+			continue;
+		++ran;
+		try
+		{
+			t.function();
+			std::cout << "passed: " << t.name << std::endl;
+		}
+		catch (const std::exception& e)
+		{
+			++failed;
+			std::cout << "FAILED: " << t.name << ": " << e.what() << std::endl;
+		}
+	}
+	if (ran == 0)
+	{
+		std::cerr << "no tests selected; available:";
+		for (auto const& t : unit_tests::registry())
+			std::cerr << " " << t.name;
+		std::cerr << std::endl;
+		return 1;
+	}
+	std::cout << (ran - failed) << " of " << ran << " tests passed" << std::endl;
+	return failed;
+}
@@ -0,0 +1,96 @@
+#include <neogfx/neogfx.hpp>
+#include <boost/filesystem.hpp>
+#include "../../../src/gfx/native/opengl_renderer.hpp"
+#include "test.hpp"
+
+namespace
+{
+	using namespace neogfx;
+	typedef opengl_renderer::shader_program shader_program;
+
+	const opengl_renderer::shaders kShaders = 
+	{
+		{ "#version 130\nvoid main() {}\n", GL_VERTEX_SHADER },
+		{ "#version 130\nuniform sampler2D tex;\nvoid main() {}\n", GL_FRAGMENT_SHADER }
+	};
+	const std::vector<std::string> kVariables = { "VertexPosition", "VertexColor", "VertexTextureCoord" };
+	const std::string kDriver = "vendor|renderer|4.5";
+
+	void cache_key_is_stable_hex()
+	{
+		auto const key = opengl_renderer::program_cache_key(kDriver, kShaders, kVariables);
+		UNIT_TEST_CHECK(key.size() == 16u);
+		UNIT_TEST_CHECK(key.find_first_not_of("0123456789abcdef") == std::string::npos);
+		UNIT_TEST_CHECK(key == opengl_renderer::program_cache_key(kDriver, kShaders, kVariables));
+	}
+
+	void cache_key_covers_every_input()
+	{
+		auto const key = opengl_renderer::program_cache_key(kDriver, kShaders, kVariables);
+		UNIT_TEST_CHECK(key != opengl_renderer::program_cache_key("vendor|renderer|4.6", kShaders, kVariables));
+		auto source = kShaders;
+		source[1].first += " ";
+		UNIT_TEST_CHECK(key != opengl_renderer::program_cache_key(kDriver, source, kVariables));
+		auto stage = kShaders;
+		stage[0].second = GL_GEOMETRY_SHADER;
+		UNIT_TEST_CHECK(key != opengl_renderer::program_cache_key(kDriver, stage, kVariables));
+		auto order = kVariables;
+		std::swap(order[0], order[1]);
+		UNIT_TEST_CHECK(key != opengl_renderer::program_cache_key(kDriver, kShaders, order));
+		UNIT_TEST_CHECK(key != opengl_renderer::program_cache_key(kDriver, kShaders, std::vector<std::string>{}));
+	}
+
+	void cache_key_separates_fields()
+	{
+		UNIT_TEST_CHECK(opengl_renderer::program_cache_key(kDriver, kShaders, { "ab", "c" }) != opengl_renderer::program_cache_key(kDriver, kShaders, { "a", "bc" }));
+		UNIT_TEST_CHECK(opengl_renderer::program_cache_key("ab", kShaders, kVariables) != opengl_renderer::program_cache_key("a", opengl_renderer::shaders{ { "b" + kShaders[0].first, kShaders[0].second }, kShaders[1] }, kVariables));
+	}
+
+	void active_uniform_names()
+	{
+		UNIT_TEST_CHECK(shader_program::uniform_name("tex") == "tex");
+		UNIT_TEST_CHECK(shader_program::uniform_name("stops[0]") == "stops");
+		UNIT_TEST_CHECK(shader_program::uniform_name("stops[1]") == "stops[1]");
+		UNIT_TEST_CHECK(shader_program::uniform_name("light[0].colour") == "light[0].colour");
+		UNIT_TEST_CHECK(shader_program::uniform_name("[0]") == "[0]");
+	}
+
+	void standard_uniforms_resolved_from_active_uniforms()
+	{
+		shader_program::uniform_map active;
+		active[shader_program::standard_uniform_name(shader_uniform::PosViewportTop)] = 3;
+		active[shader_program::standard_uniform_name(shader_uniform::Texture)] = 7;
+		active["uProjectionMatrix"] = 0;
+		active["unrelated"] = 9;
+		shader_program::standard_uniform_list standard;
+		standard.fill(42);
+		shader_program::resolve_standard_uniforms(active, standard);
+		UNIT_TEST_CHECK(standard[static_cast<std::size_t>(shader_uniform::PosViewportTop)] == 3);
+		UNIT_TEST_CHECK(standard[static_cast<std::size_t>(shader_uniform::Texture)] == 7);
+		for (std::size_t u = 0; u < standard.size(); ++u)
+			if (u != static_cast<std::size_t>(shader_uniform::PosViewportTop) && u != static_cast<std::size_t>(shader_uniform::Texture))
+				UNIT_TEST_CHECK(standard[u] == -1);
+		UNIT_TEST_CHECK(std::string{ shader_program::standard_uniform_name(shader_uniform::Texture) } == "tex");
+		UNIT_TEST_CHECK(std::string{ shader_program::standard_uniform_name(shader_uniform::GlyphTexture) } == "glyphTexture");
+	}
+
+	void program_binaries_kept_per_user()
+	{
+		auto const directory = opengl_renderer::program_binary_directory();
+		if (directory.empty())
+			return;
+		UNIT_TEST_CHECK(directory.is_absolute());
+		UNIT_TEST_CHECK(directory.filename() == "shader_cache");
+		boost::system::error_code ec;
+		auto const temp = boost::filesystem::temp_directory_path(ec);
+		if (!ec)
+			UNIT_TEST_CHECK(directory.parent_path().parent_path() != temp);
+	}
+
+	unit_tests::register_test s1{ "opengl_renderer.cache_key_is_stable_hex", cache_key_is_stable_hex };
+	unit_tests::register_test s2{ "opengl_renderer.cache_key_covers_every_input", cache_key_covers_every_input };
+	unit_tests::register_test s3{ "opengl_renderer.cache_key_separates_fields", cache_key_separates_fields };
+	unit_tests::register_test s4{ "opengl_renderer.active_uniform_names", active_uniform_names };
+	unit_tests::register_test s5{ "opengl_renderer.standard_uniforms_resolved_from_active_uniforms", standard_uniforms_resolved_from_active_uniforms };
+	unit_tests::register_test s6{ "opengl_renderer.program_binaries_kept_per_user", program_binaries_kept_per_user };
+}
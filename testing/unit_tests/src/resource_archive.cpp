@@ -0,0 +1,136 @@
+#include <neogfx/neogfx.hpp>
+#include <algorithm>
+#include <neogfx/app/resource_archive.hpp>
+#include "test.hpp"
+
+namespace
+{
+	using namespace neogfx;
+
+	// a.txt, b.txt and c.txt hold 100 of their letter and big.bin 1000 zero bytes, all deflated
+	const uint8_t kArchive[] =
+	{
+		0x50, 0x4B, 0x03, 0x04, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0xED, 0x06, 0x53, 0x5D, 0x64, 0x7A,
+		0x70, 0xAF, 0x06, 0x00, 0x00, 0x00, 0x64, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x61, 0x2E,
+		0x74, 0x78, 0x74, 0x4B, 0x4C, 0xA4, 0x3D, 0x00, 0x00, 0x50, 0x4B, 0x03, 0x04, 0x14, 0x00, 0x00,
+		0x00, 0x08, 0x00, 0xED, 0x06, 0x53, 0x5D, 0xDB, 0x62, 0x01, 0x25, 0x06, 0x00, 0x00, 0x00, 0x64,
+		0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x62, 0x2E, 0x74, 0x78, 0x74, 0x4B, 0x4A, 0xA2, 0x3D,
+		0x00, 0x00, 0x50, 0x4B, 0x03, 0x04, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0xED, 0x06, 0x53, 0x5D,
+		0x4E, 0x95, 0xD1, 0x5C, 0x06, 0x00, 0x00, 0x00, 0x64, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00,
+		0x63, 0x2E, 0x74, 0x78, 0x74, 0x4B, 0x4E, 0xA6, 0x3D, 0x00, 0x00, 0x50, 0x4B, 0x03, 0x04, 0x14,
+		0x00, 0x00, 0x00, 0x08, 0x00, 0xED, 0x06, 0x53, 0x5D, 0x80, 0x17, 0x0B, 0x06, 0x0B, 0x00, 0x00,
+		0x00, 0xE8, 0x03, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x62, 0x69, 0x67, 0x2E, 0x62, 0x69, 0x6E,
+		0x63, 0x60, 0x18, 0x05, 0xA3, 0x60, 0x14, 0x0C, 0x77, 0x00, 0x00, 0x50, 0x4B, 0x01, 0x02, 0x14,
+		0x03, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0xED, 0x06, 0x53, 0x5D, 0x64, 0x7A, 0x70, 0xAF, 0x06,
+		0x00, 0x00, 0x00, 0x64, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x80, 0x01, 0x00, 0x00, 0x00, 0x00, 0x61, 0x2E, 0x74, 0x78, 0x74, 0x50, 0x4B,
+		0x01, 0x02, 0x14, 0x03, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0xED, 0x06, 0x53, 0x5D, 0xDB, 0x62,
+		0x01, 0x25, 0x06, 0x00, 0x00, 0x00, 0x64, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x29, 0x00, 0x00, 0x00, 0x62, 0x2E, 0x74, 0x78,
+		0x74, 0x50, 0x4B, 0x01, 0x02, 0x14, 0x03, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0xED, 0x06, 0x53,
+		0x5D, 0x4E, 0x95, 0xD1, 0x5C, 0x06, 0x00, 0x00, 0x00, 0x64, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x52, 0x00, 0x00, 0x00, 0x63,
+		0x2E, 0x74, 0x78, 0x74, 0x50, 0x4B, 0x01, 0x02, 0x14, 0x03, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00,
+		0xED, 0x06, 0x53, 0x5D, 0x80, 0x17, 0x0B, 0x06, 0x0B, 0x00, 0x00, 0x00, 0xE8, 0x03, 0x00, 0x00,
+		0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x7B, 0x00,
+		0x00, 0x00, 0x62, 0x69, 0x67, 0x2E, 0x62, 0x69, 0x6E, 0x50, 0x4B, 0x05, 0x06, 0x00, 0x00, 0x00,
+		0x00, 0x04, 0x00, 0x04, 0x00, 0xCE, 0x00, 0x00, 0x00, 0xAB, 0x00, 0x00, 0x00, 0x00, 0x00,
+	};
+
+	// an archive held in memory rather than loaded through the resource manager
+	class memory_resource : public i_resource
+	{
+	public:
+		memory_resource(const void* aData, std::size_t aSize) :
+			iUri{ "memory:archive.zip" }, iData{ static_cast<const uint8_t*>(aData), static_cast<const uint8_t*>(aData) + aSize }
+		{
+		}
+	public:
+		bool available() const override { return true; }
+		std::pair<bool, double> downloading() const override { return std::make_pair(false, 100.0); }
+		bool error() const override { return false; }
+		const std::string& error_string() const override { static const std::string sNoError; return sNoError; }
+	public:
+		const std::string& uri() const override { return iUri; }
+		const void* cdata() const override { return &iData[0]; }
+		const void* data() const override { return &iData[0]; }
+		void* data() override { return &iData[0]; }
+		std::size_t size() const override { return iData.size(); }
+		hash_digest_type hash() const override { return hash_digest_type{}; }
+	private:
+		std::string iUri;
+		data_type iData;
+	};
+
+	i_resource::pointer make_archive()
+	{
+		return std::make_shared<memory_resource>(kArchive, sizeof(kArchive));
+	}
+
+	bool holds(const resource_archive::payload_pointer& aPayload, uint8_t aValue, std::size_t aSize)
+	{
+		return aPayload != nullptr && aPayload->size() == aSize && std::all_of(aPayload->begin(), aPayload->end(), [aValue](uint8_t aByte) { return aByte == aValue; });
+	}
+
+	void indexes_entries()
+	{
+		resource_archive archive{ make_archive() };
+		UNIT_TEST_CHECK(archive.entry_count() == 4u);
+		UNIT_TEST_CHECK(archive.contains("a.txt"));
+		UNIT_TEST_CHECK(archive.contains("b.txt"));
+		UNIT_TEST_CHECK(archive.contains("c.txt"));
+		UNIT_TEST_CHECK(archive.contains("big.bin"));
+		UNIT_TEST_CHECK(!archive.contains("d.txt"));
+		UNIT_TEST_CHECK(!archive.contains("A.TXT"));
+		// indexing does not decompress anything
+		UNIT_TEST_CHECK(archive.payload_cache_size() == 0u);
+	}
+
+	void extracts_entries()
+	{
+		resource_archive archive{ make_archive() };
+		UNIT_TEST_CHECK(holds(archive.extract("a.txt"), 'a', 100u));
+		UNIT_TEST_CHECK(holds(archive.extract("b.txt"), 'b', 100u));
+		UNIT_TEST_CHECK(holds(archive.extract("c.txt"), 'c', 100u));
+		UNIT_TEST_CHECK(holds(archive.extract("big.bin"), 0u, 1000u));
+		UNIT_TEST_CHECK(archive.extract("d.txt") == nullptr);
+	}
+
+	void caches_recently_used_payloads()
+	{
+		resource_archive archive{ make_archive(), 250u };
+		auto a = archive.extract("a.txt");
+		auto b = archive.extract("b.txt");
+		UNIT_TEST_CHECK(archive.payload_cache_size() == 200u);
+		// a cached payload is shared rather than extracted again
+		UNIT_TEST_CHECK(archive.extract("a.txt") == a);
+		// "b" is now the least recently used so makes way for "c"
+		auto c = archive.extract("c.txt");
+		UNIT_TEST_CHECK(archive.payload_cache_size() == 200u);
+		UNIT_TEST_CHECK(archive.extract("c.txt") == c);
+		UNIT_TEST_CHECK(archive.extract("a.txt") == a);
+		auto b2 = archive.extract("b.txt");
+		UNIT_TEST_CHECK(b2 != b);
+		UNIT_TEST_CHECK(holds(b2, 'b', 100u));
+		// "c" was used before "a" so it is the one evicted this time
+		UNIT_TEST_CHECK(archive.payload_cache_size() == 200u);
+		UNIT_TEST_CHECK(archive.extract("a.txt") == a);
+		UNIT_TEST_CHECK(archive.extract("c.txt") != c);
+	}
+
+	void does_not_cache_oversized_payloads()
+	{
+		resource_archive archive{ make_archive(), 250u };
+		auto a = archive.extract("a.txt");
+		auto big = archive.extract("big.bin");
+		UNIT_TEST_CHECK(holds(big, 0u, 1000u));
+		UNIT_TEST_CHECK(archive.payload_cache_size() == 100u);
+		UNIT_TEST_CHECK(archive.extract("big.bin") != big);
+		UNIT_TEST_CHECK(archive.extract("a.txt") == a);
+	}
+
+	unit_tests::register_test s1{ "resource_archive.indexes_entries", indexes_entries };
+	unit_tests::register_test s2{ "resource_archive.extracts_entries", extracts_entries };
+	unit_tests::register_test s3{ "resource_archive.caches_recently_used_payloads", caches_recently_used_payloads };
+	unit_tests::register_test s4{ "resource_archive.does_not_cache_oversized_payloads", does_not_cache_oversized_payloads };
+}
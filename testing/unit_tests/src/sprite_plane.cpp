@@ -0,0 +1,94 @@
+#include <neogfx/neogfx.hpp>
+#include <vector>
+#include <neogfx/game/sprite_plane.hpp>
+#include "test.hpp"
+
+namespace
+{
+	using namespace neogfx;
+
+	const uint64_t kSteps = 200u;
+
+	// a headless plane of mutually attracting bodies; inputs nudge the velocity of one of them
+	struct scenario
+	{
+		sprite_plane plane{ sprite_plane::ManualSimulation };
+		scenario()
+		{
+			plane.set_uniform_gravity();
+			for (uint32_t i = 0; i < 16; ++i)
+			{
+				auto& body = plane.create_physical_object();
+				body.set_position(vec3{ i * 10.0, 100.0 + (i % 4) * 25.0, 0.0 });
+				body.set_velocity(vec3{ (i % 3) - 1.0, 0.0, 0.0 });
+				body.set_mass(1.0e9 * (i + 1));
+			}
+			~~~~plane.input_applied([this](const sprite_plane::simulation_input& aInput)
+			{
+				auto& body = plane.objects()[aInput.code % plane.objects().size()]->as_physical_object();
+				body.set_velocity(body.velocity() + aInput.value);
+			});
+		}
+	};
+
+	// runs a recorded session, returning the state hash after every step
+	std::vector<uint64_t> record(scenario& aScenario)
+	{
+		std::vector<uint64_t> hashes;
+		aScenario.plane.start_recording();
+		for (uint64_t step = 0; step < kSteps; ++step)
+		{
+			if (step % 7 == 3)
+				aScenario.plane.post_input(static_cast<uint32_t>(step), vec3{ 1.0, step * 0.01, 0.0 });
+			aScenario.plane.step();
+			hashes.push_back(aScenario.plane.state_hash());
+		}
+		aScenario.plane.stop_recording();
+		return hashes;
+	}
+
+	void replay_matches_recording()
+	{
+		scenario recorded;
+		auto const hashes = record(recorded);
+		UNIT_TEST_CHECK(recorded.plane.step_count() == kSteps);
+		UNIT_TEST_CHECK(recorded.plane.recorded_inputs().size() == (kSteps - 3 + 6) / 7);
+		scenario replayed;
+		replayed.plane.replay(recorded.plane.recorded_inputs());
+		for (uint64_t step = 0; step < kSteps; ++step)
+		{
+			// live input is ignored while replaying
+			if (replayed.plane.replaying())
+				replayed.plane.post_input(0u, vec3{ 100.0, 100.0, 0.0 });
+			replayed.plane.step();
+			UNIT_TEST_CHECK(replayed.plane.state_hash() == hashes[step]);
+		}
+		UNIT_TEST_CHECK(!replayed.plane.replaying());
+	}
+
+	void identical_runs_hash_equal()
+	{
+		scenario first;
+		scenario second;
+		for (uint64_t step = 0; step < kSteps; ++step)
+		{
+			first.plane.step();
+			second.plane.step();
+			UNIT_TEST_CHECK(first.plane.state_hash() == second.plane.state_hash());
+		}
+	}
+
+	void inputs_change_the_hash()
+	{
+		scenario recorded;
+		auto const hashes = record(recorded);
+		scenario unperturbed;
+		unperturbed.plane.step(kSteps);
+		UNIT_TEST_CHECK(unperturbed.plane.step_count() == kSteps);
+		UNIT_TEST_CHECK(unperturbed.plane.state_hash() != hashes.back());
+	}
+
+	unit_tests::register_test s1{ "sprite_plane.replay_matches_recording", replay_matches_recording };
+	unit_tests::register_test s2{ "sprite_plane.identical_runs_hash_equal", identical_runs_hash_equal };
+	unit_tests::register_test s3{ "sprite_plane.inputs_change_the_hash", inputs_change_the_hash };
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <neogfx/neogfx.hpp>
+#include <string>
+#include <vector>
+#include <functional>
+#include <stdexcept>
+#include <sstream>
+#include <cmath>
+#include <algorithm>
+
+namespace unit_tests
+{
+	typedef std::function<void()> test_function;
+
+	struct test
+	{
+		std::string name;
+		test_function function;
+	};
+
+	struct check_failed : std::runtime_error { check_failed(const std::string& aWhat) : std::runtime_error(aWhat) {} };
+
+	inline std::vector<test>& registry()
+	{
+		static std::vector<test> sTests;
+		return sTests;
+	}
+
+	struct register_test
+	{
+		register_test(const std::string& aName, test_function aFunction)
+		{
+			registry().push_back(test{ aName, aFunction });
+		}
+	};
+
+	inline bool approximately_equal(double aLhs, double aRhs, double aTolerance = 1.0e-9)
+	{
+		return std::abs(aLhs - aRhs) <= aTolerance * std::max(1.0, std::max(std::abs(aLhs), std::abs(aRhs)));
+	}
+
+	inline void check(bool aCondition, const char* aExpression, const char* aFile, int aLine)
+	{
+		if (aCondition)
+			return;
+		std::ostringstream what;
+		what << aFile << "(" << aLine << "): check failed: " << aExpression;
+		throw check_failed(what.str());
+	}
+}
+
+#define UNIT_TEST_CHECK(condition) unit_tests::check((condition), #condition, __FILE__, __LINE__)
@@ -0,0 +1,180 @@
+#include <neogfx/neogfx.hpp>
+#include <memory>
+#include <neogfx/gfx/texture_manager.hpp>
+#include "../../../src/gfx/native/i_native_texture.hpp"
+#include "test.hpp"
+
+namespace
+{
+	// a native texture that needs no rendering context; it records its own destruction
+	class fake_texture : public neogfx::i_native_texture
+	{
+	public:
+		fake_texture(std::uintptr_t aHandle, const std::string& aUri = std::string{}, std::shared_ptr<int> aDestroyed = std::shared_ptr<int>{}, 
+			const neogfx::size& aExtents = neogfx::size{ 16.0, 16.0 }, neogfx::texture_sampling aSampling = neogfx::texture_sampling::Normal) :
+			iHandle{ aHandle }, iUri{ aUri }, iDestroyed{ aDestroyed }, iExtents{ aExtents }, iSampling{ aSampling }
+		{
+		}
+		~fake_texture()
+		{
+			if (iDestroyed != nullptr)
+				++*iDestroyed;
+		}
+	public:
+		neogfx::dimension dpi_scale_factor() const override { return 1.0; }
+		neogfx::texture_sampling sampling() const override { return iSampling; }
+		neogfx::size extents() const override { return iExtents; }
+		neogfx::size storage_extents() const override { return extents(); }
+		void set_pixels(const neogfx::rect&, const void*) override {}
+	public:
+		void* handle() const override { return reinterpret_cast<void*>(iHandle); }
+		bool is_resident() const override { return true; }
+		const std::string& uri() const override { return iUri; }
+	private:
+		std::uintptr_t iHandle;
+		std::string iUri;
+		std::shared_ptr<int> iDestroyed;
+		neogfx::size iExtents;
+		neogfx::texture_sampling iSampling;
+	};
+
+	// exposes the GL-independent index of texture_manager
+	class test_texture_manager : public neogfx::texture_manager
+	{
+	public:
+		using texture_manager::texture_key;
+		using texture_manager::textures;
+		using texture_manager::find_texture;
+		using texture_manager::add_texture;
+	public:
+		std::unique_ptr<neogfx::i_native_texture> create_texture(const neogfx::size&, neogfx::dimension, neogfx::texture_sampling, const neogfx::optional_colour&) override
+		{
+			throw std::logic_error("test_texture_manager::create_texture");
+		}
+		std::unique_ptr<neogfx::i_native_texture> create_texture(const neogfx::i_image&) override
+		{
+			throw std::logic_error("test_texture_manager::create_texture");
+		}
+	};
+
+	bool joinable(test_texture_manager& aManager, std::uintptr_t aHandle)
+	{
+		try
+		{
+			aManager.join_texture(fake_texture{ aHandle });
+			return true;
+		}
+		catch (const neogfx::i_texture_manager::texture_not_found&)
+		{
+			return false;
+		}
+	}
+
+	void purged_when_last_reference_goes()
+	{
+		test_texture_manager manager;
+		auto destroyed = std::make_shared<int>(0);
+		const test_texture_manager::texture_key key{ "file:///a.png" };
+		auto texture = manager.add_texture(std::make_shared<fake_texture>(1u, key.uri, destroyed), key);
+		UNIT_TEST_CHECK(manager.textures().size() == 1u);
+		auto found = manager.find_texture(key);
+		UNIT_TEST_CHECK(found != nullptr && found->handle() == texture->handle());
+		auto joined = manager.join_texture(*texture);
+		UNIT_TEST_CHECK(joined->handle() == texture->handle());
+		texture.reset();
+		found.reset();
+		// the joined wrapper still holds a reference
+		UNIT_TEST_CHECK(manager.textures().size() == 1u);
+		UNIT_TEST_CHECK(joinable(manager, 1u));
+		joined.reset();
+		UNIT_TEST_CHECK(*destroyed == 1);
+		UNIT_TEST_CHECK(manager.textures().empty());
+		UNIT_TEST_CHECK(manager.find_texture(key) == nullptr);
+		UNIT_TEST_CHECK(!joinable(manager, 1u));
+	}
+
+	void purged_by_content_hash()
+	{
+		test_texture_manager manager;
+		const test_texture_manager::texture_key key{ std::string{}, neogfx::i_resource::hash_digest_type{ 1u, 2u, 3u } };
+		auto texture = manager.add_texture(std::make_shared<fake_texture>(2u), key);
+		UNIT_TEST_CHECK(manager.find_texture(key) != nullptr);
+		UNIT_TEST_CHECK(manager.find_texture(test_texture_manager::texture_key{ std::string{}, neogfx::i_resource::hash_digest_type{ 1u, 2u, 4u } }) == nullptr);
+		texture.reset();
+		UNIT_TEST_CHECK(manager.textures().empty());
+		UNIT_TEST_CHECK(manager.find_texture(key) == nullptr);
+	}
+
+	void purge_keeps_newer_entry_for_same_key()
+	{
+		test_texture_manager manager;
+		const test_texture_manager::texture_key key{ "file:///b.png" };
+		auto older = manager.add_texture(std::make_shared<fake_texture>(3u, key.uri), key);
+		auto newer = manager.add_texture(std::make_shared<fake_texture>(4u, key.uri), key);
+		older.reset();
+		UNIT_TEST_CHECK(manager.textures().size() == 1u);
+		auto found = manager.find_texture(key);
+		UNIT_TEST_CHECK(found != nullptr && found->handle() == newer->handle());
+		UNIT_TEST_CHECK(!joinable(manager, 3u));
+		UNIT_TEST_CHECK(joinable(manager, 4u));
+	}
+
+	void texture_outliving_manager()
+	{
+		auto destroyed = std::make_shared<int>(0);
+		auto manager = std::make_unique<test_texture_manager>();
+		auto texture = manager->add_texture(std::make_shared<fake_texture>(5u, std::string{}, destroyed));
+		manager.reset();
+		UNIT_TEST_CHECK(*destroyed == 0);
+		texture.reset();
+		UNIT_TEST_CHECK(*destroyed == 1);
+	}
+
+	void memory_usage_natural_size()
+	{
+		// RGBA8: four bytes per texel
+		UNIT_TEST_CHECK(neogfx::texture_manager::texture_memory_usage(neogfx::size{ 64.0, 32.0 }, neogfx::texture_sampling::Normal) == 64u * 32u * 4u);
+		UNIT_TEST_CHECK(neogfx::texture_manager::texture_memory_usage(neogfx::size{ 100.0, 30.0 }, neogfx::texture_sampling::Normal) == 100u * 30u * 4u);
+		UNIT_TEST_CHECK(neogfx::texture_manager::texture_memory_usage(neogfx::size{ 1.0, 1.0 }, neogfx::texture_sampling::Normal) == 4u);
+		UNIT_TEST_CHECK(neogfx::texture_manager::texture_memory_usage(neogfx::size{}, neogfx::texture_sampling::Normal) == 0u);
+	}
+
+	void memory_usage_mipmapped()
+	{
+		// a full mipmap chain adds a third again
+		const std::size_t base = 256u * 256u * 4u;
+		UNIT_TEST_CHECK(neogfx::texture_manager::texture_memory_usage(neogfx::size{ 256.0, 256.0 }, neogfx::texture_sampling::NormalMipmap) == base + base / 3u);
+		UNIT_TEST_CHECK(neogfx::texture_manager::texture_memory_usage(neogfx::size{ 256.0, 256.0 }, neogfx::texture_sampling::NormalMipmap) >
+			neogfx::texture_manager::texture_memory_usage(neogfx::size{ 256.0, 256.0 }, neogfx::texture_sampling::Normal));
+	}
+
+	void memory_usage_multisample()
+	{
+		// four samples per texel
+		UNIT_TEST_CHECK(neogfx::texture_manager::texture_memory_usage(neogfx::size{ 64.0, 32.0 }, neogfx::texture_sampling::Multisample) == 64u * 32u * 4u * 4u);
+	}
+
+	void memory_usage_of_live_textures()
+	{
+		test_texture_manager manager;
+		UNIT_TEST_CHECK(manager.texture_memory_usage() == 0u);
+		auto normal = manager.add_texture(std::make_shared<fake_texture>(6u, std::string{}, std::shared_ptr<int>{}, neogfx::size{ 64.0, 32.0 }, neogfx::texture_sampling::Normal));
+		auto mipmapped = manager.add_texture(std::make_shared<fake_texture>(7u, std::string{}, std::shared_ptr<int>{}, neogfx::size{ 256.0, 256.0 }, neogfx::texture_sampling::NormalMipmap));
+		auto multisample = manager.add_texture(std::make_shared<fake_texture>(8u, std::string{}, std::shared_ptr<int>{}, neogfx::size{ 64.0, 32.0 }, neogfx::texture_sampling::Multisample));
+		UNIT_TEST_CHECK(manager.texture_memory_usage() == 64u * 32u * 4u + (256u * 256u * 4u) * 4u / 3u + 64u * 32u * 4u * 4u);
+		mipmapped.reset();
+		UNIT_TEST_CHECK(manager.texture_memory_usage() == 64u * 32u * 4u + 64u * 32u * 4u * 4u);
+		normal.reset();
+		multisample.reset();
+		UNIT_TEST_CHECK(manager.texture_memory_usage() == 0u);
+	}
+
+	unit_tests::register_test s1{ "texture_manager.purged_when_last_reference_goes", purged_when_last_reference_goes };
+	unit_tests::register_test s2{ "texture_manager.purged_by_content_hash", purged_by_content_hash };
+	unit_tests::register_test s3{ "texture_manager.purge_keeps_newer_entry_for_same_key", purge_keeps_newer_entry_for_same_key };
+	unit_tests::register_test s4{ "texture_manager.texture_outliving_manager", texture_outliving_manager };
+	unit_tests::register_test s5{ "texture_manager.memory_usage_natural_size", memory_usage_natural_size };
+	unit_tests::register_test s6{ "texture_manager.memory_usage_mipmapped", memory_usage_mipmapped };
+	unit_tests::register_test s7{ "texture_manager.memory_usage_multisample", memory_usage_multisample };
+	unit_tests::register_test s8{ "texture_manager.memory_usage_of_live_textures", memory_usage_of_live_textures };
+}
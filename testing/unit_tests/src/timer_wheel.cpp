@@ -0,0 +1,135 @@
+#include <neogfx/neogfx.hpp>
+#include <memory>
+#include <vector>
+#include <neogfx/app/timer_wheel.hpp>
+#include "test.hpp"
+
+namespace
+{
+	// a virtual clock: time only moves when a test moves it
+	struct virtual_clock
+	{
+		neogfx::timer_wheel::time_point now = 1000u;
+		neogfx::timer_wheel::clock clock() { return [this]() { return now; }; }
+	};
+
+	// advances the clock one millisecond at a time, giving the wheel a chance to expire timers at every tick
+	void run_until(virtual_clock& aClock, neogfx::timer_wheel& aWheel, neogfx::timer_wheel::time_point aUntil)
+	{
+		while (aClock.now < aUntil)
+		{
+			++aClock.now;
+			aWheel.advance();
+		}
+	}
+
+	void fires_at_deadline()
+	{
+		virtual_clock c;
+		neogfx::timer_wheel wheel{ c.clock() };
+		std::vector<neogfx::timer_wheel::time_point> fired;
+		neogfx::wheel_timer t{ wheel, [&](neogfx::wheel_timer&) { fired.push_back(c.now); }, 10u };
+		UNIT_TEST_CHECK(t.waiting());
+		UNIT_TEST_CHECK(wheel.count() == 1u);
+		UNIT_TEST_CHECK(t.deadline() == 1010u);
+		run_until(c, wheel, 1009u);
+		UNIT_TEST_CHECK(fired.empty());
+		run_until(c, wheel, 1100u);
+		UNIT_TEST_CHECK(fired.size() == 1u && fired[0] == 1010u);
+		UNIT_TEST_CHECK(!t.waiting());
+		UNIT_TEST_CHECK(wheel.empty());
+	}
+
+	void cascades_from_upper_levels()
+	{
+		virtual_clock c;
+		neogfx::timer_wheel wheel{ c.clock() };
+		// one deadline for each level, each crossing at least one cascade boundary on the way down
+		const uint32_t durations[] = { 63u, 100u, 5000u, 300000u };
+		std::vector<neogfx::timer_wheel::time_point> fired(4u);
+		std::vector<std::unique_ptr<neogfx::wheel_timer>> timers;
+		for (std::size_t i = 0; i < 4u; ++i)
+			timers.push_back(std::make_unique<neogfx::wheel_timer>(wheel, [&fired, &c, i](neogfx::wheel_timer&) { fired[i] = c.now; }, durations[i]));
+		UNIT_TEST_CHECK(wheel.count() == 4u);
+		run_until(c, wheel, 1000u + 300000u + 10u);
+		for (std::size_t i = 0; i < 4u; ++i)
+			UNIT_TEST_CHECK(fired[i] == 1000u + durations[i]);
+		UNIT_TEST_CHECK(wheel.empty());
+	}
+
+	void cascades_when_advancing_in_one_jump()
+	{
+		virtual_clock c;
+		neogfx::timer_wheel wheel{ c.clock() };
+		neogfx::timer_wheel::time_point fired = 0u;
+		neogfx::wheel_timer t{ wheel, [&](neogfx::wheel_timer&) { fired = wheel.now(); }, 5000u };
+		c.now += 4999u;
+		wheel.advance();
+		UNIT_TEST_CHECK(fired == 0u);
+		UNIT_TEST_CHECK(wheel.next_deadline() != boost::none && *wheel.next_deadline() == 6000u);
+		c.now += 1u;
+		UNIT_TEST_CHECK(wheel.advance());
+		UNIT_TEST_CHECK(fired == 6000u);
+	}
+
+	void rearms_in_callback()
+	{
+		virtual_clock c;
+		neogfx::timer_wheel wheel{ c.clock() };
+		std::vector<neogfx::timer_wheel::time_point> fired;
+		neogfx::wheel_timer t{ wheel, [&](neogfx::wheel_timer& aTimer) { fired.push_back(c.now); if (fired.size() < 5u) aTimer.again(); }, 70u };
+		run_until(c, wheel, 2000u);
+		UNIT_TEST_CHECK(fired.size() == 5u);
+		for (std::size_t i = 0; i < fired.size(); ++i)
+			UNIT_TEST_CHECK(fired[i] == 1000u + 70u * (i + 1u));
+		UNIT_TEST_CHECK(wheel.empty());
+	}
+
+	void destroys_itself_in_callback()
+	{
+		virtual_clock c;
+		neogfx::timer_wheel wheel{ c.clock() };
+		std::unique_ptr<neogfx::wheel_timer> first;
+		std::unique_ptr<neogfx::wheel_timer> second;
+		int firstFired = 0;
+		int secondFired = 0;
+		// both are due in the same slot so whichever is expired first destroys its own node mid-list
+		first = std::make_unique<neogfx::wheel_timer>(wheel, [&](neogfx::wheel_timer&) { ++firstFired; first.reset(); }, 20u);
+		second = std::make_unique<neogfx::wheel_timer>(wheel, [&](neogfx::wheel_timer&) { ++secondFired; second.reset(); }, 20u);
+		run_until(c, wheel, 1100u);
+		UNIT_TEST_CHECK(firstFired == 1 && secondFired == 1);
+		UNIT_TEST_CHECK(first == nullptr && second == nullptr);
+		UNIT_TEST_CHECK(wheel.empty());
+	}
+
+	void cancels_sibling_in_callback()
+	{
+		virtual_clock c;
+		neogfx::timer_wheel wheel{ c.clock() };
+		int fired = 0;
+		std::unique_ptr<neogfx::wheel_timer> a;
+		std::unique_ptr<neogfx::wheel_timer> b;
+		auto callback = [&](neogfx::wheel_timer& aTimer)
+		{
+			++fired;
+			// destroy whichever of the pair has not fired yet
+			if (&aTimer == a.get())
+				b.reset();
+			else
+				a.reset();
+		};
+		a = std::make_unique<neogfx::wheel_timer>(wheel, callback, 30u);
+		b = std::make_unique<neogfx::wheel_timer>(wheel, callback, 30u);
+		run_until(c, wheel, 1100u);
+		UNIT_TEST_CHECK(fired == 1);
+		UNIT_TEST_CHECK((a == nullptr) != (b == nullptr));
+		UNIT_TEST_CHECK(wheel.empty());
+	}
+
+	unit_tests::register_test s1{ "timer_wheel.fires_at_deadline", fires_at_deadline };
+	unit_tests::register_test s2{ "timer_wheel.cascades_from_upper_levels", cascades_from_upper_levels };
+	unit_tests::register_test s3{ "timer_wheel.cascades_when_advancing_in_one_jump", cascades_when_advancing_in_one_jump };
+	unit_tests::register_test s4{ "timer_wheel.rearms_in_callback", rearms_in_callback };
+	unit_tests::register_test s5{ "timer_wheel.destroys_itself_in_callback", destroys_itself_in_callback };
+	unit_tests::register_test s6{ "timer_wheel.cancels_sibling_in_callback", cancels_sibling_in_callback };
+}
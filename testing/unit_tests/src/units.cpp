@@ -0,0 +1,152 @@
+#include <neogfx/neogfx.hpp>
+#include <neogfx/core/units_context.hpp>
+#include "test.hpp"
+
+namespace
+{
+	using namespace neogfx;
+	using unit_tests::approximately_equal;
+
+	// a device with fixed metrics that counts how often they are read; it owns a units_context as widgets do
+	class test_device : public i_device_metrics, public i_units_context
+	{
+	public:
+		test_device(dimension aHorizontalDpi, dimension aVerticalDpi, dimension aEmSize, const size& aExtents = size{ 800.0, 600.0 }) :
+			iAvailable{ true }, iHorizontalDpi{ aHorizontalDpi }, iVerticalDpi{ aVerticalDpi }, iEmSize{ aEmSize }, iExtents{ aExtents }, iReads{ 0u }, iUnitsContext{ *this }
+		{
+		}
+	public:
+		void set_available(bool aAvailable) { iAvailable = aAvailable; }
+		void set_dpi(dimension aHorizontalDpi, dimension aVerticalDpi) { iHorizontalDpi = aHorizontalDpi; iVerticalDpi = aVerticalDpi; }
+		uint32_t reads() const { return iReads; }
+		const units_context& context() const { return iUnitsContext; }
+	public:
+		dimension horizontal_dpi() const override { ++iReads; return iHorizontalDpi; }
+		dimension vertical_dpi() const override { ++iReads; return iVerticalDpi; }
+		dimension ppi() const override { return iHorizontalDpi; }
+		bool metrics_available() const override { return iAvailable; }
+		size extents() const override { return iExtents; }
+		dimension em_size() const override { ++iReads; return iEmSize; }
+	public:
+		bool high_dpi() const override { return false; }
+		dimension dpi_scale_factor() const override { return 1.0; }
+		bool device_metrics_available() const override { return iAvailable; }
+		const i_device_metrics& device_metrics() const override { return *this; }
+		neogfx::units units() const override { return iUnitsContext.units(); }
+		neogfx::units set_units(neogfx::units aUnits) const override { return iUnitsContext.set_units(aUnits); }
+		const units_scale& device_units_scale() const override { return iUnitsContext.device_units_scale(); }
+	private:
+		bool iAvailable;
+		dimension iHorizontalDpi;
+		dimension iVerticalDpi;
+		dimension iEmSize;
+		size iExtents;
+		mutable uint32_t iReads;
+		units_context iUnitsContext;
+	};
+
+	void scale_factors()
+	{
+		UNIT_TEST_CHECK(!units_scale{}.valid());
+		units_scale const scale{ 96.0, 192.0, 0.25 };
+		UNIT_TEST_CHECK(scale.valid());
+		UNIT_TEST_CHECK(scale.to_device_units(units::Pixels) == (vector2{ 1.0, 1.0 }));
+		UNIT_TEST_CHECK(scale.to_device_units(units::Percentage) == (vector2{ 1.0, 1.0 }));
+		UNIT_TEST_CHECK(scale.to_device_units(units::Inches) == (vector2{ 96.0, 192.0 }));
+		UNIT_TEST_CHECK(approximately_equal(scale.to_device_units(units::Points)[0], 96.0 / 72.0));
+		UNIT_TEST_CHECK(approximately_equal(scale.to_device_units(units::Picas)[1], 192.0 / 6.0));
+		UNIT_TEST_CHECK(approximately_equal(scale.to_device_units(units::Millimetres)[0], 96.0 / 25.4));
+		UNIT_TEST_CHECK(approximately_equal(scale.to_device_units(units::Centimetres)[1], 192.0 / 2.54));
+		UNIT_TEST_CHECK(approximately_equal(scale.to_device_units(units::Ems)[0], 0.25 * 96.0));
+		// every factor from device units is the reciprocal of the factor to them
+		for (auto u : { units::Pixels, units::Points, units::Picas, units::Ems, units::Millimetres, units::Centimetres, units::Inches, units::Percentage })
+			for (uint32_t axis = 0; axis < 2u; ++axis)
+				UNIT_TEST_CHECK(approximately_equal(scale.to_device_units(u)[axis] * scale.from_device_units(u)[axis], 1.0));
+	}
+
+	void stateless_conversions()
+	{
+		test_device device{ 96.0, 192.0, 0.25 };
+		device.set_units(units::Points);
+		UNIT_TEST_CHECK(approximately_equal(to_device_units(device, units::Inches, 2.0), 192.0));
+		UNIT_TEST_CHECK(approximately_equal(to_device_units(device, units::Millimetres, 25.4), 96.0));
+		auto const s = to_device_units(device, units::Inches, size{ 1.0, 1.0 });
+		UNIT_TEST_CHECK(approximately_equal(s.cx, 96.0) && approximately_equal(s.cy, 192.0));
+		auto const r = to_device_units(device, units::Inches, rect{ point{ 0.5, 0.5 }, size{ 1.0, 2.0 } });
+		UNIT_TEST_CHECK(approximately_equal(r.x, 48.0) && approximately_equal(r.y, 96.0) && approximately_equal(r.cx, 96.0) && approximately_equal(r.cy, 384.0));
+		auto const m = to_device_units(device, units::Inches, margins{ 1.0, 2.0, 3.0, 4.0 });
+		UNIT_TEST_CHECK(approximately_equal(m.left, 96.0) && approximately_equal(m.top, 384.0) && approximately_equal(m.right, 288.0) && approximately_equal(m.bottom, 768.0));
+		auto const p = from_device_units(device, units::Points, point{ 96.0, 192.0 });
+		UNIT_TEST_CHECK(approximately_equal(p.x, 72.0) && approximately_equal(p.y, 72.0));
+		auto const roundTrip = from_device_units(device, units::Ems, to_device_units(device, units::Ems, delta{ 3.0, -5.0 }));
+		UNIT_TEST_CHECK(approximately_equal(roundTrip.dx, 3.0) && approximately_equal(roundTrip.dy, -5.0));
+		// percentages are of the given extents, or of the device's if none are given
+		UNIT_TEST_CHECK(approximately_equal(to_device_units(device, units::Percentage, size{ 200.0, 100.0 }, size{ 50.0, 50.0 }).cx, 100.0));
+		UNIT_TEST_CHECK(approximately_equal(to_device_units(device, units::Percentage, size{ 50.0, 50.0 }).cy, 300.0));
+		UNIT_TEST_CHECK(approximately_equal(from_device_units(device, units::Percentage, size{ 400.0, 300.0 }).cx, 50.0));
+		// the context's current units are neither used nor changed
+		UNIT_TEST_CHECK(device.units() == units::Points);
+	}
+
+	void conversions_without_metrics()
+	{
+		test_device device{ 96.0, 96.0, 0.25 };
+		device.set_available(false);
+		UNIT_TEST_CHECK(to_device_units(device, units::Pixels, 7.0) == 7.0);
+		UNIT_TEST_CHECK(approximately_equal(to_device_units(device, units::Percentage, size{ 200.0, 200.0 }, 50.0), 100.0));
+		bool threw = false;
+		try
+		{
+			to_device_units(device, units::Inches, 1.0);
+		}
+		catch (const units_converter::device_metrics_unavailable&)
+		{
+			threw = true;
+		}
+		UNIT_TEST_CHECK(threw);
+		// the scale is picked up once metrics become available without any announcement
+		device.set_available(true);
+		UNIT_TEST_CHECK(approximately_equal(to_device_units(device, units::Inches, 1.0), 96.0));
+	}
+
+	void scale_cached_until_invalidated()
+	{
+		test_device device{ 96.0, 96.0, 0.25 };
+		UNIT_TEST_CHECK(approximately_equal(to_device_units(device, units::Inches, 1.0), 96.0));
+		auto const reads = device.reads();
+		UNIT_TEST_CHECK(reads != 0u);
+		for (int i = 0; i < 100; ++i)
+			to_device_units(device, units::Millimetres, margins{ 1.0 });
+		UNIT_TEST_CHECK(device.reads() == reads);
+		// a change that has not been announced is not seen...
+		device.set_dpi(192.0, 192.0);
+		UNIT_TEST_CHECK(approximately_equal(to_device_units(device, units::Inches, 1.0), 96.0));
+		// ...until it is, either for this context alone or for every context
+		device.context().invalidate_device_units_scale();
+		UNIT_TEST_CHECK(approximately_equal(to_device_units(device, units::Inches, 1.0), 192.0));
+		device.set_dpi(288.0, 288.0);
+		units_context::device_metrics_changed();
+		UNIT_TEST_CHECK(approximately_equal(to_device_units(device, units::Inches, 1.0), 288.0));
+		auto const rebuiltReads = device.reads();
+		to_device_units(device, units::Inches, 1.0);
+		UNIT_TEST_CHECK(device.reads() == rebuiltReads);
+	}
+
+	void converter_restores_units()
+	{
+		test_device device{ 96.0, 96.0, 0.25 };
+		device.set_units(units::Millimetres);
+		{
+			units_converter uc{ device };
+			uc.set_units(units::Inches);
+			UNIT_TEST_CHECK(approximately_equal(uc.to_device_units(1.0), 96.0));
+		}
+		UNIT_TEST_CHECK(device.units() == units::Millimetres);
+	}
+
+	unit_tests::register_test s1{ "units.scale_factors", scale_factors };
+	unit_tests::register_test s2{ "units.stateless_conversions", stateless_conversions };
+	unit_tests::register_test s3{ "units.conversions_without_metrics", conversions_without_metrics };
+	unit_tests::register_test s4{ "units.scale_cached_until_invalidated", scale_cached_until_invalidated };
+	unit_tests::register_test s5{ "units.converter_restores_units", converter_restores_units };
+}
@@ -19,6 +19,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <fstream>
 #include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdint>
 #include <boost/filesystem.hpp>
 #include <neolib/xml.hpp>
 
@@ -33,6 +37,53 @@ struct failed_to_read_resource_file : std::runtime_error
 };
 struct bad_usage : std::runtime_error { bad_usage() : std::runtime_error("Bad usage") {} };
 
+// must match neogfx::translation_context_hash and neogfx::translation_key_of (i18n.hpp)
+uint64_t translation_key(const std::string& aContext, const std::string& aSource)
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (auto ch : aContext)
+		hash = (hash ^ static_cast<uint8_t>(ch)) * 1099511628211ull;
+	hash *= 1099511628211ull;
+	for (auto ch : aSource)
+		hash = (hash ^ static_cast<uint8_t>(ch)) * 1099511628211ull;
+	return hash;
+}
+
+std::string string_literal(const std::string& aText)
+{
+	std::ostringstream result;
+	result << "\"";
+	for (auto ch : aText)
+	{
+		switch (ch)
+		{
+		case '"':
+			result << "\\\"";
+			break;
+		case '\\':
+			result << "\\\\";
+			break;
+		case '\n':
+			result << "\\n";
+			break;
+		case '\r':
+			result << "\\r";
+			break;
+		case '\t':
+			result << "\\t";
+			break;
+		default:
+			if (static_cast<uint8_t>(ch) < 0x20 || static_cast<uint8_t>(ch) >= 0x80)
+				result << "\\" << std::oct << std::setw(3) << std::setfill('0') << static_cast<unsigned int>(static_cast<uint8_t>(ch)) << std::dec;
+			else
+				result << ch;
+			break;
+		}
+	}
+	result << "\"";
+	return result.str();
+}
+
 int main(int argc, char* argv[])
 {
 	std::cout << "nrc neogfx resource compiler" << std::endl;
@@ -85,7 +136,8 @@ int main(int argc, char* argv[])
 		{
 			std::ofstream output(outputFileName);
 			output << "// This is a automatically generated file, do not edit!" << std::endl;
-			output << "#include <neogfx/app/resource_manager.hpp>" << std::endl << std::endl;
+			output << "#include <neogfx/app/resource_manager.hpp>" << std::endl;
+			output << "#include <neogfx/app/i18n.hpp>" << std::endl << std::endl;
 			output << "namespace nrc" << std::endl << "{" << std::endl;
 			output << "namespace" << std::endl << "{" << std::endl;
 			std::vector<std::string> resourcePaths;
@@ -143,6 +195,50 @@ int main(int argc, char* argv[])
 					}
 				}
 			}
+			// translation catalogues are emitted as tables sorted by key so that they can be searched in place
+			output << std::dec;
+			std::vector<std::string> catalogueLanguages;
+			for (const auto& translations : input.root())
+			{
+				if (translations.name() != "translations")
+					continue;
+				if (!translations.has_attribute("language"))
+					throw invalid_file("translations without language");
+				catalogueLanguages.push_back(std::string(translations.attribute_value("language")));
+				std::cout << "Processing " << catalogueLanguages.back() << " translations..." << std::endl;
+				struct entry { uint64_t key; std::string context; std::string source; std::string translation; };
+				std::vector<entry> entries;
+				for (const auto& context : translations)
+				{
+					if (context.name() != "context")
+						continue;
+					std::string contextName = context.has_attribute("name") ? std::string(context.attribute_value("name")) : std::string();
+					for (const auto& message : context)
+					{
+						if (message.name() != "message")
+							continue;
+						entry newEntry{ 0, contextName };
+						for (const auto& part : message)
+						{
+							if (part.name() == "source")
+								newEntry.source = std::string(part.text());
+							else if (part.name() == "translation")
+								newEntry.translation = std::string(part.text());
+						}
+						newEntry.key = translation_key(newEntry.context, newEntry.source);
+						entries.push_back(newEntry);
+					}
+				}
+				std::sort(entries.begin(), entries.end(), [](const entry& aLeft, const entry& aRight) { return aLeft.key < aRight.key; });
+				output << "\tconst neogfx::translation_entry translations_" << catalogueLanguages.size() - 1 << "_data[] =" << std::endl << "\t{" << std::endl;
+				for (const auto& e : entries)
+					output << "\t\t{ 0x" << std::hex << std::setw(16) << std::setfill('0') << e.key << std::dec << "ull, " <<
+						string_literal(e.context) << ", " << string_literal(e.source) << ", " << string_literal(e.translation) << " }," << std::endl;
+				if (entries.empty())
+					output << "\t\t{ 0ull, \"\", \"\", \"\" }" << std::endl;
+				output << "\t};" << std::endl;
+				output << "\tconst std::size_t translations_" << catalogueLanguages.size() - 1 << "_size = " << entries.size() << ";" << std::endl;
+			}
 			output << "\tstruct register_data" << std::endl << "\t{" << std::endl;
 			output << "\t\tregister_data()" << std::endl << "\t\t{" << std::endl;
 			for (std::size_t i = 0; i < resourcePaths.size(); ++i)
@@ -151,6 +247,12 @@ int main(int argc, char* argv[])
 					<< "\":/" << resourcePaths[i] << "\", " << "resource_" << i << "_data, " << "sizeof(resource_" << i << "_data)"
 					<< ");" << std::endl;
 			}
+			for (std::size_t i = 0; i < catalogueLanguages.size(); ++i)
+			{
+				output << "\t\t\tneogfx::translation_manager::instance().add_catalogue("
+					<< string_literal(catalogueLanguages[i]) << ", " << "translations_" << i << "_data, " << "translations_" << i << "_size"
+					<< ");" << std::endl;
+			}
 			output << "\t\t}" << std::endl;
 			output << "\t} sData;" << std::endl;
 			output << "}" << std::endl;